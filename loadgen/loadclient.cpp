@@ -0,0 +1,633 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: loadclient.cpp
+//
+// Description: A single synthetic client session of the load generator.
+//
+//-----------------------------------------------------------------------------
+
+#include "loadclient.h"
+#include "../src/network_enums.h"
+#include "../src/version.h"
+#include "../src/huffman/huffman.h"
+
+#include <algorithm>
+#include <string.h>
+
+//*****************************************************************************
+//	DEFINES
+
+// The check value of a ticcmd with zero yaw, pitch and roll (see NETWORK_Check).
+// The clients set the angle directly, so this is all they ever need.
+#define	ZERO_TICCMD_CHECK			( 'f' + ( 'c' << 8 ) + ( '7' << 16 ) + ( '8' << 24 ))
+
+// Maximum number of sequences asked for in one CLC_MISSINGPACKET command.
+#define	MAX_MISSINGPACKET_REQUEST	256
+
+//*****************************************************************************
+//	VARIABLES
+
+// Buffers shared by all clients for the Huffman coding.
+static	UCHAR		g_ucHuffmanBuffer[131072];
+static	NETBUFFER_s	g_NetworkMessage;
+
+//*****************************************************************************
+//	FUNCTIONS
+
+void LOADSTATS_s::Clear( )
+{
+	memset( this, 0, sizeof( *this ));
+}
+
+//*****************************************************************************
+//
+void LOADSTATS_s::Add( const LOADSTATS_s &Other )
+{
+	ulBytesSent += Other.ulBytesSent;
+	ulBytesReceived += Other.ulBytesReceived;
+	ulPacketsSent += Other.ulPacketsSent;
+	ulPacketsReceived += Other.ulPacketsReceived;
+	ulMoveCommandsSent += Other.ulMoveCommandsSent;
+	ulDuplicatePackets += Other.ulDuplicatePackets;
+	ulMissingPacketsRequested += Other.ulMissingPacketsRequested;
+	ulPacketsRecovered += Other.ulPacketsRecovered;
+	ulPacketsLost += Other.ulPacketsLost;
+	dIntervalSum += Other.dIntervalSum;
+	dIntervalMax = std::max( dIntervalMax, Other.dIntervalMax );
+	ulNumIntervals += Other.ulNumIntervals;
+}
+
+//*****************************************************************************
+//*****************************************************************************
+//
+LoadClient::LoadClient( unsigned int index, const LOADSETTINGS_s &settings )
+	: _index( index ),
+	  _settings( settings ),
+	  _socket( INVALID_SOCKET ),
+	  _state( LCS_DISCONNECTED ),
+	  _errorCode( -1 ),
+	  _retryTicks( 0 ),
+	  _missingPacketTicks( 0 ),
+	  _ticsInGame( 0 ),
+	  _clientGametic( 0 ),
+	  _serverGametic( 0 ),
+	  _receivedSequences( PACKET_BUFFER_SIZE, -1 ),
+	  _requestedSequences( PACKET_BUFFER_SIZE, -1 ),
+	  _lastParsedSequence( -1 ),
+	  _highestReceivedSequence( -1 ),
+	  _lastPacketTime( 0 )
+{
+	// Spread the clients over the script so they don't all move in lockstep.
+	_scriptPosition = settings.script.size( ) ? ( index * 37 ) % settings.script.size( ) : 0;
+	_stats.Clear( );
+}
+
+//*****************************************************************************
+//
+const char *LoadClient::GetErrorDescription( int errorCode )
+{
+	switch ( errorCode )
+	{
+	case NETWORK_ERRORCODE_WRONGPASSWORD:					return ( "wrong password" );
+	case NETWORK_ERRORCODE_WRONGVERSION:					return ( "wrong version" );
+	case NETWORK_ERRORCODE_WRONGPROTOCOLVERSION:			return ( "wrong protocol version" );
+	case NETWORK_ERRORCODE_BANNED:							return ( "banned" );
+	case NETWORK_ERRORCODE_SERVERISFULL:					return ( "the server is full" );
+	case NETWORK_ERRORCODE_AUTHENTICATIONFAILED:			return ( "level authentication failed" );
+	case NETWORK_ERRORCODE_TOOMANYCONNECTIONSFROMIP:		return ( "too many connections from this IP (sv_maxclientsperip)" );
+	case NETWORK_ERRORCODE_PROTECTED_LUMP_AUTHENTICATIONFAILED:	return ( "protected lump authentication failed" );
+	case NETWORK_ERRORCODE_USERINFOREJECTED:				return ( "userinfo rejected" );
+	default:												return ( "unknown error" );
+	}
+}
+
+//*****************************************************************************
+//
+LoadClient::~LoadClient( )
+{
+	if ( _socket != INVALID_SOCKET )
+		closesocket( _socket );
+
+	_localBuffer.Free( );
+}
+
+//*****************************************************************************
+//
+bool LoadClient::Open( )
+{
+	// Every client gets its own socket (and thus its own port), otherwise the
+	// server would think they're all the same client.
+	_socket = socket( PF_INET, SOCK_DGRAM, IPPROTO_UDP );
+	if ( _socket == INVALID_SOCKET )
+	{
+		printf( "LoadClient::Open: Couldn't create socket for client %u!\n", _index );
+		return ( false );
+	}
+
+	struct sockaddr_in address;
+	memset( &address, 0, sizeof( address ));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = INADDR_ANY;
+	address.sin_port = 0;
+	if ( bind( _socket, reinterpret_cast<sockaddr *>( &address ), sizeof( address )) == SOCKET_ERROR )
+	{
+		printf( "LoadClient::Open: Couldn't bind socket for client %u: %s\n", _index, strerror( errno ));
+		return ( false );
+	}
+
+	ULONG ulArg = true;
+	if ( ioctlsocket( _socket, FIONBIO, &ulArg ) == -1 )
+		printf( "LoadClient::Open: ioctl FIONBIO: %s\n", strerror( errno ));
+
+	// [BB] The smallest huffman code is only 3 bits, see NETWORK_Construct.
+	if ( g_NetworkMessage.pbData == NULL )
+	{
+		HUFFMAN_Construct( );
+		g_NetworkMessage.Init( (( MAX_UDP_PACKET * 8 ) / 3 + 1 ), BUFFERTYPE_READ );
+	}
+
+	_localBuffer.Init( MAX_UDP_PACKET, BUFFERTYPE_WRITE );
+	_localBuffer.Clear( );
+
+	SetState( LCS_CONNECTING );
+	return ( true );
+}
+
+//*****************************************************************************
+//
+void LoadClient::Close( )
+{
+	if (( _state == LCS_DISCONNECTED ) || ( _state == LCS_FAILED ))
+		return;
+
+	// Tell the server we're leaving, so it doesn't have to time us out.
+	_localBuffer.Clear( );
+	_localBuffer.ByteStream.WriteByte( CLC_QUIT );
+	LaunchPacket( );
+	SetState( LCS_DISCONNECTED );
+}
+
+//*****************************************************************************
+//
+void LoadClient::SetState( LOADCLIENTSTATE_e state )
+{
+	_state = state;
+	_retryTicks = 0;
+
+	// The server restarts its sequence numbers at every step of the handshake.
+	std::fill( _receivedSequences.begin( ), _receivedSequences.end( ), -1 );
+	std::fill( _requestedSequences.begin( ), _requestedSequences.end( ), -1 );
+	_lastParsedSequence = -1;
+	_highestReceivedSequence = -1;
+}
+
+//*****************************************************************************
+//
+void LoadClient::ReceivePackets( double now )
+{
+	if ( _socket == INVALID_SOCKET )
+		return;
+
+	while ( true )
+	{
+		sockaddr socketFrom;
+#ifdef __WIN32__
+		int socketFromLength = sizeof( socketFrom );
+#else
+		socklen_t socketFromLength = sizeof( socketFrom );
+#endif
+		const LONG numBytes = recvfrom( _socket, reinterpret_cast<char *>( g_ucHuffmanBuffer ), sizeof( g_ucHuffmanBuffer ), 0, &socketFrom, &socketFromLength );
+
+		// Nothing left to read (or an error we don't care about here).
+		if ( numBytes <= 0 )
+			return;
+
+		if ( numBytes >= static_cast<LONG>( g_NetworkMessage.ulMaxSize ))
+			continue;
+
+		NETADDRESS_s addressFrom;
+		addressFrom.LoadFromSocketAddress( socketFrom );
+		if ( addressFrom.Compare( _settings.ServerAddress ) == false )
+			continue;
+
+		int decodedNumBytes = g_NetworkMessage.ulMaxSize;
+		HUFFMAN_Decode( g_ucHuffmanBuffer, g_NetworkMessage.pbData, numBytes, &decodedNumBytes );
+		g_NetworkMessage.ulCurrentSize = decodedNumBytes;
+		g_NetworkMessage.ByteStream.pbStream = g_NetworkMessage.pbData;
+		g_NetworkMessage.ByteStream.pbStreamEnd = g_NetworkMessage.pbData + decodedNumBytes;
+		g_NetworkMessage.ByteStream.bitBuffer = NULL;
+		g_NetworkMessage.ByteStream.bitShift = -1;
+
+		_stats.ulBytesReceived += numBytes;
+		_stats.ulPacketsReceived++;
+
+		if ( _lastPacketTime > 0 )
+		{
+			const double interval = now - _lastPacketTime;
+			_stats.dIntervalSum += interval;
+			_stats.dIntervalMax = std::max( _stats.dIntervalMax, interval );
+			_stats.ulNumIntervals++;
+		}
+		_lastPacketTime = now;
+
+		ParsePacket( &g_NetworkMessage.ByteStream, decodedNumBytes, now );
+	}
+}
+
+//*****************************************************************************
+//
+void LoadClient::ParsePacket( BYTESTREAM_s *pByteStream, LONG size, double now )
+{
+	const int header = pByteStream->ReadByte( );
+
+	// Unreliable packets are never part of the handshake and don't need to be tracked.
+	if (( header != SVC_HEADER ) || ( size < 6 ))
+		return;
+
+	const LONG sequence = pByteStream->ReadLong( );
+	const int command = pByteStream->ReadByte( );
+
+	// Connection errors are sent outside of the sequence.
+	if ( command == SVCC_ERROR )
+	{
+		_errorCode = pByteStream->ReadByte( );
+		printf( "Client %u: The server refused the connection: %s.\n", _index, LoadClient::GetErrorDescription( _errorCode ));
+		if ( _errorCode == NETWORK_ERRORCODE_TOOMANYCONNECTIONSFROMIP )
+			printf( "Client %u: All clients connect from the same address, start the server with \"+sv_maxclientsperip 0\".\n", _index );
+		else if ( _state == LCS_AUTHENTICATING )
+			printf( "Client %u: Level authentication of %s failed, pass the checksum from the server's \"mapchecksum\" command with -checksum.\n", _index, _mapName.c_str( ));
+
+		SetState( LCS_FAILED );
+		return;
+	}
+
+	if ( StoreSequence( sequence ) == false )
+		return;
+
+	switch ( command )
+	{
+	case SVCC_AUTHENTICATE:
+
+		if ( _state != LCS_FAILED )
+		{
+			_mapName = pByteStream->ReadString( );
+			_serverGametic = pByteStream->ReadLong( );
+			SetState( LCS_AUTHENTICATING );
+		}
+		break;
+	case SVCC_MAPLOAD:
+
+		if ( _state == LCS_AUTHENTICATING )
+			SetState( LCS_REQUESTINGSNAPSHOT );
+		break;
+	default:
+
+		// Once the server starts sending the snapshot, we're in.
+		if ( _state == LCS_REQUESTINGSNAPSHOT )
+		{
+			_state = LCS_INGAME;
+			_ticsInGame = 0;
+		}
+		break;
+	}
+}
+
+//*****************************************************************************
+//
+// Records the sequence of a received packet. Returns false for duplicates.
+//
+bool LoadClient::StoreSequence( LONG sequence )
+{
+	const ULONG ulSlot = static_cast<ULONG>( sequence ) % PACKET_BUFFER_SIZE;
+
+	if (( sequence <= _lastParsedSequence ) || ( _receivedSequences[ulSlot] == sequence ))
+	{
+		_stats.ulDuplicatePackets++;
+		return ( false );
+	}
+
+	_receivedSequences[ulSlot] = sequence;
+	if ( _requestedSequences[ulSlot] == sequence )
+	{
+		_stats.ulPacketsRecovered++;
+		_requestedSequences[ulSlot] = -1;
+	}
+
+	if ( sequence > _highestReceivedSequence )
+		_highestReceivedSequence = sequence;
+
+	while (( _lastParsedSequence < _highestReceivedSequence )
+		&& ( _receivedSequences[static_cast<ULONG>( _lastParsedSequence + 1 ) % PACKET_BUFFER_SIZE] == _lastParsedSequence + 1 ))
+	{
+		_lastParsedSequence++;
+	}
+
+	return ( true );
+}
+
+//*****************************************************************************
+//
+// Same as CLIENT_CheckForMissingPackets, except that we keep going when more
+// than PACKET_BUFFER_SIZE packets are missing and count them as lost instead.
+//
+void LoadClient::CheckForMissingPackets( )
+{
+	if ( _missingPacketTicks > 0 )
+	{
+		_missingPacketTicks--;
+		return;
+	}
+
+	if ( _lastParsedSequence == _highestReceivedSequence )
+		return;
+
+	if (( _highestReceivedSequence - _lastParsedSequence ) >= PACKET_BUFFER_SIZE )
+	{
+		FinishStatistics( );
+		return;
+	}
+
+	ULONG ulNumRequested = 0;
+	_localBuffer.ByteStream.WriteByte( CLC_MISSINGPACKET );
+	for ( LONG sequence = _lastParsedSequence + 1; ( sequence < _highestReceivedSequence ) && ( ulNumRequested < MAX_MISSINGPACKET_REQUEST ); sequence++ )
+	{
+		const ULONG ulSlot = static_cast<ULONG>( sequence ) % PACKET_BUFFER_SIZE;
+		if ( _receivedSequences[ulSlot] == sequence )
+			continue;
+
+		_localBuffer.ByteStream.WriteLong( sequence );
+		_requestedSequences[ulSlot] = sequence;
+		ulNumRequested++;
+	}
+	_localBuffer.ByteStream.WriteLong( -1 );
+
+	_stats.ulMissingPacketsRequested += ulNumRequested;
+	_missingPacketTicks = ( TICRATE / 4 );
+}
+
+//*****************************************************************************
+//
+// Gives up on all packets that are still missing and counts them as lost.
+//
+void LoadClient::FinishStatistics( )
+{
+	for ( LONG sequence = _lastParsedSequence + 1; sequence < _highestReceivedSequence; sequence++ )
+	{
+		if ( _receivedSequences[static_cast<ULONG>( sequence ) % PACKET_BUFFER_SIZE] != sequence )
+			_stats.ulPacketsLost++;
+	}
+
+	_lastParsedSequence = _highestReceivedSequence;
+}
+
+//*****************************************************************************
+//
+void LoadClient::CollectStatistics( LOADSTATS_s &stats )
+{
+	stats.Add( _stats );
+	_stats.Clear( );
+}
+
+//*****************************************************************************
+//
+void LoadClient::Tick( )
+{
+	// The server's gametic advances along with ours.
+	_clientGametic++;
+	_serverGametic++;
+
+	switch ( _state )
+	{
+	case LCS_CONNECTING:
+
+		SendConnectionAttempt( );
+		break;
+	case LCS_AUTHENTICATING:
+
+		SendAuthentication( );
+		break;
+	case LCS_REQUESTINGSNAPSHOT:
+
+		SendSnapshotRequest( );
+		break;
+	case LCS_INGAME:
+
+		// Confirm the full update after a second, we can't tell when it's actually done.
+		if ( ++_ticsInGame == TICRATE )
+			_localBuffer.ByteStream.WriteByte( CLC_FULLUPDATE );
+
+		SendMove( );
+		break;
+	default:
+
+		return;
+	}
+
+	CheckForMissingPackets( );
+	LaunchPacket( );
+}
+
+//*****************************************************************************
+//
+void LoadClient::SendConnectionAttempt( )
+{
+	if ( _retryTicks )
+	{
+		_retryTicks--;
+		return;
+	}
+
+	_retryTicks = CONNECTION_RESEND_TIME;
+
+	_localBuffer.ByteStream.WriteByte( CLCC_ATTEMPTCONNECTION );
+	_localBuffer.ByteStream.WriteString( DOTVERSIONSTR );
+	_localBuffer.ByteStream.WriteString( _settings.password.c_str( ));
+	_localBuffer.ByteStream.WriteByte( _settings.connectFlags );
+	_localBuffer.ByteStream.WriteByte( 0 );
+	_localBuffer.ByteStream.WriteByte( NETGAMEVERSION );
+	_localBuffer.ByteStream.WriteString( _settings.lumpChecksum.c_str( ));
+}
+
+//*****************************************************************************
+//
+void LoadClient::SendAuthentication( )
+{
+	if ( _retryTicks )
+	{
+		_retryTicks--;
+		return;
+	}
+
+	_retryTicks = CONNECTION_RESEND_TIME;
+
+	_localBuffer.ByteStream.WriteByte( CLCC_ATTEMPTAUTHENTICATION );
+
+	std::string mapName = _mapName;
+	std::transform( mapName.begin( ), mapName.end( ), mapName.begin( ), ::toupper );
+
+	// [BB] Just like the real client, send nothing if we don't know the map.
+	std::map<std::string, std::vector<BYTE> >::const_iterator it = _settings.mapChecksums.find( mapName );
+	if ( it != _settings.mapChecksums.end( ))
+		_localBuffer.ByteStream.WriteBuffer( it->second.data( ), static_cast<int>( it->second.size( )));
+}
+
+//*****************************************************************************
+//
+void LoadClient::SendSnapshotRequest( )
+{
+	if ( _retryTicks )
+	{
+		_retryTicks--;
+		return;
+	}
+
+	_retryTicks = CONNECTION_RESEND_TIME;
+
+	char szName[32];
+	snprintf( szName, sizeof( szName ), "LoadGen%u", _index );
+
+	// The server insists on all of these, see SERVER_GetUserInfo.
+	const char *const userinfo[][2] =
+	{
+		{ "name", szName },
+		{ "autoaim", "0" },
+		{ "gender", "male" },
+		{ "skin", "base" },
+		{ "railcolor", "0" },
+		{ "cl_connectiontype", "1" },
+		{ "cl_clientflags", "0" },
+		{ "handicap", "0" },
+		{ "cl_ticsperupdate", "1" },
+		{ "color", "40 cf 00" },
+		{ "colorset", "-1" },
+	};
+
+	_localBuffer.ByteStream.WriteByte( CLCC_REQUESTSNAPSHOT );
+	_localBuffer.ByteStream.WriteByte( CLC_USERINFO );
+	for ( unsigned int i = 0; i < sizeof( userinfo ) / sizeof( userinfo[0] ); ++i )
+	{
+		// Transfer the names as strings, we don't have the predefined name table.
+		_localBuffer.ByteStream.WriteShort( -1 );
+		_localBuffer.ByteStream.WriteString( userinfo[i][0] );
+		_localBuffer.ByteStream.WriteString( userinfo[i][1] );
+	}
+
+	// NAME_None ends the list.
+	_localBuffer.ByteStream.WriteShort( 0 );
+}
+
+//*****************************************************************************
+//
+void LoadClient::SendMove( )
+{
+	LOADMOVE_s move;
+	memset( &move, 0, sizeof( move ));
+
+	if ( _settings.script.size( ))
+	{
+		move = _settings.script[_scriptPosition];
+		_scriptPosition = ( _scriptPosition + 1 ) % _settings.script.size( );
+	}
+
+	ULONG ulBits = 0;
+	if ( move.ulButtons )
+	{
+		ulBits |= CLIENT_UPDATE_BUTTONS;
+		if ( move.ulButtons > 0xFF )
+			ulBits |= CLIENT_UPDATE_BUTTONS_LONG;
+	}
+	if ( move.sForwardMove )
+		ulBits |= CLIENT_UPDATE_FORWARDMOVE;
+	if ( move.sSideMove )
+		ulBits |= CLIENT_UPDATE_SIDEMOVE;
+
+	_localBuffer.ByteStream.WriteByte( CLC_CLIENTMOVE );
+	_localBuffer.ByteStream.WriteLong( _clientGametic );
+	_localBuffer.ByteStream.WriteLong( _serverGametic );
+	_localBuffer.ByteStream.WriteByte( ulBits );
+
+	if ( ulBits & CLIENT_UPDATE_BUTTONS )
+	{
+		if ( ulBits & CLIENT_UPDATE_BUTTONS_LONG )
+			_localBuffer.ByteStream.WriteLong( move.ulButtons );
+		else
+			_localBuffer.ByteStream.WriteByte( move.ulButtons );
+	}
+	if ( ulBits & CLIENT_UPDATE_FORWARDMOVE )
+		_localBuffer.ByteStream.WriteShort( move.sForwardMove );
+	if ( ulBits & CLIENT_UPDATE_SIDEMOVE )
+		_localBuffer.ByteStream.WriteShort( move.sSideMove );
+
+	_localBuffer.ByteStream.WriteLong( move.ulAngle );
+	_localBuffer.ByteStream.WriteLong( 0 );
+	_localBuffer.ByteStream.WriteLong( ZERO_TICCMD_CHECK );
+
+	// We don't know which weapon we're holding. Zero makes the server tell us
+	// instead of kicking us, see server_ProcessClientMove.
+	if ( move.ulButtons & BT_ATTACK )
+		_localBuffer.ByteStream.WriteShort( 0 );
+
+	_stats.ulMoveCommandsSent++;
+}
+
+//*****************************************************************************
+//
+void LoadClient::LaunchPacket( )
+{
+	_localBuffer.ulCurrentSize = _localBuffer.CalcSize( );
+	if ( _localBuffer.ulCurrentSize == 0 )
+		return;
+
+	int numBytesOut = sizeof( g_ucHuffmanBuffer );
+	HUFFMAN_Encode( _localBuffer.pbData, g_ucHuffmanBuffer, _localBuffer.ulCurrentSize, &numBytesOut );
+
+	struct sockaddr socketAddress;
+	_settings.ServerAddress.ToSocketAddress( socketAddress );
+	if ( sendto( _socket, reinterpret_cast<const char *>( g_ucHuffmanBuffer ), numBytesOut, 0, &socketAddress, sizeof( sockaddr_in )) != -1 )
+	{
+		_stats.ulBytesSent += numBytesOut;
+		_stats.ulPacketsSent++;
+	}
+
+	_localBuffer.Clear( );
+}
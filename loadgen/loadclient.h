@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: loadclient.h
+//
+// Description: A single synthetic client session of the load generator.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef __LOADCLIENT_H__
+#define __LOADCLIENT_H__
+
+#include "../src/networkheaders.h"
+#include "../src/networkshared.h"
+#include <map>
+#include <string>
+#include <vector>
+
+//*****************************************************************************
+//	DEFINES
+
+// These must match the values used by the game (see doomdef.h, cl_main.h and network.h).
+#define	TICRATE						35
+#define	CONNECTION_RESEND_TIME		( 3 * TICRATE )
+#define	CLIENT_UPDATE_BUTTONS		0x08
+#define	CLIENT_UPDATE_FORWARDMOVE	0x10
+#define	CLIENT_UPDATE_SIDEMOVE		0x20
+#define	CLIENT_UPDATE_BUTTONS_LONG	0x80
+#define	BT_ATTACK					1
+
+//*****************************************************************************
+enum LOADCLIENTSTATE_e
+{
+	LCS_DISCONNECTED,
+	LCS_CONNECTING,
+	LCS_AUTHENTICATING,
+	LCS_REQUESTINGSNAPSHOT,
+	LCS_INGAME,
+	LCS_FAILED,
+
+	NUM_LOADCLIENTSTATES
+};
+
+//*****************************************************************************
+//	STRUCTURES
+
+// One tic worth of input that the clients replay.
+struct LOADMOVE_s
+{
+	SWORD	sForwardMove;
+	SWORD	sSideMove;
+	ULONG	ulButtons;
+	ULONG	ulAngle;
+};
+
+//*****************************************************************************
+struct LOADSETTINGS_s
+{
+	NETADDRESS_s						ServerAddress;
+	std::string							password;
+	std::string							lumpChecksum;
+	BYTE								connectFlags;
+
+	// Map checksums as printed by the server's "mapchecksum" command, keyed by
+	// the upper case lump name of the map.
+	std::map<std::string, std::vector<BYTE> >	mapChecksums;
+
+	// The move script all clients replay (each starting at a different offset).
+	std::vector<LOADMOVE_s>				script;
+};
+
+//*****************************************************************************
+struct LOADSTATS_s
+{
+	ULONG	ulBytesSent;
+	ULONG	ulBytesReceived;
+	ULONG	ulPacketsSent;
+	ULONG	ulPacketsReceived;
+	ULONG	ulMoveCommandsSent;
+	ULONG	ulDuplicatePackets;
+	ULONG	ulMissingPacketsRequested;
+	ULONG	ulPacketsRecovered;
+	ULONG	ulPacketsLost;
+
+	// Time between two consecutive packets from the server (in ms). The server
+	// sends its packets once per tic, but this also includes the network and
+	// our own scheduling, so it is only a rough hint at the server's tic time.
+	double	dIntervalSum;
+	double	dIntervalMax;
+	ULONG	ulNumIntervals;
+
+	void	Clear( );
+	void	Add( const LOADSTATS_s &Other );
+};
+
+//==========================================================================
+//
+// LoadClient
+//
+// Speaks just enough of the client protocol to connect to a server, stay in
+// the game and keep the server's packet archive busy: It completes the
+// connection handshake, replays the move script, acknowledges packet loss
+// with CLC_MISSINGPACKET and counts everything it sends and receives. The
+// contents of the server commands are not parsed.
+//
+//==========================================================================
+class LoadClient
+{
+public:
+	LoadClient( unsigned int index, const LOADSETTINGS_s &settings );
+	~LoadClient( );
+
+	bool Open( );
+	void Close( );
+	void ReceivePackets( double now );
+	void Tick( );
+	void FinishStatistics( );
+	void CollectStatistics( LOADSTATS_s &stats );
+	LOADCLIENTSTATE_e GetState( ) const { return _state; }
+	int GetErrorCode( ) const { return _errorCode; }
+	SOCKET GetSocket( ) const { return _socket; }
+
+	static const char *GetErrorDescription( int errorCode );
+
+private:
+	void SetState( LOADCLIENTSTATE_e state );
+	void ParsePacket( BYTESTREAM_s *pByteStream, LONG size, double now );
+	bool StoreSequence( LONG sequence );
+	void CheckForMissingPackets( );
+	void SendConnectionAttempt( );
+	void SendAuthentication( );
+	void SendSnapshotRequest( );
+	void SendMove( );
+	void LaunchPacket( );
+
+	unsigned int _index;
+	const LOADSETTINGS_s &_settings;
+	SOCKET _socket;
+
+	// Commands to be sent to the server at the end of the tic.
+	NETBUFFER_s _localBuffer;
+
+	LOADCLIENTSTATE_e _state;
+
+	// The NETWORK_ERRORCODE_* the server refused us with, -1 if it didn't.
+	int _errorCode;
+	std::string _mapName;
+	ULONG _retryTicks;
+	ULONG _missingPacketTicks;
+	ULONG _ticsInGame;
+	ULONG _scriptPosition;
+	LONG _clientGametic;
+	LONG _serverGametic;
+
+	// Sequence tracking, see CLIENT_ReadPacketHeader.
+	std::vector<LONG> _receivedSequences;
+	std::vector<LONG> _requestedSequences;
+	LONG _lastParsedSequence;
+	LONG _highestReceivedSequence;
+
+	double _lastPacketTime;
+	LOADSTATS_s _stats;
+};
+
+#endif	// __LOADCLIENT_H__
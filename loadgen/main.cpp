@@ -0,0 +1,500 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: main.cpp
+//
+// Description: Headless load generator. Connects a swarm of synthetic clients
+// to a local server and reports how the server copes with them.
+//
+//-----------------------------------------------------------------------------
+
+#include "loadclient.h"
+#include "../src/network_enums.h"
+#include "../src/version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <memory>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+
+//*****************************************************************************
+//	DEFINES
+
+// The server can't take more players than this (see MAXPLAYERS in doomdef.h).
+#define	MAX_SERVER_CLIENTS		64
+
+//*****************************************************************************
+//	VARIABLES
+
+static	volatile bool	g_bStop = false;
+
+//*****************************************************************************
+//	FUNCTIONS
+
+static double loadgen_Now( void )
+{
+	using namespace std::chrono;
+	static const steady_clock::time_point start = steady_clock::now( );
+	return duration<double, std::milli>( steady_clock::now( ) - start ).count( );
+}
+
+//*****************************************************************************
+//
+static void loadgen_SignalHandler( int )
+{
+	g_bStop = true;
+}
+
+//*****************************************************************************
+//
+static void loadgen_PrintUsage( void )
+{
+	printf( "Usage: zandronum-loadgen [options]\n"
+		"  -host <address>           Server address (default: 127.0.0.1:10666)\n"
+		"  -clients <n>              Number of synthetic clients (default: 8)\n"
+		"  -duration <seconds>       How long to run, 0 runs until interrupted (default: 60)\n"
+		"  -rampup <ms>              Delay between two client connections (default: 250)\n"
+		"  -report <seconds>         Interval between two status lines (default: 5)\n"
+		"  -password <password>      Server password\n"
+		"  -lumpchecksum <checksum>  Lump authentication checksum (only needed with sv_pure)\n"
+		"  -checksum <map>=<hex>     Map checksum as printed by the server's \"mapchecksum\" command\n"
+		"  -script <file>            Move script to replay instead of the built-in one\n"
+		"  -spectate                 Connect as spectators\n"
+		"\n"
+		"The move script has one tic per line: <forwardmove> <sidemove> <buttons> <angle in degrees>\n"
+		"\n"
+		"All clients connect from the same address, while the server only accepts\n"
+		"sv_maxclientsperip (default: 2) of them. Start the server with\n"
+		"\"+sv_maxclientsperip 0\" to lift that limit, and make sure sv_maxclients\n"
+		"and sv_maxplayers are large enough for the number of clients.\n" );
+}
+
+//*****************************************************************************
+//
+static bool loadgen_ParseChecksum( const char *pszArgument, LOADSETTINGS_s &Settings )
+{
+	const char *pszSeparator = strchr( pszArgument, '=' );
+	if (( pszSeparator == NULL ) || ( strlen( pszSeparator + 1 ) != 32 ))
+		return ( false );
+
+	std::vector<BYTE> checksum( 16 );
+	for ( unsigned int i = 0; i < 16; ++i )
+	{
+		unsigned int byte;
+		if ( sscanf( pszSeparator + 1 + 2 * i, "%2x", &byte ) != 1 )
+			return ( false );
+		checksum[i] = static_cast<BYTE>( byte );
+	}
+
+	std::string mapName( pszArgument, pszSeparator - pszArgument );
+	std::transform( mapName.begin( ), mapName.end( ), mapName.begin( ), ::toupper );
+	Settings.mapChecksums[mapName] = checksum;
+	return ( true );
+}
+
+//*****************************************************************************
+//
+static ULONG loadgen_DegreesToAngle( double degrees )
+{
+	return static_cast<ULONG>( static_cast<int64_t>( degrees * 4294967296.0 / 360.0 ));
+}
+
+//*****************************************************************************
+//
+static bool loadgen_LoadScript( const char *pszFileName, std::vector<LOADMOVE_s> &script )
+{
+	FILE *pFile = fopen( pszFileName, "r" );
+	if ( pFile == NULL )
+	{
+		printf( "Couldn't open script %s: %s\n", pszFileName, strerror( errno ));
+		return ( false );
+	}
+
+	char szLine[256];
+	ULONG ulLine = 0;
+	while ( fgets( szLine, sizeof( szLine ), pFile ))
+	{
+		ulLine++;
+
+		// Skip comments and empty lines.
+		const char *pszLine = szLine + strspn( szLine, " \t" );
+		if (( *pszLine == '#' ) || ( *pszLine == '\n' ) || ( *pszLine == '\r' ) || ( *pszLine == 0 ))
+			continue;
+
+		int forwardMove, sideMove;
+		unsigned int buttons;
+		double angle;
+		if ( sscanf( pszLine, "%d %d %u %lf", &forwardMove, &sideMove, &buttons, &angle ) != 4 )
+		{
+			printf( "%s:%lu: Expected <forwardmove> <sidemove> <buttons> <angle>\n", pszFileName, ulLine );
+			fclose( pFile );
+			return ( false );
+		}
+
+		LOADMOVE_s move;
+		move.sForwardMove = static_cast<SWORD>( forwardMove );
+		move.sSideMove = static_cast<SWORD>( sideMove );
+		move.ulButtons = buttons;
+		move.ulAngle = loadgen_DegreesToAngle( angle );
+		script.push_back( move );
+	}
+
+	fclose( pFile );
+
+	if ( script.size( ) == 0 )
+	{
+		printf( "Script %s doesn't contain any moves.\n", pszFileName );
+		return ( false );
+	}
+
+	return ( true );
+}
+
+//*****************************************************************************
+//
+// The default script: Run forward, turn around while running, strafe and back
+// up, two seconds each. The values match what the game puts into a ticcmd.
+//
+static void loadgen_BuildDefaultScript( std::vector<LOADMOVE_s> &script )
+{
+	double angle = 0;
+
+	for ( ULONG ulTic = 0; ulTic < 8 * TICRATE; ++ulTic )
+	{
+		LOADMOVE_s move;
+		memset( &move, 0, sizeof( move ));
+
+		switch ( ulTic / ( 2 * TICRATE ))
+		{
+		case 0:
+
+			move.sForwardMove = 0x32 << 8;
+			break;
+		case 1:
+
+			move.sForwardMove = 0x32 << 8;
+			angle += 180.0 / ( 2 * TICRATE );
+			break;
+		case 2:
+
+			move.sSideMove = 0x28 << 8;
+			break;
+		default:
+
+			move.sForwardMove = -( 0x32 << 8 );
+			break;
+		}
+
+		move.ulAngle = loadgen_DegreesToAngle( angle );
+		script.push_back( move );
+	}
+}
+
+//*****************************************************************************
+//
+static void loadgen_PrintStatistics( const char *pszLabel, const LOADSTATS_s &Stats, double seconds, ULONG ulNumInGame, ULONG ulNumClients )
+{
+	const double kBytesOut = Stats.ulBytesSent / 1024.0 / seconds;
+	const double kBytesIn = Stats.ulBytesReceived / 1024.0 / seconds;
+
+	printf( "%s %lu/%lu in game | out %.1f kB/s, in %.1f kB/s (%.1f kB/s per client), %.0f packets/s | "
+		"packet interval %.1f ms avg, %.1f ms max | requested %lu, recovered %lu, lost %lu, duplicates %lu\n",
+		pszLabel, ulNumInGame, ulNumClients,
+		kBytesOut, kBytesIn, ulNumInGame ? kBytesIn / ulNumInGame : 0.0, Stats.ulPacketsReceived / seconds,
+		Stats.ulNumIntervals ? Stats.dIntervalSum / Stats.ulNumIntervals : 0.0, Stats.dIntervalMax,
+		Stats.ulMissingPacketsRequested, Stats.ulPacketsRecovered, Stats.ulPacketsLost, Stats.ulDuplicatePackets );
+}
+
+//*****************************************************************************
+//
+static ULONG loadgen_CountInGame( const std::vector<std::unique_ptr<LoadClient> > &clients )
+{
+	ULONG ulNumInGame = 0;
+	for ( unsigned int i = 0; i < clients.size( ); ++i )
+	{
+		if ( clients[i]->GetState( ) == LCS_INGAME )
+			ulNumInGame++;
+	}
+	return ( ulNumInGame );
+}
+
+//*****************************************************************************
+//
+// Returns true if most of the clients were refused by the server, after
+// telling why.
+//
+static bool loadgen_CheckRefusals( const std::vector<std::unique_ptr<LoadClient> > &clients, ULONG ulNumClients )
+{
+	ULONG ulNumRefused = 0;
+	int counts[256] = { 0 };
+
+	for ( unsigned int i = 0; i < clients.size( ); ++i )
+	{
+		const int errorCode = clients[i]->GetErrorCode( );
+		if ( errorCode >= 0 )
+		{
+			counts[errorCode & 0xFF]++;
+			ulNumRefused++;
+		}
+	}
+
+	if ( ulNumRefused <= ulNumClients / 2 )
+		return ( false );
+
+	printf( "\nError: The server refused %lu of %lu clients:\n", ulNumRefused, ulNumClients );
+	for ( int code = 0; code < 256; ++code )
+	{
+		if ( counts[code] > 0 )
+			printf( "  %d x %s\n", counts[code], LoadClient::GetErrorDescription( code ));
+	}
+	if ( counts[NETWORK_ERRORCODE_TOOMANYCONNECTIONSFROMIP] > 0 )
+		printf( "Start the server with \"+sv_maxclientsperip 0\", all clients connect from the same address.\n" );
+	return ( true );
+}
+
+//*****************************************************************************
+//
+int main( int argc, char **argv )
+{
+	LOADSETTINGS_s	Settings;
+	const char		*pszHost = "127.0.0.1:10666";
+	const char		*pszScript = NULL;
+	ULONG			ulNumClients = 8;
+	double			duration = 60;
+	double			rampUp = 250;
+	double			reportInterval = 5;
+
+	Settings.connectFlags = 0;
+
+	printf( "=== Zandronum load generator | %s ===\n\n", GetVersionStringRev( ));
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		const bool bHasValue = ( i + 1 < argc );
+
+		if (( stricmp( argv[i], "-host" ) == 0 ) && bHasValue )
+			pszHost = argv[++i];
+		else if (( stricmp( argv[i], "-clients" ) == 0 ) && bHasValue )
+			ulNumClients = std::max( 1L, atol( argv[++i] ));
+		else if (( stricmp( argv[i], "-duration" ) == 0 ) && bHasValue )
+			duration = atof( argv[++i] );
+		else if (( stricmp( argv[i], "-rampup" ) == 0 ) && bHasValue )
+			rampUp = std::max( 0.0, atof( argv[++i] ));
+		else if (( stricmp( argv[i], "-report" ) == 0 ) && bHasValue )
+			reportInterval = std::max( 1.0, atof( argv[++i] ));
+		else if (( stricmp( argv[i], "-password" ) == 0 ) && bHasValue )
+			Settings.password = argv[++i];
+		else if (( stricmp( argv[i], "-lumpchecksum" ) == 0 ) && bHasValue )
+			Settings.lumpChecksum = argv[++i];
+		else if (( stricmp( argv[i], "-script" ) == 0 ) && bHasValue )
+			pszScript = argv[++i];
+		else if ( stricmp( argv[i], "-spectate" ) == 0 )
+			Settings.connectFlags |= 1; // CCF_STARTASSPECTATOR
+		else if (( stricmp( argv[i], "-checksum" ) == 0 ) && bHasValue )
+		{
+			if ( loadgen_ParseChecksum( argv[++i], Settings ) == false )
+			{
+				printf( "Invalid checksum \"%s\", expected <map>=<32 hex digits>.\n", argv[i] );
+				return ( 1 );
+			}
+		}
+		else
+		{
+			loadgen_PrintUsage( );
+			return ( stricmp( argv[i], "-help" ) == 0 ) ? 0 : 1;
+		}
+	}
+
+#ifdef __WIN32__
+	WSADATA WSAData;
+	if ( WSAStartup( 0x0101, &WSAData ))
+	{
+		printf( "Winsock initialization failed!\n" );
+		return ( 1 );
+	}
+#endif
+
+	bool bOk;
+	Settings.ServerAddress = NETADDRESS_s( pszHost, &bOk );
+	if ( bOk == false )
+	{
+		printf( "Couldn't resolve %s.\n", pszHost );
+		return ( 1 );
+	}
+
+	if ( pszScript )
+	{
+		if ( loadgen_LoadScript( pszScript, Settings.script ) == false )
+			return ( 1 );
+	}
+	else
+		loadgen_BuildDefaultScript( Settings.script );
+
+	if ( ulNumClients > MAX_SERVER_CLIENTS )
+		printf( "Warning: The server only has %d player slots, the remaining clients will be refused.\n", MAX_SERVER_CLIENTS );
+	if ( Settings.mapChecksums.empty( ))
+		printf( "Warning: No map checksums given, level authentication is going to fail.\n" );
+
+	printf( "Connecting %lu clients to %s...\n", ulNumClients, Settings.ServerAddress.ToString( ));
+
+	signal( SIGINT, loadgen_SignalHandler );
+	signal( SIGTERM, loadgen_SignalHandler );
+
+	std::vector<std::unique_ptr<LoadClient> > clients;
+	LOADSTATS_s intervalStats, totalStats;
+	intervalStats.Clear( );
+	totalStats.Clear( );
+
+	const double startTime = loadgen_Now( );
+	const double endTime = ( duration > 0 ) ? startTime + duration * 1000 : 0;
+	double nextTic = startTime;
+	double nextConnect = startTime;
+	double intervalStart = startTime;
+	ULONG ulMaxInGame = 0;
+	bool bRefused = false;
+
+	while ( g_bStop == false )
+	{
+		const double now = loadgen_Now( );
+		if (( endTime > 0 ) && ( now >= endTime ))
+			break;
+
+		for ( unsigned int i = 0; i < clients.size( ); ++i )
+			clients[i]->ReceivePackets( now );
+
+		if ( now >= nextTic )
+		{
+			// Bring in the clients one by one, so that the server isn't flooded with
+			// connection attempts.
+			while (( clients.size( ) < ulNumClients ) && ( now >= nextConnect ))
+			{
+				clients.push_back( std::unique_ptr<LoadClient>( new LoadClient( static_cast<unsigned int>( clients.size( )), Settings )));
+				if ( clients.back( )->Open( ) == false )
+					return ( 1 );
+				nextConnect += rampUp;
+			}
+
+			for ( unsigned int i = 0; i < clients.size( ); ++i )
+				clients[i]->Tick( );
+
+			nextTic += 1000.0 / TICRATE;
+
+			// We fell behind, don't try to catch up.
+			if ( nextTic < now )
+				nextTic = now + 1000.0 / TICRATE;
+		}
+
+		if ( now - intervalStart >= reportInterval * 1000 )
+		{
+			char szLabel[32];
+			for ( unsigned int i = 0; i < clients.size( ); ++i )
+				clients[i]->CollectStatistics( intervalStats );
+
+			const ULONG ulNumInGame = loadgen_CountInGame( clients );
+			ulMaxInGame = std::max( ulMaxInGame, ulNumInGame );
+
+			snprintf( szLabel, sizeof( szLabel ), "[%5.0fs]", ( now - startTime ) / 1000 );
+			loadgen_PrintStatistics( szLabel, intervalStats, ( now - intervalStart ) / 1000, ulNumInGame, static_cast<ULONG>( clients.size( )));
+
+			totalStats.Add( intervalStats );
+			intervalStats.Clear( );
+			intervalStart = now;
+
+			// There is no point in measuring anything if most of the swarm
+			// didn't get in.
+			if ( loadgen_CheckRefusals( clients, ulNumClients ))
+			{
+				bRefused = true;
+				break;
+			}
+		}
+
+		// Wait for the next packet or the next tic, whatever comes first.
+		struct timeval timeout;
+		fd_set fdset;
+		SOCKET maxSocket = 0;
+		FD_ZERO( &fdset );
+		for ( unsigned int i = 0; i < clients.size( ); ++i )
+		{
+			const SOCKET socket = clients[i]->GetSocket( );
+			if ( socket != INVALID_SOCKET )
+			{
+				FD_SET( socket, &fdset );
+				maxSocket = std::max( maxSocket, socket );
+			}
+		}
+
+		const double wait = std::max( 0.0, nextTic - loadgen_Now( ));
+		timeout.tv_sec = 0;
+		timeout.tv_usec = static_cast<long>( wait * 1000 );
+		select( static_cast<int>( maxSocket ) + 1, &fdset, NULL, NULL, &timeout );
+	}
+
+	const double now = loadgen_Now( );
+	const ULONG ulNumInGame = loadgen_CountInGame( clients );
+	ulMaxInGame = std::max( ulMaxInGame, ulNumInGame );
+
+	for ( unsigned int i = 0; i < clients.size( ); ++i )
+	{
+		clients[i]->FinishStatistics( );
+		clients[i]->CollectStatistics( intervalStats );
+		clients[i]->Close( );
+	}
+	totalStats.Add( intervalStats );
+
+	printf( "\n" );
+	loadgen_PrintStatistics( "Total:", totalStats, std::max( 0.001, ( now - startTime ) / 1000 ), ulMaxInGame, static_cast<ULONG>( clients.size( )));
+	printf( "%lu move commands sent, %lu packets sent, %lu packets received.\n",
+		totalStats.ulMoveCommandsSent, totalStats.ulPacketsSent, totalStats.ulPacketsReceived );
+
+	if ( bRefused == false )
+		bRefused = loadgen_CheckRefusals( clients, ulNumClients );
+
+#ifdef __WIN32__
+	WSACleanup( );
+#endif
+
+	return ( bRefused ? 1 : 0 );
+}
@@ -601,20 +601,12 @@ enum EThingSpecialActivationType
 	THINGSPEC_Switch			= 1<<10,	// The thing is alternatively activated and deactivated when triggered
 };
 
-// [RH] Like msecnode_t, but for the blockmap
-struct FBlockNode
+// The thing blocks an actor is linked into. Width and Height are 0 if the
+// actor is not in the thing grid.
+struct FThingBlockLinks
 {
-	AActor *Me;						// actor this node references
-	int BlockIndex;					// index into blocklinks for the block this node is in
-	FBlockNode **PrevActor;			// previous actor in this block
-	FBlockNode *NextActor;			// next actor in this block
-	FBlockNode **PrevBlock;			// previous block this actor is in
-	FBlockNode *NextBlock;			// next block this actor is in
-
-	static FBlockNode *Create (AActor *who, int x, int y);
-	void Release ();
-
-	static FBlockNode *FreeBlocks;
+	WORD X, Y;
+	WORD Width, Height;
 };
 
 class FDecalBase;
@@ -944,25 +936,16 @@ public:
 	// Triggers SECSPAC_Exit/SECSPAC_Enter and related events if oldsec != current sector
 	void CheckSectorTransition(sector_t *oldsec);
 
-// info for drawing
 // NOTE: The first member variable *must* be x.
+// The members up to the drawing info are the ones the thinkers and the
+// movement code use every tic. They are kept together so that moving an
+// actor touches as few cache lines as possible.
 	fixed_t	 		x,y,z;
 	AActor			*snext, **sprev;	// links in sector (if needed)
 	angle_t			angle;
-	WORD			sprite;				// used to find patch_t and flip value
-	BYTE			frame;				// sprite frame to draw
-	fixed_t			scaleX, scaleY;		// Scaling values; FRACUNIT is normal size
-	FRenderStyle	RenderStyle;		// Style to draw this actor with
-	DWORD			renderflags;		// Different rendering flags
-	FTextureID		picnum;				// Draw this instead of sprite if valid
-	DWORD			effects;			// [RH] see p_effect.h
-	fixed_t			alpha;
-	DWORD			fillcolor;			// Color to draw when STYLE_Shaded
 
 // interaction info
-	fixed_t			pitch;
-	angle_t			roll;	// This was fixed_t before, which is probably wrong
-	FBlockNode		*BlockNode;			// links in blocks (if needed)
+	FThingBlockLinks	BlockLinks;			// links in thing blocks (if needed)
 	struct sector_t	*Sector;
 	subsector_t *		subsector;
 	fixed_t			floorz, ceilingz;	// closest together of contacted secs
@@ -986,6 +969,26 @@ public:
 	DWORD			flags5;			// OMG! We need another one.
 	DWORD			flags6;			// Shit! Where did all the flags go?
 	DWORD			flags7;			// 
+	int 			health;
+	player_t		*player;		// only valid if type of APlayerPawn
+	fixed_t			floorclip;		// value to use for floor clipping
+	int				waterlevel;		// 0=none, 1=feet, 2=waist, 3=eyes
+	fixed_t			gravity;		// [GRB] Gravity factor
+	AActor			*BlockingMobj;	// Actor that blocked the last move
+	line_t			*BlockingLine;	// Line that blocked the last move
+
+// info for drawing
+	WORD			sprite;				// used to find patch_t and flip value
+	BYTE			frame;				// sprite frame to draw
+	fixed_t			scaleX, scaleY;		// Scaling values; FRACUNIT is normal size
+	FRenderStyle	RenderStyle;		// Style to draw this actor with
+	DWORD			renderflags;		// Different rendering flags
+	FTextureID		picnum;				// Draw this instead of sprite if valid
+	DWORD			effects;			// [RH] see p_effect.h
+	fixed_t			alpha;
+	DWORD			fillcolor;			// Color to draw when STYLE_Shaded
+	fixed_t			pitch;
+	angle_t			roll;	// This was fixed_t before, which is probably wrong
 
 	// [BB] If 0, everybody can see the actor, if > 0, only members of team (VisibleToTeam-1) can see it.
 	DWORD			VisibleToTeam;
@@ -1004,7 +1007,6 @@ public:
 
 	int				special1;		// Special info
 	int				special2;		// Special info
-	int 			health;
 	BYTE			movedir;		// 0-7
 	SBYTE			visdir;
 	SWORD			movecount;		// when 0, select a new dir
@@ -1017,7 +1019,6 @@ public:
 									// player to freeze a bit after teleporting
 	SDWORD			threshold;		// if > 0, the target will be chased
 									// no matter what (even if shot)
-	player_t		*player;		// only valid if type of APlayerPawn
 	TObjPtr<AActor>	LastLookActor;	// Actor last looked for (if TIDtoHate != 0)
 	fixed_t			SpawnPoint[3]; 	// For nightmare respawn
 	WORD			SpawnAngle;
@@ -1029,7 +1030,6 @@ public:
 	FNameNoInit		Species;		// For monster families
 	TObjPtr<AActor>	tracer;			// Thing being chased/attacked for tracers
 	TObjPtr<AActor>	master;			// Thing which spawned this one (prevents mutual attacks)
-	fixed_t			floorclip;		// value to use for floor clipping
 	int				tid;			// thing identifier
 	int				special;		// special
 	BYTE			SavedSpecial;	// [BC] Saved actor special for when a map gets reset.
@@ -1039,9 +1039,8 @@ public:
 
 	int		accuracy, stamina;		// [RH] Strife stats -- [XA] moved here for DECORATE/ACS access.
 
-	AActor			*inext, **iprev;// Links to other mobjs in same bucket
+	AActor			*inext, *iprev;// Links to other mobjs with the same TID
 	TObjPtr<AActor> goal;			// Monster's goal if not chasing anything
-	int				waterlevel;		// 0=none, 1=feet, 2=waist, 3=eyes
 	BYTE			boomwaterlevel;	// splash information for non-swimmable water sectors
 	BYTE			MinMissileChance;// [RH] If a random # is > than this, then missile attack.
 	SBYTE			LastLookPlayerNumber;// Player number last looked for (if TIDtoHate == 0)
@@ -1055,7 +1054,6 @@ public:
 	fixed_t			bouncefactor;	// Strife's grenades use 50%, Hexen's Flechettes 70.
 	fixed_t			wallbouncefactor;	// The bounce factor for walls can be different.
 	int				bouncecount;	// Strife's grenades only bounce twice before exploding
-	fixed_t			gravity;		// [GRB] Gravity factor
 	int 			FastChaseStrafeCount;
 	fixed_t			pushfactor;
 	int				lastpush;
@@ -1065,8 +1063,6 @@ public:
 	FString *		Tag;			// Strife's tag name.
 	int				DesignatedTeam;	// Allow for friendly fire cacluations to be done on non-players.
 
-	AActor			*BlockingMobj;	// Actor that blocked the last move
-	line_t			*BlockingLine;	// Line that blocked the last move
 
 	int PoisonDamage; // Damage received per tic from poison.
 	FNameNoInit PoisonDamageType; // Damage type dealt by poison.
@@ -1178,8 +1174,9 @@ public:
 	void RemoveFromHash ();
 
 private:
-	static AActor *TIDHash[128];
-	static inline int TIDHASH (int key) { return key & 127; }
+	// Maps each TID in use to the most recently added actor with it.
+	// The actors sharing a TID are linked through inext/iprev.
+	static TMap<int, AActor *> TIDHash;
 	static FSharedStringArena mStringPropertyData;
 
 	friend class FActorIterator;
@@ -1258,7 +1255,10 @@ public:
 		if (id == 0)
 			return NULL;
 		if (!base)
-			base = AActor::TIDHash[id & 127];
+		{
+			AActor **head = AActor::TIDHash.CheckKey(id);
+			base = head != NULL ? *head : NULL;
+		}
 		else
 			base = base->inext;
 
@@ -230,47 +230,36 @@ bool P_BlockThingsIterator (int x, int y, bool(*func)(AActor*), TArray<AActor *>
 	}
 	else
 	{
-		FBlockNode *block;
-		int index = y*bmapwidth + x;
+		FBlockThingsIterator it(x, y, x, y);
+		AActor *mo;
 
-		if (actor == NULL)
+		if (actor != NULL)
 		{
-			block = blocklinks[index];
-		}
-		else
-		{
-			block = actor->BlockNode;
-			while (block != NULL && block->BlockIndex != index)
-			{
-				block = block->NextBlock;
-			}
-			if (block != NULL)
+			// Only look at the things linked into this block before the actor.
+			while ((mo = it.Next()) != NULL && mo != actor)
 			{
-				block = block->NextActor;
 			}
 		}
-		while (block != NULL)
+		while ((mo = it.Next()) != NULL)
 		{
-			FBlockNode *next = block->NextActor;
 			int i;
 
 			// Don't recheck things that were already checked
 			for (i = (int)checkarray.Size() - 1; i >= 0; --i)
 			{
-				if (checkarray[i] == block->Me)
+				if (checkarray[i] == mo)
 				{
 					break;
 				}
 			}
 			if (i < 0)
 			{
-				checkarray.Push (block->Me);
-				if (!func (block->Me))
+				checkarray.Push (mo);
+				if (!func (mo))
 				{
 					return false;
 				}
 			}
-			block = next;
 		}
 	}
 	return true;
@@ -463,6 +463,7 @@ void BOTS_Destruct( void )
 			players[ulIdx].bIsBot = false;
 		}
 	}
+	SERVER_UpdatePlayerLists( );
 }
 
 //*****************************************************************************
@@ -613,6 +614,7 @@ void BOTS_RemoveBot( ULONG ulPlayerIdx, bool bExitMsg )
 	TEAM_CancelAssistsOfPlayer ( ulPlayerIdx );
 
 	playeringame[ulPlayerIdx] = false;
+	SERVER_UpdatePlayerLists( );
 	
 	// [BB] Run the disconnect scripts now that the bot is leaving the game.
 	if (( players[ulPlayerIdx].bSpectating == false ) ||
@@ -1699,6 +1701,7 @@ CSkullBot::CSkullBot( char *pszName, char *pszTeamName, ULONG ulPlayerNum )
 
 	// Update the playeringame slot.
 	playeringame[ulPlayerNum] = true;
+	SERVER_UpdatePlayerLists( );
 
 	// Setup the player's userinfo based on the bot's botinfo.
 	// [BB] First clear the userinfo.
@@ -1903,6 +1906,7 @@ CSkullBot::CSkullBot( char *pszName, char *pszTeamName, ULONG ulPlayerNum )
 
 	// Check and see if this bot should spawn as a spectator.
 	m_pPlayer->bSpectating = PLAYER_ShouldSpawnAsSpectator( m_pPlayer );
+	SERVER_UpdatePlayerLists( );
 
 	// [BB] If the bot is forced to spectate, make sure he is not on a team.
 	if ( m_pPlayer->bSpectating )
@@ -1922,6 +1926,7 @@ CSkullBot::CSkullBot( char *pszName, char *pszTeamName, ULONG ulPlayerNum )
 		Printf("Unable to spawn bot %s.\n", players[ulPlayerNum].userinfo.GetName());
 		g_bBotIsInitialized[ulPlayerNum] = true;
 		m_pPlayer->bSpectating = true;
+		SERVER_UpdatePlayerLists( );
 		return;
 	}
 
@@ -3339,6 +3344,7 @@ void CSkullBot::PreDelete( void )
 
 	// Remove the bot from the game.
 	playeringame[( m_pPlayer - players )] = false;
+	SERVER_UpdatePlayerLists( );
 
 	// Delete the actor attached to the player.
 	if ( m_pPlayer->mo )
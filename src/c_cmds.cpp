@@ -84,6 +84,7 @@
 #include "cooperative.h"
 #include "survival.h"
 #include "m_cheat.h"
+#include "sv_logthread.h"
 
 extern FILE *Logfile;
 extern bool insave;
@@ -157,6 +158,8 @@ void StopLogging( void )
 	if ( Logfile )
 	{
 		Printf( "Log stopped: %s, %s", g_szActualLogFilename, myasctime() );
+		// [Zandronum] Make sure the log thread is done with the file.
+		SERVER_LOGTHREAD_Flush( );
 		fclose( Logfile );
 		Logfile = NULL;
 		g_szActualLogFilename[0] = 0;
@@ -76,6 +76,7 @@
 #include "win32/g15/g15.h"
 #include "gi.h"
 #include "sv_rcon.h"
+#include "sv_logthread.h"
 
 #define CONSOLESIZE	16384	// Number of characters to store in console
 #define CONSOLELINES 256	// Max number of lines of console text
@@ -1062,12 +1063,16 @@ int PrintString (int printlevel, const char *outline)
 
 		needPrependedTimestamp = (copy[copy.Len() - 1] == '\n');
 
-		fputs (copy, Logfile);
-		// [TP] copy is now an FString.
-//		delete [] copy;
+		// [Zandronum] With -logthread, the log thread writes the line.
+		if ( SERVER_LOGTHREAD_Write( Logfile, copy ) == false )
+		{
+			fputs (copy, Logfile);
+			// [TP] copy is now an FString.
+//			delete [] copy;
 //#ifdef _DEBUG
-		fflush (Logfile);
+			fflush (Logfile);
 //#endif
+		}
 	}
 
 	// For servers, dump message to console window.
@@ -795,3 +795,12 @@ void CLIENTCOMMANDS_RCONSetCVar( const char *cvarName, const char *cvarValue )
 	CLIENT_GetLocalBuffer( )->ByteStream.WriteString( cvarName );
 	CLIENT_GetLocalBuffer( )->ByteStream.WriteString( cvarValue );
 }
+
+//*****************************************************************************
+//
+void CLIENTCOMMANDS_AckActorSnapshot( LONG lSnapshotTic, ULONG ulPieceMask )
+{
+	CLIENT_GetLocalBuffer( )->ByteStream.WriteByte( CLC_ACKACTORSNAPSHOT );
+	CLIENT_GetLocalBuffer( )->ByteStream.WriteLong( lSnapshotTic );
+	CLIENT_GetLocalBuffer( )->ByteStream.WriteByte( ulPieceMask );
+}
@@ -119,5 +119,6 @@ void	CLIENTCOMMANDS_SpecialCheat( int special, const TArray<int>& args );
 void	CLIENTCOMMANDS_SetWantHideAccount( bool wantHideCountry );
 void	CLIENTCOMMANDS_SetVideoResolution();
 void	CLIENTCOMMANDS_RCONSetCVar( const char *cvarName, const char *cvarValue );
+void	CLIENTCOMMANDS_AckActorSnapshot( LONG lSnapshotTic, ULONG ulPieceMask );
 
 #endif	// __CL_COMMANDS_H__
@@ -94,6 +94,7 @@
 #include "announcer.h"
 #include "network.h"
 #include "sv_main.h"
+#include "sv_actorsnapshot.h"
 #include "sbar.h"
 #include "m_random.h"
 #include "templates.h"
@@ -112,6 +113,7 @@
 #include "d_netinf.h"
 #include "po_man.h"
 #include "network/cl_auth.h"
+#include "network/netcompression.h"
 #include "r_data/colormaps.h"
 #include "r_main.h"
 #include "network_enums.h"
@@ -139,6 +141,7 @@ DECLARE_ACTION(A_RestoreSpecialPosition)
 EXTERN_CVAR( Bool, telezoom )
 EXTERN_CVAR( Bool, sv_cheats )
 EXTERN_CVAR( Int, cl_bloodtype )
+EXTERN_CVAR( Bool, cl_netcompression )
 EXTERN_CVAR( Int, cl_pufftype )
 EXTERN_CVAR( String, playerclass )
 EXTERN_CVAR( Int, am_cheat )
@@ -374,6 +377,17 @@ static	int					g_lLatestServerGametic = 0;
 // Offset from the server gametic caused by cl_ticsperupdate.
 static	int					g_ServerGameticOffset;
 
+// The latest actor snapshot we got, and which of its pieces we applied completely.
+static	LONG				g_lActorSnapshotTic;
+static	ULONG				g_ulActorSnapshotPieces;
+static	ULONG				g_ulActorSnapshotPiece;
+
+// Do the deltas that follow belong to the latest actor snapshot?
+static	bool				g_bApplyActorDeltas;
+
+// Does the server need to hear about the actor snapshot pieces we got?
+static	bool				g_bAckActorSnapshot;
+
 // [TP] Client's understanding of the account names of players.
 static FString				g_PlayerAccountNames[MAXPLAYERS];
 
@@ -852,13 +866,24 @@ void CLIENT_AttemptConnection( void )
 	// [CK] Reset this here since we plan on connecting to a new server
 	CLIENT_SetLatestServerGametic( 0 );
 
+	g_lActorSnapshotTic = -1;
+	g_ulActorSnapshotPieces = 0;
+	g_bApplyActorDeltas = false;
+	g_bAckActorSnapshot = false;
+
+	// Packets are only compressed once the server accepted it.
+	NETWORK_COMPRESSION_ClearAddresses( );
+	const int connectFlags = cl_connect_flags | ( cl_netcompression ? CCF_NETCOMPRESSION : 0 );
+
 	 // Send connection signal to the server.
 	g_LocalBuffer.ByteStream.WriteByte( CLCC_ATTEMPTCONNECTION );
 	g_LocalBuffer.ByteStream.WriteString( DOTVERSIONSTR );
 	g_LocalBuffer.ByteStream.WriteString( cl_password );
-	g_LocalBuffer.ByteStream.WriteByte( cl_connect_flags );
+	g_LocalBuffer.ByteStream.WriteByte( connectFlags );
 	g_LocalBuffer.ByteStream.WriteByte( cl_hideaccount );
 	g_LocalBuffer.ByteStream.WriteByte( NETGAMEVERSION );
+	if ( connectFlags & CCF_NETCOMPRESSION )
+		g_LocalBuffer.ByteStream.WriteLong( NETWORK_COMPRESSION_GetDictionaryID( ));
 	g_LocalBuffer.ByteStream.WriteString( g_lumpsAuthenticationChecksum.GetChars() );
 }
 
@@ -2444,6 +2469,13 @@ void CLIENT_SendCmd( void )
 		return;
 	}
 
+	// Let the server know which actor snapshot we have, the next one is based on it.
+	if ( g_bAckActorSnapshot )
+	{
+		CLIENTCOMMANDS_AckActorSnapshot( g_lActorSnapshotTic, g_ulActorSnapshotPieces );
+		g_bAckActorSnapshot = false;
+	}
+
 	// Don't send movement information if we're spectating!
 	if ( players[consoleplayer].bSpectating )
 	{
@@ -3319,6 +3351,16 @@ void ServerCommands::EndSnapshot::Execute()
 	CLIENT_DisplayMOTD( );
 }
 
+//*****************************************************************************
+//
+void ServerCommands::SetNetCompression::Execute()
+{
+	// The server only accepts if it uses the same dictionary, a demo is not
+	// connected to anything.
+	if (( CLIENTDEMO_IsPlaying( ) == false ) && ( dictionaryID == NETWORK_COMPRESSION_GetDictionaryID( )))
+		NETWORK_COMPRESSION_EnableForAddress( g_AddressServer, true );
+}
+
 //*****************************************************************************
 //
 void ServerCommands::FullUpdateCompleted::Execute()
@@ -4938,6 +4980,78 @@ void ServerCommands::MoveThingExact::Execute()
 		actor->movedir = movedir;
 }
 
+//*****************************************************************************
+//
+void ServerCommands::ActorSnapshot::Execute()
+{
+	// This piece belongs to an older snapshot than one we already have, so
+	// its deltas are outdated.
+	if ( snapshotTic < g_lActorSnapshotTic )
+	{
+		g_bApplyActorDeltas = false;
+		return;
+	}
+
+	if ( snapshotTic > g_lActorSnapshotTic )
+	{
+		g_lActorSnapshotTic = snapshotTic;
+		g_ulActorSnapshotPieces = 0;
+	}
+
+	g_ulActorSnapshotPiece = piece;
+	if ( piece < MAX_ACKNOWLEDGED_PIECES )
+		g_ulActorSnapshotPieces |= ( 1 << piece );
+
+	g_bApplyActorDeltas = true;
+	g_bAckActorSnapshot = true;
+}
+
+//*****************************************************************************
+//
+void ServerCommands::ActorDelta::Execute()
+{
+	if ( g_bApplyActorDeltas == false )
+		return;
+
+	// We don't know this actor (yet), so we can't claim that we have this piece.
+	if (( actor == NULL ) || ( gamestate != GS_LEVEL ))
+	{
+		if ( g_ulActorSnapshotPiece < MAX_ACKNOWLEDGED_PIECES )
+			g_ulActorSnapshotPieces &= ~( 1 << g_ulActorSnapshotPiece );
+		return;
+	}
+
+	if ( bits & ( CM_X|CM_Y|CM_Z ))
+	{
+		const fixed_t newX = ContainsX() ? x : actor->x;
+		const fixed_t newY = ContainsY() ? y : actor->y;
+		const fixed_t newZ = ContainsZ() ? z : actor->z;
+
+		// Keep these in line with what MoveThing would have done.
+		if ( ContainsX() )
+			actor->lastX = newX;
+		if ( ContainsY() )
+			actor->lastY = newY;
+		if ( ContainsZ() )
+			actor->lastZ = newZ;
+
+		CLIENT_MoveThing( actor, newX, newY, newZ );
+	}
+
+	if ( ContainsAngle() )
+		actor->angle = angle;
+
+	if ( ContainsVelX() )
+		actor->velx = velX;
+	if ( ContainsVelY() )
+		actor->vely = velY;
+	if ( ContainsVelZ() )
+		actor->velz = velZ;
+
+	if ( ContainsMovedir() )
+		actor->movedir = movedir;
+}
+
 //*****************************************************************************
 //
 void ServerCommands::KillThing::Execute()
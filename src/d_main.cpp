@@ -114,6 +114,7 @@
 #include "lastmanstanding.h"
 #include "campaign.h"
 #include "sv_save.h"
+#include "sv_capture.h"
 #include "callvote.h"
 #include "invasion.h"
 #include "survival.h"
@@ -245,6 +246,7 @@ TArray<FString> allwads;
 TArray<FString> autoloadedwads;
 TArray<FString> optionalwads; // [TP] Files loaded with -optfile
 bool devparm;				// started game with -devparm
+bool leanstartup;			// [Zandronum] server started with -lean
 const char *D_DrawIcon;	// [RH] Patch name of icon to draw on next refresh
 int NoWipe;				// [RH] Allow wipe? (Needs to be set each time)
 bool singletics = false;	// debug flag to cancel adaptiveness
@@ -1335,6 +1337,10 @@ void D_DoomLoop ()
 			case NETSTATE_SERVER:
 
 				SERVER_Tick( );
+
+				// [Zandronum] Leave through the regular quit path once a capture was replayed.
+				if ( SERVER_CAPTURE_IsReplayFinished( ))
+					ST_Endoom( );
 				break;
 			default:
 
@@ -2432,6 +2438,11 @@ static void D_DoomInit()
 	if ( Args->CheckParm( "-host" ))
 		NETWORK_SetState( NETSTATE_SERVER );
 
+	// [Zandronum] A lean server doesn't load the data that is only needed to draw the game.
+	// So far that is hires textures, PALVERS, voxels and models. Textures, fonts, decals
+	// and sounds are still set up in full.
+	leanstartup = ( NETWORK_GetState( ) == NETSTATE_SERVER ) && Args->CheckParm( "-lean" );
+
 #ifndef	WIN32
 	// Check if we should read standard input.
 	if (Args->CheckParm("-noinput"))
@@ -2717,6 +2728,34 @@ static void CheckCmdLine()
 	}
 }
 
+//==========================================================================
+//
+// D_PrefetchDefinitionLumps
+//
+// [Zandronum] Decompresses the lumps that are parsed during startup on
+// worker threads before the parsers get to them.
+//
+//==========================================================================
+
+static void D_PrefetchDefinitionLumps ()
+{
+	static const char *names[] =
+	{
+		"CVARINFO", "MAPINFO", "ZMAPINFO", "EMAPINFO", "DECORATE", "DEHACKED", "LANGUAGE",
+		"SNDINFO", "SNDSEQ", "TEXTURES", "ANIMDEFS", "LOCKDEFS", "TERRAIN", "DECALDEF",
+		"KEYCONF", "SBARINFO", "GLDEFS", "LOADACS", "TEAMINFO", "SKININFO", "MENUDEF",
+		"FONTDEFS", "VOXELDEF", "MODELDEF", NULL
+	};
+	TArray<int> lumps;
+	int lump, lastlump = 0;
+
+	while ((lump = Wads.FindLumpMulti (names, &lastlump)) != -1)
+	{
+		lumps.Push (lump);
+	}
+	Wads.PrefetchLumps (lumps);
+}
+
 //==========================================================================
 //
 // FinalGC
@@ -2745,6 +2784,9 @@ void D_DoomMain (void)
 	const char *wad;
 	DArgs *execFiles;
 	TArray<FString> pwads;
+	// [Zandronum] Servers report how long the startup took and how much memory it used.
+	const unsigned int startuptime = I_FPSTime( );
+	const unsigned int startupmemory = I_GetResidentMemoryKB( );
 	/* [BB] Zandronum uses different bot code and thus doesn't need these.
 	FString *args;
 	int argcount;
@@ -2841,6 +2883,7 @@ void D_DoomMain (void)
 		allwads.Clear();
 		allwads.ShrinkToFit();
 		SetMapxxFlag();
+		D_PrefetchDefinitionLumps ();
 
 		// Now that wads are loaded, define mod-specific cvars.
 		ParseCVarInfo();
@@ -3271,6 +3314,15 @@ void D_DoomMain (void)
 			}
 		}
 
+		// [Zandronum] Everything that was prefetched has been parsed by now.
+		Wads.ReleasePrefetchedLumps ();
+
+		if ( NETWORK_GetState( ) == NETSTATE_SERVER )
+		{
+			Printf( "Startup took %u ms%s, resident memory went from %u KB to %u KB.\n",
+				I_FPSTime( ) - startuptime, leanstartup ? " (lean)" : "", startupmemory, I_GetResidentMemoryKB( ));
+		}
+
 		try
 		{
 			D_DoomLoop ();		// never returns
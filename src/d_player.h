@@ -737,6 +737,10 @@ public:
 	fixed_t		restoreFloorZ;
 	fixed_t		restoreCeilingZ;
 
+	// Set while the player is reconciled without being relinked, so that
+	// traces use the unlagged hitbox instead of the blockmap.
+	bool		bUnlaggedHitbox;
+
 	// [BC] End of ST additions.
 
 	fixed_t GetDeltaViewHeight() const
@@ -278,6 +278,12 @@ namespace GC
 	// Does a complete collection.
 	void FullGC();
 
+	// [Zandronum] Sets StepMul and the floor used by gc_adaptivestepmul.
+	void SetStepMul(int stepmul);
+
+	// [Zandronum] Clears the pause histogram.
+	void ResetPauseStats();
+
 	// Handles the grunt work for a write barrier.
 	void Barrier(DObject *pointing, DObject *pointed);
 
@@ -56,6 +56,8 @@
 
 // HEADER FILES ------------------------------------------------------------
 
+#include <chrono>
+
 #include "dobject.h"
 #include "templates.h"
 //#include "b_bot.h"
@@ -65,6 +67,7 @@
 #include "sbar.h"
 #include "stats.h"
 #include "c_dispatch.h"
+#include "c_cvars.h"
 #include "p_acs.h"
 #include "s_sndseq.h"
 #include "r_data/r_interpolate.h"
@@ -96,6 +99,15 @@
 */
 #define DEFAULT_GCMUL		400 // GC runs 'quadruple the speed' of memory allocation
 
+// [Zandronum] Upper bound for the step multiplier when gc_adaptivestepmul
+// raises it to keep up with the allocation rate.
+#define MAX_GCMUL			2000
+
+// [Zandronum] gc_timebudget is ignored while the heap is more than this many
+// times its live size, so that a budget that is too tight for the allocation
+// rate can't let the heap grow without bound.
+#define GCBUDGETMAXGROWTH	3
+
 // Number of sectors to mark for each step.
 #define SECTORSTEPSIZE	32
 #define POLYSTEPSIZE 120
@@ -135,6 +147,14 @@ extern DThinker *NextToThink;
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
 
+// [Zandronum] Maximum number of microseconds the collector may spend per tic.
+// 0 lets every step run to its full StepMul-sized amount of work.
+CVAR(Int, gc_timebudget, 0, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+
+// [Zandronum] Scale StepMul with the amount of memory allocated during each
+// collection cycle.
+CVAR(Bool, gc_adaptivestepmul, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+
 namespace GC
 {
 size_t AllocBytes;
@@ -155,6 +175,28 @@ size_t Dept;
 
 static DSectorMarker *SectorMarker;
 
+// [Zandronum] gc_timebudget bookkeeping: the tic the budget applies to and
+// how much of it has been used (microseconds).
+static int BudgetTic = -1;
+static QWORD BudgetUsed;
+
+// [Zandronum] Net bytes allocated during the current cycle, for
+// gc_adaptivestepmul, and the StepMul it may not drop below.
+static size_t LastAllocBytes;
+static size_t CycleAlloc;
+static int BaseStepMul = DEFAULT_GCMUL;
+
+// [Zandronum] Histogram of the time the collector spent in each tic, summed
+// over all Step and FullGC calls made during that tic.
+static const unsigned int PauseBucketLimits[] = { 50, 100, 250, 500, 1000, 2500 };
+static const char *const PauseBucketNames[] = { "<50us", "<100us", "<250us", "<500us", "<1ms", "<2.5ms", ">=2.5ms" };
+static unsigned int PauseBuckets[countof(PauseBucketLimits) + 1];
+static unsigned int PauseCount;
+static QWORD PauseTotal;
+static QWORD PauseMax;
+static int PauseTic = -1;
+static QWORD PauseTicTime;
+
 // CODE --------------------------------------------------------------------
 
 //==========================================================================
@@ -431,12 +473,99 @@ static size_t SingleStep()
 	}
 }
 
+//==========================================================================
+//
+// GetMicroseconds
+//
+// [Zandronum] Monotonic clock used for the time budget and pause statistics.
+//
+//==========================================================================
+
+static QWORD GetMicroseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//==========================================================================
+//
+// RecordTic
+//
+// [Zandronum] Adds the total collector time of one tic to the histogram.
+//
+//==========================================================================
+
+static void RecordTic(QWORD us)
+{
+	unsigned int i;
+
+	for (i = 0; i < countof(PauseBucketLimits); ++i)
+	{
+		if (us < PauseBucketLimits[i])
+			break;
+	}
+	PauseBuckets[i]++;
+	PauseCount++;
+	PauseTotal += us;
+	if (us > PauseMax)
+	{
+		PauseMax = us;
+	}
+}
+
+//==========================================================================
+//
+// RecordPause
+//
+// [Zandronum] Accounts the duration of one Step or FullGC to the current
+// tic. The previous tic's total is recorded once gametic has moved on.
+//
+//==========================================================================
+
+static void RecordPause(QWORD us)
+{
+	if (PauseTic != gametic)
+	{
+		if (PauseTicTime > 0)
+		{
+			RecordTic(PauseTicTime);
+		}
+		PauseTic = gametic;
+		PauseTicTime = 0;
+	}
+	PauseTicTime += us;
+}
+
+//==========================================================================
+//
+// AdaptStepMul
+//
+// [Zandronum] Called at the end of each cycle. If the heap grew by more
+// than half its live size while the cycle was running, the collector is
+// falling behind the allocation rate and gets more work per step. If it
+// barely grew, steps are shortened again down to the configured StepMul.
+//
+//==========================================================================
+
+static void AdaptStepMul()
+{
+	if (CycleAlloc > Estimate / 2)
+	{
+		StepMul = MIN(StepMul * 3 / 2, MAX(MAX_GCMUL, BaseStepMul));
+	}
+	else if (CycleAlloc < Estimate / 8 && StepMul > BaseStepMul)
+	{
+		StepMul = MAX(StepMul * 9 / 10, BaseStepMul);
+	}
+}
+
 //==========================================================================
 //
 // Step
 //
 // Performs enough single steps to cover GCSTEPSIZE * StepMul% bytes of
-// memory.
+// memory. With gc_timebudget set, it also stops once this tic's share of
+// time is used up; the remaining work is picked up on the next tic.
 //
 //==========================================================================
 
@@ -444,19 +573,60 @@ void Step()
 {
 	size_t lim = (GCSTEPSIZE/100) * StepMul;
 	size_t olim;
+	QWORD start;
+	QWORD deadline = 0;
+	bool outoftime = false;
+	bool budgeted = gc_timebudget > 0 && AllocBytes <= Estimate * GCBUDGETMAXGROWTH;
+
+	if (budgeted)
+	{
+		if (BudgetTic != gametic)
+		{
+			BudgetTic = gametic;
+			BudgetUsed = 0;
+		}
+		else if (BudgetUsed >= (QWORD)gc_timebudget)
+		{
+			// This tic's budget is spent. Once that happens the threshold
+			// stays at AllocBytes, so CheckGC calls us after every thinker;
+			// bail out before reading the clock.
+			return;
+		}
+	}
+	start = GetMicroseconds();
+	if (budgeted)
+	{
+		deadline = start + gc_timebudget - BudgetUsed;
+	}
+
 	if (lim == 0)
 	{
 		lim = (~(size_t)0) / 2;		// no limit
 	}
+	if (AllocBytes > LastAllocBytes)
+	{
+		CycleAlloc += AllocBytes - LastAllocBytes;
+	}
 	Dept += AllocBytes - Threshold;
 	do
 	{
 		olim = lim;
 		lim -= SingleStep();
+		if (deadline != 0 && GetMicroseconds() >= deadline)
+		{
+			outoftime = true;
+			break;
+		}
 	} while (olim > lim && State != GCS_Pause);
 	if (State != GCS_Pause)
 	{
-		if (Dept < GCSTEPSIZE)
+		if (outoftime && olim > lim)
+		{
+			// The step wasn't finished, so nothing of the debt was paid off.
+			// Continue as soon as the next tic's budget allows.
+			Threshold = AllocBytes;
+		}
+		else if (Dept < GCSTEPSIZE)
 		{
 			Threshold = AllocBytes + GCSTEPSIZE;	// - lim/StepMul
 		}
@@ -470,8 +640,18 @@ void Step()
 	{
 		assert(AllocBytes >= Estimate);
 		SetThreshold();
+		if (gc_adaptivestepmul)
+		{
+			AdaptStepMul();
+		}
+		CycleAlloc = 0;
 	}
+	LastAllocBytes = AllocBytes;
 	StepCount++;
+
+	QWORD elapsed = GetMicroseconds() - start;
+	BudgetUsed += elapsed;
+	RecordPause(elapsed);
 }
 
 //==========================================================================
@@ -484,6 +664,8 @@ void Step()
 
 void FullGC()
 {
+	QWORD start = GetMicroseconds();
+
 	if (State <= GCS_Propagate)
 	{
 		// Reset sweep mark to sweep all elements (returning them to white)
@@ -503,6 +685,65 @@ void FullGC()
 		SingleStep();
 	}
 	SetThreshold();
+	LastAllocBytes = AllocBytes;
+	CycleAlloc = 0;
+
+	RecordPause(GetMicroseconds() - start);
+}
+
+//==========================================================================
+//
+// SetStepMul
+//
+// [Zandronum] Sets the step multiplier, which also becomes the lower bound
+// for gc_adaptivestepmul.
+//
+//==========================================================================
+
+void SetStepMul(int stepmul)
+{
+	StepMul = BaseStepMul = MAX(100, stepmul);
+}
+
+//==========================================================================
+//
+// ResetPauseStats
+//
+// [Zandronum] Clears the pause histogram shown by "stat gc".
+//
+//==========================================================================
+
+void ResetPauseStats()
+{
+	memset(PauseBuckets, 0, sizeof(PauseBuckets));
+	PauseTic = -1;
+	PauseTicTime = 0;
+	PauseCount = 0;
+	PauseTotal = 0;
+	PauseMax = 0;
+}
+
+//==========================================================================
+//
+// GetPauseStats
+//
+// [Zandronum] Formats the pause histogram for "stat gc".
+//
+//==========================================================================
+
+static FString GetPauseStats()
+{
+	FString out;
+
+	out.Format("GC tics: %u  avg:%.3fms  max:%.3fms  StepMul:%d%s  Budget:%dus\n",
+		PauseCount, PauseCount > 0 ? PauseTotal / 1000. / PauseCount : 0.,
+		PauseMax / 1000., StepMul, gc_adaptivestepmul ? " (adaptive)" : "",
+		*gc_timebudget);
+	for (unsigned int i = 0; i < countof(PauseBuckets); ++i)
+	{
+		out.AppendFormat(" %s:%u", PauseBucketNames[i], PauseBuckets[i]);
+	}
+	return out;
 }
 
 //==========================================================================
@@ -721,6 +962,7 @@ ADD_STAT(gc)
 	{
 		out.AppendFormat("  %zuK", (GC::Dept + 1023) >> 10);
 	}
+	out << "\n" << GC::GetPauseStats();
 	return out;
 }
 
@@ -736,7 +978,7 @@ CCMD(gc)
 {
 	if (argv.argc() == 1)
 	{
-		Printf ("Usage: gc stop|now|full|pause [size]|stepmul [size]\n");
+		Printf ("Usage: gc stop|now|full|pause [size]|stepmul [size]|resetstats\n");
 		return;
 	}
 	if (stricmp(argv[1], "stop") == 0)
@@ -770,7 +1012,11 @@ CCMD(gc)
 		}
 		else
 		{
-			GC::StepMul = MAX(100, atoi(argv[2]));
+			GC::SetStepMul(atoi(argv[2]));
 		}
 	}
+	else if (stricmp(argv[1], "resetstats") == 0)
+	{
+		GC::ResetPauseStats();
+	}
 }
@@ -45,6 +45,7 @@ extern EGameSpeed GameSpeed;
 // Command line parameters.
 //
 extern	bool			devparm;		// DEBUG: launched with -devparm
+extern	bool			leanstartup;	// [Zandronum] Server launched with -lean, skips render-only data
 
 
 
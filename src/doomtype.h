@@ -97,6 +97,16 @@
 
 #endif
 
+// [Zandronum] Storage class for software renderer state that each render
+// slice thread needs its own copy of. The assembly drawers address this
+// state directly, so builds that use them keep it global and never render
+// in slices.
+#if defined(X86_ASM) || defined(X64_ASM)
+#define RENDER_TLS
+#else
+#define RENDER_TLS thread_local
+#endif
+
 
 #if defined(_MSC_VER) || defined(__WATCOMC__)
 #define STACK_ARGS __cdecl
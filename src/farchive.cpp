@@ -141,6 +141,7 @@ void FCompressedFile::BeEmpty ()
 	m_Buffer = NULL;
 	m_File = NULL;
 	m_NoCompress = false;
+	m_CompressionLevel = Z_DEFAULT_COMPRESSION;
 	m_Mode = ENotOpen;
 }
 
@@ -337,13 +338,14 @@ void FCompressedFile::Implode ()
 	BYTE *oldbuf = m_Buffer;
 	int r;
 
-	if (!nofilecompression && !m_NoCompress)
+	// [Zandronum] Level 0 means the data is stored as-is.
+	if (!nofilecompression && !m_NoCompress && m_CompressionLevel != 0)
 	{
 		outlen = OUT_LEN(len);
 		do
 		{
 			compressed = new Bytef[outlen];
-			r = compress (compressed, &outlen, m_Buffer, len);
+			r = compress2 (compressed, &outlen, m_Buffer, len, m_CompressionLevel);
 			if (r == Z_BUF_ERROR)
 			{
 				delete[] compressed;
@@ -420,10 +422,271 @@ void FCompressedFile::Explode ()
 	}
 }
 
+//==========================================================================
+//
+// [Zandronum] Snapshot deltas
+//
+// A delta starts with the length of the data it restores, followed by a
+// list of operations, each one starting with a varint v. When v is odd,
+// (v >> 1) + DELTA_MINMATCH bytes are copied from the base, at the offset
+// stored in the varint that follows. Otherwise, (v >> 1) + 1 literal bytes
+// follow.
+//
+//==========================================================================
+
+enum
+{
+	DELTA_BLOCK = 32,
+	DELTA_MINMATCH = 12,
+};
+
+static const DWORD DELTA_HASHPRIME = 0x01000193;
+
+static void DeltaPutVarint (TArray<BYTE> &out, unsigned int v)
+{
+	while (v >= 0x80)
+	{
+		out.Push (BYTE(v | 0x80));
+		v >>= 7;
+	}
+	out.Push (BYTE(v));
+}
+
+static bool DeltaGetVarint (const BYTE *&in, const BYTE *end, unsigned int &v)
+{
+	v = 0;
+	for (int shift = 0; shift < 32; shift += 7)
+	{
+		if (in >= end)
+		{
+			return false;
+		}
+		BYTE b = *in++;
+		v |= (unsigned int)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void DeltaPutLiterals (TArray<BYTE> &out, const BYTE *data, unsigned int count)
+{
+	if (count > 0)
+	{
+		DeltaPutVarint (out, (count - 1) << 1);
+		unsigned int place = out.Reserve (count);
+		memcpy (&out[place], data, count);
+	}
+}
+
+static DWORD DeltaHashBlock (const BYTE *data)
+{
+	DWORD hash = 0;
+	for (int i = 0; i < DELTA_BLOCK; ++i)
+	{
+		hash = hash * DELTA_HASHPRIME + data[i];
+	}
+	return hash;
+}
+
+static inline unsigned int DeltaHashSlot (DWORD hash, unsigned int bits)
+{
+	return (hash * 0x9E3779B1u) >> (32 - bits);
+}
+
+static unsigned int DeltaMatchLength (const BYTE *a, unsigned int alen, const BYTE *b, unsigned int blen)
+{
+	unsigned int max = alen < blen ? alen : blen;
+	unsigned int i = 0;
+	while (i < max && a[i] == b[i])
+	{
+		++i;
+	}
+	return i;
+}
+
+//==========================================================================
+//
+// DeltaEncode
+//
+// The base is indexed by the hashes of its aligned blocks and the data is
+// scanned with a rolling hash. Most of a snapshot continues the way the
+// base does after the previous match, so that is tried first.
+//
+//==========================================================================
+
+static void DeltaEncode (const BYTE *base, unsigned int baselen, const BYTE *data, unsigned int len, TArray<BYTE> &out)
+{
+	TArray<unsigned int> table;
+	unsigned int bits = 8;
+
+	out.Clear ();
+	DeltaPutVarint (out, len);
+
+	while (bits < 30 && (1u << bits) < baselen / DELTA_BLOCK * 2)
+	{
+		++bits;
+	}
+	table.Resize (1u << bits);
+	memset (&table[0], 0, table.Size() * sizeof(unsigned int));
+	for (unsigned int b = 0; b + DELTA_BLOCK <= baselen; b += DELTA_BLOCK)
+	{
+		unsigned int &slot = table[DeltaHashSlot (DeltaHashBlock (base + b), bits)];
+		if (slot == 0)
+		{
+			slot = b + 1;
+		}
+	}
+
+	DWORD power = 1;
+	for (int i = 0; i < DELTA_BLOCK - 1; ++i)
+	{
+		power *= DELTA_HASHPRIME;
+	}
+
+	unsigned int literal = 0;
+	unsigned int expected = 0;
+	unsigned int pos = 0;
+	DWORD hash = 0;
+	bool hashvalid = false;
+
+	while (pos < len)
+	{
+		unsigned int matchpos = 0;
+		unsigned int matchlen = 0;
+
+		if (expected < baselen)
+		{
+			matchpos = expected;
+			matchlen = DeltaMatchLength (base + expected, baselen - expected, data + pos, len - pos);
+		}
+		if (matchlen < DELTA_MINMATCH && pos + DELTA_BLOCK <= len)
+		{
+			if (!hashvalid)
+			{
+				hash = DeltaHashBlock (data + pos);
+				hashvalid = true;
+			}
+			unsigned int slot = table[DeltaHashSlot (hash, bits)];
+			if (slot != 0)
+			{
+				unsigned int candidate = slot - 1;
+				unsigned int candlen = DeltaMatchLength (base + candidate, baselen - candidate, data + pos, len - pos);
+				if (candlen > matchlen)
+				{
+					matchpos = candidate;
+					matchlen = candlen;
+				}
+			}
+		}
+
+		if (matchlen >= DELTA_MINMATCH)
+		{
+			// Take back the literals that match, too.
+			while (pos > literal && matchpos > 0 && data[pos - 1] == base[matchpos - 1])
+			{
+				--pos;
+				--matchpos;
+				++matchlen;
+			}
+			DeltaPutLiterals (out, data + literal, pos - literal);
+			DeltaPutVarint (out, ((matchlen - DELTA_MINMATCH) << 1) | 1);
+			DeltaPutVarint (out, matchpos);
+			pos += matchlen;
+			literal = pos;
+			expected = matchpos + matchlen;
+			hashvalid = false;
+		}
+		else
+		{
+			if (hashvalid)
+			{
+				if (pos + DELTA_BLOCK < len)
+				{
+					hash = (hash - data[pos] * power) * DELTA_HASHPRIME + data[pos + DELTA_BLOCK];
+				}
+				else
+				{
+					hashvalid = false;
+				}
+			}
+			++pos;
+			++expected;
+		}
+	}
+	DeltaPutLiterals (out, data + literal, len - literal);
+}
+
+//==========================================================================
+//
+// DeltaDecode
+//
+// Returns NULL if the delta doesn't fit the base.
+//
+//==========================================================================
+
+static BYTE *DeltaDecode (const BYTE *base, unsigned int baselen, const BYTE *delta, unsigned int deltalen, unsigned int &len)
+{
+	const BYTE *in = delta;
+	const BYTE *end = delta + deltalen;
+	unsigned int pos = 0;
+	bool ok = true;
+
+	if (!DeltaGetVarint (in, end, len))
+	{
+		return NULL;
+	}
+	BYTE *data = (BYTE *)M_Malloc (len > 0 ? len : 1);
+
+	while (ok && in < end)
+	{
+		unsigned int v, count, offset;
+
+		ok = DeltaGetVarint (in, end, v);
+		if (!ok)
+		{
+			break;
+		}
+		count = (v >> 1) + ((v & 1) ? DELTA_MINMATCH : 1);
+		if (count > len - pos)
+		{
+			ok = false;
+		}
+		else if (v & 1)
+		{
+			ok = DeltaGetVarint (in, end, offset) && offset <= baselen && count <= baselen - offset;
+			if (ok)
+			{
+				memcpy (data + pos, base + offset, count);
+			}
+		}
+		else
+		{
+			ok = count <= (unsigned int)(end - in);
+			if (ok)
+			{
+				memcpy (data + pos, in, count);
+				in += count;
+			}
+		}
+		pos += count;
+	}
+	if (!ok || pos != len)
+	{
+		M_Free (data);
+		return NULL;
+	}
+	return data;
+}
+
 FCompressedMemFile::FCompressedMemFile ()
 {
 	m_SourceFromMem = false;
 	m_ImplodedBuffer = NULL;
+	m_DeltaBase = NULL;
+	m_IsDelta = false;
 }
 
 /*
@@ -483,6 +746,7 @@ bool FCompressedMemFile::Open (void *memblock)
 bool FCompressedMemFile::Open ()
 {
 	Close ();
+	m_IsDelta = false;
 	m_Mode = EWriting;
 	m_BufferSize = 0;
 	m_MaxBufferSize = 16384;
@@ -511,6 +775,25 @@ bool FCompressedMemFile::Reopen ()
 			throw;
 		}
 		m_SourceFromMem = false;
+
+		if (m_IsDelta)
+		{
+			unsigned int len;
+			BYTE *data = NULL;
+
+			if (m_DeltaBase != NULL)
+			{
+				data = DeltaDecode (m_DeltaBase->Size() > 0 ? &(*m_DeltaBase)[0] : NULL, m_DeltaBase->Size(), m_Buffer, m_BufferSize, len);
+			}
+			M_Free (m_Buffer);
+			m_Buffer = NULL;
+			if (data == NULL)
+			{
+				I_Error ("Could not restore a snapshot from its delta");
+			}
+			m_Buffer = data;
+			m_BufferSize = len;
+		}
 		return true;
 	}
 	return false;
@@ -520,6 +803,18 @@ void FCompressedMemFile::Close ()
 {
 	if (m_Mode == EWriting)
 	{
+		// [Zandronum] Only store what differs from the base.
+		if (m_DeltaBase != NULL && m_Buffer != NULL)
+		{
+			TArray<BYTE> delta;
+
+			DeltaEncode (m_DeltaBase->Size() > 0 ? &(*m_DeltaBase)[0] : NULL, m_DeltaBase->Size(), m_Buffer, m_BufferSize, delta);
+			M_Free (m_Buffer);
+			m_MaxBufferSize = m_BufferSize = delta.Size();
+			m_Buffer = (BYTE *)M_Malloc (m_BufferSize);
+			memcpy (m_Buffer, &delta[0], m_BufferSize);
+			m_IsDelta = true;
+		}
 		Implode ();
 		m_ImplodedBuffer = m_Buffer;
 		m_Buffer = NULL;
@@ -534,6 +829,10 @@ void FCompressedMemFile::Serialize (FArchive &arc)
 		{
 			I_Error ("FCompressedMemFile must be compressed before storing");
 		}
+		if (m_IsDelta)
+		{
+			I_Error ("FCompressedMemFile must not be a delta when storing");
+		}
 		arc.Write (ZSig, 4);
 
 		DWORD sizes[2];
@@ -564,6 +863,34 @@ void FCompressedMemFile::Serialize (FArchive &arc)
 		m_ImplodedBuffer = m_Buffer;
 		m_Buffer = NULL;
 		m_Mode = EWriting;
+		m_IsDelta = false;
+	}
+}
+
+//==========================================================================
+//
+// FCompressedMemFile :: GetContents
+//
+// [Zandronum] Copies the uncompressed data of a closed file and leaves it
+// closed.
+//
+//==========================================================================
+
+void FCompressedMemFile::GetContents (TArray<BYTE> &data)
+{
+	EOpenMode mode = m_Mode;
+	bool reopened = Reopen ();
+
+	data.Resize (m_BufferSize);
+	if (m_BufferSize > 0)
+	{
+		memcpy (&data[0], m_Buffer, m_BufferSize);
+	}
+	if (reopened)
+	{
+		M_Free (m_Buffer);
+		m_Buffer = NULL;
+		m_Mode = mode;
 	}
 }
 
@@ -88,6 +88,9 @@ public:
 	bool IsOpen () const;
 	unsigned int GetSize () const { return m_BufferSize; }
 
+	// [Zandronum] The zlib compression level used when the file is closed.
+	void SetCompressionLevel (int level) { m_CompressionLevel = level; }
+
 	FFile &Write (const void *, unsigned int);
 	FFile &Read (void *, unsigned int);
 	unsigned int Tell () const;
@@ -99,6 +102,7 @@ protected:
 	unsigned int m_MaxBufferSize;
 	unsigned char *m_Buffer;
 	bool m_NoCompress;
+	int m_CompressionLevel;
 	EOpenMode m_Mode;
 	FILE *m_File;
 
@@ -128,12 +132,20 @@ public:
 
 	void Serialize (FArchive &arc);
 
+	// [Zandronum] When closed, the data is stored as a delta against base,
+	// which has to stay unchanged for as long as the file may be reopened.
+	void SetDeltaBase (const TArray<BYTE> *base) { m_DeltaBase = base; }
+	bool IsDelta () const { return m_IsDelta; }
+	void GetContents (TArray<BYTE> &data);
+
 protected:
 	bool FreeOnExplode () { return !m_SourceFromMem; }
 
 private:
 	bool m_SourceFromMem;
 	unsigned char *m_ImplodedBuffer;
+	const TArray<BYTE> *m_DeltaBase;
+	bool m_IsDelta;
 };
 
 class FPNGChunkFile : public FCompressedFile
@@ -527,3 +527,26 @@ char *MemoryReader::Gets(char *strbuf, int len)
 {
 	return GetsFromBuffer(bufptr, strbuf, len);
 }
+
+//==========================================================================
+//
+// MappedFileReader
+//
+// [Zandronum] reads data from a file mapped into memory
+//
+//==========================================================================
+
+MappedFileReader::MappedFileReader (const char *filename)
+: MemoryReader (NULL, 0)
+{
+	if (Open (filename))
+	{
+		bufptr = (const char *)I_MapFile (File, Length);
+	}
+	FilePos = 0;
+}
+
+MappedFileReader::~MappedFileReader ()
+{
+	I_UnmapFile (const_cast<char *>(bufptr), Length);
+}
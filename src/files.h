@@ -338,6 +338,18 @@ protected:
 	const char * bufptr;
 };
 
+// [Zandronum] Reads a file through a memory mapping, so the uncompressed lumps
+// in it can be used without copying them. The file stays open for the code
+// that needs the FILE itself.
+class MappedFileReader : public MemoryReader
+{
+public:
+	MappedFileReader (const char *filename);
+	~MappedFileReader ();
+
+	bool IsMapped () const { return bufptr != NULL; }
+};
+
 
 
 #endif
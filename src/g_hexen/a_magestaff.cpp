@@ -215,16 +215,19 @@ DEFINE_ACTION_FUNCTION(AActor, A_MStaffTrack)
 
 static AActor *FrontBlockCheck (AActor *mo, int index, void *)
 {
-	FBlockNode *link;
+	int bx = index % bmapwidth;
+	int by = index / bmapwidth;
+	FBlockThingsIterator it(bx, by, bx, by);
+	AActor *link;
 
-	for (link = blocklinks[index]; link != NULL; link = link->NextActor)
+	while ((link = it.Next()))
 	{
-		if (link->Me != mo)
+		if (link != mo)
 		{
-			if (P_PointOnDivlineSide (link->Me->x, link->Me->y, &BlockCheckLine) == 0 &&
-				mo->IsOkayToAttack (link->Me))
+			if (P_PointOnDivlineSide (link->x, link->y, &BlockCheckLine) == 0 &&
+				mo->IsOkayToAttack (link))
 			{
-				return link->Me;
+				return link;
 			}
 		}
 	}
@@ -46,6 +46,7 @@
 #include "w_wad.h"
 #include "am_map.h"
 #include "c_dispatch.h"
+#include "stats.h"
 #include "i_system.h"
 #include "p_setup.h"
 #include "p_local.h"
@@ -88,6 +89,8 @@
 #include "network.h"
 #include "sv_commands.h"
 #include "sv_rcon.h"
+#include "sv_capture.h"
+#include "sv_actorsnapshot.h"
 #include "team.h"
 #include "maprotation.h"
 #include "campaign.h"
@@ -120,6 +123,32 @@ EXTERN_CVAR (Float, sv_aircontrol)
 EXTERN_CVAR (Int, disableautosave)
 EXTERN_CVAR (String, playerclass)
 
+// [Zandronum] The zlib level used for the level snapshots. The default is
+// zlib's own default level. Lower levels make hub transitions cheaper, but
+// the snapshots are stored in savegames as they are, so saves get bigger.
+CUSTOM_CVAR (Int, snapshotcompression, 6, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+{
+	if (self < 0)
+		self = 0;
+	else if (self > 9)
+		self = 9;
+}
+
+// [Zandronum] Store hub snapshots as deltas against the level as it was
+// spawned. Only what changed since gets compressed and kept around.
+CUSTOM_CVAR (Bool, snapshotdelta, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+{
+	// The bases are only taken when a level is entered.
+	if (!self)
+	{
+		for (unsigned int i = 0; i < wadlevelinfos.Size(); i++)
+		{
+			if (wadlevelinfos[i].snapshot == NULL)
+				wadlevelinfos[i].ClearSnapshotBase();
+		}
+	}
+}
+
 #define SNAP_ID			MAKE_ID('s','n','A','p')
 #define DSNP_ID			MAKE_ID('d','s','N','p')
 #define VIST_ID			MAKE_ID('v','i','S','t')
@@ -299,6 +328,7 @@ void G_NewInit ()
 		playeringame[i] = 0;
 		players[i].userinfo.TransferFrom(saved_ui);
 	}
+	SERVER_UpdatePlayerLists( );
 	BackupSaveName = "";
 	consoleplayer = 0;
 
@@ -520,6 +550,10 @@ void G_InitNew (const char *mapname, bool bTitleLevel)
 				rngseed = use_staticrng ? staticrngseed : (rngseed + 1);
 			}
 			FRandom::StaticClearRandom ();
+
+			// Server captures begin here, and so do their replays.
+			if ( NETWORK_GetState( ) == NETSTATE_SERVER )
+				SERVER_CAPTURE_NewGame( );
 		}
 		P_ClearACSVars(true);
 		level.time = 0;
@@ -1411,6 +1445,9 @@ void G_DoLoadLevel (int position, bool autosave)
 			g_NetIDList.clear( );
 	}
 
+	// The actor snapshots of the old level are meaningless now.
+	SERVER_ACTORSNAPSHOT_Clear( );
+
 	P_SetupLevel (level.mapname, position);
 
 	AM_LevelInit();
@@ -1446,6 +1483,9 @@ void G_DoLoadLevel (int position, bool autosave)
 	}
 
 	level.starttime = gametic;
+	// [Zandronum] Remember how the level was spawned before anything changes it.
+	if (level.info->snapshot == NULL)
+		G_SnapshotLevelBase ();
 	G_UnSnapshotLevel (!savegamerestore);	// [RH] Restore the state of the level.
 
 	// [BB] If the snapshot was taken with less players than we have now (possible due to ingame joining),
@@ -2252,6 +2292,9 @@ void G_SnapshotLevel ()
 		level.info->snapshotVer = SAVEVER;
 		level.info->snapshot = new FCompressedMemFile;
 		level.info->snapshot->Open ();
+		level.info->snapshot->SetCompressionLevel (snapshotcompression);
+		if (snapshotdelta && level.info->snapshotBase != NULL)
+			level.info->snapshot->SetDeltaBase (level.info->snapshotBase);
 
 		FArchive arc (*level.info->snapshot);
 
@@ -2260,6 +2303,35 @@ void G_SnapshotLevel ()
 	}
 }
 
+//==========================================================================
+//
+// [Zandronum] Archives the current level uncompressed, as the base for
+// its snapshots. Most of a level doesn't change while playing it, so a
+// snapshot only needs to store how it differs from the level that was
+// spawned. Only levels in a hub can be snapshotted.
+//
+//==========================================================================
+
+void G_SnapshotLevelBase ()
+{
+	level.info->ClearSnapshotBase();
+
+	if (snapshotdelta && (level.clusterflags & CLUSTER_HUB) && level.info->isValid())
+	{
+		FCompressedMemFile base;
+		base.Open ();
+		base.SetCompressionLevel (0);
+		{
+			FArchive arc (base);
+
+			SaveVersion = SAVEVER;
+			G_SerializeLevel (arc, false);
+		}
+		level.info->snapshotBase = new TArray<BYTE>;
+		base.GetContents (*level.info->snapshotBase);
+	}
+}
+
 //==========================================================================
 //
 // Unarchives the current level based on its snapshot
@@ -2350,7 +2422,24 @@ static void writeSnapShot (FArchive &arc, level_info_t *i)
 {
 	arc << i->snapshotVer;
 	writeMapName (arc, i->mapname);
-	i->snapshot->Serialize (arc);
+
+	// [Zandronum] The savegame doesn't contain the base of a delta.
+	if (i->snapshot->IsDelta ())
+	{
+		TArray<BYTE> data;
+		FCompressedMemFile full;
+
+		i->snapshot->GetContents (data);
+		full.Open ();
+		full.SetCompressionLevel (snapshotcompression);
+		full.Write (&data[0], data.Size());
+		full.Close ();
+		full.Serialize (arc);
+	}
+	else
+	{
+		i->snapshot->Serialize (arc);
+	}
 }
 
 //==========================================================================
@@ -2531,6 +2620,70 @@ CCMD(listsnapshots)
 	}
 }
 
+//==========================================================================
+//
+// CCMD bench_snapshot
+//
+// [Zandronum] Snapshots the current level like a hub transition does, once
+// with snapshotcompression and once with another level for comparison (the
+// fastest one, or the default if snapshotcompression already is the
+// fastest), and prints how long serializing, compressing and decompressing
+// took. In a hub, it also snapshots as a delta against the level's base.
+// Load a large hub map, play a bit and compare.
+//
+//==========================================================================
+
+CCMD (bench_snapshot)
+{
+	const int passes = (argv.argc() > 1) ? MAX (atoi (argv[1]), 1) : 10;
+	const int levels[3] = { snapshotcompression, snapshotcompression != 1 ? 1 : 6, snapshotcompression };
+	const int configs = (level.info->snapshotBase != NULL) ? 3 : 2;
+
+	if (gamestate != GS_LEVEL || !level.info->isValid())
+	{
+		Printf ("No level is loaded.\n");
+		return;
+	}
+
+	for (int l = 0; l < configs; ++l)
+	{
+		cycle_t serializetime, compresstime, decompresstime;
+		unsigned int comp = 0, uncomp = 0;
+
+		serializetime.Reset();
+		compresstime.Reset();
+		decompresstime.Reset();
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			FCompressedMemFile snapshot;
+			snapshot.Open ();
+			snapshot.SetCompressionLevel (levels[l]);
+			if (l == 2)
+				snapshot.SetDeltaBase (level.info->snapshotBase);
+			{
+				FArchive arc (snapshot);
+
+				serializetime.Clock();
+				SaveVersion = SAVEVER;
+				G_SerializeLevel (arc, false);
+				serializetime.Unclock();
+
+				compresstime.Clock();
+				arc.Close ();
+				compresstime.Unclock();
+			}
+			snapshot.GetSizes (comp, uncomp);
+
+			decompresstime.Clock();
+			snapshot.Reopen ();
+			decompresstime.Unclock();
+		}
+		Printf ("Level %d%s: %.2f ms to serialize, %.2f ms to compress, %.2f ms to decompress, %u -> %u bytes\n",
+			levels[l], (l == 2) ? " delta" : "", serializetime.TimeMS() / passes, compresstime.TimeMS() / passes,
+			decompresstime.TimeMS() / passes, uncomp, comp);
+	}
+}
+
 //==========================================================================
 //
 //
@@ -301,6 +301,7 @@ struct level_info_t
 	int			musicorder;
 	FCompressedMemFile	*snapshot;
 	DWORD		snapshotVer;
+	TArray<BYTE> *snapshotBase;	// [Zandronum] The level as it was spawned, snapshots are deltas against it.
 	struct acsdefered_t *defered;
 	float		skyspeed1;
 	float		skyspeed2;
@@ -352,12 +353,14 @@ struct level_info_t
 	~level_info_t()
 	{
 		ClearSnapshot(); 
+		ClearSnapshotBase();
 		ClearDefered();
 	}
 	void Reset();
 	bool isValid();
 	FString LookupLevelName ();
 	void ClearSnapshot();
+	void ClearSnapshotBase();
 	void ClearDefered();
 	level_info_t *CheckLevelRedirect ();
 
@@ -550,6 +553,7 @@ void G_ParseMapInfo (const char *basemapinfo);
 void G_ClearSnapshots (void);
 void P_RemoveDefereds ();
 void G_SnapshotLevel (void);
+void G_SnapshotLevelBase (void);
 void G_UnSnapshotLevel (bool keepPlayers);
 struct PNGHandle;
 void G_ReadSnapshots (PNGHandle *png);
@@ -212,6 +212,7 @@ void G_ClearSnapshots (void)
 	for (unsigned int i = 0; i < wadlevelinfos.Size(); i++)
 	{
 		wadlevelinfos[i].ClearSnapshot();
+		wadlevelinfos[i].ClearSnapshotBase();
 	}
 	// Since strings are only locked when snapshotting a level, unlock them
 	// all now, since we got rid of all the snapshots that cared about them.
@@ -267,6 +268,7 @@ void level_info_t::Reset()
 	musicorder = 0;
 	snapshot = NULL;
 	snapshotVer = 0;
+	snapshotBase = NULL;
 	defered = 0;
 	skyspeed1 = skyspeed2 = 0.f;
 	fadeto = 0;
@@ -361,6 +363,18 @@ void level_info_t::ClearSnapshot()
 	snapshot = NULL;
 }
 
+//==========================================================================
+//
+// [Zandronum]
+//
+//==========================================================================
+
+void level_info_t::ClearSnapshotBase()
+{
+	if (snapshotBase != NULL) delete snapshotBase;
+	snapshotBase = NULL;
+}
+
 //==========================================================================
 //
 //
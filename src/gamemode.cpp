@@ -692,6 +692,7 @@ void GAMEMODE_RespawnDeadSpectators( BYTE Playerstate )
 
 		players[ulIdx].bSpectating = false;
 		players[ulIdx].bDeadSpectator = false;
+		SERVER_UpdatePlayerLists( );
 		if ( GAMEMODE_GetCurrentFlags() & GMF_USEMAXLIVES )
 		{
 			PLAYER_SetLivesLeft ( &players[ulIdx], GAMEMODE_GetMaxLives() - 1 );
@@ -28,7 +28,7 @@ extern GLRenderSettings glset;
 #include "a_sharedglobal.h"
 #include "c_cvars.h"
 
-extern int extralight;
+extern RENDER_TLS int extralight;
 EXTERN_CVAR(Int, gl_weaponlight);
 
 inline	int getExtraLight()
@@ -25,6 +25,11 @@
 #include <stdlib.h>
 #include "mystdint.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HQX_SSE2
+#include <emmintrin.h>
+#endif
+
 #define MASK_2     0x0000FF00
 #define MASK_13    0x00FF00FF
 #define MASK_RGB   0x00FFFFFF
@@ -58,6 +63,57 @@ static inline int Diff(uint32_t c1, uint32_t c2)
     return yuv_diff(rgb_to_yuv(c1), rgb_to_yuv(c2));
 }
 
+/* Build the 8 bit neighbourhood pattern for the center pixel w[5].
+ * Bit n-1 (n = 1..4) and bit n-2 (n = 6..9) are set when w[n] differs
+ * from w[5] according to yuv_diff. */
+static inline int hqx_pattern(const uint32_t *w)
+{
+#ifdef HQX_SSE2
+    /* The YUV table stores 0x00YYUUVV, so the three range checks of
+     * yuv_diff are per byte comparisons: |a-b| > threshold per channel.
+     * Do all eight neighbours at once with saturating byte arithmetic. */
+    const uint32_t c = w[5];
+    const uint32_t yuv1 = rgb_to_yuv(c);
+    uint32_t y[8];
+    y[0] = w[1] == c ? yuv1 : rgb_to_yuv(w[1]);
+    y[1] = w[2] == c ? yuv1 : rgb_to_yuv(w[2]);
+    y[2] = w[3] == c ? yuv1 : rgb_to_yuv(w[3]);
+    y[3] = w[4] == c ? yuv1 : rgb_to_yuv(w[4]);
+    y[4] = w[6] == c ? yuv1 : rgb_to_yuv(w[6]);
+    y[5] = w[7] == c ? yuv1 : rgb_to_yuv(w[7]);
+    y[6] = w[8] == c ? yuv1 : rgb_to_yuv(w[8]);
+    y[7] = w[9] == c ? yuv1 : rgb_to_yuv(w[9]);
+
+    const __m128i center = _mm_set1_epi32((int)yuv1);
+    const __m128i thresh = _mm_set1_epi32(trY | trU | trV);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_loadu_si128((const __m128i *)&y[0]);
+    __m128i hi = _mm_loadu_si128((const __m128i *)&y[4]);
+    lo = _mm_or_si128(_mm_subs_epu8(lo, center), _mm_subs_epu8(center, lo));
+    hi = _mm_or_si128(_mm_subs_epu8(hi, center), _mm_subs_epu8(center, hi));
+    lo = _mm_cmpeq_epi32(_mm_subs_epu8(lo, thresh), zero);
+    hi = _mm_cmpeq_epi32(_mm_subs_epu8(hi, thresh), zero);
+    return (~(_mm_movemask_ps(_mm_castsi128_ps(lo)) | (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4))) & 0xFF;
+#else
+    int pattern = 0;
+    int flag = 1;
+    uint32_t yuv1 = rgb_to_yuv(w[5]);
+
+    for (int k=1; k<=9; k++)
+    {
+        if (k==5) continue;
+
+        if ( w[k] != w[5] )
+        {
+            if (yuv_diff(yuv1, rgb_to_yuv(w[k])))
+                pattern |= flag;
+        }
+        flag <<= 1;
+    }
+    return pattern;
+#endif
+}
+
 /* Interpolate functions */
 static inline uint32_t Interpolate_2(uint32_t c1, int w1, uint32_t c2, int w2, int s)
 {
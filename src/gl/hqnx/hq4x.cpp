@@ -163,16 +163,15 @@
 #define PIXEL33_81    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[6]);
 #define PIXEL33_82    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[8]);
 
-HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres )
+HQX_API void HQX_CALLCONV hq4x_32_rb_rows( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres, int firstRow, int lastRow )
 {
-    int  i, j, k;
+    int  i, j;
     int  prevline, nextline;
     uint32_t w[10];
     int dpL = (drb >> 2);
     int spL = (srb >> 2);
-    uint8_t *sRowP = (uint8_t *) sp;
-    uint8_t *dRowP = (uint8_t *) dp;
-    uint32_t yuv1, yuv2;
+    uint8_t *sRowP = (uint8_t *) sp + firstRow * srb;
+    uint8_t *dRowP = (uint8_t *) dp + firstRow * drb * 4;
 
     //   +----+----+----+
     //   |    |    |    |
@@ -185,7 +184,10 @@ HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    sp = (uint32_t *) sRowP;
+    dp = (uint32_t *) dRowP;
+
+    for (j=firstRow; j<lastRow; j++)
     {
         if (j>0)      prevline = -spL; else prevline = 0;
         if (j<Yres-1) nextline =  spL; else nextline = 0;
@@ -222,23 +224,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp
                 w[9] = w[8];
             }
 
-            int pattern = 0;
-            int flag = 1;
-
-            yuv1 = rgb_to_yuv(w[5]);
-
-            for (k=1; k<=9; k++)
-            {
-                if (k==5) continue;
-
-                if ( w[k] != w[5] )
-                {
-                    yuv2 = rgb_to_yuv(w[k]);
-                    if (yuv_diff(yuv1, yuv2))
-                        pattern |= flag;
-                }
-                flag <<= 1;
-            }
+            int pattern = hqx_pattern(w);
 
             switch (pattern)
             {
@@ -5226,6 +5212,11 @@ HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp
     }
 }
 
+HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * sp, uint32_t srb, uint32_t * dp, uint32_t drb, int Xres, int Yres )
+{
+    hq4x_32_rb_rows(sp, srb, dp, drb, Xres, Yres, 0, Yres);
+}
+
 HQX_API void HQX_CALLCONV hq4x_32( uint32_t * sp, uint32_t * dp, int Xres, int Yres )
 {
     uint32_t rowBytesL = Xres * 4;
@@ -52,4 +52,11 @@ HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uin
 HQX_API void HQX_CALLCONV hq3x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
 HQX_API void HQX_CALLCONV hq4x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
 
+/* Process only source rows [firstRow, lastRow) of the image. The edges are
+ * still handled relative to the full image, so disjoint row ranges can be
+ * scaled independently and give the same result as a single pass. */
+HQX_API void HQX_CALLCONV hq2x_32_rb_rows( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height, int firstRow, int lastRow );
+HQX_API void HQX_CALLCONV hq3x_32_rb_rows( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height, int firstRow, int lastRow );
+HQX_API void HQX_CALLCONV hq4x_32_rb_rows( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height, int firstRow, int lastRow );
+
 #endif
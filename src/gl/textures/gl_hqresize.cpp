@@ -39,7 +39,16 @@
 #include "gl/renderer/gl_renderer.h"
 #include "gl/textures/gl_texture.h"
 #include "c_cvars.h"
+#include "c_dispatch.h"
+#include "cmdlib.h"
+#include "doomerrors.h"
+#include "m_misc.h"
+#include "m_swap.h"
+#include "md5.h"
+#include "stats.h"
 #include "gl/hqnx/hqx.h"
+#include <zlib.h>
+#include <thread>
 #ifdef _MSC_VER
 #include "gl/hqnx_asm/hqnx_asm.h"
 #endif
@@ -62,6 +71,12 @@ CUSTOM_CVAR(Int, gl_texture_hqresize_targets, 7, CVAR_ARCHIVE | CVAR_GLOBALCONFI
 	GLRenderer->FlushTextures();
 }
 
+// Split hqNx upscaling of large textures into row bands processed on all cores.
+CVAR(Bool, gl_texture_hqresize_mt, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
+// Keep hqNx results on disk so that they don't need to be recomputed on the next start.
+CVAR(Bool, gl_texture_hqresize_cache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+
 CVAR (Flag, gl_texture_hqresize_textures, gl_texture_hqresize_targets, 1);
 CVAR (Flag, gl_texture_hqresize_sprites, gl_texture_hqresize_targets, 2);
 CVAR (Flag, gl_texture_hqresize_fonts, gl_texture_hqresize_targets, 4);
@@ -214,7 +229,153 @@ static unsigned char *hqNxAsmHelper( void (*hqNxFunction) ( int*, unsigned char*
 }
 #endif
 
-static unsigned char *hqNxHelper( void (*hqNxFunction) ( unsigned*, unsigned*, int, int ),
+//===========================================================================
+//
+// hqNx result cache
+//
+// Upscaled buffers are stored in the cache directory, keyed by the MD5 of
+// the source pixels and the scaler settings, so the same texture in any
+// file resolves to the same entry. Each file holds the "HQNX" magic, the
+// output size and the zlib compressed RGBA data.
+//
+//===========================================================================
+
+static cycle_t HQResizeCycles;
+static unsigned HQResizeCount, HQResizeCacheHits;
+
+static FString CreateHQCacheName(int N, const unsigned char *inputBuffer, int inWidth, int inHeight, bool create)
+{
+	MD5Context md5;
+	BYTE digest[16];
+	DWORD header[3] = { LittleLong(DWORD(N)), LittleLong(DWORD(inWidth)), LittleLong(DWORD(inHeight)) };
+
+	md5.Update((const BYTE *)header, sizeof(header));
+	md5.Update(inputBuffer, inWidth * inHeight * 4);
+	md5.Final(digest);
+
+	FString path = M_GetCachePath(create);
+	path << "/hqnx";
+	if (create) CreatePath(path);
+
+	path << '/';
+	for (int i = 0; i < 16; ++i)
+	{
+		path.AppendFormat("%02x", digest[i]);
+	}
+	path << ".hqc";
+	return path;
+}
+
+static unsigned char *LoadCachedHQBuffer(const FString &path, int outWidth, int outHeight)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) return NULL;
+
+	char magic[4];
+	DWORD size[2];
+	unsigned char *compressed = NULL;
+	unsigned char *newBuffer = NULL;
+	uLongf outlen = outWidth * outHeight * 4;
+	long complen;
+
+	if (fread(magic, 1, 4, f) != 4 || memcmp(magic, "HQNX", 4)) goto errorout;
+	if (fread(size, 4, 2, f) != 2) goto errorout;
+	if ((int)LittleLong(size[0]) != outWidth || (int)LittleLong(size[1]) != outHeight) goto errorout;
+
+	fseek(f, 0, SEEK_END);
+	complen = ftell(f) - 12;
+	fseek(f, 12, SEEK_SET);
+	if (complen <= 0) goto errorout;
+
+	compressed = new unsigned char[complen];
+	if (fread(compressed, 1, complen, f) != (size_t)complen) goto errorout;
+
+	newBuffer = new unsigned char[outlen];
+	if (uncompress(newBuffer, &outlen, compressed, complen) != Z_OK || outlen != uLongf(outWidth * outHeight * 4))
+	{
+		delete[] newBuffer;
+		newBuffer = NULL;
+	}
+
+errorout:
+	delete[] compressed;
+	fclose(f);
+	return newBuffer;
+}
+
+static void SaveCachedHQBuffer(const FString &path, const unsigned char *buffer, int outWidth, int outHeight)
+{
+	uLong srclen = outWidth * outHeight * 4;
+	uLongf outlen = compressBound(srclen);
+	unsigned char *compressed = new unsigned char[outlen + 12];
+
+	if (compress2(compressed + 12, &outlen, buffer, srclen, Z_BEST_SPEED) == Z_OK)
+	{
+		DWORD size[2] = { LittleLong(DWORD(outWidth)), LittleLong(DWORD(outHeight)) };
+		memcpy(compressed, "HQNX", 4);
+		memcpy(compressed + 4, size, 8);
+
+		FILE *f = fopen(path, "wb");
+		if (f != NULL)
+		{
+			fwrite(compressed, 1, outlen + 12, f);
+			fclose(f);
+		}
+	}
+	delete[] compressed;
+}
+
+//===========================================================================
+//
+// hqNxHelper
+//
+// The hqNx scalers only read the source image, so disjoint row bands can
+// be scaled on separate threads with the same result as a single pass.
+//
+//===========================================================================
+
+typedef void (HQX_CALLCONV *HQNXROWFUNC) ( uint32_t*, uint32_t, uint32_t*, uint32_t, int, int, int, int );
+
+static void hqNxScale( HQNXROWFUNC hqNxFunction, const int N, unsigned char *inputBuffer, unsigned char *outputBuffer, const int inWidth, const int inHeight )
+{
+	uint32_t *src = reinterpret_cast<uint32_t*>(inputBuffer);
+	uint32_t *dest = reinterpret_cast<uint32_t*>(outputBuffer);
+	const uint32_t srb = inWidth * 4;
+	const uint32_t drb = srb * N;
+
+	// Thread startup isn't free, so leave small textures alone.
+	int numbands = 1;
+	if (gl_texture_hqresize_mt && inWidth * inHeight >= 128*128)
+	{
+		numbands = clamp<int>(std::thread::hardware_concurrency(), 1, 16);
+		numbands = MIN(numbands, inHeight / 16);
+	}
+
+	if (numbands <= 1)
+	{
+		hqNxFunction(src, srb, dest, drb, inWidth, inHeight, 0, inHeight);
+		return;
+	}
+
+	std::thread workers[16];
+	const int bandheight = (inHeight + numbands - 1) / numbands;
+
+	// The calling thread does the first band itself.
+	for (int i = 1; i < numbands; ++i)
+	{
+		const int first = MIN(i * bandheight, inHeight);
+		const int last = MIN(first + bandheight, inHeight);
+		workers[i] = std::thread(hqNxFunction, src, srb, dest, drb, inWidth, inHeight, first, last);
+	}
+	hqNxFunction(src, srb, dest, drb, inWidth, inHeight, 0, MIN(bandheight, inHeight));
+
+	for (int i = 1; i < numbands; ++i)
+	{
+		workers[i].join();
+	}
+}
+
+static unsigned char *hqNxHelper( HQNXROWFUNC hqNxFunction,
 							  const int N,
 							  unsigned char *inputBuffer,
 							  const int inWidth,
@@ -232,12 +393,69 @@ static unsigned char *hqNxHelper( void (*hqNxFunction) ( unsigned*, unsigned*, i
 	outWidth = N * inWidth;
 	outHeight = N *inHeight;
 
-	unsigned char * newBuffer = new unsigned char[outWidth*outHeight*4];
-	hqNxFunction( reinterpret_cast<unsigned*>(inputBuffer), reinterpret_cast<unsigned*>(newBuffer), inWidth, inHeight );
+	FString cachename;
+	unsigned char * newBuffer = NULL;
+
+	HQResizeCount++;
+	HQResizeCycles.Clock();
+	if (gl_texture_hqresize_cache)
+	{
+		cachename = CreateHQCacheName(N, inputBuffer, inWidth, inHeight, true);
+		newBuffer = LoadCachedHQBuffer(cachename, outWidth, outHeight);
+	}
+
+	if (newBuffer != NULL)
+	{
+		HQResizeCacheHits++;
+	}
+	else
+	{
+		newBuffer = new unsigned char[outWidth*outHeight*4];
+		hqNxScale( hqNxFunction, N, inputBuffer, newBuffer, inWidth, inHeight );
+
+		if (cachename.IsNotEmpty())
+		{
+			SaveCachedHQBuffer(cachename, newBuffer, outWidth, outHeight);
+		}
+	}
+	HQResizeCycles.Unclock();
+
 	delete[] inputBuffer;
 	return newBuffer;
 }
 
+ADD_STAT(hqresize)
+{
+	FString out;
+	out.Format("hqNx textures: %u (%u from cache), %.2f ms total", HQResizeCount, HQResizeCacheHits, HQResizeCycles.TimeMS());
+	return out;
+}
+
+UNSAFE_CCMD(clearhqresizecache)
+{
+	TArray<FFileList> list;
+	FString path = M_GetCachePath(false);
+	path += "/hqnx/";
+
+	try
+	{
+		ScanDirectory(list, path);
+	}
+	catch (CRecoverableError &err)
+	{
+		Printf("%s", err.GetMessage());
+		return;
+	}
+
+	for (unsigned i = 0; i < list.Size(); i++)
+	{
+		if (!list[i].isDirectory)
+		{
+			remove(list[i].Filename);
+		}
+	}
+}
+
 
 //===========================================================================
 // 
@@ -302,11 +520,11 @@ unsigned char *gl_CreateUpsampledTextureBuffer ( const FTexture *inputTexture, u
 		case 3:
 			return scaleNxHelper( &scale4x, 4, inputBuffer, inWidth, inHeight, outWidth, outHeight );
 		case 4:
-			return hqNxHelper( &hq2x_32, 2, inputBuffer, inWidth, inHeight, outWidth, outHeight );
+			return hqNxHelper( &hq2x_32_rb_rows, 2, inputBuffer, inWidth, inHeight, outWidth, outHeight );
 		case 5:
-			return hqNxHelper( &hq3x_32, 3, inputBuffer, inWidth, inHeight, outWidth, outHeight );
+			return hqNxHelper( &hq3x_32_rb_rows, 3, inputBuffer, inWidth, inHeight, outWidth, outHeight );
 		case 6:
-			return hqNxHelper( &hq4x_32, 4, inputBuffer, inWidth, inHeight, outWidth, outHeight );
+			return hqNxHelper( &hq4x_32_rb_rows, 4, inputBuffer, inWidth, inHeight, outWidth, outHeight );
 #ifdef _MSC_VER
 		case 7:
 			return hqNxAsmHelper( &HQnX_asm::hq2x_32, 2, inputBuffer, inWidth, inHeight, outWidth, outHeight );
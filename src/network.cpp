@@ -77,6 +77,8 @@
 #include "huffman.h"
 #include "i_system.h"
 #include "sv_main.h"
+#include "sv_capture.h"
+#include "sv_netthread.h"
 #include "m_random.h"
 #include "network.h"
 #include "sbar.h"
@@ -91,6 +93,7 @@
 
 #include "md5.h"
 #include "network/sv_auth.h"
+#include "network/netcompression.h"
 #include "doomerrors.h"
 
 enum LumpAuthenticationMode {
@@ -556,6 +559,43 @@ int NETWORK_GetPackets( void )
 
 	iSocketFromLength = sizeof( SocketFrom );
 
+	// When replaying a server capture, the packets come from the capture instead of the socket.
+	if ( SERVER_CAPTURE_IsReplaying( ))
+	{
+		ULONG ulSize;
+		if ( SERVER_CAPTURE_ReadPacket( g_AddressFrom, g_NetworkMessage.pbData, g_NetworkMessage.ulMaxSize, ulSize ) == false )
+			return ( 0 );
+
+		g_NetworkMessage.ulCurrentSize = ulSize;
+		g_NetworkMessage.ByteStream.pbStream = g_NetworkMessage.pbData;
+		g_NetworkMessage.ByteStream.pbStreamEnd = g_NetworkMessage.ByteStream.pbStream + g_NetworkMessage.ulCurrentSize;
+		g_NetworkMessage.ByteStream.bitBuffer = NULL;
+		g_NetworkMessage.ByteStream.bitShift = -1;
+		return ( g_NetworkMessage.ulCurrentSize );
+	}
+
+	// The server's network thread already received and decoded the packet.
+	if ( SERVER_NETTHREAD_IsRunning( ))
+	{
+		ULONG ulSize;
+		ULONG ulRawSize;
+		if ( SERVER_NETTHREAD_PopPacket( g_AddressFrom, g_NetworkMessage.pbData, g_NetworkMessage.ulMaxSize, ulSize, ulRawSize ) == false )
+			return ( 0 );
+
+		SERVER_STATISTIC_AddToInboundDataTransfer( ulRawSize );
+
+		g_NetworkMessage.ulCurrentSize = ulSize;
+		g_NetworkMessage.ByteStream.pbStream = g_NetworkMessage.pbData;
+		g_NetworkMessage.ByteStream.pbStreamEnd = g_NetworkMessage.ByteStream.pbStream + g_NetworkMessage.ulCurrentSize;
+		g_NetworkMessage.ByteStream.bitBuffer = NULL;
+		g_NetworkMessage.ByteStream.bitShift = -1;
+
+		if ( SERVER_CAPTURE_IsCapturing( ))
+			SERVER_CAPTURE_RecordPacket( g_AddressFrom, g_NetworkMessage.pbData, g_NetworkMessage.ulCurrentSize );
+
+		return ( g_NetworkMessage.ulCurrentSize );
+	}
+
 	// [BB] If the socket is invalid, there is no point in trying to use it.
 	if ( g_NetworkSocket == INVALID_SOCKET )
 		return ( 0 );
@@ -618,7 +658,8 @@ int NETWORK_GetPackets( void )
 	// [BB] Communication with the auth server is not Huffman-encoded.
 	if ( g_AddressFrom.Compare( NETWORK_AUTH_GetCachedServerAddress() ) == false )
 	{
-		HUFFMAN_Decode( g_ucHuffmanBuffer, (unsigned char *)g_NetworkMessage.pbData, lNumBytes, &iDecodedNumBytes );
+		iDecodedNumBytes = g_NetworkMessage.ulMaxSize;
+		NETWORK_COMPRESSION_Decode( g_ucHuffmanBuffer, (unsigned char *)g_NetworkMessage.pbData, lNumBytes, &iDecodedNumBytes );
 		g_NetworkMessage.ulCurrentSize = iDecodedNumBytes;
 	}
 	else
@@ -633,9 +674,51 @@ int NETWORK_GetPackets( void )
 	g_NetworkMessage.ByteStream.bitBuffer = NULL;
 	g_NetworkMessage.ByteStream.bitShift = -1;
 
+	if ( SERVER_CAPTURE_IsCapturing( ))
+		SERVER_CAPTURE_RecordPacket( g_AddressFrom, g_NetworkMessage.pbData, g_NetworkMessage.ulCurrentSize );
+
 	return ( g_NetworkMessage.ulCurrentSize );
 }
 
+//*****************************************************************************
+//
+// Waits up to iTimeoutMS for a packet and receives it as it is, without
+// decoding it. Returns the size of the packet or 0 if there is none. Unlike
+// the other functions here, this one may be used by another thread than the
+// game thread.
+//
+LONG NETWORK_ReceiveRawPacket( BYTE *pbBuffer, ULONG ulBufferSize, NETADDRESS_s &Address, int iTimeoutMS )
+{
+	sockaddr			SocketFrom;
+	INT					iSocketFromLength = sizeof( SocketFrom );
+	struct timeval		timeout;
+	fd_set				fdset;
+	LONG				lNumBytes;
+
+	if ( g_NetworkSocket == INVALID_SOCKET )
+		return ( 0 );
+
+	FD_ZERO( &fdset );
+	FD_SET( g_NetworkSocket, &fdset );
+	timeout.tv_sec = iTimeoutMS / 1000;
+	timeout.tv_usec = ( iTimeoutMS % 1000 ) * 1000;
+	if ( select( static_cast<int>( g_NetworkSocket ) + 1, &fdset, NULL, NULL, &timeout ) <= 0 )
+		return ( 0 );
+
+#ifdef	WIN32
+	lNumBytes = recvfrom( g_NetworkSocket, (char *)pbBuffer, ulBufferSize, 0, &SocketFrom, &iSocketFromLength );
+#else
+	lNumBytes = recvfrom( g_NetworkSocket, (char *)pbBuffer, ulBufferSize, 0, &SocketFrom, (socklen_t *)&iSocketFromLength );
+#endif
+
+	// Errors are handled like no packet at all, the socket is non-blocking.
+	if ( lNumBytes <= 0 )
+		return ( 0 );
+
+	Address.LoadFromSocketAddress( SocketFrom );
+	return ( lNumBytes );
+}
+
 //*****************************************************************************
 //
 int NETWORK_GetLANPackets( void )
@@ -745,13 +828,17 @@ void NETWORK_LaunchPacket( NETBUFFER_s *pBuffer, NETADDRESS_s Address )
 	if ( pBuffer->ulCurrentSize == 0 )
 		return;
 
+	// Nobody is listening to a replayed server capture.
+	if ( SERVER_CAPTURE_IsReplaying( ))
+		return;
+
 	// Convert the IP address to a socket address.
 	struct sockaddr_in SocketAddress;
 	Address.ToSocketAddress( reinterpret_cast<sockaddr&>(SocketAddress) );
 
 	// [BB] Communication with the auth server is not Huffman-encoded.
 	if ( Address.Compare( NETWORK_AUTH_GetCachedServerAddress() ) == false )
-		HUFFMAN_Encode( (unsigned char *)pBuffer->pbData, g_ucHuffmanBuffer, pBuffer->ulCurrentSize, &iNumBytesOut );
+		NETWORK_COMPRESSION_Encode( Address, (unsigned char *)pBuffer->pbData, g_ucHuffmanBuffer, pBuffer->ulCurrentSize, &iNumBytesOut );
 	else
 	{
 		// [BB] We don't need to encode, so we just copy the data.
@@ -1559,6 +1646,18 @@ void I_DoSelect (void)
     if (do_stdin)
     	FD_SET(0, &fdset);
 
+    // The packets are received by the network thread, only look at the input.
+    if ( SERVER_NETTHREAD_IsRunning( ))
+    {
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 0;
+        if (select (1, &fdset, NULL, NULL, &timeout) == -1)
+            return;
+
+        stdin_ready = FD_ISSET(0, &fdset);
+        return;
+    }
+
     FD_SET(g_NetworkSocket, &fdset);
     timeout.tv_sec = 1;
     timeout.tv_usec = 0;
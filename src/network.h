@@ -253,6 +253,7 @@ void			NETWORK_Construct( USHORT usPort, bool bAllocateLANSocket );
 void			NETWORK_Destruct( void );
 
 int				NETWORK_GetPackets( void );
+LONG			NETWORK_ReceiveRawPacket( BYTE *pbBuffer, ULONG ulBufferSize, NETADDRESS_s &Address, int iTimeoutMS );
 int				NETWORK_GetLANPackets( void );
 NETADDRESS_s	NETWORK_GetFromAddress( void );
 void			NETWORK_LaunchPacket( NETBUFFER_s *pBuffer, NETADDRESS_s Address );
@@ -47,33 +47,50 @@
 //-----------------------------------------------------------------------------
 
 #include "netcommand.h"
+#include "../sv_packetscheduler.h"
 
 //*****************************************************************************
 //
 ClientIterator::ClientIterator ( const ULONG ulPlayerExtra, const ServerCommandFlags flags )
 	: _ulPlayerExtra ( ulPlayerExtra ),
 		_flags ( flags ),
-		_current ( 0 )
+		_ulPosition ( 0 )
 {
+	// Sending to a single client is very common, there is no need to look
+	// through the whole client list for it.
+	if ( _flags & SVCF_ONLYTHISCLIENT )
+	{
+		_pulClients = &_ulPlayerExtra;
+		_ulNumClients = 1;
+	}
+	else
+	{
+		const PLAYERLIST_s &clients = SERVER_GetClientList( );
+		_pulClients = clients.aulPlayers;
+		_ulNumClients = clients.ulNumPlayers;
+	}
+
 	incremntCurrentTillValid();
 }
 
 //*****************************************************************************
 //
 bool ClientIterator::isCurrentValid ( ) const {
-	if ( SERVER_IsValidClient( _current ) == false )
+	const ULONG ulCurrent = **this;
+
+	if ( SERVER_IsValidClient( ulCurrent ) == false )
 		return false;
 
-	if ((( _flags & SVCF_SKIPTHISCLIENT ) && ( _ulPlayerExtra == _current )) ||
-		(( _flags & SVCF_ONLYTHISCLIENT ) && ( _ulPlayerExtra != _current )))
+	if ((( _flags & SVCF_SKIPTHISCLIENT ) && ( _ulPlayerExtra == ulCurrent )) ||
+		(( _flags & SVCF_ONLYTHISCLIENT ) && ( _ulPlayerExtra != ulCurrent )))
 	{
 		return false;
 	}
 
-	if ( ( _flags & SVCF_ONLY_CONNECTIONTYPE_0 ) && ( players[_current].userinfo.GetConnectionType() != 0 ) )
+	if ( ( _flags & SVCF_ONLY_CONNECTIONTYPE_0 ) && ( players[ulCurrent].userinfo.GetConnectionType() != 0 ) )
 		return false;
 
-	if ( ( _flags & SVCF_ONLY_CONNECTIONTYPE_1 ) && ( players[_current].userinfo.GetConnectionType() != 1 ) )
+	if ( ( _flags & SVCF_ONLY_CONNECTIONTYPE_1 ) && ( players[ulCurrent].userinfo.GetConnectionType() != 1 ) )
 		return false;
 
 	return true;
@@ -82,22 +99,22 @@ bool ClientIterator::isCurrentValid ( ) const {
 //*****************************************************************************
 //
 void ClientIterator::incremntCurrentTillValid ( ) {
-	while ( ( isCurrentValid() == false ) && notAtEnd() )
-		++_current;
+	while ( notAtEnd() && ( isCurrentValid() == false ) )
+		++_ulPosition;
 }
 
 //*****************************************************************************
 //
 ULONG ClientIterator::operator* ( ) const {
-	return ( _current );
+	return ( _pulClients[_ulPosition] );
 }
 
 //*****************************************************************************
 //
 ULONG ClientIterator::operator++ ( ) {
-	++_current;
+	++_ulPosition;
 	incremntCurrentTillValid();
-	return ( _current );
+	return ( notAtEnd() ? **this : MAXPLAYERS );
 }
 
 //*****************************************************************************
@@ -285,6 +302,10 @@ void NetCommand::sendCommandToClients ( ULONG ulPlayerExtra, ServerCommandFlags
 //
 void NetCommand::sendCommandToOneClient( ULONG i )
 {
+	// Unreliable commands are queued by the packet scheduler if it's enabled.
+	if ( _unreliable && SERVER_PACKETSCHEDULER_QueueCommand( i, _buffer ))
+		return;
+
 	SERVER_CheckClientBuffer( i, _buffer.ulCurrentSize, _unreliable == false );
 
 	// [BB] 5 = 1 + 4 (SVC_HEADER + packet number)
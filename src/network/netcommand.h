@@ -53,12 +53,17 @@
 /**
  * \brief Iterate over all clients, possibly skipping one or all but one.
  *
+ * Only the clients in the server's dense client list are visited, so the cost
+ * depends on the number of connected clients and not on MAXPLAYERS.
+ *
  * \author Benjamin Berkels
  */
 class ClientIterator {
 	const ULONG _ulPlayerExtra;
 	const ServerCommandFlags _flags;
-	ULONG _current;
+	const ULONG *_pulClients;
+	ULONG _ulNumClients;
+	ULONG _ulPosition;
 
 	void incremntCurrentTillValid ( );
 
@@ -69,7 +74,7 @@ public:
 	ClientIterator ( const ULONG ulPlayerExtra = MAXPLAYERS, const ServerCommandFlags flags = 0 );
 
 	inline bool notAtEnd ( ) const {
-		return ( _current < MAXPLAYERS );
+		return ( _ulPosition < _ulNumClients );
 	}
 
 	ULONG operator* ( ) const;
@@ -0,0 +1,654 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: netcompression.cpp
+//
+// Description: Optional deflate compression of the game packets with a preset
+// dictionary, negotiated per connection.
+//
+// The static Huffman table only removes the redundancy of single bytes. Game
+// packets mostly consist of the same command headers, player numbers and
+// coordinates over and over again, which deflate handles much better. Every
+// packet is compressed on its own, since packets may get lost or arrive in any
+// order. To make this worthwhile for packets of a few hundred bytes, deflate is
+// started with a preset dictionary that contains byte sequences typical for
+// Zandronum traffic. The dictionary is read from the NETDICT lump and can be
+// trained from sampled traffic with net_traindictionary.
+//
+// A client offers compression in its connection request together with the ID
+// of its dictionary. If the server uses the same dictionary, it tells the
+// client so and from then on, both sides send deflated packets to each other
+// whenever they are smaller than the Huffman encoded ones. Deflated packets
+// start with a byte the Huffman encoder never writes there, so every packet
+// can be decoded without knowing the connection.
+//
+//-----------------------------------------------------------------------------
+
+#include <zlib.h>
+#include <queue>
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "huffman.h"
+#include "i_system.h"
+#include "stats.h"
+#include "w_wad.h"
+#include "network.h"
+#include "netcompression.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// The first byte of a deflated packet. The Huffman encoder only writes 0-7
+// (the padding bits) or 0xFF (not encoded) there.
+#define	DEFLATED_PACKET_MARKER		0xFE
+
+// Smaller packets are always Huffman encoded.
+#define	MIN_DEFLATE_SIZE			64
+
+// The deflate parameters, these have to be the same on both sides. The window
+// is kept small, since setting up the dictionary for each packet costs time
+// in proportion to it.
+#define	DEFLATE_LEVEL				6
+#define	DEFLATE_WINDOW_BITS			13
+#define	DEFLATE_MEM_LEVEL			5
+
+// The size of the dictionaries net_traindictionary builds.
+#define	MAX_DICTIONARY_SIZE			4096
+
+// The dictionary is built from segments of the sampled packets of this
+// size that contain the most common sequences of DICTIONARY_GRAM_SIZE bytes.
+#define	DICTIONARY_SEGMENT_SIZE		32
+#define	DICTIONARY_GRAM_SIZE		6
+
+#define	MAX_SAMPLED_PACKETS			8192
+
+//*****************************************************************************
+//	STRUCTURES
+
+struct DICTIONARYSEGMENT_s
+{
+	ULONG	ulSample;
+	ULONG	ulOffset;
+	ULONG	ulLength;
+	ULONG	ulScore;
+
+	bool operator< ( const DICTIONARYSEGMENT_s &Other ) const
+	{
+		return ( ulScore < Other.ulScore );
+	}
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+static	TArray<BYTE>				g_Dictionary;
+static	ULONG						g_ulDictionaryID;
+static	bool						g_bDictionaryLoaded = false;
+
+// The peers that accepted compression.
+static	TArray<NETADDRESS_s>		g_CompressedAddresses;
+
+static	z_stream					g_DeflateStream;
+
+// Only used by the thread that decodes incoming packets, which is the network
+// thread when -netthread is used. Anything else needs a stream of its own.
+static	z_stream					g_InflateStream;
+static	bool						g_bStreamsInitialized = false;
+
+// Uncompressed outgoing packets sampled for net_traindictionary and
+// net_benchcompression.
+static	TArray<TArray<BYTE> >		g_SampledPackets;
+static	ULONG						g_ulPacketsToSample = 0;
+
+// Statistics for "stat netcompression".
+static	ULONG						g_ulDeflatedPackets;
+static	ULONG						g_ulHuffmanPackets;
+static	ULONG						g_ulDeflatedBytesIn;
+static	ULONG						g_ulDeflatedBytesOut;
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	void			network_compression_LoadDictionary( void );
+static	void			network_compression_InitStreams( void );
+static	bool			network_compression_Deflate( const BYTE *pbInput, int iInputSize, BYTE *pbOutput, int iOutputSize, int *piDeflatedSize, const TArray<BYTE> &Dictionary );
+static	bool			network_compression_Inflate( z_stream &Stream, const BYTE *pbInput, int iInputSize, BYTE *pbOutput, int iOutputSize, int *piInflatedSize, const TArray<BYTE> &Dictionary );
+static	bool			network_compression_IsEnabledFor( const NETADDRESS_s &Address );
+static	void			network_compression_TrainDictionary( ULONG ulFirstSample, ULONG ulNumSamples, TArray<BYTE> &Dictionary );
+
+//*****************************************************************************
+//	FUNCTIONS
+
+//*****************************************************************************
+//
+// Loads the dictionary and sets up the zlib streams right away instead of on
+// first use. Needed before another thread decodes packets.
+//
+void NETWORK_COMPRESSION_Construct( void )
+{
+	network_compression_LoadDictionary( );
+	network_compression_InitStreams( );
+}
+
+//*****************************************************************************
+//
+// Returns the ID the client sends in its connection request. It's the CRC32 of
+// the dictionary, or 0 if there is none.
+//
+ULONG NETWORK_COMPRESSION_GetDictionaryID( void )
+{
+	network_compression_LoadDictionary( );
+	return ( g_ulDictionaryID );
+}
+
+//*****************************************************************************
+//
+void NETWORK_COMPRESSION_EnableForAddress( const NETADDRESS_s &Address, bool bEnable )
+{
+	for ( unsigned int i = 0; i < g_CompressedAddresses.Size( ); i++ )
+	{
+		if ( g_CompressedAddresses[i].Compare( Address ) == false )
+			continue;
+
+		if ( bEnable == false )
+			g_CompressedAddresses.Delete( i );
+		return;
+	}
+
+	if ( bEnable )
+		g_CompressedAddresses.Push( Address );
+}
+
+//*****************************************************************************
+//
+void NETWORK_COMPRESSION_ClearAddresses( void )
+{
+	g_CompressedAddresses.Clear( );
+}
+
+//*****************************************************************************
+//
+// Encodes an outgoing packet. Packets to peers that accepted compression are
+// deflated if that makes them smaller than Huffman encoding. On entry,
+// piOutputSize holds the size of pbOutput.
+//
+void NETWORK_COMPRESSION_Encode( const NETADDRESS_s &Address, const BYTE *pbInput, BYTE *pbOutput, int iInputSize, int *piOutputSize )
+{
+	if (( g_ulPacketsToSample > 0 ) && ( iInputSize > 0 ))
+	{
+		TArray<BYTE> &sample = g_SampledPackets[g_SampledPackets.Reserve( 1 )];
+		sample.Resize( iInputSize );
+		memcpy( &sample[0], pbInput, iInputSize );
+
+		if ( --g_ulPacketsToSample == 0 )
+			Printf( "Sampled %u packets.\n", g_SampledPackets.Size( ));
+	}
+
+	HUFFMAN_Encode( pbInput, pbOutput, iInputSize, piOutputSize );
+
+	if (( iInputSize < MIN_DEFLATE_SIZE ) || ( *piOutputSize <= 2 ) || ( network_compression_IsEnabledFor( Address ) == false ))
+		return;
+
+	// Only use the deflated packet if it's smaller than the Huffman encoded one.
+	BYTE	abDeflated[MAX_UDP_PACKET];
+	int		iDeflatedSize;
+
+	if ( network_compression_Deflate( pbInput, iInputSize, abDeflated + 1, MIN<int>( *piOutputSize - 2, sizeof( abDeflated ) - 1 ), &iDeflatedSize, g_Dictionary ))
+	{
+		abDeflated[0] = DEFLATED_PACKET_MARKER;
+		memcpy( pbOutput, abDeflated, iDeflatedSize + 1 );
+		*piOutputSize = iDeflatedSize + 1;
+
+		g_ulDeflatedPackets++;
+		g_ulDeflatedBytesIn += iInputSize;
+		g_ulDeflatedBytesOut += *piOutputSize;
+	}
+	else
+		g_ulHuffmanPackets++;
+}
+
+//*****************************************************************************
+//
+// Decodes an incoming packet, deflated or Huffman encoded. On entry,
+// piOutputSize holds the size of pbOutput, it's set to 0 if the packet is
+// invalid.
+//
+void NETWORK_COMPRESSION_Decode( const BYTE *pbInput, BYTE *pbOutput, int iInputSize, int *piOutputSize )
+{
+	if (( iInputSize == 0 ) || ( pbInput[0] != DEFLATED_PACKET_MARKER ))
+	{
+		HUFFMAN_Decode( pbInput, pbOutput, iInputSize, piOutputSize );
+		return;
+	}
+
+	network_compression_LoadDictionary( );
+
+	if ( network_compression_Inflate( g_InflateStream, pbInput + 1, iInputSize - 1, pbOutput, *piOutputSize, piOutputSize, g_Dictionary ) == false )
+		*piOutputSize = 0;
+}
+
+//*****************************************************************************
+//
+static void network_compression_LoadDictionary( void )
+{
+	// The lumps aren't loaded yet.
+	if ( g_bDictionaryLoaded || ( Wads.GetNumLumps( ) == 0 ))
+		return;
+
+	g_bDictionaryLoaded = true;
+	g_Dictionary.Clear( );
+	g_ulDictionaryID = 0;
+
+	const int lump = Wads.CheckNumForName( "NETDICT" );
+	if ( lump < 0 )
+		return;
+
+	const int length = MIN<int>( Wads.LumpLength( lump ), 1 << DEFLATE_WINDOW_BITS );
+	if ( length <= 0 )
+		return;
+
+	FMemLump data = Wads.ReadLump( lump );
+	g_Dictionary.Resize( length );
+	memcpy( &g_Dictionary[0], data.GetMem( ), length );
+	g_ulDictionaryID = crc32( 0, &g_Dictionary[0], length );
+}
+
+//*****************************************************************************
+//
+static void network_compression_InitStreams( void )
+{
+	if ( g_bStreamsInitialized )
+		return;
+
+	memset( &g_DeflateStream, 0, sizeof( g_DeflateStream ));
+	memset( &g_InflateStream, 0, sizeof( g_InflateStream ));
+
+	// Negative window bits give raw deflate streams, the packets don't need
+	// a zlib header or checksum.
+	if (( deflateInit2( &g_DeflateStream, DEFLATE_LEVEL, Z_DEFLATED, -DEFLATE_WINDOW_BITS, DEFLATE_MEM_LEVEL, Z_DEFAULT_STRATEGY ) != Z_OK ) ||
+		( inflateInit2( &g_InflateStream, -DEFLATE_WINDOW_BITS ) != Z_OK ))
+	{
+		I_Error( "network_compression_InitStreams: Couldn't initialize zlib.\n" );
+	}
+
+	g_bStreamsInitialized = true;
+}
+
+//*****************************************************************************
+//
+static bool network_compression_Deflate( const BYTE *pbInput, int iInputSize, BYTE *pbOutput, int iOutputSize, int *piDeflatedSize, const TArray<BYTE> &Dictionary )
+{
+	network_compression_InitStreams( );
+
+	if (( deflateReset( &g_DeflateStream ) != Z_OK ) || ( iOutputSize <= 0 ))
+		return ( false );
+
+	if ( Dictionary.Size( ) > 0 )
+		deflateSetDictionary( &g_DeflateStream, &Dictionary[0], Dictionary.Size( ));
+
+	g_DeflateStream.next_in = const_cast<BYTE *>( pbInput );
+	g_DeflateStream.avail_in = iInputSize;
+	g_DeflateStream.next_out = pbOutput;
+	g_DeflateStream.avail_out = iOutputSize;
+
+	// Anything but Z_STREAM_END means that the output didn't fit.
+	if ( deflate( &g_DeflateStream, Z_FINISH ) != Z_STREAM_END )
+		return ( false );
+
+	*piDeflatedSize = iOutputSize - g_DeflateStream.avail_out;
+	return ( true );
+}
+
+//*****************************************************************************
+//
+static bool network_compression_Inflate( z_stream &Stream, const BYTE *pbInput, int iInputSize, BYTE *pbOutput, int iOutputSize, int *piInflatedSize, const TArray<BYTE> &Dictionary )
+{
+	network_compression_InitStreams( );
+
+	if ( inflateReset( &Stream ) != Z_OK )
+		return ( false );
+
+	if ( Dictionary.Size( ) > 0 )
+		inflateSetDictionary( &Stream, &Dictionary[0], Dictionary.Size( ));
+
+	Stream.next_in = const_cast<BYTE *>( pbInput );
+	Stream.avail_in = iInputSize;
+	Stream.next_out = pbOutput;
+	Stream.avail_out = iOutputSize;
+
+	if ( inflate( &Stream, Z_FINISH ) != Z_STREAM_END )
+		return ( false );
+
+	*piInflatedSize = iOutputSize - Stream.avail_out;
+	return ( true );
+}
+
+//*****************************************************************************
+//
+static bool network_compression_IsEnabledFor( const NETADDRESS_s &Address )
+{
+	for ( unsigned int i = 0; i < g_CompressedAddresses.Size( ); i++ )
+	{
+		if ( g_CompressedAddresses[i].Compare( Address ))
+			return ( true );
+	}
+
+	return ( false );
+}
+
+//*****************************************************************************
+//
+static DWORD network_compression_HashGram( const BYTE *pbGram )
+{
+	DWORD hash = 2166136261u;
+
+	for ( int i = 0; i < DICTIONARY_GRAM_SIZE; i++ )
+		hash = ( hash ^ pbGram[i] ) * 16777619u;
+
+	return ( hash );
+}
+
+//*****************************************************************************
+//
+static ULONG network_compression_ScoreSegment( const DICTIONARYSEGMENT_s &Segment, TMap<DWORD, DWORD> &GramCounts )
+{
+	const BYTE	*pbData = &g_SampledPackets[Segment.ulSample][Segment.ulOffset];
+	ULONG		ulScore = 0;
+
+	for ( ULONG ulIdx = 0; ulIdx + DICTIONARY_GRAM_SIZE <= Segment.ulLength; ulIdx++ )
+	{
+		DWORD *pCount = GramCounts.CheckKey( network_compression_HashGram( pbData + ulIdx ));
+		if ( pCount != NULL )
+			ulScore += *pCount;
+	}
+
+	return ( ulScore );
+}
+
+//*****************************************************************************
+//
+// Builds a dictionary from the given sampled packets. Every sequence of
+// DICTIONARY_GRAM_SIZE bytes is worth as much as it's common in the samples.
+// The segments of the samples worth the most are put into the dictionary, but
+// each sequence only counts for the first segment that contains it. The best
+// segments are put at the end of the dictionary, where deflate can refer to
+// them with the shortest distances.
+//
+static void network_compression_TrainDictionary( ULONG ulFirstSample, ULONG ulNumSamples, TArray<BYTE> &Dictionary )
+{
+	TMap<DWORD, DWORD>						gramCounts;
+	std::priority_queue<DICTIONARYSEGMENT_s>	candidates;
+	TArray<DICTIONARYSEGMENT_s>				selected;
+	ULONG									ulTotalLength = 0;
+
+	for ( ULONG ulSample = ulFirstSample; ulSample < ulFirstSample + ulNumSamples; ulSample++ )
+	{
+		const TArray<BYTE> &sample = g_SampledPackets[ulSample];
+
+		for ( ULONG ulIdx = 0; ulIdx + DICTIONARY_GRAM_SIZE <= sample.Size( ); ulIdx++ )
+			gramCounts[network_compression_HashGram( &sample[ulIdx] )]++;
+	}
+
+	for ( ULONG ulSample = ulFirstSample; ulSample < ulFirstSample + ulNumSamples; ulSample++ )
+	{
+		const ULONG ulSize = g_SampledPackets[ulSample].Size( );
+
+		for ( ULONG ulOffset = 0; ulOffset + DICTIONARY_GRAM_SIZE <= ulSize; ulOffset += DICTIONARY_SEGMENT_SIZE / 2 )
+		{
+			DICTIONARYSEGMENT_s segment;
+			segment.ulSample = ulSample;
+			segment.ulOffset = ulOffset;
+			segment.ulLength = MIN<ULONG>( DICTIONARY_SEGMENT_SIZE, ulSize - ulOffset );
+			segment.ulScore = network_compression_ScoreSegment( segment, gramCounts );
+			candidates.push( segment );
+		}
+	}
+
+	// The scores only go down as segments are selected, so a segment whose
+	// updated score is still the best one can be taken right away.
+	while (( candidates.empty( ) == false ) && ( ulTotalLength < MAX_DICTIONARY_SIZE ))
+	{
+		DICTIONARYSEGMENT_s segment = candidates.top( );
+		candidates.pop( );
+
+		segment.ulScore = network_compression_ScoreSegment( segment, gramCounts );
+		if ( segment.ulScore == 0 )
+			continue;
+
+		if (( candidates.empty( ) == false ) && ( segment.ulScore < candidates.top( ).ulScore ))
+		{
+			candidates.push( segment );
+			continue;
+		}
+
+		selected.Push( segment );
+		ulTotalLength += segment.ulLength;
+
+		const BYTE *pbData = &g_SampledPackets[segment.ulSample][segment.ulOffset];
+		for ( ULONG ulIdx = 0; ulIdx + DICTIONARY_GRAM_SIZE <= segment.ulLength; ulIdx++ )
+			gramCounts[network_compression_HashGram( pbData + ulIdx )] = 0;
+	}
+
+	Dictionary.Clear( );
+	for ( int i = static_cast<int>( selected.Size( )) - 1; i >= 0; i-- )
+	{
+		const DICTIONARYSEGMENT_s	&segment = selected[i];
+		const ULONG					ulOffset = Dictionary.Size( );
+
+		Dictionary.Resize( ulOffset + segment.ulLength );
+		memcpy( &Dictionary[ulOffset], &g_SampledPackets[segment.ulSample][segment.ulOffset], segment.ulLength );
+	}
+
+	if ( Dictionary.Size( ) > MAX_DICTIONARY_SIZE )
+		Dictionary.Delete( 0, Dictionary.Size( ) - MAX_DICTIONARY_SIZE );
+}
+
+//*****************************************************************************
+//	CONSOLE VARIABLES
+
+// Whether the server accepts compression offered by the clients.
+CVAR( Bool, sv_netcompression, true, CVAR_ARCHIVE|CVAR_NOSETBYACS )
+
+// Whether the client offers compression to the servers.
+CVAR( Bool, cl_netcompression, true, CVAR_ARCHIVE )
+
+//*****************************************************************************
+//	CONSOLE COMMANDS
+
+// Samples the next outgoing packets for net_traindictionary and
+// net_benchcompression.
+CCMD( net_samplepackets )
+{
+	if ( argv.argc( ) < 2 )
+	{
+		Printf( "Usage: net_samplepackets <number of packets>\n" );
+		return;
+	}
+
+	g_SampledPackets.Clear( );
+	g_ulPacketsToSample = clamp<int>( atoi( argv[1] ), 0, MAX_SAMPLED_PACKETS );
+	Printf( "Sampling the next %lu outgoing packets.\n", g_ulPacketsToSample );
+}
+
+//*****************************************************************************
+//
+// Builds a dictionary from the sampled packets and saves it. To use it, it has
+// to be added as NETDICT lump to zandronum.pk3, both the servers and the
+// clients need the same one.
+//
+CCMD( net_traindictionary )
+{
+	if ( argv.argc( ) < 2 )
+	{
+		Printf( "Usage: net_traindictionary <file>\n" );
+		return;
+	}
+
+	if ( g_SampledPackets.Size( ) == 0 )
+	{
+		Printf( "No packets sampled, use net_samplepackets first.\n" );
+		return;
+	}
+
+	TArray<BYTE> dictionary;
+	network_compression_TrainDictionary( 0, g_SampledPackets.Size( ), dictionary );
+
+	FILE *pFile = fopen( argv[1], "wb" );
+	if ( pFile == NULL )
+	{
+		Printf( "Couldn't open %s for writing.\n", argv[1] );
+		return;
+	}
+
+	if ( dictionary.Size( ) > 0 )
+		fwrite( &dictionary[0], 1, dictionary.Size( ), pFile );
+	fclose( pFile );
+
+	Printf( "Wrote a dictionary of %u bytes from %u packets to %s (ID %08lx).\n", dictionary.Size( ), g_SampledPackets.Size( ), argv[1],
+		dictionary.Size( ) ? static_cast<ULONG>( crc32( 0, &dictionary[0], dictionary.Size( ))) : 0UL );
+}
+
+//*****************************************************************************
+//
+// Compares the size and the encoding time of the sampled packets with Huffman
+// encoding, deflate without a dictionary, deflate with the NETDICT dictionary
+// and deflate with a dictionary trained from the first half of the samples.
+// The latter is measured on the second half only.
+//
+CCMD( net_benchcompression )
+{
+	const ULONG ulNumSamples = g_SampledPackets.Size( );
+
+	if ( ulNumSamples < 2 )
+	{
+		Printf( "Not enough packets sampled, use net_samplepackets first.\n" );
+		return;
+	}
+
+	network_compression_LoadDictionary( );
+
+	// g_InflateStream may be in use by the network thread right now.
+	z_stream		inflateStream;
+	memset( &inflateStream, 0, sizeof( inflateStream ));
+	if ( inflateInit2( &inflateStream, -DEFLATE_WINDOW_BITS ) != Z_OK )
+	{
+		Printf( "Couldn't initialize zlib.\n" );
+		return;
+	}
+
+	TArray<BYTE>	noDictionary;
+	TArray<BYTE>	trainedDictionary;
+	cycle_t			trainingTime;
+
+	trainingTime.Reset( );
+	trainingTime.Clock( );
+	network_compression_TrainDictionary( 0, ulNumSamples / 2, trainedDictionary );
+	trainingTime.Unclock( );
+
+	const char		*apszMethods[] = { "Huffman", "Deflate", "Deflate + NETDICT", "Deflate + trained" };
+	const ULONG		ulNumMethods = countof( apszMethods );
+
+	for ( ULONG ulMethod = 0; ulMethod < ulNumMethods; ulMethod++ )
+	{
+		const TArray<BYTE>	&dictionary = ( ulMethod == 2 ) ? g_Dictionary : ( ulMethod == 3 ) ? trainedDictionary : noDictionary;
+		const ULONG			ulFirstSample = ( ulMethod == 3 ) ? ulNumSamples / 2 : 0;
+		ULONG				ulBytesIn = 0;
+		ULONG				ulBytesOut = 0;
+		cycle_t				encodeTime;
+		cycle_t				decodeTime;
+		BYTE				abEncoded[MAX_UDP_PACKET * 2];
+		BYTE				abDecoded[MAX_UDP_PACKET * 2];
+
+		if (( ulMethod == 2 ) && ( g_Dictionary.Size( ) == 0 ))
+		{
+			Printf( "%s: no NETDICT lump loaded\n", apszMethods[ulMethod] );
+			continue;
+		}
+
+		encodeTime.Reset( );
+		decodeTime.Reset( );
+
+		for ( ULONG ulSample = ulFirstSample; ulSample < ulNumSamples; ulSample++ )
+		{
+			const TArray<BYTE>	&sample = g_SampledPackets[ulSample];
+			int					iEncodedSize = sizeof( abEncoded );
+			int					iDecodedSize = sizeof( abDecoded );
+
+			encodeTime.Clock( );
+			if ( ulMethod == 0 )
+				HUFFMAN_Encode( &sample[0], abEncoded, sample.Size( ), &iEncodedSize );
+			else if ( network_compression_Deflate( &sample[0], sample.Size( ), abEncoded, sizeof( abEncoded ), &iEncodedSize, dictionary ) == false )
+				iEncodedSize = 0;
+			encodeTime.Unclock( );
+
+			decodeTime.Clock( );
+			if ( ulMethod == 0 )
+				HUFFMAN_Decode( abEncoded, abDecoded, iEncodedSize, &iDecodedSize );
+			else
+				network_compression_Inflate( inflateStream, abEncoded, iEncodedSize, abDecoded, sizeof( abDecoded ), &iDecodedSize, dictionary );
+			decodeTime.Unclock( );
+
+			ulBytesIn += sample.Size( );
+			ulBytesOut += iEncodedSize;
+		}
+
+		const ULONG ulPackets = ulNumSamples - ulFirstSample;
+		Printf( "%s: %lu packets, %lu -> %lu bytes (%.1f%%), %.2f us to encode, %.2f us to decode per packet\n",
+			apszMethods[ulMethod], ulPackets, ulBytesIn, ulBytesOut, ulBytesIn ? 100.0 * ulBytesOut / ulBytesIn : 0.0,
+			encodeTime.TimeMS( ) * 1000.0 / ulPackets, decodeTime.TimeMS( ) * 1000.0 / ulPackets );
+	}
+
+	Printf( "Training the dictionary from %lu packets took %.2f ms.\n", ulNumSamples / 2, trainingTime.TimeMS( ));
+	inflateEnd( &inflateStream );
+}
+
+//*****************************************************************************
+//	STATISTICS
+
+ADD_STAT( netcompression )
+{
+	FString	out;
+
+	out.Format( "%u peers, dictionary %08lx, %lu packets deflated (%lu -> %lu bytes), %lu Huffman encoded",
+		g_CompressedAddresses.Size( ), g_ulDictionaryID, g_ulDeflatedPackets, g_ulDeflatedBytesIn, g_ulDeflatedBytesOut, g_ulHuffmanPackets );
+	return ( out );
+}
@@ -380,6 +380,9 @@ BEGIN_ENUM( SVC2 )
 	ENUM_ELEMENT ( SVC2_SRP_USER_PROCESS_CHALLENGE ),
 	ENUM_ELEMENT ( SVC2_SRP_USER_VERIFY_SESSION ),
 	ENUM_ELEMENT ( SVC2_RCONACCESS ),
+	ENUM_ELEMENT ( SVC2_ACTORSNAPSHOT ),
+	ENUM_ELEMENT ( SVC2_ACTORDELTA ),
+	ENUM_ELEMENT ( SVC2_SETNETCOMPRESSION ),
 
 	ENUM_ELEMENT ( NUM_SVC2_COMMANDS ),
 }
@@ -450,6 +453,7 @@ BEGIN_ENUM( CLC )
 	ENUM_ELEMENT( CLC_SETWANTHIDEACCOUNT ),
 	ENUM_ELEMENT( CLC_SETVIDEORESOLUTION ),
 	ENUM_ELEMENT( CLC_RCONSETCVAR ),
+	ENUM_ELEMENT( CLC_ACKACTORSNAPSHOT ),
 
 	ENUM_ELEMENT( NUM_CLIENT_COMMANDS )
 }
@@ -63,6 +63,23 @@ static	bool	g_MeasuringOutboundTraffic = false;
 // [BB] Number of bytes sent by NETWORK_Write* since NETWORK_StartTrafficMeasurement() was called.
 static	int		g_OutboundBytesMeasured = 0;
 
+// Packet sized buffers are taken from and returned to a free list instead of
+// being allocated every time, since NetCommand creates one per command. The
+// first bytes of a free block point to the next one. Each thread has its own
+// list, buffers aren't passed between threads.
+#define	MAX_POOLED_PACKET_BUFFERS	64
+
+struct POOLEDPACKETBUFFER_s
+{
+	POOLEDPACKETBUFFER_s	*pNext;
+};
+
+static	thread_local	POOLEDPACKETBUFFER_s	*g_pFreePacketBuffers = NULL;
+static	thread_local	ULONG					g_ulNumFreePacketBuffers = 0;
+static	thread_local	ULONG					g_ulPacketBuffersReused = 0;
+static	thread_local	ULONG					g_ulPacketBuffersAllocated = 0;
+static	bool									g_bPoolPacketBuffers = true;
+
 //*****************************************************************************
 //
 extern std::ostream &operator<< ( std::ostream &os, const IPStringArray &input ) {
@@ -103,8 +120,19 @@ void NETBUFFER_s::Init( ULONG ulLength, BUFFERTYPE_e BufferType )
 {
 	memset( this, 0, sizeof( *this ));
 	this->ulMaxSize = ulLength;
-	this->pbData = new BYTE[ulLength];
 	this->BufferType = BufferType;
+
+	if (( ulLength == MAX_UDP_PACKET ) && ( g_pFreePacketBuffers != NULL ))
+	{
+		this->pbData = reinterpret_cast<BYTE *>( g_pFreePacketBuffers );
+		g_pFreePacketBuffers = g_pFreePacketBuffers->pNext;
+		g_ulNumFreePacketBuffers--;
+		g_ulPacketBuffersReused++;
+		return;
+	}
+
+	this->pbData = new BYTE[ulLength];
+	g_ulPacketBuffersAllocated++;
 }
 
 //*****************************************************************************
@@ -113,7 +141,16 @@ void NETBUFFER_s::Free()
 {
 	if ( this->pbData )
 	{
-		delete[] ( this->pbData );
+		if (( this->ulMaxSize == MAX_UDP_PACKET ) && g_bPoolPacketBuffers && ( g_ulNumFreePacketBuffers < MAX_POOLED_PACKET_BUFFERS ))
+		{
+			POOLEDPACKETBUFFER_s *pBlock = reinterpret_cast<POOLEDPACKETBUFFER_s *>( this->pbData );
+			pBlock->pNext = g_pFreePacketBuffers;
+			g_pFreePacketBuffers = pBlock;
+			g_ulNumFreePacketBuffers++;
+		}
+		else
+			delete[] ( this->pbData );
+
 		this->pbData = NULL;
 	}
 
@@ -181,6 +218,37 @@ int NETWORK_StopTrafficMeasurement ( )
 	return g_OutboundBytesMeasured;
 }
 
+//*****************************************************************************
+//
+// Turns the pooling of packet sized buffers on or off. Only meant to compare
+// the two in benchmarks.
+//
+void NETWORK_SetPacketBufferPooling ( bool bEnable )
+{
+	g_bPoolPacketBuffers = bEnable;
+
+	// Empty the pool, so that every buffer is allocated again.
+	if ( bEnable == false )
+	{
+		while ( g_pFreePacketBuffers != NULL )
+		{
+			POOLEDPACKETBUFFER_s *pBlock = g_pFreePacketBuffers;
+			g_pFreePacketBuffers = pBlock->pNext;
+			delete[] reinterpret_cast<BYTE *>( pBlock );
+		}
+
+		g_ulNumFreePacketBuffers = 0;
+	}
+}
+
+//*****************************************************************************
+//
+void NETWORK_GetPacketBufferPoolStats ( ULONG &ulReused, ULONG &ulAllocated )
+{
+	ulReused = g_ulPacketBuffersReused;
+	ulAllocated = g_ulPacketBuffersAllocated;
+}
+
 //================================================================================
 // IO read functions
 //================================================================================
@@ -395,6 +395,8 @@ struct NETBUFFER_s
 
 void			NETWORK_StartTrafficMeasurement ( );
 int				NETWORK_StopTrafficMeasurement ( );
+void			NETWORK_SetPacketBufferPooling ( bool bEnable );
+void			NETWORK_GetPacketBufferPoolStats ( ULONG &ulReused, ULONG &ulAllocated );
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- CLASSES ---------------------------------------------------------------------------------------------------------------------------------------
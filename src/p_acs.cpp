@@ -399,6 +399,13 @@ FACSStack::~FACSStack()
 // in its local and map variables are unlocked. Locking and unlocking are
 // cumulative operations.
 //
+// Most dynamic strings only live for a tic or two. Strings that were added
+// since the last collection are young, and once there are enough of them
+// (acs_younggcthreshold), they alone are collected at the end of the tic.
+// Strings that survive this become old and are only freed by a full
+// collection. The characters themselves are kept in an arena instead of
+// separate heap blocks.
+//
 // What this all means is that:
 //   * Strings returned by strparam last indefinitely. No longer do they
 //     disappear at the end of the tic they were generated.
@@ -410,6 +417,10 @@ FACSStack::~FACSStack()
 
 ACSStringPool GlobalACSStrings;
 
+// Number of strings created since the last collection that triggers a
+// collection of just those strings at the end of the tic. 0 disables this.
+CVAR( Int, acs_younggcthreshold, 1024, CVAR_ARCHIVE | CVAR_NOSETBYACS )
+
 // [BB] Extracted from PCD_SAVESTRING.
 int ACS_PushAndReturnDynamicString ( const FString &Work )
 {
@@ -419,7 +430,18 @@ int ACS_PushAndReturnDynamicString ( const FString &Work )
 ACSStringPool::ACSStringPool()
 {
 	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
+	memset(FreeChunks, 0, sizeof(FreeChunks));
 	FirstFreeEntry = 0;
+	MarkYoungOnly = false;
+	UsedBytes = 0;
+	NumMinorCollections = NumFullCollections = 0;
+	LastFreedCount = 0;
+	LastMinorMS = LastFullMS = MaxMinorMS = MaxFullMS = 0;
+}
+
+ACSStringPool::~ACSStringPool()
+{
+	Clear();
 }
 
 //============================================================================
@@ -432,9 +454,93 @@ ACSStringPool::ACSStringPool()
 
 void ACSStringPool::Clear()
 {
+	// Only strings too big for the arena need to be freed individually.
+	for (unsigned int i = 0; i < Pool.Size(); ++i)
+	{
+		if (Pool[i].Next != FREE_ENTRY && Pool[i].Len >= (1u << (MIN_CHUNK_SHIFT + NUM_CHUNK_SIZES - 1)))
+		{
+			M_Free(Pool[i].Str);
+		}
+	}
 	Pool.Clear();
+	YoungEntries.Clear();
+	CharArena.FreeAll();
+	memset(FreeChunks, 0, sizeof(FreeChunks));
 	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
 	FirstFreeEntry = 0;
+	UsedBytes = 0;
+}
+
+//============================================================================
+//
+// ACSStringPool :: AllocChars
+//
+// Copies a string's characters into the arena. Chunks are rounded up to a
+// power of two so that freed ones can be reused by any string of a similar
+// length.
+//
+//============================================================================
+
+char *ACSStringPool::AllocChars(const char *str, size_t len)
+{
+	char *chars = NULL;
+	unsigned int sizeclass = 0;
+
+	while (sizeclass < NUM_CHUNK_SIZES && len >= (1u << (MIN_CHUNK_SHIFT + sizeclass)))
+	{
+		sizeclass++;
+	}
+	if (sizeclass == NUM_CHUNK_SIZES)
+	{ // Too big for the arena.
+		chars = (char *)M_Malloc(len + 1);
+		UsedBytes += len + 1;
+	}
+	else
+	{
+		size_t chunksize = 1u << (MIN_CHUNK_SHIFT + sizeclass);
+		chars = FreeChunks[sizeclass];
+		if (chars != NULL)
+		{
+			FreeChunks[sizeclass] = *(char **)chars;
+		}
+		else
+		{
+			chars = (char *)CharArena.Alloc(chunksize);
+		}
+		UsedBytes += chunksize;
+	}
+	memcpy(chars, str, len);
+	chars[len] = '\0';
+	return chars;
+}
+
+//============================================================================
+//
+// ACSStringPool :: FreeChars
+//
+// Returns a string's characters to the free list for its chunk size.
+//
+//============================================================================
+
+void ACSStringPool::FreeChars(char *chars, size_t len)
+{
+	unsigned int sizeclass = 0;
+
+	while (sizeclass < NUM_CHUNK_SIZES && len >= (1u << (MIN_CHUNK_SHIFT + sizeclass)))
+	{
+		sizeclass++;
+	}
+	if (sizeclass == NUM_CHUNK_SIZES)
+	{
+		M_Free(chars);
+		UsedBytes -= len + 1;
+	}
+	else
+	{
+		*(char **)chars = FreeChunks[sizeclass];
+		FreeChunks[sizeclass] = chars;
+		UsedBytes -= 1u << (MIN_CHUNK_SHIFT + sizeclass);
+	}
 }
 
 //============================================================================
@@ -456,8 +562,10 @@ int ACSStringPool::AddString(const char *str)
 	{
 		return i | STRPOOL_LIBRARYID_OR;
 	}
-	FString fstr(str);
-	return InsertString(fstr, h, bucketnum);
+	// The string may be one of ours, which a collection could free, so
+	// make a copy before inserting it.
+	FString fstr(str, len);
+	return InsertString(fstr.GetChars(), len, h, bucketnum);
 }
 
 int ACSStringPool::AddString(FString &str)
@@ -469,7 +577,7 @@ int ACSStringPool::AddString(FString &str)
 	{
 		return i | STRPOOL_LIBRARYID_OR;
 	}
-	return InsertString(str, h, bucketnum);
+	return InsertString(str.GetChars(), str.Len(), h, bucketnum);
 }
 
 //============================================================================
@@ -536,7 +644,7 @@ void ACSStringPool::MarkString(int strnum)
 	assert((strnum & LIBRARYID_MASK) == STRPOOL_LIBRARYID_OR);
 	strnum &= ~LIBRARYID_MASK;
 	assert((unsigned)strnum < Pool.Size());
-	Pool[strnum].LockCount |= 0x80000000;
+	MarkEntry(strnum);
 }
 
 //============================================================================
@@ -610,7 +718,7 @@ void ACSStringPool::MarkStringArray(const int *strnum, unsigned int count)
 			num &= ~LIBRARYID_MASK;
 			if ((unsigned)num < Pool.Size())
 			{
-				Pool[num].LockCount |= 0x80000000;
+				MarkEntry(num);
 			}
 		}
 	}
@@ -637,7 +745,7 @@ void ACSStringPool::MarkStringMap(const FWorldGlobalArray &aray)
 			num &= ~LIBRARYID_MASK;
 			if ((unsigned)num < Pool.Size())
 			{
-				Pool[num].LockCount |= 0x80000000;
+				MarkEntry(num);
 			}
 		}
 	}
@@ -660,6 +768,76 @@ void ACSStringPool::UnlockAll()
 	}
 }
 
+//============================================================================
+//
+// ACSStringPool :: BeginCollection
+//
+// Must be called before marking strings for PurgeStrings or
+// PurgeYoungStrings. If youngonly is true, only strings added since the last
+// collection will be marked.
+//
+//============================================================================
+
+void ACSStringPool::BeginCollection(bool youngonly)
+{
+	MarkYoungOnly = youngonly;
+	CollectCycles.Reset();
+	CollectCycles.Clock();
+}
+
+//============================================================================
+//
+// ACSStringPool :: EndCollection
+//
+// Updates the collection statistics.
+//
+//============================================================================
+
+void ACSStringPool::EndCollection(bool youngonly, unsigned int freedcount)
+{
+	CollectCycles.Unclock();
+	double ms = CollectCycles.TimeMS();
+
+	MarkYoungOnly = false;
+	LastFreedCount = freedcount;
+	if (youngonly)
+	{
+		NumMinorCollections++;
+		LastMinorMS = ms;
+		MaxMinorMS = MAX(MaxMinorMS, ms);
+	}
+	else
+	{
+		NumFullCollections++;
+		LastFullMS = ms;
+		MaxFullMS = MAX(MaxFullMS, ms);
+	}
+}
+
+//============================================================================
+//
+// ACSStringPool :: FreeEntry
+//
+// Frees an entry's string and marks it as free. The entry must already
+// have been removed from its hash bucket.
+//
+//============================================================================
+
+void ACSStringPool::FreeEntry(unsigned int index)
+{
+	PoolEntry *entry = &Pool[index];
+
+	FreeChars(entry->Str, entry->Len);
+	entry->Str = NULL;
+	entry->Len = 0;
+	entry->Next = FREE_ENTRY;
+	entry->Young = false;
+	if (index < FirstFreeEntry)
+	{
+		FirstFreeEntry = index;
+	}
+}
+
 //============================================================================
 //
 // ACSStringPool :: PurgeStrings
@@ -670,6 +848,7 @@ void ACSStringPool::UnlockAll()
 
 void ACSStringPool::PurgeStrings()
 {
+	assert(!MarkYoungOnly);
 	// Clear the hash buckets. We'll rebuild them as we decide what strings
 	// to keep and which to toss.
 	memset(PoolBuckets, 0xFF, sizeof(PoolBuckets));
@@ -682,14 +861,7 @@ void ACSStringPool::PurgeStrings()
 			if (entry->LockCount == 0)
 			{
 				freedcount++;
-				// Mark this entry as free.
-				entry->Next = FREE_ENTRY;
-				if (i < FirstFreeEntry)
-				{
-					FirstFreeEntry = i;
-				}
-				// And free the string.
-				entry->Str = "";
+				FreeEntry(i);
 			}
 			else
 			{
@@ -699,10 +871,61 @@ void ACSStringPool::PurgeStrings()
 				entry->Next = PoolBuckets[h];
 				PoolBuckets[h] = i;
 				// Remove MarkString's mark.
-				entry->LockCount &= 0x7FFFFFFF;
+				entry->LockCount &= ~MARKED;
+				// Everything that survives a full collection is old.
+				entry->Young = false;
+			}
+		}
+	}
+	YoungEntries.Clear();
+	EndCollection(false, (unsigned int)freedcount);
+}
+
+//============================================================================
+//
+// ACSStringPool :: PurgeYoungStrings
+//
+// Remove all unlocked strings that were added since the last collection.
+// Most strings are built, printed and forgotten within a tic, so this
+// reclaims them without visiting the rest of the pool. Survivors become old
+// and are only looked at again by PurgeStrings.
+//
+//============================================================================
+
+void ACSStringPool::PurgeYoungStrings()
+{
+	assert(MarkYoungOnly);
+	unsigned int freedcount = 0;
+	for (unsigned int i = 0; i < YoungEntries.Size(); ++i)
+	{
+		unsigned int index = YoungEntries[i];
+		PoolEntry *entry = &Pool[index];
+		if (entry->Next == FREE_ENTRY || !entry->Young)
+		{
+			continue;
+		}
+		if (entry->LockCount == 0)
+		{
+			// Unlink this entry from its hash bucket. New entries are added
+			// to the front of the chain, so it should not be far in.
+			unsigned int *prev = &PoolBuckets[entry->Hash % NUM_BUCKETS];
+			while (*prev != index)
+			{
+				assert(*prev != NO_ENTRY);
+				prev = &Pool[*prev].Next;
 			}
+			*prev = entry->Next;
+			FreeEntry(index);
+			freedcount++;
+		}
+		else
+		{
+			entry->LockCount &= ~MARKED;
+			entry->Young = false;
 		}
 	}
+	YoungEntries.Clear();
+	EndCollection(true, freedcount);
 }
 
 //============================================================================
@@ -721,8 +944,8 @@ int ACSStringPool::FindString(const char *str, size_t len, unsigned int h, unsig
 	{
 		PoolEntry *entry = &Pool[i];
 		assert(entry->Next != FREE_ENTRY);
-		if (entry->Hash == h && entry->Str.Len() == len &&
-			memcmp(entry->Str.GetChars(), str, len) == 0)
+		if (entry->Hash == h && entry->Len == len &&
+			memcmp(entry->Str, str, len) == 0)
 		{
 			return i;
 		}
@@ -739,7 +962,7 @@ int ACSStringPool::FindString(const char *str, size_t len, unsigned int h, unsig
 //
 //============================================================================
 
-int ACSStringPool::InsertString(FString &str, unsigned int h, unsigned int bucketnum)
+int ACSStringPool::InsertString(const char *str, size_t len, unsigned int h, unsigned int bucketnum)
 {
 	unsigned int index = FirstFreeEntry;
 	if (index >= MIN_GC_SIZE && index == Pool.Max())
@@ -761,11 +984,14 @@ int ACSStringPool::InsertString(FString &str, unsigned int h, unsigned int bucke
 		FindFirstFreeEntry(FirstFreeEntry + 1);
 	}
 	PoolEntry *entry = &Pool[index];
-	entry->Str = str;
+	entry->Str = AllocChars(str, len);
+	entry->Len = (unsigned int)len;
 	entry->Hash = h;
 	entry->Next = PoolBuckets[bucketnum];
 	entry->LockCount = 0;
+	entry->Young = true;
 	PoolBuckets[bucketnum] = index;
+	YoungEntries.Push(index);
 	return index | STRPOOL_LIBRARYID_OR;
 }
 
@@ -816,20 +1042,35 @@ void ACSStringPool::ReadStrings(PNGHandle *png, DWORD id)
 			// Mark skipped entries as free
 			for (; i < j; ++i)
 			{
+				Pool[i].Str = NULL;
+				Pool[i].Len = 0;
 				Pool[i].Next = FREE_ENTRY;
 				Pool[i].LockCount = 0;
+				Pool[i].Young = false;
 			}
 			arc << str;
-			h = SuperFastHash(str, strlen(str));
+			size_t slen = strlen(str);
+			h = SuperFastHash(str, slen);
 			bucketnum = h % NUM_BUCKETS;
-			Pool[i].Str = str;
+			Pool[i].Str = AllocChars(str, slen);
+			Pool[i].Len = (unsigned int)slen;
 			Pool[i].Hash = h;
 			Pool[i].LockCount = arc.ReadCount();
+			Pool[i].Young = false;
 			Pool[i].Next = PoolBuckets[bucketnum];
 			PoolBuckets[bucketnum] = i;
 			i++;
 			j = arc.ReadCount();
 		}
+		// Any entries after the last string are free, too.
+		for (; i < poolsize; ++i)
+		{
+			Pool[i].Str = NULL;
+			Pool[i].Len = 0;
+			Pool[i].Next = FREE_ENTRY;
+			Pool[i].LockCount = 0;
+			Pool[i].Young = false;
+		}
 		if (str != NULL)
 		{
 			delete[] str;
@@ -884,12 +1125,38 @@ void ACSStringPool::Dump() const
 	{
 		if (Pool[i].Next != FREE_ENTRY)
 		{
-			Printf("%4u. (%2d) \"%s\"\n", i, Pool[i].LockCount, Pool[i].Str.GetChars());
+			Printf("%4u. (%2d)%c\"%s\"\n", i, Pool[i].LockCount, Pool[i].Young ? '*' : ' ', Pool[i].Str);
 		}
 	}
 	Printf("First free %u\n", FirstFreeEntry);
 }
 
+//============================================================================
+//
+// ACSStringPool :: GetStats
+//
+// Returns a summary of the pool's size and collection times.
+//
+//============================================================================
+
+FString ACSStringPool::GetStats() const
+{
+	unsigned int live = 0;
+	for (unsigned int i = 0; i < Pool.Size(); ++i)
+	{
+		if (Pool[i].Next != FREE_ENTRY)
+		{
+			live++;
+		}
+	}
+	FString out;
+	out.Format("Strings: %u/%u (young %u)  Bytes: %zuK  Minor: %u %.2f/%.2f ms  Full: %u %.2f/%.2f ms  Freed: %u",
+		live, Pool.Size(), YoungEntries.Size(), (UsedBytes + 1023) >> 10,
+		NumMinorCollections, LastMinorMS, MaxMinorMS,
+		NumFullCollections, LastFullMS, MaxFullMS, LastFreedCount);
+	return out;
+}
+
 //============================================================================
 //
 // ScriptPresentation
@@ -947,13 +1214,13 @@ void P_MarkGlobalVarStrings()
 
 //============================================================================
 //
-// P_CollectACSGlobalStrings
+// P_MarkACSStrings
 //
-// Garbage collect ACS global strings.
+// Marks every string that might be referenced by an ACS variable.
 //
 //============================================================================
 
-void P_CollectACSGlobalStrings()
+static void P_MarkACSStrings()
 {
 	for (FACSStack *stack = FACSStack::head; stack != NULL; stack = stack->next)
 	{
@@ -975,14 +1242,53 @@ void P_CollectACSGlobalStrings()
 	FBehavior::StaticMarkLevelVarStrings();
 	P_MarkWorldVarStrings();
 	P_MarkGlobalVarStrings();
+}
+
+//============================================================================
+//
+// P_CollectACSGlobalStrings
+//
+// Garbage collect ACS global strings.
+//
+//============================================================================
+
+void P_CollectACSGlobalStrings()
+{
+	GlobalACSStrings.BeginCollection(false);
+	P_MarkACSStrings();
 	GlobalACSStrings.PurgeStrings();
 }
 
+//============================================================================
+//
+// P_CollectACSYoungStrings
+//
+// Garbage collect only the ACS global strings that were created since the
+// last collection.
+//
+//============================================================================
+
+void P_CollectACSYoungStrings()
+{
+	GlobalACSStrings.BeginCollection(true);
+	P_MarkACSStrings();
+	GlobalACSStrings.PurgeYoungStrings();
+}
+
+ADD_STAT(acsstrings)
+{
+	return GlobalACSStrings.GetStats();
+}
+
 #ifdef _DEBUG
 CCMD(acsgc)
 {
 	P_CollectACSGlobalStrings();
 }
+CCMD(acsyounggc)
+{
+	P_CollectACSYoungStrings();
+}
 CCMD(globstr)
 {
 	GlobalACSStrings.Dump();
@@ -1023,6 +1329,7 @@ void P_ClearACSVars(bool alsoglobal)
 	{
 		// Purge any strings that aren't referenced by global variables, since
 		// they're the only possible references left.
+		GlobalACSStrings.BeginCollection(false);
 		P_MarkGlobalVarStrings();
 		GlobalACSStrings.PurgeStrings();
 	}
@@ -3530,6 +3837,13 @@ void DACSThinker::Tick ()
 
 //	GlobalACSStrings.Clear();
 
+	// No script is running now, so every string that is still needed can be
+	// found by the collector.
+	if (acs_younggcthreshold > 0 && GlobalACSStrings.GetNumYoungStrings() >= (unsigned)acs_younggcthreshold)
+	{
+		P_CollectACSYoungStrings();
+	}
+
 	if (ACS_StringBuilderStack.Size())
 	{
 		int size = ACS_StringBuilderStack.Size();
@@ -7249,6 +7563,7 @@ doplaysound:			if (funcIndex == ACSF_PlayActorSound)
 					// [BB] Revive the player.
 					players[ulPlayer].bSpectating = false;
 					players[ulPlayer].bDeadSpectator = false;
+					SERVER_UpdatePlayerLists( );
 					if ( GAMEMODE_GetCurrentFlags() & GMF_USEMAXLIVES )
 						PLAYER_SetLivesLeft ( &players[ulPlayer], GAMEMODE_GetMaxLives() - 1 );
 					players[ulPlayer].playerstate = ( zadmflags & ZADF_DEAD_PLAYERS_CAN_KEEP_INVENTORY ) ? PST_REBORN : PST_REBORNNOINVENTORY;
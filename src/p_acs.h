@@ -38,6 +38,8 @@
 #include "dobject.h"
 #include "dthinker.h"
 #include "doomtype.h"
+#include "memarena.h"
+#include "stats.h"
 // [BB] New #includes.
 #include "r_data/r_translate.h"
 #include <algorithm>
@@ -111,6 +113,7 @@ class ACSStringPool
 {
 public:
 	ACSStringPool();
+	~ACSStringPool();
 	int AddString(const char *str);
 	int AddString(FString &str);
 	const char *GetString(int strnum);
@@ -122,35 +125,74 @@ public:
 	void UnlockStringArray(const int *strnum, unsigned int count);
 	void MarkStringArray(const int *strnum, unsigned int count);
 	void MarkStringMap(const FWorldGlobalArray &array);
+	void BeginCollection(bool youngonly);
 	void PurgeStrings();
+	void PurgeYoungStrings();
 	void Clear();
 	void Dump() const;
 	void ReadStrings(PNGHandle *png, DWORD id);
 	void WriteStrings(FILE *file, DWORD id) const;
+	unsigned int GetNumYoungStrings() const { return YoungEntries.Size(); }
+	FString GetStats() const;
 
 private:
 	int FindString(const char *str, size_t len, unsigned int h, unsigned int bucketnum);
-	int InsertString(FString &str, unsigned int h, unsigned int bucketnum);
+	int InsertString(const char *str, size_t len, unsigned int h, unsigned int bucketnum);
 	void FindFirstFreeEntry(unsigned int base);
+	void FreeEntry(unsigned int index);
+	char *AllocChars(const char *str, size_t len);
+	void FreeChars(char *chars, size_t len);
+	void EndCollection(bool youngonly, unsigned int freedcount);
+
+	void MarkEntry(unsigned int num)
+	{
+		// A young-only collection leaves old strings alone, so it must not
+		// set marks on them that nobody would clear again.
+		if (!MarkYoungOnly || Pool[num].Young)
+		{
+			Pool[num].LockCount |= MARKED;
+		}
+	}
 
 	enum { NUM_BUCKETS = 251 };
 	enum { FREE_ENTRY = 0xFFFFFFFE };	// Stored in PoolEntry's Next field
 	enum { NO_ENTRY = 0xFFFFFFFF };
 	enum { MIN_GC_SIZE = 100 };			// Don't auto-collect until there are this many strings
+	enum { MARKED = 0x80000000 };		// Stored in PoolEntry's LockCount field
+
+	// String bytes live in an arena. Freed chunks are kept in per-size free
+	// lists, so a string's address never changes while it is in the pool.
+	enum { MIN_CHUNK_SHIFT = 4 };		// Smallest chunk is 16 bytes
+	enum { NUM_CHUNK_SIZES = 6 };		// Largest chunk is 512 bytes; anything bigger uses the heap
+
 	struct PoolEntry
 	{
-		FString Str;
+		char *Str;
+		unsigned int Len;
 		unsigned int Hash;
 		unsigned int Next;
 		unsigned int LockCount;
+		bool Young;
 	};
 	TArray<PoolEntry> Pool;
+	TArray<unsigned int> YoungEntries;	// Entries added since the last collection
 	unsigned int PoolBuckets[NUM_BUCKETS];
 	unsigned int FirstFreeEntry;
+	bool MarkYoungOnly;
+
+	FMemArena CharArena;
+	char *FreeChunks[NUM_CHUNK_SIZES];
+	size_t UsedBytes;
+
+	cycle_t CollectCycles;
+	unsigned int NumMinorCollections, NumFullCollections;
+	unsigned int LastFreedCount;
+	double LastMinorMS, LastFullMS, MaxMinorMS, MaxFullMS;
 };
 extern ACSStringPool GlobalACSStrings;
 
 void P_CollectACSGlobalStrings();
+void P_CollectACSYoungStrings();
 void P_ReadACSVars(PNGHandle *);
 void P_WriteACSVars(FILE*);
 void P_ClearACSVars(bool);
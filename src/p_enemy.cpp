@@ -1398,13 +1398,14 @@ bool P_LookForMonsters (AActor *actor)
 AActor *LookForTIDInBlock (AActor *lookee, int index, void *extparams)
 {
 	FLookExParams *params = (FLookExParams *)extparams;
-	FBlockNode *block;
+	int bx = index % bmapwidth;
+	int by = index / bmapwidth;
+	FBlockThingsIterator it(bx, by, bx, by);
 	AActor *link;
 	AActor *other;
 	
-	for (block = blocklinks[index]; block != NULL; block = block->NextActor)
+	while ((link = it.Next()))
 	{
-		link = block->Me;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
@@ -1568,14 +1569,15 @@ bool P_LookForTID (AActor *actor, INTBOOL allaround, FLookExParams *params)
 
 AActor *LookForEnemiesInBlock (AActor *lookee, int index, void *extparam)
 {
-	FBlockNode *block;
+	int bx = index % bmapwidth;
+	int by = index / bmapwidth;
+	FBlockThingsIterator it(bx, by, bx, by);
 	AActor *link;
 	AActor *other;
 	FLookExParams *params = (FLookExParams *)extparam;
 	
-	for (block = blocklinks[index]; block != NULL; block = block->NextActor)
+	while ((link = it.Next()))
 	{
-		link = block->Me;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
@@ -2194,6 +2194,7 @@ void PLAYER_SetFragcount( player_t *pPlayer, LONG lFragCount, bool bAnnounce, bo
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdatePlayerInfo( pPlayer - players, UDF_FRAGS );
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 
 	// Refresh the HUD since a score has changed.
@@ -2574,6 +2575,7 @@ void PLAYER_SetSpectator( player_t *pPlayer, bool bBroadcast, bool bDeadSpectato
 	// Flag this player as being a spectator.
 	pPlayer->bSpectating = true;
 	pPlayer->bDeadSpectator = bDeadSpectator;
+	SERVER_UpdatePlayerLists( );
 	// [BB] Spectators have to be excluded from the special handling that prevents selection room pistol-fights.
 	pPlayer->bUnarmed = false;
 
@@ -2799,6 +2801,7 @@ void PLAYER_SpectatorJoinsGame( player_t *pPlayer )
 
 	pPlayer->bSpectating = false;
 	pPlayer->bDeadSpectator = false;
+	SERVER_UpdatePlayerLists( );
 
 	// [BB] If the spectator used the chasecam or noclip cheat (which is always allowed for spectators)
 	// remove it now that he joins the game.
@@ -2833,6 +2836,7 @@ void PLAYER_SetPoints( player_t *pPlayer, ULONG ulPoints )
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdatePlayerInfo( static_cast<ULONG>( pPlayer - players ), UDF_FRAGS );
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 }
 
@@ -2854,6 +2858,7 @@ void PLAYER_SetWins( player_t *pPlayer, ULONG ulWins )
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdatePlayerInfo( pPlayer - players, UDF_FRAGS );
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 }
 
@@ -50,6 +50,10 @@
 extern int bmapnegx;
 extern int bmapnegy;
 
+// Things are linked into their own grid. Every blockmap block is split into
+// 1 << thingblockshift thing blocks along each axis.
+extern int thingblockshift;
+
 inline int GetSafeBlockX(int blockx)
 {
 	blockx >>= MAPBLOCKSHIFT;
@@ -72,6 +76,22 @@ inline int GetSafeBlockY(long long blocky)
 	return int((blocky <= bmapnegy) ? blocky & 0x1FF: blocky);
 }
 
+inline int GetSafeThingBlockX(int blockx)
+{
+	return GetSafeBlockX(blockx) * (1 << thingblockshift) + ((blockx >> (MAPBLOCKSHIFT - thingblockshift)) & ((1 << thingblockshift) - 1));
+}
+
+inline int GetSafeThingBlockY(int blocky)
+{
+	return GetSafeBlockY(blocky) * (1 << thingblockshift) + ((blocky >> (MAPBLOCKSHIFT - thingblockshift)) & ((1 << thingblockshift) - 1));
+}
+
+// The actors linked into one thing block, most recently linked one last.
+struct FThingBlock
+{
+	TArray<AActor *>	Actors;
+};
+
 // MAXRADIUS is for precalculated sector block boxes
 // the spider demon is larger,
 // but we do not have any moving sectors nearby
@@ -316,12 +336,15 @@ public:
 
 class FBlockThingsIterator
 {
+	// These are in thing blocks, not blockmap blocks.
 	int minx, maxx;
 	int miny, maxy;
 
 	int curx, cury;
 
-	FBlockNode *block;
+	FThingBlock *block;
+	int blockpos;
+	AActor *lastactor;
 
 	int Buckets[32];
 
@@ -336,6 +359,7 @@ class FBlockThingsIterator
 
 	HashEntry *GetHashEntry(int i) { return i < (int)countof(FixedHash) ? &FixedHash[i] : &DynHash[i - countof(FixedHash)]; }
 
+	void SetBlocks(int minx, int miny, int maxx, int maxy);
 	void StartBlock(int x, int y);
 	void SwitchBlock(int x, int y);
 	void ClearHash();
@@ -365,6 +389,7 @@ class FPathTraverse
 
 	void AddLineIntercepts(int bx, int by);
 	void AddThingIntercepts(int bx, int by, FBlockThingsIterator &it, bool compatible);
+	void AddThingIntercept(AActor *thing, bool compatible);
 public:
 
 	intercept_t *Next();
@@ -577,7 +602,12 @@ extern int				bmapwidth;
 extern int				bmapheight; 	// in mapblocks
 extern fixed_t			bmaporgx;
 extern fixed_t			bmaporgy;		// origin of block map
-extern FBlockNode**		blocklinks; 	// for thing chains
+extern FThingBlock*		thingblocks;	// for thing chains
+extern int				thingblockwidth;
+extern int				thingblockheight;	// in thing blocks
+
+void P_CreateThingBlocks (int numthings);
+void P_FreeThingBlocks ();
 
 
 
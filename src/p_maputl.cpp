@@ -43,6 +43,9 @@
 
 // [Leo] Zandronum includes
 #include "v_text.h"
+#include "unlagged.h"
+#include "c_dispatch.h"
+#include "stats.h"
 
 static AActor *RoughBlockCheck (AActor *mo, int index, void *);
 
@@ -303,20 +306,29 @@ void AActor::UnlinkFromWorld ()
 	if (!(flags & MF_NOBLOCKMAP))
 	{
 		// [RH] Unlink from all blocks this actor uses
-		FBlockNode *block = this->BlockNode;
-
-		while (block != NULL)
+		// (The links are stale if the grid was recreated for a new level.)
+		if (thingblocks != NULL &&
+			BlockLinks.X + BlockLinks.Width <= thingblockwidth &&
+			BlockLinks.Y + BlockLinks.Height <= thingblockheight)
 		{
-			if (block->NextActor != NULL)
+			for (int y = BlockLinks.Y; y < BlockLinks.Y + BlockLinks.Height; ++y)
 			{
-				block->NextActor->PrevActor = block->PrevActor;
+				for (int x = BlockLinks.X; x < BlockLinks.X + BlockLinks.Width; ++x)
+				{
+					// Keep the order of the other actors in the block.
+					TArray<AActor *> &actors = thingblocks[y*thingblockwidth + x].Actors;
+					for (unsigned int i = actors.Size(); i-- > 0; )
+					{
+						if (actors[i] == this)
+						{
+							actors.Delete (i);
+							break;
+						}
+					}
+				}
 			}
-			*(block->PrevActor) = block->NextActor;
-			FBlockNode *next = block->NextBlock;
-			block->Release ();
-			block = next;
 		}
-		BlockNode = NULL;
+		BlockLinks.Width = BlockLinks.Height = 0;
 	}
 }
 
@@ -390,44 +402,32 @@ void AActor::LinkToWorld (sector_t *sec)
 	// link into blockmap (inert things don't need to be in the blockmap)
 	if ( !(flags & MF_NOBLOCKMAP) )
 	{
-		int x1 = GetSafeBlockX(x - radius - bmaporgx);
-		int x2 = GetSafeBlockX(x + radius - bmaporgx);
-		int y1 = GetSafeBlockY(y - radius - bmaporgy);
-		int y2 = GetSafeBlockY(y + radius - bmaporgy);
+		int x1 = GetSafeThingBlockX(x - radius - bmaporgx);
+		int x2 = GetSafeThingBlockX(x + radius - bmaporgx);
+		int y1 = GetSafeThingBlockY(y - radius - bmaporgy);
+		int y2 = GetSafeThingBlockY(y + radius - bmaporgy);
 
-		if (x1 >= bmapwidth || x2 < 0 || y1 >= bmapheight || y2 < 0)
+		if (x1 >= thingblockwidth || x2 < 0 || y1 >= thingblockheight || y2 < 0)
 		{ // thing is off the map
-			BlockNode = NULL;
+			BlockLinks.Width = BlockLinks.Height = 0;
 		}
 		else
         { // [RH] Link into every block this actor touches, not just the center one
-			FBlockNode **alink = &this->BlockNode;
 			x1 = MAX (0, x1);
 			y1 = MAX (0, y1);
-			x2 = MIN (bmapwidth - 1, x2);
-			y2 = MIN (bmapheight - 1, y2);
+			x2 = MIN (thingblockwidth - 1, x2);
+			y2 = MIN (thingblockheight - 1, y2);
 			for (int y = y1; y <= y2; ++y)
 			{
 				for (int x = x1; x <= x2; ++x)
 				{
-					FBlockNode **link = &blocklinks[y*bmapwidth + x];
-					FBlockNode *node = FBlockNode::Create (this, x, y);
-
-					// Link in to block
-					if ((node->NextActor = *link) != NULL)
-					{
-						(*link)->PrevActor = &node->NextActor;
-					}
-					node->PrevActor = link;
-					*link = node;
-
-					// Link in to actor
-					node->PrevBlock = alink;
-					node->NextBlock = NULL;
-					(*alink) = node;
-					alink = &node->NextBlock;
+					thingblocks[y*thingblockwidth + x].Actors.Push (this);
 				}
 			}
+			BlockLinks.X = x1;
+			BlockLinks.Y = y1;
+			BlockLinks.Width = x2 - x1 + 1;
+			BlockLinks.Height = y2 - y1 + 1;
 		}
 	}
 }
@@ -610,34 +610,66 @@ void AActor::SetOrigin (fixed_t ix, fixed_t iy, fixed_t iz)
 	ulSTFlags |= STFL_POSITIONCHANGED;
 }
 
-FBlockNode *FBlockNode::FreeBlocks = NULL;
+//==========================================================================
+//
+// The thing grid
+//
+// Things are not linked into the blockmap blocks themselves but into a grid
+// of their own, which may be finer than the blockmap in maps with a lot of
+// things. Every block keeps its actors in one array, so walking a block does
+// not chase pointers through the whole heap.
+//
+//==========================================================================
+
+// 0 picks the size from the number of things in the map.
+CUSTOM_CVAR (Int, sv_thingblocksize, 128, CVAR_ARCHIVE)
+{
+	if (self != 0 && self != 32 && self != 64 && self != 128)
+	{
+		self = (self < 0) ? 0 : (self <= 32) ? 32 : (self <= 64) ? 64 : 128;
+	}
+}
+
+FThingBlock*	thingblocks;
+int				thingblockwidth;
+int				thingblockheight;
+int				thingblockshift;
 
-FBlockNode *FBlockNode::Create (AActor *who, int x, int y)
+void P_CreateThingBlocks (int numthings)
 {
-	FBlockNode *block;
+	P_FreeThingBlocks ();
 
-	if (FreeBlocks != NULL)
+	if (sv_thingblocksize == 32)
+	{
+		thingblockshift = 2;
+	}
+	else if (sv_thingblocksize == 64)
+	{
+		thingblockshift = 1;
+	}
+	else if (sv_thingblocksize == 0)
 	{
-		block = FreeBlocks;
-		FreeBlocks = block->NextBlock;
+		// Crowded maps spend most of their time in the thing blocks.
+		thingblockshift = (numthings >= 4 * bmapwidth * bmapheight || numthings >= 2000) ? 1 : 0;
 	}
 	else
 	{
-		block = new FBlockNode;
+		thingblockshift = 0;
 	}
-	block->BlockIndex = x + y*bmapwidth;
-	block->Me = who;
-	block->NextActor = NULL;
-	block->PrevActor = NULL;
-	block->PrevBlock = NULL;
-	block->NextBlock = NULL;
-	return block;
+
+	thingblockwidth = bmapwidth << thingblockshift;
+	thingblockheight = bmapheight << thingblockshift;
+	thingblocks = new FThingBlock[thingblockwidth * thingblockheight];
 }
 
-void FBlockNode::Release ()
+void P_FreeThingBlocks ()
 {
-	NextBlock = FreeBlocks;
-	FreeBlocks = this;
+	if (thingblocks != NULL)
+	{
+		delete[] thingblocks;
+		thingblocks = NULL;
+	}
+	thingblockwidth = thingblockheight = 0;
 }
 
 //
@@ -788,15 +820,14 @@ FBlockThingsIterator::FBlockThingsIterator()
 	miny = maxy = 0;
 	ClearHash();
 	block = NULL;
+	blockpos = 0;
+	lastactor = NULL;
 }
 
 FBlockThingsIterator::FBlockThingsIterator(int _minx, int _miny, int _maxx, int _maxy)
 : DynHash(0)
 {
-	minx = _minx;
-	maxx = _maxx;
-	miny = _miny;
-	maxy = _maxy;
+	SetBlocks(_minx, _miny, _maxx, _maxy);
 	ClearHash();
 	Reset();
 }
@@ -804,14 +835,32 @@ FBlockThingsIterator::FBlockThingsIterator(int _minx, int _miny, int _maxx, int
 FBlockThingsIterator::FBlockThingsIterator(const FBoundingBox &box)
 : DynHash(0)
 {
-	maxy = GetSafeBlockY(box.Top() - bmaporgy);
-	miny = GetSafeBlockY(box.Bottom() - bmaporgy);
-	maxx = GetSafeBlockX(box.Right() - bmaporgx);
-	minx = GetSafeBlockX(box.Left() - bmaporgx);
+	maxy = GetSafeThingBlockY(box.Top() - bmaporgy);
+	miny = GetSafeThingBlockY(box.Bottom() - bmaporgy);
+	maxx = GetSafeThingBlockX(box.Right() - bmaporgx);
+	minx = GetSafeThingBlockX(box.Left() - bmaporgx);
 	ClearHash();
 	Reset();
 }
 
+//===========================================================================
+//
+// FBlockThingsIterator :: SetBlocks
+//
+// Converts a range of blockmap blocks to the thing blocks covering it.
+//
+//===========================================================================
+
+void FBlockThingsIterator::SetBlocks(int _minx, int _miny, int _maxx, int _maxy)
+{
+	const int scale = 1 << thingblockshift;
+
+	minx = _minx * scale;
+	miny = _miny * scale;
+	maxx = (_maxx + 1) * scale - 1;
+	maxy = (_maxy + 1) * scale - 1;
+}
+
 //===========================================================================
 //
 // FBlockThingsIterator :: ClearHash
@@ -835,28 +884,32 @@ void FBlockThingsIterator::StartBlock(int x, int y)
 { 
 	curx = x; 
 	cury = y; 
-	if (x >= 0 && y >= 0 && x < bmapwidth && y <bmapheight)
+	if (x >= 0 && y >= 0 && x < thingblockwidth && y < thingblockheight)
 	{
-		block = blocklinks[y*bmapwidth + x];
+		block = &thingblocks[y*thingblockwidth + x];
+		blockpos = block->Actors.Size();
 	}
 	else
 	{
 		// invalid block
 		block = NULL;
+		blockpos = 0;
 	}
+	lastactor = NULL;
 }
 
 //===========================================================================
 //
 // FBlockThingsIterator :: SwitchBlock
 //
+// Takes blockmap block coordinates.
+//
 //===========================================================================
 
 void FBlockThingsIterator::SwitchBlock(int x, int y)
 {
-	minx = maxx = x;
-	miny = maxy = y;
-	StartBlock(x, y);
+	SetBlocks(x, y, x, y);
+	StartBlock(minx, miny);
 }
 
 //===========================================================================
@@ -871,24 +924,44 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 	{
 		while (block != NULL)
 		{
-			AActor *me = block->Me;
-			FBlockNode *mynode = block;
+			TArray<AActor *> &actors = block->Actors;
+
+			// The blocks are walked from the most recently linked actor down,
+			// so unlinking the last returned actor does not move the others.
+			// If an actor in front of it was unlinked instead, step back over
+			// the hole so that it is not returned twice.
+			if (blockpos > (int)actors.Size())
+			{
+				blockpos = actors.Size();
+			}
+			else if (blockpos > 0 && lastactor != NULL && actors[blockpos - 1] == lastactor)
+			{
+				blockpos--;
+			}
+
+			if (blockpos == 0)
+			{
+				break;
+			}
+
+			AActor *me = actors[--blockpos];
 			HashEntry *entry;
 			int i;
 
-			block = block->NextActor;
+			lastactor = me;
 			// Don't recheck things that were already checked
-			if (mynode->NextBlock == NULL && mynode->PrevBlock == &me->BlockNode)
+			if (me->BlockLinks.Width == 1 && me->BlockLinks.Height == 1)
 			{ // This actor doesn't span blocks, so we know it can only ever be checked once.
 				return me;
 			}
 			if (centeronly)
 			{
 				// Block boundaries for compatibility mode
-				fixed_t blockleft = (curx << MAPBLOCKSHIFT) + bmaporgx;
-				fixed_t blockright = blockleft + MAPBLOCKSIZE;
-				fixed_t blockbottom = (cury << MAPBLOCKSHIFT) + bmaporgy;
-				fixed_t blocktop = blockbottom + MAPBLOCKSIZE;
+				const int blockshift = MAPBLOCKSHIFT - thingblockshift;
+				fixed_t blockleft = (curx << blockshift) + bmaporgx;
+				fixed_t blockright = blockleft + (1 << blockshift);
+				fixed_t blockbottom = (cury << blockshift) + bmaporgy;
+				fixed_t blocktop = blockbottom + (1 << blockshift);
 
 				// only return actors with the center in this block
 				if (me->x >= blockleft && me->x < blockright &&
@@ -1024,140 +1097,155 @@ void FPathTraverse::AddThingIntercepts (int bx, int by, FBlockThingsIterator &it
 	it.SwitchBlock(bx, by);
 	while ((thing = it.Next(compatible)))
 	{
-		int numfronts = 0;
-		divline_t line;
-		int i;
+		// Players reconciled without relinking are added from their unlagged hitbox.
+		if (thing->player != NULL && thing->player->bUnlaggedHitbox)
+			continue;
 
+		AddThingIntercept(thing, compatible);
+	}
+}
 
-		if (!compatible)
-		{
-			// [RH] Don't check a corner to corner crossection for hit.
-			// Instead, check against the actual bounding box (but not if compatibility optioned.)
+//===========================================================================
+//
+// FPathTraverse :: AddThingIntercept
+//
+//===========================================================================
 
-			// There's probably a smarter way to determine which two sides
-			// of the thing face the trace than by trying all four sides...
-			for (i = 0; i < 4; ++i)
-			{
-				switch (i)
-				{
-				case 0:		// Top edge
-					line.x = thing->x + thing->radius;
-					line.y = thing->y + thing->radius;
-					line.dx = -thing->radius * 2;
-					line.dy = 0;
-					break;
-
-				case 1:		// Right edge
-					line.x = thing->x + thing->radius;
-					line.y = thing->y - thing->radius;
-					line.dx = 0;
-					line.dy = thing->radius * 2;
-					break;
-
-				case 2:		// Bottom edge
-					line.x = thing->x - thing->radius;
-					line.y = thing->y - thing->radius;
-					line.dx = thing->radius * 2;
-					line.dy = 0;
-					break;
-
-				case 3:		// Left edge
-					line.x = thing->x - thing->radius;
-					line.y = thing->y + thing->radius;
-					line.dx = 0;
-					line.dy = thing->radius * -2;
-					break;
-				}
-				// Check if this side is facing the trace origin
-				if (P_PointOnDivlineSide (trace.x, trace.y, &line) == 0)
-				{
-					numfronts++;
+void FPathTraverse::AddThingIntercept (AActor *thing, bool compatible)
+{
+	int numfronts = 0;
+	divline_t line;
+	int i;
 
-					// If it is, see if the trace crosses it
-					if (P_PointOnDivlineSide (line.x, line.y, &trace) !=
-						P_PointOnDivlineSide (line.x + line.dx, line.y + line.dy, &trace))
-					{
-						// It's a hit
-						fixed_t frac = P_InterceptVector (&trace, &line);
-						if (frac < 0)
-						{ // behind source
-							continue;
-						}
 
-						intercept_t newintercept;
-						newintercept.frac = frac;
-						newintercept.isaline = false;
-						newintercept.done = false;
-						newintercept.d.thing = thing;
-						intercepts.Push (newintercept);
-						continue;
-					}
-				}
-			}
+	if (!compatible)
+	{
+		// [RH] Don't check a corner to corner crossection for hit.
+		// Instead, check against the actual bounding box (but not if compatibility optioned.)
 
-			// If none of the sides was facing the trace, then the trace
-			// must have started inside the box, so add it as an intercept.
-			if (numfronts == 0)
-			{
-				intercept_t newintercept;
-				newintercept.frac = 0;
-				newintercept.isaline = false;
-				newintercept.done = false;
-				newintercept.d.thing = thing;
-				intercepts.Push (newintercept);
-			}
-		}
-		else
+		// There's probably a smarter way to determine which two sides
+		// of the thing face the trace than by trying all four sides...
+		for (i = 0; i < 4; ++i)
 		{
-			// Old code for compatibility purposes
-			fixed_t 		x1, y1, x2, y2;
-			int 			s1, s2;
-			divline_t		dl;
-			fixed_t 		frac;
-				
-			bool tracepositive = (trace.dx ^ trace.dy)>0;
-						
-			// check a corner to corner crossection for hit
-			if (tracepositive)
-			{
-				x1 = thing->x - thing->radius;
-				y1 = thing->y + thing->radius;
-						
-				x2 = thing->x + thing->radius;
-				y2 = thing->y - thing->radius;					
-			}
-			else
+			switch (i)
 			{
-				x1 = thing->x - thing->radius;
-				y1 = thing->y - thing->radius;
-						
-				x2 = thing->x + thing->radius;
-				y2 = thing->y + thing->radius;					
+			case 0:		// Top edge
+				line.x = thing->x + thing->radius;
+				line.y = thing->y + thing->radius;
+				line.dx = -thing->radius * 2;
+				line.dy = 0;
+				break;
+
+			case 1:		// Right edge
+				line.x = thing->x + thing->radius;
+				line.y = thing->y - thing->radius;
+				line.dx = 0;
+				line.dy = thing->radius * 2;
+				break;
+
+			case 2:		// Bottom edge
+				line.x = thing->x - thing->radius;
+				line.y = thing->y - thing->radius;
+				line.dx = thing->radius * 2;
+				line.dy = 0;
+				break;
+
+			case 3:		// Left edge
+				line.x = thing->x - thing->radius;
+				line.y = thing->y + thing->radius;
+				line.dx = 0;
+				line.dy = thing->radius * -2;
+				break;
 			}
-			
-			s1 = P_PointOnDivlineSide (x1, y1, &trace);
-			s2 = P_PointOnDivlineSide (x2, y2, &trace);
-
-			if (s1 != s2)
+			// Check if this side is facing the trace origin
+			if (P_PointOnDivlineSide (trace.x, trace.y, &line) == 0)
 			{
-				dl.x = x1;
-				dl.y = y1;
-				dl.dx = x2-x1;
-				dl.dy = y2-y1;
-				
-				frac = P_InterceptVector (&trace, &dl);
+				numfronts++;
 
-				if (frac >= 0)
+				// If it is, see if the trace crosses it
+				if (P_PointOnDivlineSide (line.x, line.y, &trace) !=
+					P_PointOnDivlineSide (line.x + line.dx, line.y + line.dy, &trace))
 				{
+					// It's a hit
+					fixed_t frac = P_InterceptVector (&trace, &line);
+					if (frac < 0)
+					{ // behind source
+						continue;
+					}
+
 					intercept_t newintercept;
 					newintercept.frac = frac;
 					newintercept.isaline = false;
 					newintercept.done = false;
 					newintercept.d.thing = thing;
 					intercepts.Push (newintercept);
+					continue;
 				}
 			}
 		}
+
+		// If none of the sides was facing the trace, then the trace
+		// must have started inside the box, so add it as an intercept.
+		if (numfronts == 0)
+		{
+			intercept_t newintercept;
+			newintercept.frac = 0;
+			newintercept.isaline = false;
+			newintercept.done = false;
+			newintercept.d.thing = thing;
+			intercepts.Push (newintercept);
+		}
+	}
+	else
+	{
+		// Old code for compatibility purposes
+		fixed_t 		x1, y1, x2, y2;
+		int 			s1, s2;
+		divline_t		dl;
+		fixed_t 		frac;
+			
+		bool tracepositive = (trace.dx ^ trace.dy)>0;
+					
+		// check a corner to corner crossection for hit
+		if (tracepositive)
+		{
+			x1 = thing->x - thing->radius;
+			y1 = thing->y + thing->radius;
+					
+			x2 = thing->x + thing->radius;
+			y2 = thing->y - thing->radius;					
+		}
+		else
+		{
+			x1 = thing->x - thing->radius;
+			y1 = thing->y - thing->radius;
+					
+			x2 = thing->x + thing->radius;
+			y2 = thing->y + thing->radius;					
+		}
+		
+		s1 = P_PointOnDivlineSide (x1, y1, &trace);
+		s2 = P_PointOnDivlineSide (x2, y2, &trace);
+
+		if (s1 != s2)
+		{
+			dl.x = x1;
+			dl.y = y1;
+			dl.dx = x2-x1;
+			dl.dy = y2-y1;
+			
+			frac = P_InterceptVector (&trace, &dl);
+
+			if (frac >= 0)
+			{
+				intercept_t newintercept;
+				newintercept.frac = frac;
+				newintercept.isaline = false;
+				newintercept.done = false;
+				newintercept.d.thing = thing;
+				intercepts.Push (newintercept);
+			}
+		}
 	}
 }
 
@@ -1401,6 +1489,13 @@ FPathTraverse::FPathTraverse (fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2, in
 			break;
 		}
 	}
+
+	// Add the players that were moved back in time without relinking them.
+	if (flags & PT_ADDTHINGS)
+	{
+		for (ULONG i = 0; i < UNLAGGED_GetNumHitboxActors(); ++i)
+			AddThingIntercept(UNLAGGED_GetHitboxActor(i), compatible);
+	}
 	maxfrac = FRACUNIT;
 }
 
@@ -1521,21 +1616,102 @@ AActor *P_BlockmapSearch (AActor *mo, int distance, AActor *(*check)(AActor*, in
 static AActor *RoughBlockCheck (AActor *mo, int index, void *param)
 {
 	bool onlyseekable = param != NULL;
-	FBlockNode *link;
+	int bx = index % bmapwidth;
+	int by = index / bmapwidth;
+	FBlockThingsIterator it(bx, by, bx, by);
+	AActor *link;
 
-	for (link = blocklinks[index]; link != NULL; link = link->NextActor)
+	while ((link = it.Next()))
 	{
-		if (link->Me != mo)
+		if (link != mo)
 		{
-			if (onlyseekable && !mo->CanSeek(link->Me))
+			if (onlyseekable && !mo->CanSeek(link))
 			{
 				continue;
 			}
-			if (mo->IsOkayToAttack (link->Me))
+			if (mo->IsOkayToAttack (link))
 			{
-				return link->Me;
+				return link;
 			}
 		}
 	}
 	return NULL;
 }
+
+//===========================================================================
+//
+// CCMD bench_thingblocks
+//
+// Runs the thing checks P_CheckPosition does for every actor in the level
+// and relinks all of them. Load a slaughtermap and compare the results for
+// the different values of sv_thingblocksize.
+//
+//===========================================================================
+
+CCMD (bench_thingblocks)
+{
+	const int passes = (argv.argc() > 1) ? MAX (atoi (argv[1]), 1) : 10;
+	TThinkerIterator<AActor> iterator;
+	TArray<AActor *> actors;
+	AActor *actor;
+	cycle_t checktime, linktime;
+	unsigned int links = 0, maxlinks = 0, usedblocks = 0, touching = 0;
+
+	if (thingblocks == NULL)
+	{
+		Printf ("No level is loaded.\n");
+		return;
+	}
+
+	while ((actor = iterator.Next()))
+	{
+		if (!(actor->flags & MF_NOBLOCKMAP))
+		{
+			actors.Push (actor);
+		}
+	}
+
+	for (int i = thingblockwidth * thingblockheight - 1; i >= 0; --i)
+	{
+		unsigned int count = thingblocks[i].Actors.Size();
+		links += count;
+		maxlinks = MAX (maxlinks, count);
+		usedblocks += (count > 0);
+	}
+
+	checktime.Reset();
+	linktime.Reset();
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		checktime.Clock();
+		for (unsigned int i = 0; i < actors.Size(); ++i)
+		{
+			actor = actors[i];
+			FBlockThingsIterator it (FBoundingBox (actor->x, actor->y, actor->radius));
+			AActor *th;
+
+			while ((th = it.Next()))
+			{
+				fixed_t blockdist = th->radius + actor->radius;
+				if (th != actor && abs (th->x - actor->x) < blockdist && abs (th->y - actor->y) < blockdist)
+				{
+					touching++;
+				}
+			}
+		}
+		checktime.Unclock();
+
+		linktime.Clock();
+		for (unsigned int i = 0; i < actors.Size(); ++i)
+		{
+			actors[i]->UnlinkFromWorld ();
+			actors[i]->LinkToWorld ();
+		}
+		linktime.Unclock();
+	}
+
+	Printf ("%d unit thing blocks: %u of %d used, %u links, at most %u in one block\n",
+		MAPBLOCKSIZE >> (FRACBITS + thingblockshift), usedblocks, thingblockwidth * thingblockheight, links, maxlinks);
+	Printf ("%u actors: %.3f ms per pass for the checks (%u touching), %.3f ms per pass for relinking\n",
+		actors.Size(), checktime.TimeMS() / passes, touching / passes, linktime.TimeMS() / passes);
+}
@@ -3527,7 +3527,7 @@ void P_NightmareRespawn (AActor *mobj)
 }
 
 
-AActor *AActor::TIDHash[128];
+TMap<int, AActor *> AActor::TIDHash;
 
 //
 // P_ClearTidHashes
@@ -3537,13 +3537,13 @@ AActor *AActor::TIDHash[128];
 
 void AActor::ClearTIDHashes ()
 {
-	memset(TIDHash, 0, sizeof(TIDHash));
+	TIDHash.Clear();
 }
 
 //
 // P_AddMobjToHash
 //
-// Inserts an mobj into the correct chain based on its tid.
+// Inserts an mobj at the front of the list for its tid.
 // If its tid is 0, this function does nothing.
 //
 void AActor::AddToHash ()
@@ -3556,14 +3556,14 @@ void AActor::AddToHash ()
 	}
 	else
 	{
-		int hash = TIDHASH (tid);
+		AActor **head = TIDHash.CheckKey(tid);
 
-		inext = TIDHash[hash];
-		iprev = &TIDHash[hash];
-		TIDHash[hash] = this;
+		inext = head != NULL ? *head : NULL;
+		iprev = NULL;
+		TIDHash[tid] = this;
 		if (inext)
 		{
-			inext->iprev = &inext;
+			inext->iprev = this;
 		}
 	}
 }
@@ -3571,16 +3571,38 @@ void AActor::AddToHash ()
 //
 // P_RemoveMobjFromHash
 //
-// Removes an mobj from its hash chain.
+// Removes an mobj from the list for its tid. The table entry
+// is dropped along with the last actor using that tid.
 //
 void AActor::RemoveFromHash ()
 {
-	if (tid != 0 && iprev)
+	if (tid != 0)
 	{
-		*iprev = inext;
-		if (inext)
+		if (iprev != NULL)
+		{
+			iprev->inext = inext;
+			if (inext)
+			{
+				inext->iprev = iprev;
+			}
+		}
+		else
 		{
-			inext->iprev = iprev;
+			// Only the head of a list has no iprev, so make sure this
+			// actor actually is one before touching the table.
+			AActor **head = TIDHash.CheckKey(tid);
+			if (head != NULL && *head == this)
+			{
+				if (inext)
+				{
+					*head = inext;
+					inext->iprev = NULL;
+				}
+				else
+				{
+					TIDHash.Remove(tid);
+				}
+			}
 		}
 		iprev = NULL;
 		inext = NULL;
@@ -3599,16 +3621,7 @@ void AActor::RemoveFromHash ()
 
 bool P_IsTIDUsed(int tid)
 {
-	AActor *probe = AActor::TIDHash[tid & 127];
-	while (probe != NULL)
-	{
-		if (probe->tid == tid)
-		{
-			return true;
-		}
-		probe = probe->inext;
-	}
-	return false;
+	return AActor::TIDHash.CheckKey(tid) != NULL;
 }
 
 //==========================================================================
@@ -8058,6 +8071,88 @@ ADD_STAT( spawns )
 	return ( Out );
 }
 
+//*****************************************************************************
+//
+// Spawns the given number of monsters around the player, lets them chase the
+// player and times the thinkers over the given number of tics, i.e. what
+// "stat think" shows while the game runs. Use it to compare builds with
+// changes to the actor code or to the layout of AActor. It changes the game,
+// so it is only available offline.
+//
+CCMD( bench_think )
+{
+	const int		numMonsters = ( argv.argc( ) > 1 ) ? MAX( atoi( argv[1] ), 1 ) : 5000;
+	const int		numTics = ( argv.argc( ) > 2 ) ? MAX( atoi( argv[2] ), 1 ) : 350;
+	const PClass	*type = PClass::FindClass( ( argv.argc( ) > 3 ) ? argv[3] : "ZombieMan" );
+	AActor			*mo = players[consoleplayer].mo;
+	int				spawned = 0;
+	cycle_t			time;
+
+	if (( NETWORK_GetState( ) != NETSTATE_SINGLE ) || ( gamestate != GS_LEVEL ) || ( mo == NULL ))
+	{
+		Printf( "bench_think can only be used in an offline game.\n" );
+		return;
+	}
+
+	if (( type == NULL ) || ( type->IsDescendantOf( RUNTIME_CLASS( AActor )) == false ) || (( GetDefaultByType( type )->flags3 & MF3_ISMONSTER ) == 0 ))
+	{
+		Printf( "Usage: bench_think [monsters] [tics] [monster class]\n" );
+		return;
+	}
+
+	// Place the monsters on a grid in rings around the player, skipping the
+	// spots where they don't fit.
+	const fixed_t spacing = GetDefaultByType( type )->radius * 2 + 8 * FRACUNIT;
+	for ( int ring = 1; ( spawned < numMonsters ) && ( ring <= 256 ); ++ring )
+	{
+		for ( int step = 0; ( step < 8 * ring ) && ( spawned < numMonsters ); ++step )
+		{
+			const int side = step / ( 2 * ring );
+			const int pos = step % ( 2 * ring );
+			const int dx = ( side == 0 ) ? pos - ring : ( side == 1 ) ? ring : ( side == 2 ) ? ring - pos : -ring;
+			const int dy = ( side == 0 ) ? -ring : ( side == 1 ) ? pos - ring : ( side == 2 ) ? ring : ring - pos;
+
+			AActor *monster = Spawn( type, mo->x + dx * spacing, mo->y + dy * spacing, ONFLOORZ, NO_REPLACE );
+			if ( P_TestMobjLocation( monster ) == false )
+			{
+				monster->ClearCounters( );
+				monster->Destroy( );
+				continue;
+			}
+
+			monster->target = mo;
+			monster->LastHeard = mo;
+			if ( monster->SeeState != NULL )
+				monster->SetState( monster->SeeState );
+			spawned++;
+		}
+	}
+
+	TThinkerIterator<AActor>	iterator;
+	int							numActors = 0;
+	while ( iterator.Next( ))
+		numActors++;
+
+	// Don't let the monsters end the benchmark early.
+	const DWORD oldCheats = players[consoleplayer].cheats;
+	players[consoleplayer].cheats |= CF_GODMODE;
+
+	time.Reset( );
+	for ( int tic = 0; tic < numTics; ++tic )
+	{
+		time.Clock( );
+		DThinker::RunThinkers( );
+		time.Unclock( );
+	}
+
+	players[consoleplayer].cheats = oldCheats;
+
+	Printf( "%d %s spawned, %d actors\n", spawned, type->TypeName.GetChars( ), numActors );
+	Printf( "%d tics: %.3f ms per tic, %.1f ns per actor per tic (AActor is %u bytes)\n", numTics,
+		time.TimeMS( ) / numTics, time.TimeMS( ) * 1000000.0 / ( static_cast<double>( numTics ) * numActors ),
+		static_cast<unsigned int>( sizeof( AActor )));
+}
+
 #ifdef _DEBUG
 // [BC]
 #include "c_dispatch.h"
@@ -189,7 +189,6 @@ fixed_t 		bmaporgy;
 int				bmapnegx;		// min negs of block map before wrapping
 int				bmapnegy;
 
-FBlockNode**	blocklinks;		// for thing chains
 
 
 // REJECT
@@ -3175,9 +3174,7 @@ void P_LoadBlockMap (MapData * map)
 	bmapnegy = bmapheight > 255 ? bmapheight - 512 : -257;
 
 	// clear out mobj chains
-	count = bmapwidth*bmapheight;
-	blocklinks = new FBlockNode *[count];
-	memset (blocklinks, 0, count*sizeof(*blocklinks));
+	P_CreateThingBlocks (MapThingsConverted.Size());
 	blockmap = blockmaplump+4;
 
 	// [BC] Also, build the node list for the bot pathing module.
@@ -3825,11 +3822,7 @@ void P_FreeLevelData ()
 		delete[] blockmaplump;
 		blockmaplump = NULL;
 	}
-	if (blocklinks != NULL)
-	{
-		delete[] blocklinks;
-		blocklinks = NULL;
-	}
+	P_FreeThingBlocks ();
 	if (PolyBlockMap != NULL)
 	{
 		for (int i = bmapwidth*bmapheight-1; i >= 0; --i)
@@ -3884,19 +3877,9 @@ extern msecnode_t *headsecnode;
 
 void P_FreeExtraLevelData()
 {
-	// Free all blocknodes and msecnodes.
+	// Free all msecnodes.
 	// *NEVER* call this function without calling
 	// P_FreeLevelData() first, or they might not all be freed.
-	{
-		FBlockNode *node = FBlockNode::FreeBlocks;
-		while (node != NULL)
-		{
-			FBlockNode *next = node->NextBlock;
-			delete node;
-			node = next;
-		}
-		FBlockNode::FreeBlocks = NULL;
-	}
 	{
 		msecnode_t *node = headsecnode;
 
@@ -3910,6 +3893,51 @@ void P_FreeExtraLevelData()
 	}
 }
 
+//===========================================================================
+//
+// P_PrefetchLevelLumps
+//
+// [Zandronum] Decompresses the map, the ACS libraries and, unless we are the
+// server, the sounds the level precaches on worker threads before they are
+// loaded.
+//
+//===========================================================================
+
+static void P_PrefetchLevelLumps (const char *mapname)
+{
+	TArray<int> lumps;
+	FString fmt;
+	int lump;
+
+	fmt.Format("maps/%s.wad", mapname);
+	if ((lump = Wads.CheckNumForFullName(fmt)) != -1)
+	{
+		lumps.Push(lump);
+	}
+
+	for (lump = 0; lump < Wads.GetNumLumps(); ++lump)
+	{
+		if (Wads.GetLumpNamespace(lump) == ns_acslibrary)
+		{
+			lumps.Push(lump);
+		}
+	}
+
+	if (NETWORK_GetState() != NETSTATE_SERVER && level.info != NULL)
+	{
+		for (unsigned int i = 0; i < level.info->PrecacheSounds.Size(); ++i)
+		{
+			const int id = level.info->PrecacheSounds[i];
+			if (id > 0 && id < (int)S_sfx.Size() && S_sfx[id].lumpnum >= 0)
+			{
+				lumps.Push(S_sfx[id].lumpnum);
+			}
+		}
+	}
+
+	Wads.PrefetchLumps(lumps);
+}
+
 //
 // P_SetupLevel
 //
@@ -3993,6 +4021,8 @@ void P_SetupLevel (char *lumpname, int position)
 	P_FreeLevelData ();
 	interpolator.ClearInterpolations();	// [RH] Nothing to interpolate on a fresh level.
 
+	P_PrefetchLevelLumps(lumpname);
+
 	MapData *map = P_OpenMapData(lumpname, true);
 	if (map == NULL)
 	{
@@ -4528,6 +4558,7 @@ void P_SetupLevel (char *lumpname, int position)
 				if ( PLAYER_ShouldSpawnAsSpectator( &players[i] ))
 				{
 					players[i].bSpectating = true;
+					SERVER_UpdatePlayerLists( );
 
 					// [BB] If we turned a player on a team into a spectator, remove the team affiliation.
 					if ( players[i].bOnTeam && ( GAMEMODE_GetCurrentFlags() & GMF_PLAYERSONTEAMS ) )
@@ -4708,6 +4739,9 @@ void P_SetupLevel (char *lumpname, int position)
 
 	// Call Init function to set sector colors if in Domination
 	DOMINATION_Init();
+
+	// [Zandronum] Everything that was prefetched has been loaded by now.
+	Wads.ReleasePrefetchedLumps();
 }
 
 
@@ -318,21 +318,27 @@ void P_Ticker (void)
 	{
 		for ( int i = 0; i < ( ( gametic % 3 == 0 ) ? 2 : 1 ); i++ )
 		{
-			for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+			// Work on a copy, processing a command may kick the client.
+			const PLAYERLIST_s clients = SERVER_GetClientList( );
+
+			for ( ULONG ulListIdx = 0; ulListIdx < clients.ulNumPlayers; ulListIdx++ )
 			{
+				ulIdx = clients.aulPlayers[ulListIdx];
 				if ( SERVER_IsValidClient( ulIdx ) == false )
 					continue;
 
-				while ( SERVER_GetClient( ulIdx )->MoveCMDs.Size( ) != 0 )
+				ClientCommandBuffer &commands = SERVER_GetClient( ulIdx )->MoveCMDs;
+				while ( commands.Size( ) != 0 )
 				{
-					// Process only one movement command.
-					const bool bMovement = SERVER_GetClient( ulIdx )->MoveCMDs[0]->isMoveCmd( );
-					SERVER_GetClient( ulIdx )->MoveCMDs[0]->process( ulIdx );
+					// Take the command out of the buffer before processing it,
+					// processing may kick the client and clear the buffer.
+					const CLIENT_BUFFERED_COMMAND_s cmd = commands.Front( );
+					commands.PopFront( );
 
-					delete SERVER_GetClient( ulIdx )->MoveCMDs[0];
-					SERVER_GetClient( ulIdx )->MoveCMDs.Delete(0);
+					// Process only one movement command.
+					SERVER_ProcessBufferedCommand( ulIdx, cmd );
 
-					if ( bMovement == true )
+					if ( cmd.Type == CCT_MOVE )
 						break;
 				}
 			}
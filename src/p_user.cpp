@@ -354,7 +354,8 @@ player_t::player_t()
   bLagging( 0 ),
   bSpawnTelefragged( 0 ),
   ulTime( 0 ),
-  bUnarmed( false )
+  bUnarmed( false ),
+  bUnlaggedHitbox( false )
 {
 	memset (&cmd, 0, sizeof(cmd));
 	// [BB] Check if this is still necessary.
@@ -533,6 +534,7 @@ player_t &player_t::operator=(const player_t &p)
 	restoreZ = p.restoreZ;
 	restoreFloorZ = p.restoreFloorZ;
 	restoreCeilingZ = p.restoreCeilingZ;
+	bUnlaggedHitbox = p.bUnlaggedHitbox;
 
 	return *this;
 }
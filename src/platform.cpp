@@ -73,6 +73,7 @@ void I_Sleep( int iMS )
 #include "networkheaders.h"
 #include "networkshared.h"
 #include "v_text.h"
+#include "sv_logthread.h"
 
 // [BB] I collect dummy implementations of many functions, which are either
 // GL or server console gui related, here. This way one doesn't have to make
@@ -93,7 +94,9 @@ void SERVERCONSOLE_UpdatePlayerInfo( LONG lPlayer, ULONG ulUpdateFlags ) {}
 void SERVERCONSOLE_Print( char *pszString )
 {
 	V_StripColors( pszString );
-	std::cout << pszString;
+	// [Zandronum] With -logthread, the log thread writes the output.
+	if ( SERVER_LOGTHREAD_Write( stdout, pszString ) == false )
+		std::cout << pszString;
 }
 #endif //NO_SERVER_GUI
 // ------------------- GL related stuff ------------------- 
@@ -1496,9 +1496,8 @@ void FPolyObj::UnLinkPolyobj ()
 bool FPolyObj::CheckMobjBlocking (side_t *sd)
 {
 	static TArray<AActor *> checker;
-	FBlockNode *block;
 	AActor *mobj;
-	int i, j, k;
+	int k;
 	int left, right, top, bottom;
 	line_t *ld;
 	bool blocked;
@@ -1527,92 +1526,86 @@ bool FPolyObj::CheckMobjBlocking (side_t *sd)
 	right = right < 0 ? 0 : right;
 	right = right >= bmapwidth ?  bmapwidth-1 : right;
 
-	for (j = bottom*bmapwidth; j <= top*bmapwidth; j += bmapwidth)
+	FBlockThingsIterator it(left, bottom, right, top);
+	while ((mobj = it.Next()))
 	{
-		for (i = left; i <= right; i++)
+		for (k = (int)checker.Size()-1; k >= 0; --k)
 		{
-			for (block = blocklinks[j+i]; block != NULL; block = block->NextActor)
+			if (checker[k] == mobj)
 			{
-				mobj = block->Me;
-				for (k = (int)checker.Size()-1; k >= 0; --k)
+				break;
+			}
+		}
+		if (k < 0)
+		{
+			checker.Push (mobj);
+			if ((mobj->flags&MF_SOLID) && !(mobj->flags&MF_NOCLIP))
+			{
+				FLineOpening open;
+				open.top = INT_MAX;
+				open.bottom = -INT_MAX;
+				// [TN] Check wether this actor gets blocked by the line.
+				if (ld->backsector != NULL &&
+					!(ld->flags & (ML_BLOCKING|ML_BLOCKEVERYTHING))
+					&& !(ld->flags & ML_BLOCK_PLAYERS && mobj->player) 
+					&& !(ld->flags & ML_BLOCKMONSTERS && mobj->flags3 & MF3_ISMONSTER)
+					&& !((mobj->flags & MF_FLOAT) && (ld->flags & ML_BLOCK_FLOATERS))
+					&& (!(ld->flags & ML_3DMIDTEX) ||
+						(!P_LineOpening_3dMidtex(mobj, ld, open) &&
+							(mobj->z + mobj->height < open.top)
+						) || (open.abovemidtex && mobj->z > mobj->floorz))
+					)
 				{
-					if (checker[k] == mobj)
-					{
-						break;
-					}
+					// [BL] We can't just continue here since we must
+					// determine if the line's backsector is going to
+					// be blocked.
+					performBlockingThrust = false;
 				}
-				if (k < 0)
+				else
+				{
+					performBlockingThrust = true;
+				}
+
+				FBoundingBox box(mobj->x, mobj->y, mobj->radius);
+
+				if (box.Right() <= ld->bbox[BOXLEFT]
+					|| box.Left() >= ld->bbox[BOXRIGHT]
+					|| box.Top() <= ld->bbox[BOXBOTTOM]
+					|| box.Bottom() >= ld->bbox[BOXTOP])
 				{
-					checker.Push (mobj);
-					if ((mobj->flags&MF_SOLID) && !(mobj->flags&MF_NOCLIP))
+					continue;
+				}
+				if (box.BoxOnLineSide(ld) != -1)
+				{
+					continue;
+				}
+				// We have a two-sided linedef so we should only check one side
+				// so that the thrust from both sides doesn't cancel each other out.
+				// Best use the one facing the player and ignore the back side.
+				if (ld->sidedef[1] != NULL)
+				{
+					int side = P_PointOnLineSide(mobj->x, mobj->y, ld);
+					if (ld->sidedef[side] != sd)
+					{
+						continue;
+					}
+					// [BL] See if we hit below the floor/ceiling of the poly.
+					else if(!performBlockingThrust && (
+							mobj->z < ld->sidedef[!side]->sector->GetSecPlane(sector_t::floor).ZatPoint(mobj->x, mobj->y) ||
+							mobj->z + mobj->height > ld->sidedef[!side]->sector->GetSecPlane(sector_t::ceiling).ZatPoint(mobj->x, mobj->y)
+						))
 					{
-						FLineOpening open;
-						open.top = INT_MAX;
-						open.bottom = -INT_MAX;
-						// [TN] Check wether this actor gets blocked by the line.
-						if (ld->backsector != NULL &&
-							!(ld->flags & (ML_BLOCKING|ML_BLOCKEVERYTHING))
-							&& !(ld->flags & ML_BLOCK_PLAYERS && mobj->player) 
-							&& !(ld->flags & ML_BLOCKMONSTERS && mobj->flags3 & MF3_ISMONSTER)
-							&& !((mobj->flags & MF_FLOAT) && (ld->flags & ML_BLOCK_FLOATERS))
-							&& (!(ld->flags & ML_3DMIDTEX) ||
-								(!P_LineOpening_3dMidtex(mobj, ld, open) &&
-									(mobj->z + mobj->height < open.top)
-								) || (open.abovemidtex && mobj->z > mobj->floorz))
-							)
-						{
-							// [BL] We can't just continue here since we must
-							// determine if the line's backsector is going to
-							// be blocked.
-							performBlockingThrust = false;
-						}
-						else
-						{
-							performBlockingThrust = true;
-						}
-
-						FBoundingBox box(mobj->x, mobj->y, mobj->radius);
-
-						if (box.Right() <= ld->bbox[BOXLEFT]
-							|| box.Left() >= ld->bbox[BOXRIGHT]
-							|| box.Top() <= ld->bbox[BOXBOTTOM]
-							|| box.Bottom() >= ld->bbox[BOXTOP])
-						{
-							continue;
-						}
-						if (box.BoxOnLineSide(ld) != -1)
-						{
-							continue;
-						}
-						// We have a two-sided linedef so we should only check one side
-						// so that the thrust from both sides doesn't cancel each other out.
-						// Best use the one facing the player and ignore the back side.
-						if (ld->sidedef[1] != NULL)
-						{
-							int side = P_PointOnLineSide(mobj->x, mobj->y, ld);
-							if (ld->sidedef[side] != sd)
-							{
-								continue;
-							}
-							// [BL] See if we hit below the floor/ceiling of the poly.
-							else if(!performBlockingThrust && (
-									mobj->z < ld->sidedef[!side]->sector->GetSecPlane(sector_t::floor).ZatPoint(mobj->x, mobj->y) ||
-									mobj->z + mobj->height > ld->sidedef[!side]->sector->GetSecPlane(sector_t::ceiling).ZatPoint(mobj->x, mobj->y)
-								))
-							{
-								performBlockingThrust = true;
-							}
-						}
-
-						if(performBlockingThrust)
-						{
-							ThrustMobj (mobj, sd);
-							blocked = true;
-						}
-						else
-							continue;
+						performBlockingThrust = true;
 					}
 				}
+
+				if(performBlockingThrust)
+				{
+					ThrustMobj (mobj, sd);
+					blocked = true;
+				}
+				else
+					continue;
 			}
 		}
 	}
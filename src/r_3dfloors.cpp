@@ -16,25 +16,25 @@
 #include "r_3dfloors.h"
 
 // external variables
-int fake3D;
-F3DFloor *fakeFloor;
-fixed_t fakeHeight;
-fixed_t fakeAlpha;
-int fakeActive = 0;
-fixed_t sclipBottom;
-fixed_t sclipTop;
-HeightLevel *height_top = NULL;
-HeightLevel *height_cur = NULL;
-int CurrentMirror = 0;
-int CurrentSkybox = 0;
+RENDER_TLS int fake3D;
+RENDER_TLS F3DFloor *fakeFloor;
+RENDER_TLS fixed_t fakeHeight;
+RENDER_TLS fixed_t fakeAlpha;
+RENDER_TLS int fakeActive = 0;
+RENDER_TLS fixed_t sclipBottom;
+RENDER_TLS fixed_t sclipTop;
+RENDER_TLS HeightLevel *height_top = NULL;
+RENDER_TLS HeightLevel *height_cur = NULL;
+RENDER_TLS int CurrentMirror = 0;
+RENDER_TLS int CurrentSkybox = 0;
 
 CVAR(Int, r_3dfloors, true, 0);
 
 // private variables
-int height_max = -1;
-TArray<HeightStack> toplist;
-ClipStack *clip_top = NULL;
-ClipStack *clip_cur = NULL;
+RENDER_TLS int height_max = -1;
+RENDER_TLS TArray<HeightStack> toplist;
+RENDER_TLS ClipStack *clip_top = NULL;
+RENDER_TLS ClipStack *clip_cur = NULL;
 
 void R_3D_DeleteHeights()
 {
@@ -89,6 +89,20 @@ void R_3D_AddHeight(secplane_t *add, sector_t *sec)
 	height_max++;
 }
 
+// [Zandronum] The clip arrays belong to the render thread, not the 3D floor,
+// so several slices can walk the same 3D floors at once.
+ClipStack *R_3D_GetClip(F3DFloor *ffloor)
+{
+	for (ClipStack *clip = clip_top; clip != NULL; clip = clip->next)
+	{
+		if (clip->ffloor == ffloor)
+		{
+			return clip;
+		}
+	}
+	return NULL;
+}
+
 void R_3D_NewClip()
 {
 	ClipStack *curr;
@@ -100,10 +114,7 @@ void R_3D_NewClip()
 	memcpy(curr->floorclip, floorclip, sizeof(short) * MAXWIDTH);
 	memcpy(curr->ceilingclip, ceilingclip, sizeof(short) * MAXWIDTH);
 	curr->ffloor = fakeFloor;
-	assert(fakeFloor->floorclip == NULL);
-	assert(fakeFloor->ceilingclip == NULL);
-	fakeFloor->floorclip = curr->floorclip;
-	fakeFloor->ceilingclip = curr->ceilingclip;
+	assert(R_3D_GetClip(fakeFloor) == NULL);
 	if(clip_top) {
 		clip_cur->next = curr;
 		clip_cur = curr;
@@ -117,9 +128,6 @@ void R_3D_ResetClip()
 	clip_cur = clip_top;
 	while(clip_cur) 
 	{
-		assert(clip_cur->ffloor->floorclip != NULL);
-		assert(clip_cur->ffloor->ceilingclip != NULL);
-		clip_cur->ffloor->ceilingclip = clip_cur->ffloor->floorclip = NULL;
 		clip_top = clip_cur;
 		clip_cur = clip_cur->next;
 		M_Free(clip_top);
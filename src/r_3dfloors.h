@@ -47,17 +47,17 @@ enum
 	FAKE3D_DOWN2UP			= 8,	// rendering from down to up (floors)
 };
 
-extern int fake3D;
-extern F3DFloor *fakeFloor;
-extern fixed_t fakeHeight;
-extern fixed_t fakeAlpha;
-extern int fakeActive;
-extern fixed_t sclipBottom;
-extern fixed_t sclipTop;
-extern HeightLevel *height_top;
-extern HeightLevel *height_cur;
-extern int CurrentMirror;
-extern int CurrentSkybox;
+extern RENDER_TLS int fake3D;
+extern RENDER_TLS F3DFloor *fakeFloor;
+extern RENDER_TLS fixed_t fakeHeight;
+extern RENDER_TLS fixed_t fakeAlpha;
+extern RENDER_TLS int fakeActive;
+extern RENDER_TLS fixed_t sclipBottom;
+extern RENDER_TLS fixed_t sclipTop;
+extern RENDER_TLS HeightLevel *height_top;
+extern RENDER_TLS HeightLevel *height_cur;
+extern RENDER_TLS int CurrentMirror;
+extern RENDER_TLS int CurrentSkybox;
 EXTERN_CVAR(Int, r_3dfloors);
 
 // [TP] Override r_3dfloors in the same way as gl_fogmode
@@ -68,6 +68,7 @@ EXTERN_CVAR(Int, r_3dfloors);
 // functions
 void R_3D_DeleteHeights();
 void R_3D_AddHeight(secplane_t *add, sector_t *sec);
+ClipStack *R_3D_GetClip(F3DFloor *ffloor);
 void R_3D_NewClip();
 void R_3D_ResetClip();
 void R_3D_EnterSkybox();
@@ -58,61 +58,61 @@
 
 int WallMost (short *mostbuf, const secplane_t &plane);
 
-seg_t*			curline;
-side_t* 		sidedef;
-line_t* 		linedef;
-sector_t*		frontsector;
-sector_t*		backsector;
+RENDER_TLS seg_t*			curline;
+RENDER_TLS side_t* 		sidedef;
+RENDER_TLS line_t* 		linedef;
+RENDER_TLS sector_t*		frontsector;
+RENDER_TLS sector_t*		backsector;
 
 // killough 4/7/98: indicates doors closed wrt automap bugfix:
-int				doorclosed;
+RENDER_TLS int				doorclosed;
 
-bool			r_fakingunderwater;
+RENDER_TLS bool			r_fakingunderwater;
 
-extern bool		rw_prepped;
-extern bool		rw_havehigh, rw_havelow;
-extern int		rw_floorstat, rw_ceilstat;
-extern bool		rw_mustmarkfloor, rw_mustmarkceiling;
-extern short	walltop[MAXWIDTH];	// [RH] record max extents of wall
-extern short	wallbottom[MAXWIDTH];
-extern short	wallupper[MAXWIDTH];
-extern short	walllower[MAXWIDTH];
+extern RENDER_TLS bool		rw_prepped;
+extern RENDER_TLS bool		rw_havehigh, rw_havelow;
+extern RENDER_TLS int		rw_floorstat, rw_ceilstat;
+extern RENDER_TLS bool		rw_mustmarkfloor, rw_mustmarkceiling;
+extern RENDER_TLS short	walltop[MAXWIDTH];	// [RH] record max extents of wall
+extern RENDER_TLS short	wallbottom[MAXWIDTH];
+extern RENDER_TLS short	wallupper[MAXWIDTH];
+extern RENDER_TLS short	walllower[MAXWIDTH];
 
-fixed_t			rw_backcz1, rw_backcz2;
-fixed_t			rw_backfz1, rw_backfz2;
-fixed_t			rw_frontcz1, rw_frontcz2;
-fixed_t			rw_frontfz1, rw_frontfz2;
+RENDER_TLS fixed_t			rw_backcz1, rw_backcz2;
+RENDER_TLS fixed_t			rw_backfz1, rw_backfz2;
+RENDER_TLS fixed_t			rw_frontcz1, rw_frontcz2;
+RENDER_TLS fixed_t			rw_frontfz1, rw_frontfz2;
 
 
-size_t			MaxDrawSegs;
-drawseg_t		*drawsegs;
-drawseg_t*		firstdrawseg;
-drawseg_t*		ds_p;
+RENDER_TLS size_t			MaxDrawSegs;
+RENDER_TLS drawseg_t		*drawsegs;
+RENDER_TLS drawseg_t*		firstdrawseg;
+RENDER_TLS drawseg_t*		ds_p;
 
-size_t			FirstInterestingDrawseg;
-TArray<size_t>	InterestingDrawsegs;
+RENDER_TLS size_t			FirstInterestingDrawseg;
+RENDER_TLS TArray<size_t>	InterestingDrawsegs;
 
-fixed_t			WallTX1, WallTX2;	// x coords at left, right of wall in view space
-fixed_t			WallTY1, WallTY2;	// y coords at left, right of wall in view space
+RENDER_TLS fixed_t			WallTX1, WallTX2;	// x coords at left, right of wall in view space
+RENDER_TLS fixed_t			WallTY1, WallTY2;	// y coords at left, right of wall in view space
 
-fixed_t			WallCX1, WallCX2;	// x coords at left, right of wall in camera space
-fixed_t			WallCY1, WallCY2;	// y coords at left, right of wall in camera space
+RENDER_TLS fixed_t			WallCX1, WallCX2;	// x coords at left, right of wall in camera space
+RENDER_TLS fixed_t			WallCY1, WallCY2;	// y coords at left, right of wall in camera space
 
-int				WallSX1, WallSX2;	// x coords at left, right of wall in screen space
-fixed_t			WallSZ1, WallSZ2;	// depth at left, right of wall in screen space
+RENDER_TLS int				WallSX1, WallSX2;	// x coords at left, right of wall in screen space
+RENDER_TLS fixed_t			WallSZ1, WallSZ2;	// depth at left, right of wall in screen space
 
-float			WallDepthOrg, WallDepthScale;
-float			WallUoverZorg, WallUoverZstep;
-float			WallInvZorg, WallInvZstep;
+RENDER_TLS float			WallDepthOrg, WallDepthScale;
+RENDER_TLS float			WallUoverZorg, WallUoverZstep;
+RENDER_TLS float			WallInvZorg, WallInvZstep;
 
-static BYTE		FakeSide;
+static RENDER_TLS BYTE		FakeSide;
 
-int WindowLeft, WindowRight;
-WORD MirrorFlags;
-seg_t *ActiveWallMirror;
-TArray<size_t> WallMirrors;
+RENDER_TLS int WindowLeft, WindowRight;
+RENDER_TLS WORD MirrorFlags;
+RENDER_TLS seg_t *ActiveWallMirror;
+RENDER_TLS TArray<size_t> WallMirrors;
 
-static subsector_t *InSubsector;
+static RENDER_TLS subsector_t *InSubsector;
 
 CVAR (Bool, r_drawflat, false, 0)		// [RH] Don't texture segs?
 
@@ -153,8 +153,8 @@ struct cliprange_t
 
 
 // newend is one past the last valid seg
-static cliprange_t     *newend;
-static cliprange_t		solidsegs[MAXWIDTH/2+2];
+static RENDER_TLS cliprange_t     *newend;
+static RENDER_TLS cliprange_t		solidsegs[MAXWIDTH/2+2];
 
 
 
@@ -531,7 +531,7 @@ sector_t *R_FakeFlat(sector_t *sec, sector_t *tempsec,
 
 void R_AddLine (seg_t *line)
 {
-	static sector_t tempsec;	// killough 3/8/98: ceiling/water hack
+	static RENDER_TLS sector_t tempsec;	// killough 3/8/98: ceiling/water hack
 	bool			solid;
 	fixed_t			tx1, tx2, ty1, ty2;
 
@@ -981,6 +981,27 @@ static void R_AddPolyobjs(subsector_t *sub)
 	}
 }
 
+//==========================================================================
+//
+// R_BuildDirtyPolyBSPs
+//
+// [Zandronum] R_AddPolyobjs builds polyobject BSPs on demand, which can't
+// happen while several slices walk the level, so build them up front.
+//
+//==========================================================================
+
+void R_BuildDirtyPolyBSPs ()
+{
+	for (int i = 0; i < numsubsectors; i++)
+	{
+		subsector_t *sub = &subsectors[i];
+		if (sub->polys != NULL && (sub->BSP == NULL || sub->BSP->bDirty))
+		{
+			sub->BuildPolyBSP();
+		}
+	}
+}
+
 // kg3D - add fake segs, never rendered
 void R_FakeDrawLoop(subsector_t *sub)
 {
@@ -1166,9 +1187,8 @@ void R_Subsector (subsector_t *sub)
 			if (fakeFloor->alpha == 0) continue;
 			if (fakeFloor->flags & FF_THISINSIDE && fakeFloor->flags & FF_INVERTSECTOR) continue;
 			fakeAlpha = MIN(Scale(fakeFloor->alpha, OPAQUE, 255), OPAQUE);
-			if (fakeFloor->validcount != validcount)
+			if (R_3D_GetClip(fakeFloor) == NULL)
 			{
-				fakeFloor->validcount = validcount;
 				R_3D_NewClip();
 			}
 			fakeHeight = fakeFloor->top.plane->ZatPoint(frontsector->soundorg[0], frontsector->soundorg[0]);
@@ -1228,9 +1248,8 @@ void R_Subsector (subsector_t *sub)
 			if (!(fakeFloor->flags & FF_THISINSIDE) && (fakeFloor->flags & (FF_SWIMMABLE|FF_INVERTSECTOR)) == (FF_SWIMMABLE|FF_INVERTSECTOR)) continue;
 			fakeAlpha = MIN(Scale(fakeFloor->alpha, OPAQUE, 255), OPAQUE);
 
-			if (fakeFloor->validcount != validcount)
+			if (R_3D_GetClip(fakeFloor) == NULL)
 			{
-				fakeFloor->validcount = validcount;
 				R_3D_NewClip();
 			}
 			fakeHeight = fakeFloor->bottom.plane->ZatPoint(frontsector->soundorg[0], frontsector->soundorg[1]);
@@ -1329,9 +1348,8 @@ void R_Subsector (subsector_t *sub)
 					tempsec.floorplane = *fakeFloor->top.plane;
 					tempsec.ceilingplane = *fakeFloor->bottom.plane;
 					backsector = &tempsec;
-					if (fakeFloor->validcount != validcount)
+					if (R_3D_GetClip(fakeFloor) == NULL)
 					{
-						fakeFloor->validcount = validcount;
 						R_3D_NewClip();
 					}
 					if (frontsector->CenterFloor() >= backsector->CenterFloor())
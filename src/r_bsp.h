@@ -62,24 +62,24 @@ struct drawseg_t
 };
 
 
-extern seg_t*		curline;
-extern side_t*		sidedef;
-extern line_t*		linedef;
-extern sector_t*	frontsector;
-extern sector_t*	backsector;
+extern RENDER_TLS seg_t*		curline;
+extern RENDER_TLS side_t*		sidedef;
+extern RENDER_TLS line_t*		linedef;
+extern RENDER_TLS sector_t*	frontsector;
+extern RENDER_TLS sector_t*	backsector;
 
-extern drawseg_t	*drawsegs;
-extern drawseg_t	*firstdrawseg;
-extern drawseg_t*	ds_p;
+extern RENDER_TLS drawseg_t	*drawsegs;
+extern RENDER_TLS drawseg_t	*firstdrawseg;
+extern RENDER_TLS drawseg_t*	ds_p;
 
-extern TArray<size_t>	InterestingDrawsegs;	// drawsegs that have something drawn on them
-extern size_t			FirstInterestingDrawseg;
+extern RENDER_TLS TArray<size_t>	InterestingDrawsegs;	// drawsegs that have something drawn on them
+extern RENDER_TLS size_t			FirstInterestingDrawseg;
 
-extern int			WindowLeft, WindowRight;
-extern WORD			MirrorFlags;
-extern seg_t*		ActiveWallMirror;
+extern RENDER_TLS int			WindowLeft, WindowRight;
+extern RENDER_TLS WORD			MirrorFlags;
+extern RENDER_TLS seg_t*		ActiveWallMirror;
 
-extern TArray<size_t>	WallMirrors;
+extern RENDER_TLS TArray<size_t>	WallMirrors;
 
 typedef void (*drawfunc_t) (int start, int stop);
 
@@ -89,6 +89,7 @@ EXTERN_CVAR (Bool, r_drawflat)		// [RH] Don't texture segs?
 void R_ClearClipSegs (short left, short right);
 void R_ClearDrawSegs ();
 void R_RenderBSPNode (void *node);
+void R_BuildDirtyPolyBSPs ();
 
 // killough 4/13/98: fake floors/ceilings for deep water / fake ceilings:
 sector_t *R_FakeFlat(sector_t *, sector_t *, int *, int *, bool);
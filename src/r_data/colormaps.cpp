@@ -53,6 +53,7 @@
 #include "templates.h"
 #include "r_utility.h"
 #include "r_renderer.h"
+#include "r_main.h"
 
 static bool R_CheckForFixedLights(const BYTE *colormaps);
 
@@ -187,6 +188,9 @@ FDynamicColormap *GetSpecialLights (PalEntry color, PalEntry fade, int desaturat
 {
 	FDynamicColormap *colormap;
 
+	// [Zandronum] Render slices may ask for the same new colormap at once.
+	FSliceResourceLock lock;
+
 	// If this colormap has already been created, just return it
 	for (colormap = &NormalLight; colormap != NULL; colormap = colormap->Next)
 	{
@@ -14,6 +14,7 @@
 #include "r_data/sprites.h"
 #include "r_data/voxels.h"
 #include "textures/textures.h"
+#include "doomstat.h"
 
 void gl_InitModels();
 
@@ -1078,7 +1079,9 @@ void R_InitSprites ()
 	}
 
 	R_InitSpriteDefs ();
-	R_InitVoxels();		// [RH] Parse VOXELDEF
+	// [Zandronum] Voxels are only drawn, lean servers don't load them.
+	if (!leanstartup)
+		R_InitVoxels();		// [RH] Parse VOXELDEF
 	NumStdSprites = sprites.Size();
 	R_InitSkins ();		// [RH] Finish loading skin data
 
@@ -1273,7 +1276,9 @@ void R_InitSprites ()
 	// [RH] Sort the skins, but leave base as skin 0
 	//qsort (&skins[PlayerClasses.Size ()], skins.Size()-PlayerClasses.Size (), sizeof(FPlayerSkin), skinsorter);
 
-	gl_InitModels();
+	// [Zandronum] Neither are the models.
+	if (!leanstartup)
+		gl_InitModels();
 }
 
 void R_DeinitSpriteData()
@@ -57,7 +57,7 @@ enum
 	SIL_BOTH
 };
 
-extern size_t MaxDrawSegs;
+extern RENDER_TLS size_t MaxDrawSegs;
 
 
 //
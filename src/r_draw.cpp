@@ -85,6 +85,12 @@ void (*R_DrawSpanMaskedTranslucent)(void);
 void (*R_DrawSpanAddClamp)(void);
 void (*R_DrawSpanMaskedAddClamp)(void);
 void (STACK_ARGS *rt_map4cols)(int,int,int);
+void (STACK_ARGS *rt_subclamp4cols)(int,int,int);
+void (STACK_ARGS *rt_revsubclamp4cols)(int,int,int);
+#ifndef X86_ASM
+void (STACK_ARGS *rt_add4cols)(int,int,int);
+void (STACK_ARGS *rt_addclamp4cols)(int,int,int);
+#endif
 
 //
 // R_DrawColumn
@@ -93,35 +99,35 @@ void (STACK_ARGS *rt_map4cols)(int,int,int);
 extern "C" {
 int				dc_pitch=0xABadCafe;	// [RH] Distance between rows
 
-lighttable_t*	dc_colormap; 
-int 			dc_x; 
-int 			dc_yl; 
-int 			dc_yh; 
-fixed_t 		dc_iscale; 
-fixed_t 		dc_texturemid;
-fixed_t			dc_texturefrac;
-int				dc_color;				// [RH] Color for column filler
-DWORD			dc_srccolor;
-DWORD			*dc_srcblend;			// [RH] Source and destination
-DWORD			*dc_destblend;			// blending lookups
+RENDER_TLS lighttable_t*	dc_colormap; 
+RENDER_TLS int 			dc_x; 
+RENDER_TLS int 			dc_yl; 
+RENDER_TLS int 			dc_yh; 
+RENDER_TLS fixed_t 		dc_iscale; 
+RENDER_TLS fixed_t 		dc_texturemid;
+RENDER_TLS fixed_t			dc_texturefrac;
+RENDER_TLS int				dc_color;				// [RH] Color for column filler
+RENDER_TLS DWORD			dc_srccolor;
+RENDER_TLS DWORD			*dc_srcblend;			// [RH] Source and destination
+RENDER_TLS DWORD			*dc_destblend;			// blending lookups
 
 // first pixel in a column (possibly virtual) 
-const BYTE*		dc_source;				
+RENDER_TLS const BYTE*		dc_source;				
 
-BYTE*			dc_dest;
-int				dc_count;
+RENDER_TLS BYTE*			dc_dest;
+RENDER_TLS int				dc_count;
 
-DWORD			vplce[4];
-DWORD			vince[4];
-BYTE*			palookupoffse[4];
-const BYTE*		bufplce[4];
+RENDER_TLS DWORD			vplce[4];
+RENDER_TLS DWORD			vince[4];
+RENDER_TLS BYTE*			palookupoffse[4];
+RENDER_TLS const BYTE*		bufplce[4];
 
 // just for profiling 
 int 			dccount;
 }
 
 int dc_fillcolor;
-BYTE *dc_translation;
+RENDER_TLS BYTE *dc_translation;
 BYTE shadetables[NUMCOLORMAPS*16*256];
 FDynamicColormap ShadeFakeColormap[16];
 BYTE identitymap[256];
@@ -417,6 +423,14 @@ void R_InitFuzzTable (int fuzzoff)
 	}
 }
 
+// [Zandronum] Picks where the fuzz pattern starts for the current tic. The
+// C drawer offsets it by column instead of carrying it from one column to
+// the next, so the columns can be drawn in any order.
+void R_UpdateFuzzPos ()
+{
+	fuzzpos = ((DWORD)gametic * 2654435761u >> 16) % FUZZTABLE;
+}
+
 #ifndef X86_ASM
 //
 // Creates a fuzzy image by copying pixels from adjacent ones above and below.
@@ -451,7 +465,7 @@ void R_DrawFuzzColumnP_C (void)
 		// [RH] Make local copies of global vars to try and improve
 		//		the optimizations made by the compiler.
 		int pitch = dc_pitch;
-		int fuzz = fuzzpos;
+		int fuzz = (fuzzpos + dc_x * 7) % FUZZTABLE;
 		int cnt;
 		BYTE *map = &NormalLight.Maps[6*256];
 
@@ -490,7 +504,6 @@ void R_DrawFuzzColumnP_C (void)
 				} while (--count);
 			}
 		}
-		fuzzpos = fuzz;
 	}
 } 
 #endif
@@ -965,23 +978,23 @@ void R_DrawRevSubClampTranslatedColumnP_C ()
 // swapped.
 //
 extern "C" {
-int						ds_color;				// [RH] color for non-textured spans
+RENDER_TLS int						ds_color;				// [RH] color for non-textured spans
 
-int 					ds_y;
-int 					ds_x1;
-int 					ds_x2;
+RENDER_TLS int 					ds_y;
+RENDER_TLS int 					ds_x1;
+RENDER_TLS int 					ds_x2;
 
-lighttable_t*			ds_colormap;
+RENDER_TLS lighttable_t*			ds_colormap;
 
-dsfixed_t 				ds_xfrac;
-dsfixed_t 				ds_yfrac;
-dsfixed_t 				ds_xstep;
-dsfixed_t 				ds_ystep;
-int						ds_xbits;
-int						ds_ybits;
+RENDER_TLS dsfixed_t 				ds_xfrac;
+RENDER_TLS dsfixed_t 				ds_yfrac;
+RENDER_TLS dsfixed_t 				ds_xstep;
+RENDER_TLS dsfixed_t 				ds_ystep;
+RENDER_TLS int						ds_xbits;
+RENDER_TLS int						ds_ybits;
 
 // start of a floor/ceiling tile image 
-const BYTE*				ds_source;
+RENDER_TLS const BYTE*				ds_source;
 
 // just for profiling
 int 					dscount;
@@ -1490,7 +1503,7 @@ void R_FillSpan (void)
 // Actually, this is just R_DrawColumn with an extra width parameter.
 
 #ifndef X86_ASM
-static const BYTE *slabcolormap;
+static RENDER_TLS const BYTE *slabcolormap;
 
 extern "C" void R_SetupDrawSlabC(const BYTE *colormap)
 {
@@ -1579,7 +1592,7 @@ extern "C" void STACK_ARGS R_DrawSlabC(int dx, fixed_t v, int dy, fixed_t vi, co
 
 #ifndef X86_ASM
 static DWORD STACK_ARGS vlinec1 ();
-static int vlinebits;
+static RENDER_TLS int vlinebits;
 
 DWORD (STACK_ARGS *dovline1)() = vlinec1;
 DWORD (STACK_ARGS *doprevline1)() = vlinec1;
@@ -1595,7 +1608,7 @@ void (STACK_ARGS *dovline4)() = vlinec4;
 
 static DWORD STACK_ARGS mvlinec1();
 static void STACK_ARGS mvlinec4();
-static int mvlinebits;
+static RENDER_TLS int mvlinebits;
 
 DWORD (STACK_ARGS *domvline1)() = mvlinec1;
 void (STACK_ARGS *domvline4)() = mvlinec4;
@@ -1760,37 +1773,40 @@ void STACK_ARGS mvlinec4 ()
 }
 #endif
 
-extern "C" short spanend[MAXHEIGHT];
-extern fixed_t rw_light;
-extern fixed_t rw_lightstep;
-extern int wallshade;
+extern "C" RENDER_TLS short spanend[MAXHEIGHT];
+extern RENDER_TLS fixed_t rw_light;
+extern RENDER_TLS fixed_t rw_lightstep;
+extern RENDER_TLS int wallshade;
 
+// [Zandronum] The spans are worked out for the whole boundary, so that they
+// come out the same in every render slice, but only the columns of the
+// current slice are drawn.
 static void R_DrawFogBoundarySection (int y, int y2, int x1)
 {
 	BYTE *colormap = dc_colormap;
 	BYTE *dest = ylookup[y] + dc_destorg;
 
+	x1 = MAX (x1, SliceLeft);
 	for (; y < y2; ++y)
 	{
-		int x2 = spanend[y];
-		int x = x1;
-		do
+		int x2 = MIN<int> (spanend[y], SliceRight - 1);
+		for (int x = x1; x <= x2; ++x)
 		{
 			dest[x] = colormap[dest[x]];
-		} while (++x <= x2);
+		}
 		dest += dc_pitch;
 	}
 }
 
 static void R_DrawFogBoundaryLine (int y, int x)
 {
-	int x2 = spanend[y];
+	int x2 = MIN<int> (spanend[y], SliceRight - 1);
 	BYTE *colormap = dc_colormap;
 	BYTE *dest = ylookup[y] + dc_destorg;
-	do
+	for (x = MAX (x, SliceLeft); x <= x2; ++x)
 	{
 		dest[x] = colormap[dest[x]];
-	} while (++x <= x2);
+	}
 }
 
 void R_DrawFogBoundary (int x1, int x2, short *uclip, short *dclip)
@@ -1799,6 +1815,11 @@ void R_DrawFogBoundary (int x1, int x2, short *uclip, short *dclip)
 	// to create new horizontal spans whenever the light changes enough that
 	// we need to use a new colormap.
 
+	if (x2 < SliceLeft || x1 >= SliceRight)
+	{
+		return;
+	}
+
 	fixed_t lightstep = rw_lightstep;
 	fixed_t light = rw_light+lightstep*(x2-x1);
 	int x = x2;
@@ -1882,7 +1903,7 @@ void R_DrawFogBoundary (int x1, int x2, short *uclip, short *dclip)
 	}
 }
 
-int tmvlinebits;
+RENDER_TLS int tmvlinebits;
 
 void setuptmvline (int bits)
 {
@@ -2167,6 +2188,26 @@ const BYTE *R_GetColumn (FTexture *tex, int col)
 	return tex->GetColumn (col, NULL);
 }
 
+//==========================================================================
+//
+// R_PrepareTexture
+//
+// [Zandronum] Textures build their pixels and spans the first time they are
+// asked for them. While the view is rendered in slices, that has to happen
+// under the resource lock before the slice reads any columns.
+//
+//==========================================================================
+
+void R_PrepareTexture (FTexture *tex)
+{
+	if (RenderingSlices)
+	{
+		FSliceResourceLock lock;
+		const FTexture::Span *spans;
+		tex->GetColumn (0, &spans);
+	}
+}
+
 
 // [RH] Initialize the column drawer pointers
 void R_InitColumnDrawers ()
@@ -2196,6 +2237,19 @@ void R_InitColumnDrawers ()
 	R_DrawSpan					= R_DrawSpanP_C;
 	R_DrawSpanMasked			= R_DrawSpanMaskedP_C;
 	rt_map4cols					= rt_map4cols_c;
+	rt_add4cols					= rt_add4cols_c;
+	rt_addclamp4cols			= rt_addclamp4cols_c;
+#endif
+	rt_subclamp4cols			= rt_subclamp4cols_c;
+	rt_revsubclamp4cols			= rt_revsubclamp4cols_c;
+#ifdef RT_SSE2_DRAWERS
+	if (CPU.bSSE2)
+	{
+		rt_add4cols				= rt_add4cols_sse2;
+		rt_addclamp4cols		= rt_addclamp4cols_sse2;
+		rt_subclamp4cols		= rt_subclamp4cols_sse2;
+		rt_revsubclamp4cols		= rt_revsubclamp4cols_sse2;
+	}
 #endif
 	R_DrawSpanTranslucent		= R_DrawSpanTranslucentP_C;
 	R_DrawSpanMaskedTranslucent = R_DrawSpanMaskedTranslucentP_C;
@@ -2208,7 +2262,7 @@ EXTERN_CVAR (Int, r_drawfuzz)
 EXTERN_CVAR (Bool, r_drawtrans)
 EXTERN_CVAR (Float, transsouls)
 
-static FDynamicColormap *basecolormapsave;
+static RENDER_TLS FDynamicColormap *basecolormapsave;
 
 static bool R_SetBlendFunc (int op, fixed_t fglevel, fixed_t bglevel, int flags)
 {
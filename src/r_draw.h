@@ -29,33 +29,34 @@ extern "C" int			ylookup[MAXHEIGHT];
 
 extern "C" int			dc_pitch;		// [RH] Distance between rows
 
-extern "C" lighttable_t*dc_colormap;
-extern "C" int			dc_x;
-extern "C" int			dc_yl;
-extern "C" int			dc_yh;
-extern "C" fixed_t		dc_iscale;
-extern "C" fixed_t		dc_texturemid;
-extern "C" fixed_t		dc_texturefrac;
-extern "C" int			dc_color;		// [RH] For flat colors (no texturing)
-extern "C" DWORD		dc_srccolor;
-extern "C" DWORD		*dc_srcblend;
-extern "C" DWORD		*dc_destblend;
+extern "C" RENDER_TLS lighttable_t*dc_colormap;
+extern "C" RENDER_TLS int			dc_x;
+extern "C" RENDER_TLS int			dc_yl;
+extern "C" RENDER_TLS int			dc_yh;
+extern "C" RENDER_TLS fixed_t		dc_iscale;
+extern "C" RENDER_TLS fixed_t		dc_texturemid;
+extern "C" RENDER_TLS fixed_t		dc_texturefrac;
+extern "C" RENDER_TLS int			dc_color;		// [RH] For flat colors (no texturing)
+extern "C" RENDER_TLS DWORD		dc_srccolor;
+extern "C" RENDER_TLS DWORD		*dc_srcblend;
+extern "C" RENDER_TLS DWORD		*dc_destblend;
 
 // first pixel in a column
-extern "C" const BYTE*	dc_source;
+extern "C" RENDER_TLS const BYTE*	dc_source;
 
-extern "C" BYTE			*dc_dest, *dc_destorg;
-extern "C" int			dc_count;
+extern "C" RENDER_TLS BYTE	*dc_dest;
+extern "C" BYTE			*dc_destorg;
+extern "C" RENDER_TLS int			dc_count;
 
-extern "C" DWORD		vplce[4];
-extern "C" DWORD		vince[4];
-extern "C" BYTE*		palookupoffse[4];
-extern "C" const BYTE*	bufplce[4];
+extern "C" RENDER_TLS DWORD		vplce[4];
+extern "C" RENDER_TLS DWORD		vince[4];
+extern "C" RENDER_TLS BYTE*		palookupoffse[4];
+extern "C" RENDER_TLS const BYTE*	bufplce[4];
 
 // [RH] Temporary buffer for column drawing
-extern "C" BYTE			*dc_temp;
-extern "C" unsigned int	dc_tspans[4][MAXHEIGHT];
-extern "C" unsigned int	*dc_ctspan[4];
+extern "C" RENDER_TLS BYTE			*dc_temp;
+extern "C" RENDER_TLS unsigned int	dc_tspans[4][MAXHEIGHT];
+extern "C" RENDER_TLS unsigned int	*dc_ctspan[4];
 extern "C" unsigned int	horizspans[4];
 
 
@@ -144,8 +145,8 @@ void rt_tlaterevsubclamp1col (int hx, int sx, int yl, int yh);
 void STACK_ARGS rt_map4cols_c (int sx, int yl, int yh);
 void STACK_ARGS rt_add4cols_c (int sx, int yl, int yh);
 void STACK_ARGS rt_addclamp4cols_c (int sx, int yl, int yh);
-void STACK_ARGS rt_subclamp4cols (int sx, int yl, int yh);
-void STACK_ARGS rt_revsubclamp4cols (int sx, int yl, int yh);
+void STACK_ARGS rt_subclamp4cols_c (int sx, int yl, int yh);
+void STACK_ARGS rt_revsubclamp4cols_c (int sx, int yl, int yh);
 
 void STACK_ARGS rt_tlate4cols (int sx, int yl, int yh);
 void STACK_ARGS rt_tlateadd4cols (int sx, int yl, int yh);
@@ -161,9 +162,22 @@ void STACK_ARGS rt_map4cols_asm1 (int sx, int yl, int yh);
 void STACK_ARGS rt_map4cols_asm2 (int sx, int yl, int yh);
 void STACK_ARGS rt_add4cols_asm (int sx, int yl, int yh);
 void STACK_ARGS rt_addclamp4cols_asm (int sx, int yl, int yh);
+
+void STACK_ARGS rt_add4cols_sse2 (int sx, int yl, int yh);
+void STACK_ARGS rt_addclamp4cols_sse2 (int sx, int yl, int yh);
+void STACK_ARGS rt_subclamp4cols_sse2 (int sx, int yl, int yh);
+void STACK_ARGS rt_revsubclamp4cols_sse2 (int sx, int yl, int yh);
 }
 
+// SSE2 is always present on x86-64, but the drawers are still picked
+// through the CPU detection so that they can be compared with the C ones.
+#if !defined(X86_ASM) && (defined(_M_X64) || defined(__amd64__))
+#define RT_SSE2_DRAWERS
+#endif
+
 extern void (STACK_ARGS *rt_map4cols)(int sx, int yl, int yh);
+extern void (STACK_ARGS *rt_subclamp4cols)(int sx, int yl, int yh);
+extern void (STACK_ARGS *rt_revsubclamp4cols)(int sx, int yl, int yh);
 
 #ifdef X86_ASM
 #define rt_copy1col			rt_copy1col_asm
@@ -177,8 +191,8 @@ extern void (STACK_ARGS *rt_map4cols)(int sx, int yl, int yh);
 #define rt_copy4cols		rt_copy4cols_c
 #define rt_map1col			rt_map1col_c
 #define rt_shaded4cols		rt_shaded4cols_c
-#define rt_add4cols			rt_add4cols_c
-#define rt_addclamp4cols	rt_addclamp4cols_c
+extern void (STACK_ARGS *rt_add4cols)(int sx, int yl, int yh);
+extern void (STACK_ARGS *rt_addclamp4cols)(int sx, int yl, int yh);
 #endif
 
 void rt_draw4cols (int sx);
@@ -233,33 +247,34 @@ void	R_FillSpan (void);
 extern "C" void			   R_SetupDrawSlab(const BYTE *colormap);
 extern "C" void STACK_ARGS R_DrawSlab(int dx, fixed_t v, int dy, fixed_t vi, const BYTE *vptr, BYTE *p);
 
-extern "C" int				ds_y;
-extern "C" int				ds_x1;
-extern "C" int				ds_x2;
+extern "C" RENDER_TLS int				ds_y;
+extern "C" RENDER_TLS int				ds_x1;
+extern "C" RENDER_TLS int				ds_x2;
 
-extern "C" lighttable_t*	ds_colormap;
+extern "C" RENDER_TLS lighttable_t*	ds_colormap;
 
-extern "C" dsfixed_t		ds_xfrac;
-extern "C" dsfixed_t		ds_yfrac;
-extern "C" dsfixed_t		ds_xstep;
-extern "C" dsfixed_t		ds_ystep;
-extern "C" int				ds_xbits;
-extern "C" int				ds_ybits;
-extern "C" fixed_t			ds_alpha;
+extern "C" RENDER_TLS dsfixed_t		ds_xfrac;
+extern "C" RENDER_TLS dsfixed_t		ds_yfrac;
+extern "C" RENDER_TLS dsfixed_t		ds_xstep;
+extern "C" RENDER_TLS dsfixed_t		ds_ystep;
+extern "C" RENDER_TLS int				ds_xbits;
+extern "C" RENDER_TLS int				ds_ybits;
+extern "C" RENDER_TLS fixed_t			ds_alpha;
 
 // start of a 64*64 tile image
-extern "C" const BYTE*		ds_source;
+extern "C" RENDER_TLS const BYTE*		ds_source;
 
-extern "C" int				ds_color;		// [RH] For flat color (no texturing)
+extern "C" RENDER_TLS int				ds_color;		// [RH] For flat color (no texturing)
 
 extern BYTE shadetables[/*NUMCOLORMAPS*16*256*/];
 extern FDynamicColormap ShadeFakeColormap[16];
 extern BYTE identitymap[256];
-extern BYTE *dc_translation;
+extern RENDER_TLS BYTE *dc_translation;
 
 // [RH] Added for muliresolution support
 void R_InitShadeMaps();
 void R_InitFuzzTable (int fuzzoff);
+void R_UpdateFuzzPos ();
 
 // [RH] Consolidate column drawer selection
 enum ESPSResult
@@ -281,6 +296,7 @@ bool R_GetTransMaskDrawers (fixed_t (**tmvline1)(), void (**tmvline4)());
 // to just use the texture's GetColumn() method. It just exists
 // for double-layer skies.
 const BYTE *R_GetColumn (FTexture *tex, int col);
+void R_PrepareTexture (FTexture *tex);
 void wallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixed_t *lwal, fixed_t yrepeat, const BYTE *(*getcol)(FTexture *tex, int col)=R_GetColumn);
 
 // maskwallscan is exactly like wallscan but does not draw anything where the texture is color 0.
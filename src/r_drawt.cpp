@@ -57,11 +57,11 @@
 // dc_ctspan is advanced while drawing into dc_temp.
 // horizspan is advanced up to dc_ctspan when drawing from dc_temp to the screen.
 
-BYTE dc_tempbuff[MAXHEIGHT*4];
-BYTE *dc_temp;
-unsigned int dc_tspans[4][MAXHEIGHT];
-unsigned int *dc_ctspan[4];
-unsigned int *horizspan[4];
+RENDER_TLS BYTE dc_tempbuff[MAXHEIGHT*4];
+RENDER_TLS BYTE *dc_temp;
+RENDER_TLS unsigned int dc_tspans[4][MAXHEIGHT];
+RENDER_TLS unsigned int *dc_ctspan[4];
+RENDER_TLS unsigned int *horizspan[4];
 
 #ifdef X86_ASM
 extern "C" void R_SetupShadedCol();
@@ -656,7 +656,7 @@ void rt_subclamp1col (int hx, int sx, int yl, int yh)
 }
 
 // Subtracts all four spans to the screen starting at sx with clamping.
-void STACK_ARGS rt_subclamp4cols (int sx, int yl, int yh)
+void STACK_ARGS rt_subclamp4cols_c (int sx, int yl, int yh)
 {
 	BYTE *colormap;
 	BYTE *source;
@@ -765,7 +765,7 @@ void rt_revsubclamp1col (int hx, int sx, int yl, int yh)
 }
 
 // Subtracts all four spans from the screen starting at sx with clamping.
-void STACK_ARGS rt_revsubclamp4cols (int sx, int yl, int yh)
+void STACK_ARGS rt_revsubclamp4cols_c (int sx, int yl, int yh)
 {
 	BYTE *colormap;
 	BYTE *source;
@@ -0,0 +1,361 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: r_drawt_sse2.cpp
+//
+//-----------------------------------------------------------------------------
+//
+// SSE2 versions of the translucent rt_*4cols drawers. The palette lookups
+// still have to be done one pixel at a time, but the RGB arithmetic for all
+// four columns is done at once. The results are identical to the C drawers
+// in r_drawt.cpp.
+//
+//-----------------------------------------------------------------------------
+
+#include "templates.h"
+#include "doomtype.h"
+#include "doomdef.h"
+#include "r_defs.h"
+#include "r_draw.h"
+#include "r_main.h"
+#include "v_video.h"
+#include "v_palette.h"
+#include "v_text.h"
+#include "c_dispatch.h"
+#include "stats.h"
+#include "x86.h"
+
+#ifdef RT_SSE2_DRAWERS
+
+#include <emmintrin.h>
+
+// Looks up the four blend table entries for one row of the temporary buffer.
+#define FG4(fg2rgb, colormap, source) \
+	_mm_setr_epi32 (fg2rgb[colormap[source[0]]], fg2rgb[colormap[source[1]]], \
+					fg2rgb[colormap[source[2]]], fg2rgb[colormap[source[3]]])
+
+// Looks up the four blend table entries for the screen pixels under a row.
+#define BG4(bg2rgb, dest) \
+	_mm_setr_epi32 (bg2rgb[dest[0]], bg2rgb[dest[1]], bg2rgb[dest[2]], bg2rgb[dest[3]])
+
+//==========================================================================
+//
+// rt_store4
+//
+// Converts four R5G5B5 values, each of which the C drawers would compute
+// as (a>>15) & a, into palette entries and writes them to the screen.
+//
+//==========================================================================
+
+static inline void rt_store4 (BYTE *dest, __m128i a)
+{
+	a = _mm_and_si128 (a, _mm_srli_epi32 (a, 15));
+	// All values fit in 15 bits, so they survive the signed saturation.
+	a = _mm_packs_epi32 (a, a);
+	dest[0] = RGB32k[0][0][_mm_extract_epi16 (a, 0)];
+	dest[1] = RGB32k[0][0][_mm_extract_epi16 (a, 1)];
+	dest[2] = RGB32k[0][0][_mm_extract_epi16 (a, 2)];
+	dest[3] = RGB32k[0][0][_mm_extract_epi16 (a, 3)];
+}
+
+// Adds all four spans to the screen starting at sx without clamping.
+void STACK_ARGS rt_add4cols_sse2 (int sx, int yl, int yh)
+{
+	BYTE *colormap;
+	BYTE *source;
+	BYTE *dest;
+	int count;
+	int pitch;
+
+	count = yh-yl;
+	if (count < 0)
+		return;
+	count++;
+
+	DWORD *fg2rgb = dc_srcblend;
+	DWORD *bg2rgb = dc_destblend;
+	dest = ylookup[yl] + sx + dc_destorg;
+	source = &dc_temp[yl*4];
+	pitch = dc_pitch;
+	colormap = dc_colormap;
+
+	const __m128i lowbits = _mm_set1_epi32 (0x1f07c1f);
+
+	do {
+		__m128i fg = FG4 (fg2rgb, colormap, source);
+		__m128i bg = BG4 (bg2rgb, dest);
+		rt_store4 (dest, _mm_or_si128 (_mm_add_epi32 (fg, bg), lowbits));
+		source += 4;
+		dest += pitch;
+	} while (--count);
+}
+
+// Adds all four spans to the screen starting at sx with clamping.
+void STACK_ARGS rt_addclamp4cols_sse2 (int sx, int yl, int yh)
+{
+	BYTE *colormap;
+	BYTE *source;
+	BYTE *dest;
+	int count;
+	int pitch;
+
+	count = yh-yl;
+	if (count < 0)
+		return;
+	count++;
+
+	DWORD *fg2rgb = dc_srcblend;
+	DWORD *bg2rgb = dc_destblend;
+	dest = ylookup[yl] + sx + dc_destorg;
+	source = &dc_temp[yl*4];
+	pitch = dc_pitch;
+	colormap = dc_colormap;
+
+	const __m128i lowbits = _mm_set1_epi32 (0x01f07c1f);
+	const __m128i carries = _mm_set1_epi32 (0x40100400);
+	const __m128i fields = _mm_set1_epi32 (0x3fffffff);
+
+	do {
+		__m128i a = _mm_add_epi32 (FG4 (fg2rgb, colormap, source), BG4 (bg2rgb, dest));
+		__m128i b = _mm_and_si128 (a, carries);
+
+		a = _mm_and_si128 (_mm_or_si128 (a, lowbits), fields);
+		b = _mm_sub_epi32 (b, _mm_srli_epi32 (b, 5));
+		rt_store4 (dest, _mm_or_si128 (a, b));
+		source += 4;
+		dest += pitch;
+	} while (--count);
+}
+
+// Subtracts all four spans to the screen starting at sx with clamping.
+void STACK_ARGS rt_subclamp4cols_sse2 (int sx, int yl, int yh)
+{
+	BYTE *colormap;
+	BYTE *source;
+	BYTE *dest;
+	int count;
+	int pitch;
+
+	count = yh-yl;
+	if (count < 0)
+		return;
+	count++;
+
+	DWORD *fg2rgb = dc_srcblend;
+	DWORD *bg2rgb = dc_destblend;
+	dest = ylookup[yl] + sx + dc_destorg;
+	source = &dc_temp[yl*4];
+	pitch = dc_pitch;
+	colormap = dc_colormap;
+
+	const __m128i lowbits = _mm_set1_epi32 (0x01f07c1f);
+	const __m128i carries = _mm_set1_epi32 (0x40100400);
+
+	do {
+		__m128i a = _mm_sub_epi32 (_mm_or_si128 (FG4 (fg2rgb, colormap, source), carries), BG4 (bg2rgb, dest));
+		__m128i b = _mm_and_si128 (a, carries);
+
+		b = _mm_sub_epi32 (b, _mm_srli_epi32 (b, 5));
+		rt_store4 (dest, _mm_or_si128 (_mm_and_si128 (a, b), lowbits));
+		source += 4;
+		dest += pitch;
+	} while (--count);
+}
+
+// Subtracts all four spans from the screen starting at sx with clamping.
+void STACK_ARGS rt_revsubclamp4cols_sse2 (int sx, int yl, int yh)
+{
+	BYTE *colormap;
+	BYTE *source;
+	BYTE *dest;
+	int count;
+	int pitch;
+
+	count = yh-yl;
+	if (count < 0)
+		return;
+	count++;
+
+	DWORD *fg2rgb = dc_srcblend;
+	DWORD *bg2rgb = dc_destblend;
+	dest = ylookup[yl] + sx + dc_destorg;
+	source = &dc_temp[yl*4];
+	pitch = dc_pitch;
+	colormap = dc_colormap;
+
+	const __m128i lowbits = _mm_set1_epi32 (0x01f07c1f);
+	const __m128i carries = _mm_set1_epi32 (0x40100400);
+
+	do {
+		__m128i a = _mm_sub_epi32 (_mm_or_si128 (BG4 (bg2rgb, dest), carries), FG4 (fg2rgb, colormap, source));
+		__m128i b = _mm_and_si128 (a, carries);
+
+		b = _mm_sub_epi32 (b, _mm_srli_epi32 (b, 5));
+		rt_store4 (dest, _mm_or_si128 (_mm_and_si128 (a, b), lowbits));
+		source += 4;
+		dest += pitch;
+	} while (--count);
+}
+
+#endif // RT_SSE2_DRAWERS
+
+//==========================================================================
+//
+// CCMD bench_drawers
+//
+// Runs the C and SSE2 versions of the translucent 4-column drawers over
+// the same random input, checks that they produce the same pixels and
+// reports how long each one took.
+//
+// Usage: bench_drawers [passes]
+//
+//==========================================================================
+
+CCMD (bench_drawers)
+{
+#ifndef RT_SSE2_DRAWERS
+	Printf ("This build has no SSE2 drawers.\n");
+#else
+	struct DrawerPair
+	{
+		const char *Name;
+		void (STACK_ARGS *C)(int sx, int yl, int yh);
+		void (STACK_ARGS *SSE2)(int sx, int yl, int yh);
+		bool LessPrecision;
+	};
+	static const DrawerPair drawers[] =
+	{
+		{ "add",			rt_add4cols_c,			rt_add4cols_sse2,			false },
+		{ "addclamp",		rt_addclamp4cols_c,		rt_addclamp4cols_sse2,		true },
+		{ "subclamp",		rt_subclamp4cols_c,		rt_subclamp4cols_sse2,		true },
+		{ "revsubclamp",	rt_revsubclamp4cols_c,	rt_revsubclamp4cols_sse2,	true },
+	};
+
+	if (dc_pitch <= 0 || screen == NULL)
+	{
+		Printf ("The software renderer has not been set up yet.\n");
+		return;
+	}
+
+	const int passes = MAX (argv.argc() > 1 ? atoi (argv[1]) : 100, 1);
+	const int width = dc_pitch & ~3;
+	const int height = MIN (screen->GetHeight(), MAXHEIGHT);
+
+	// The drawers use the real ylookup table, so the test buffers must have
+	// the same pitch as the screen.
+	BYTE *cbuffer = new BYTE[dc_pitch * height];
+	BYTE *ssebuffer = new BYTE[dc_pitch * height];
+	BYTE *background = new BYTE[dc_pitch * height];
+	for (int i = 0; i < dc_pitch * height; ++i)
+	{
+		background[i] = BYTE(rand());
+	}
+
+	BYTE *savedtemp = dc_temp;
+	BYTE *saveddestorg = dc_destorg;
+	BYTE *savedcolormap = dc_colormap;
+	DWORD *savedsrcblend = dc_srcblend;
+	DWORD *saveddestblend = dc_destblend;
+
+	rt_initcols ();
+	for (int i = 0; i < height * 4; ++i)
+	{
+		dc_temp[i] = BYTE(rand());
+	}
+	dc_colormap = identitymap;
+
+	for (size_t i = 0; i < countof(drawers); ++i)
+	{
+		cycle_t ctime, ssetime;
+		ctime.Reset();
+		ssetime.Reset();
+		memcpy (cbuffer, background, dc_pitch * height);
+		memcpy (ssebuffer, background, dc_pitch * height);
+
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			// Use a different alpha for each pass to cover the blend tables.
+			const int fglevel = (pass * 7) & 63;
+			if (drawers[i].LessPrecision)
+			{
+				dc_srcblend = Col2RGB8_LessPrecision[fglevel];
+				dc_destblend = Col2RGB8_LessPrecision[64 - fglevel];
+			}
+			else
+			{
+				dc_srcblend = Col2RGB8[fglevel];
+				dc_destblend = Col2RGB8[64 - fglevel];
+			}
+
+			dc_destorg = cbuffer;
+			ctime.Clock();
+			for (int x = 0; x < width; x += 4)
+			{
+				drawers[i].C (x, 0, height - 1);
+			}
+			ctime.Unclock();
+
+			dc_destorg = ssebuffer;
+			ssetime.Clock();
+			for (int x = 0; x < width; x += 4)
+			{
+				drawers[i].SSE2 (x, 0, height - 1);
+			}
+			ssetime.Unclock();
+		}
+
+		const bool same = memcmp (cbuffer, ssebuffer, dc_pitch * height) == 0;
+		Printf ("%-12s C: %8.3f ms  SSE2: %8.3f ms  %s\n", drawers[i].Name,
+			ctime.TimeMS(), ssetime.TimeMS(), same ? "identical" : TEXTCOLOR_RED "MISMATCH");
+	}
+
+	dc_temp = savedtemp;
+	dc_destorg = saveddestorg;
+	dc_colormap = savedcolormap;
+	dc_srcblend = savedsrcblend;
+	dc_destblend = saveddestblend;
+
+	delete[] cbuffer;
+	delete[] ssebuffer;
+	delete[] background;
+#endif
+}
@@ -27,6 +27,9 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 // [BB] network.h has to be included before stats.h under Linux.
 // The reason should be investigated.
@@ -88,17 +91,18 @@ void R_DeinitSprites();
 // PRIVATE FUNCTION PROTOTYPES ---------------------------------------------
 
 static void R_ShutdownRenderer();
+static void R_StopSliceThreads ();
 
 // EXTERNAL DATA DECLARATIONS ----------------------------------------------
 
-extern short *openings;
-extern bool r_fakingunderwater;
+extern RENDER_TLS short *openings;
+extern RENDER_TLS bool r_fakingunderwater;
 extern "C" int fuzzviewheight;
 
 
 // PRIVATE DATA DECLARATIONS -----------------------------------------------
 
-static float CurrentVisibility = 8.f;
+static RENDER_TLS float CurrentVisibility = 8.f;
 static fixed_t MaxVisForWall;
 static fixed_t MaxVisForFloor;
 static bool polyclipped;
@@ -111,22 +115,22 @@ CVAR (String, r_viewsize, "", CVAR_NOSET)
 CVAR (Int, r_polymost, 0, 0)
 CVAR (Bool, r_shadercolormaps, true, CVAR_ARCHIVE)
 
-fixed_t			r_BaseVisibility;
-fixed_t			r_WallVisibility;
-fixed_t			r_FloorVisibility;
-float			r_TiltVisibility;
-fixed_t			r_SpriteVisibility;
-fixed_t			r_ParticleVisibility;
-fixed_t			r_SkyVisibility;
+RENDER_TLS fixed_t			r_BaseVisibility;
+RENDER_TLS fixed_t			r_WallVisibility;
+RENDER_TLS fixed_t			r_FloorVisibility;
+RENDER_TLS float			r_TiltVisibility;
+RENDER_TLS fixed_t			r_SpriteVisibility;
+RENDER_TLS fixed_t			r_ParticleVisibility;
+RENDER_TLS fixed_t			r_SkyVisibility;
 
-fixed_t			GlobVis;
+RENDER_TLS fixed_t			GlobVis;
 fixed_t			viewingrangerecip;
 fixed_t			FocalLengthX;
 fixed_t			FocalLengthY;
 float			FocalLengthXfloat;
-FDynamicColormap*basecolormap;		// [RH] colormap currently drawing with
+RENDER_TLS FDynamicColormap*basecolormap;		// [RH] colormap currently drawing with
 int				fixedlightlev;
-lighttable_t	*fixedcolormap;
+RENDER_TLS lighttable_t	*fixedcolormap;
 FSpecialColormap *realfixedcolormap;
 float			WallTMapScale;
 float			WallTMapScale2;
@@ -135,7 +139,7 @@ float			WallTMapScale2;
 bool			bRenderingToCanvas;	// [RH] True if rendering to a special canvas
 fixed_t			globaluclip, globaldclip;
 fixed_t 		centerxfrac;
-fixed_t 		centeryfrac;
+RENDER_TLS fixed_t 		centeryfrac;
 fixed_t			yaspectmul;
 fixed_t			baseyaspectmul;		// yaspectmul without a forced aspect ratio
 float			iyaspectmulfloat;
@@ -155,26 +159,69 @@ int 			loopcount;
 // from clipangle to -clipangle.
 angle_t 		xtoviewangle[MAXWIDTH+1];
 
-bool			foggy;			// [RH] ignore extralight and fullbright?
-int				r_actualextralight;
+RENDER_TLS bool			foggy;			// [RH] ignore extralight and fullbright?
+RENDER_TLS int				r_actualextralight;
 
-void (*colfunc) (void);
+RENDER_TLS void (*colfunc) (void);
 void (*basecolfunc) (void);
 void (*fuzzcolfunc) (void);
 void (*transcolfunc) (void);
-void (*spanfunc) (void);
+RENDER_TLS void (*spanfunc) (void);
 
-void (*hcolfunc_pre) (void);
-void (*hcolfunc_post1) (int hx, int sx, int yl, int yh);
-void (*hcolfunc_post2) (int hx, int sx, int yl, int yh);
-void (STACK_ARGS *hcolfunc_post4) (int sx, int yl, int yh);
+RENDER_TLS void (*hcolfunc_pre) (void);
+RENDER_TLS void (*hcolfunc_post1) (int hx, int sx, int yl, int yh);
+RENDER_TLS void (*hcolfunc_post2) (int hx, int sx, int yl, int yh);
+RENDER_TLS void (STACK_ARGS *hcolfunc_post4) (int sx, int yl, int yh);
 
-cycle_t WallCycles, PlaneCycles, MaskedCycles, WallScanCycles;
+RENDER_TLS cycle_t WallCycles, PlaneCycles, MaskedCycles, WallScanCycles;
+
+RENDER_TLS int	SliceLeft = 0, SliceRight = MAXWIDTH;
+bool			RenderingSlices;
+
+// [Zandronum] 1 renders the view on the main thread only, 0 uses one slice
+// per hardware thread.
+CUSTOM_CVAR (Int, r_slices, 1, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+{
+	if (self < 0)
+	{
+		self = 0;
+	}
+	else if (self > MAX_RENDER_SLICES)
+	{
+		self = MAX_RENDER_SLICES;
+	}
+}
 
 // PRIVATE DATA DEFINITIONS ------------------------------------------------
 
 static int lastcenteryfrac;
 
+// [Zandronum] The view the slice threads render, copied from the main
+// thread's render state.
+static struct
+{
+	fixed_t viewx, viewy, viewz;
+	angle_t viewangle;
+	fixed_t viewsin, viewcos, viewtansin, viewtancos;
+	sector_t *viewsector;
+	AActor *camera;
+	int extralight;
+	lighttable_t *fixedcolormap;
+	FDynamicColormap *basecolormap;
+	fixed_t centeryfrac;
+	float visibility;
+} SliceView;
+
+static std::thread SliceThreads[MAX_RENDER_SLICES-1];
+static int NumSliceThreads;
+static int NumSlices;
+static int SliceFrame;
+static int SlicesPending;
+static bool SliceThreadsQuit;
+static std::mutex SliceMutex;
+static std::condition_variable SliceStart, SliceDone;
+static std::recursive_mutex SliceResourceMutex;
+
 // CODE --------------------------------------------------------------------
 
 //==========================================================================
@@ -490,11 +537,13 @@ void R_InitRenderer()
 
 //==========================================================================
 //
-// R_ShutdownRenderer
+// R_FreeRenderBuffers
+//
+// Frees the calling thread's sprite, plane, opening and drawseg buffers.
 //
 //==========================================================================
 
-static void R_ShutdownRenderer()
+static void R_FreeRenderBuffers ()
 {
 	R_DeinitSprites();
 	R_DeinitPlanes();
@@ -513,6 +562,18 @@ static void R_ShutdownRenderer()
 	}
 }
 
+//==========================================================================
+//
+// R_ShutdownRenderer
+//
+//==========================================================================
+
+static void R_ShutdownRenderer()
+{
+	R_StopSliceThreads ();
+	R_FreeRenderBuffers ();
+}
+
 //==========================================================================
 //
 // R_CopyStackedViewParameters
@@ -706,7 +767,7 @@ void R_EnterMirror (drawseg_t *ds, int depth)
 
 	R_CopyStackedViewParameters();
 
-	validcount++;
+	R_NewSpriteValidCount ();
 	ActiveWallMirror = ds->curline;
 
 	R_ClearPlanes (false);
@@ -776,30 +837,85 @@ void R_SetupBuffer ()
 
 //==========================================================================
 //
-// R_RenderActorView
+// R_GetNumRenderSlices
+//
+// [Zandronum] Returns how many slices the next view should be split into.
 //
 //==========================================================================
 
-void R_RenderActorView (AActor *actor, bool dontmaplines)
+int R_GetNumRenderSlices ()
 {
-	WallCycles.Reset();
-	PlaneCycles.Reset();
-	MaskedCycles.Reset();
-	WallScanCycles.Reset();
+#if defined(X86_ASM) || defined(X64_ASM)
+	return 1;
+#else
+	if (r_polymost || r_drawflat)
+	{
+		return 1;
+	}
 
-	fakeActive = 0; // kg3D - reset fake floor indicator
-	R_3D_ResetClip(); // reset clips (floor/ceiling)
+	int slices = r_slices;
+	if (slices == 0)
+	{
+		slices = clamp<int> (std::thread::hardware_concurrency (), 1, MAX_RENDER_SLICES);
+	}
+	// Slices are made of 16 column blocks so that the quad column drawers
+	// and tilted plane blocks never straddle two of them.
+	return MIN (slices, (viewwidth + 15) / 16);
+#endif
+}
 
-	R_SetupBuffer ();
-	R_SetupFrame (actor);
+//==========================================================================
+//
+// R_NetUpdate
+//
+// NetUpdate may touch the game state, so it is left out while the slice
+// threads are walking the level. The main thread catches up afterwards.
+//
+//==========================================================================
 
+void R_NetUpdate ()
+{
+	if (!RenderingSlices)
+	{
+		NetUpdate ();
+	}
+}
+
+//==========================================================================
+//
+// R_LockSliceResources
+//
+//==========================================================================
+
+void R_LockSliceResources ()
+{
+	SliceResourceMutex.lock ();
+}
+
+void R_UnlockSliceResources ()
+{
+	SliceResourceMutex.unlock ();
+}
+
+//==========================================================================
+//
+// R_RenderScene
+//
+// Draws the view set up by R_RenderActorView, limited to the columns of
+// the current slice.
+//
+//==========================================================================
+
+static void R_RenderScene ()
+{
 	// Clear buffers.
 	R_ClearClipSegs (0, viewwidth);
 	R_ClearDrawSegs ();
 	R_ClearPlanes (true);
 	R_ClearSprites ();
+	R_NewSpriteValidCount ();
 
-	NetUpdate ();
+	R_NetUpdate ();
 
 	// [RH] Show off segs if r_drawflat is 1
 	if (r_drawflat)
@@ -824,32 +940,21 @@ void R_RenderActorView (AActor *actor, bool dontmaplines)
 	MirrorFlags = 0;
 	ActiveWallMirror = NULL;
 
-	r_dontmaplines = dontmaplines;
-	
 	// [RH] Hack to make windows into underwater areas possible
 	r_fakingunderwater = false;
 
-	// [RH] Setup particles for this frame
-	P_FindParticleSubsectors ();
-
 	WallCycles.Clock();
-	DWORD savedflags = camera->renderflags;
 	// Never draw the player unless in chasecam mode
-	if (!r_showviewer)
-	{
-		camera->renderflags |= RF_INVISIBLE;
-	}
-	// Link the polyobjects right before drawing the scene to reduce the amounts of calls to this function
-	PO_LinkToSubsectors();
+	r_hiddenviewer = r_showviewer ? NULL : camera;
 	if (r_polymost < 2)
 	{
 		R_RenderBSPNode (nodes + numnodes - 1);	// The head node is the last node output.
 		R_3D_ResetClip(); // reset clips (floor/ceiling)
 	}
-	camera->renderflags = savedflags;
+	r_hiddenviewer = NULL;
 	WallCycles.Unclock();
 
-	NetUpdate ();
+	R_NetUpdate ();
 
 	if (viewactive)
 	{
@@ -865,13 +970,13 @@ void R_RenderActorView (AActor *actor, bool dontmaplines)
 			R_EnterMirror (drawsegs + WallMirrors[i], 0);
 		}
 
-		NetUpdate ();
+		R_NetUpdate ();
 		
 		MaskedCycles.Clock();
 		R_DrawMasked ();
 		MaskedCycles.Unclock();
 
-		NetUpdate ();
+		R_NetUpdate ();
 
 		if (r_polymost)
 		{
@@ -884,6 +989,207 @@ void R_RenderActorView (AActor *actor, bool dontmaplines)
 		}
 	}
 	WallMirrors.Clear ();
+}
+
+//==========================================================================
+//
+// R_RenderSlice
+//
+// Renders slice number <slice> of NumSlices. The slice threads first pick
+// up the view the main thread set up.
+//
+//==========================================================================
+
+static void R_RenderSlice (int slice)
+{
+	if (slice != 0)
+	{
+		viewx = SliceView.viewx;
+		viewy = SliceView.viewy;
+		viewz = SliceView.viewz;
+		viewangle = SliceView.viewangle;
+		viewsin = SliceView.viewsin;
+		viewcos = SliceView.viewcos;
+		viewtansin = SliceView.viewtansin;
+		viewtancos = SliceView.viewtancos;
+		viewsector = SliceView.viewsector;
+		camera = SliceView.camera;
+		extralight = SliceView.extralight;
+		fixedcolormap = SliceView.fixedcolormap;
+		basecolormap = SliceView.basecolormap;
+		centeryfrac = SliceView.centeryfrac;
+		R_SetVisibility (SliceView.visibility);
+		R_CopyStackedViewParameters ();
+
+		fakeActive = 0; // kg3D - reset fake floor indicator
+		R_3D_ResetClip(); // reset clips (floor/ceiling)
+	}
+
+	int blocks = (viewwidth + 15) / 16;
+	SliceLeft = 16 * (slice * blocks / NumSlices);
+	SliceRight = MIN (16 * ((slice + 1) * blocks / NumSlices), viewwidth);
+
+	R_RenderScene ();
+}
+
+//==========================================================================
+//
+// R_SliceThreadFunc
+//
+//==========================================================================
+
+static void R_SliceThreadFunc (int slice, int frame)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock (SliceMutex);
+			SliceStart.wait (lock, [frame] { return SliceThreadsQuit || SliceFrame != frame; });
+			if (SliceThreadsQuit)
+			{
+				break;
+			}
+			frame = SliceFrame;
+			if (slice >= NumSlices)
+			{
+				continue;
+			}
+		}
+
+		R_RenderSlice (slice);
+
+		std::lock_guard<std::mutex> lock (SliceMutex);
+		if (--SlicesPending == 0)
+		{
+			SliceDone.notify_one ();
+		}
+	}
+	R_FreeRenderBuffers ();
+}
+
+//==========================================================================
+//
+// R_StopSliceThreads
+//
+//==========================================================================
+
+static void R_StopSliceThreads ()
+{
+	{
+		std::lock_guard<std::mutex> lock (SliceMutex);
+		SliceThreadsQuit = true;
+	}
+	SliceStart.notify_all ();
+	for (int i = 0; i < NumSliceThreads; i++)
+	{
+		SliceThreads[i].join ();
+	}
+	NumSliceThreads = 0;
+	SliceThreadsQuit = false;
+}
+
+//==========================================================================
+//
+// R_RenderSlices
+//
+// Renders slice 0 on the calling thread and the others on the slice
+// threads, starting more of them if needed.
+//
+//==========================================================================
+
+static void R_RenderSlices (int slices)
+{
+	SliceView.viewx = viewx;
+	SliceView.viewy = viewy;
+	SliceView.viewz = viewz;
+	SliceView.viewangle = viewangle;
+	SliceView.viewsin = viewsin;
+	SliceView.viewcos = viewcos;
+	SliceView.viewtansin = viewtansin;
+	SliceView.viewtancos = viewtancos;
+	SliceView.viewsector = viewsector;
+	SliceView.camera = camera;
+	SliceView.extralight = extralight;
+	SliceView.fixedcolormap = fixedcolormap;
+	SliceView.basecolormap = basecolormap;
+	SliceView.centeryfrac = centeryfrac;
+	SliceView.visibility = R_GetVisibility ();
+
+	// Polyobject BSPs are built on demand while walking the level.
+	R_BuildDirtyPolyBSPs ();
+
+	{
+		std::lock_guard<std::mutex> lock (SliceMutex);
+		while (NumSliceThreads < slices - 1)
+		{
+			SliceThreads[NumSliceThreads] = std::thread (R_SliceThreadFunc, NumSliceThreads + 1, SliceFrame);
+			NumSliceThreads++;
+		}
+		NumSlices = slices;
+		SlicesPending = slices - 1;
+		SliceFrame++;
+		RenderingSlices = true;
+	}
+	SliceStart.notify_all ();
+
+	R_RenderSlice (0);
+
+	{
+		std::unique_lock<std::mutex> lock (SliceMutex);
+		SliceDone.wait (lock, [] { return SlicesPending == 0; });
+		RenderingSlices = false;
+	}
+	SliceLeft = 0;
+	SliceRight = MAXWIDTH;
+}
+
+//==========================================================================
+//
+// R_RenderActorView
+//
+//==========================================================================
+
+void R_RenderActorView (AActor *actor, bool dontmaplines)
+{
+	WallCycles.Reset();
+	PlaneCycles.Reset();
+	MaskedCycles.Reset();
+	WallScanCycles.Reset();
+
+	fakeActive = 0; // kg3D - reset fake floor indicator
+	R_3D_ResetClip(); // reset clips (floor/ceiling)
+
+	R_SetupBuffer ();
+	R_SetupFrame (actor);
+
+	r_dontmaplines = dontmaplines;
+
+	// [RH] Setup particles for this frame
+	P_FindParticleSubsectors ();
+
+	// Link the polyobjects right before drawing the scene to reduce the amounts of calls to this function
+	PO_LinkToSubsectors();
+	R_UpdateFuzzPos ();
+
+	int slices = R_GetNumRenderSlices ();
+	if (slices > 1)
+	{
+		R_RenderSlices (slices);
+	}
+	else
+	{
+		R_RenderScene ();
+	}
+
+	// [Zandronum] The slices leave the weapon out so that it is drawn once,
+	// over all of them.
+	if (slices > 1 && viewactive)
+	{
+		R_DrawPlayerSprites ();
+	}
+
+	NetUpdate ();
+
 	interpolator.RestoreInterpolations ();
 	R_SetupBuffer ();
 
@@ -949,7 +1255,7 @@ void R_MultiresInit ()
 // Displays statistics about rendering times
 //
 //==========================================================================
-extern cycle_t WallCycles, PlaneCycles, MaskedCycles, WallScanCycles;
+extern RENDER_TLS cycle_t WallCycles, PlaneCycles, MaskedCycles, WallScanCycles;
 extern cycle_t FrameCycles;
 
 ADD_STAT (fps)
@@ -35,8 +35,8 @@ typedef BYTE lighttable_t;	// This could be wider for >8 bit display.
 // POV related.
 //
 extern bool				bRenderingToCanvas;
-extern fixed_t			viewcos;
-extern fixed_t			viewsin;
+extern RENDER_TLS fixed_t			viewcos;
+extern RENDER_TLS fixed_t			viewsin;
 extern fixed_t			viewingrangerecip;
 extern fixed_t			FocalLengthX, FocalLengthY;
 extern float			FocalLengthXfloat;
@@ -49,11 +49,11 @@ extern int				viewwindowx;
 extern int				viewwindowy;
 
 extern fixed_t			centerxfrac;
-extern fixed_t			centeryfrac;
+extern RENDER_TLS fixed_t			centeryfrac;
 extern fixed_t			yaspectmul;
 extern float			iyaspectmulfloat;
 
-extern FDynamicColormap*basecolormap;	// [RH] Colormap for sector currently being drawn
+extern RENDER_TLS FDynamicColormap*basecolormap;	// [RH] Colormap for sector currently being drawn
 
 extern int				linecount;
 extern int				loopcount;
@@ -84,22 +84,22 @@ extern bool				r_dontmaplines;
 // Change R_CalcTiltedLighting() when this changes.
 #define GETPALOOKUP(vis,shade)	(clamp<int> (((shade)-MIN(MAXLIGHTVIS,(vis)))>>FRACBITS, 0, NUMCOLORMAPS-1))
 
-extern fixed_t			GlobVis;
+extern RENDER_TLS fixed_t			GlobVis;
 
 void R_SetVisibility (float visibility);
 float R_GetVisibility ();
 
-extern fixed_t			r_BaseVisibility;
-extern fixed_t			r_WallVisibility;
-extern fixed_t			r_FloorVisibility;
-extern float			r_TiltVisibility;
-extern fixed_t			r_SpriteVisibility;
-extern fixed_t			r_SkyVisibility;
+extern RENDER_TLS fixed_t			r_BaseVisibility;
+extern RENDER_TLS fixed_t			r_WallVisibility;
+extern RENDER_TLS fixed_t			r_FloorVisibility;
+extern RENDER_TLS float			r_TiltVisibility;
+extern RENDER_TLS fixed_t			r_SpriteVisibility;
+extern RENDER_TLS fixed_t			r_SkyVisibility;
 
-extern int				r_actualextralight;
-extern bool				foggy;
+extern RENDER_TLS int				r_actualextralight;
+extern RENDER_TLS bool				foggy;
 extern int				fixedlightlev;
-extern lighttable_t*	fixedcolormap;
+extern RENDER_TLS lighttable_t*	fixedcolormap;
 extern FSpecialColormap*realfixedcolormap;
 
 
@@ -107,18 +107,18 @@ extern FSpecialColormap*realfixedcolormap;
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void 			(*colfunc) (void);
+extern RENDER_TLS void 			(*colfunc) (void);
 extern void 			(*basecolfunc) (void);
 extern void 			(*fuzzcolfunc) (void);
 extern void				(*transcolfunc) (void);
 // No shadow effects on floors.
-extern void 			(*spanfunc) (void);
+extern RENDER_TLS void 			(*spanfunc) (void);
 
 // [RH] Function pointers for the horizontal column drawers.
-extern void (*hcolfunc_pre) (void);
-extern void (*hcolfunc_post1) (int hx, int sx, int yl, int yh);
-extern void (*hcolfunc_post2) (int hx, int sx, int yl, int yh);
-extern void (STACK_ARGS *hcolfunc_post4) (int sx, int yl, int yh);
+extern RENDER_TLS void (*hcolfunc_pre) (void);
+extern RENDER_TLS void (*hcolfunc_post1) (int hx, int sx, int yl, int yh);
+extern RENDER_TLS void (*hcolfunc_post2) (int hx, int sx, int yl, int yh);
+extern RENDER_TLS void (STACK_ARGS *hcolfunc_post4) (int sx, int yl, int yh);
 
 
 void R_InitTextureMapping ();
@@ -137,11 +137,32 @@ void R_RenderViewToCanvas (AActor *actor, DCanvas *canvas, int x, int y, int wid
 // [RH] Initialize multires stuff for renderer
 void R_MultiresInit (void);
 
+// [Zandronum] Rendering the view in vertical slices on several threads. Every
+// slice walks the whole scene, but only draws the columns in
+// [SliceLeft, SliceRight); outside of a slice that is the whole view.
+#define MAX_RENDER_SLICES		16
 
-extern int stacked_extralight;
-extern float stacked_visibility;
-extern fixed_t stacked_viewx, stacked_viewy, stacked_viewz;
-extern angle_t stacked_angle;
+extern RENDER_TLS int	SliceLeft, SliceRight;
+extern bool				RenderingSlices;
+
+int R_GetNumRenderSlices ();
+void R_NetUpdate ();
+
+// Texture and colormap generation isn't thread-safe, so the slices take turns.
+void R_LockSliceResources ();
+void R_UnlockSliceResources ();
+
+struct FSliceResourceLock
+{
+	FSliceResourceLock () { if (RenderingSlices) R_LockSliceResources (); }
+	~FSliceResourceLock () { if (RenderingSlices) R_UnlockSliceResources (); }
+};
+
+
+extern RENDER_TLS int stacked_extralight;
+extern RENDER_TLS float stacked_visibility;
+extern RENDER_TLS fixed_t stacked_viewx, stacked_viewy, stacked_viewz;
+extern RENDER_TLS angle_t stacked_angle;
 
 extern void R_CopyStackedViewParameters();
 
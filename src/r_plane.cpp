@@ -84,12 +84,12 @@ planefunction_t 		ceilingfunc;
 #define MAX_SKYBOX_PLANES 1000
 
 // [RH] Allocate one extra for sky box planes.
-static visplane_t		*visplanes[MAXVISPLANES+1];	// killough
-static visplane_t		*freetail;					// killough
-static visplane_t		**freehead = &freetail;		// killough
+static RENDER_TLS visplane_t		*visplanes[MAXVISPLANES+1];	// killough
+static RENDER_TLS visplane_t		*freetail;					// killough
+static RENDER_TLS visplane_t		**freehead = &freetail;		// killough
 
-visplane_t 				*floorplane;
-visplane_t 				*ceilingplane;
+RENDER_TLS visplane_t 				*floorplane;
+RENDER_TLS visplane_t 				*ceilingplane;
 
 // killough -- hash function for visplanes
 // Empirically verified to be fairly uniform:
@@ -101,54 +101,63 @@ visplane_t 				*ceilingplane;
 // When you change the main parameters, you should copy them here too *unless*
 // you are changing them to draw a stacked sector. Otherwise, stacked sectors
 // won't draw in skyboxes properly.
-int stacked_extralight;
-float stacked_visibility;
-fixed_t stacked_viewx, stacked_viewy, stacked_viewz;
-angle_t stacked_angle;
+RENDER_TLS int stacked_extralight;
+RENDER_TLS float stacked_visibility;
+RENDER_TLS fixed_t stacked_viewx, stacked_viewy, stacked_viewz;
+RENDER_TLS angle_t stacked_angle;
 
 
 //
 // opening
 //
 
-size_t					maxopenings;
-short					*openings;
-ptrdiff_t				lastopening;
+RENDER_TLS size_t					maxopenings;
+RENDER_TLS short					*openings;
+RENDER_TLS ptrdiff_t				lastopening;
 
 //
 // Clip values are the solid pixel bounding the range.
 //	floorclip starts out SCREENHEIGHT and is just outside the range
 //	ceilingclip starts out 0 and is just inside the range
 //
-short					floorclip[MAXWIDTH];
-short					ceilingclip[MAXWIDTH];
+RENDER_TLS short					floorclip[MAXWIDTH];
+RENDER_TLS short					ceilingclip[MAXWIDTH];
 
 //
 // texture mapping
 //
 
-static fixed_t			planeheight;
+static RENDER_TLS fixed_t			planeheight;
 
 extern "C" {
 //
 // spanend holds the end of a plane span in each screen row
 //
-short					spanend[MAXHEIGHT];
-BYTE					*tiltlighting[MAXWIDTH];
+RENDER_TLS short					spanend[MAXHEIGHT];
+RENDER_TLS BYTE					*tiltlighting[MAXWIDTH];
 
-int						planeshade;
-FVector3				plane_sz, plane_su, plane_sv;
-float					planelightfloat;
-bool					plane_shade;
-fixed_t					pviewx, pviewy;
+RENDER_TLS int						planeshade;
+RENDER_TLS FVector3				plane_sz, plane_su, plane_sv;
+RENDER_TLS float					planelightfloat;
+RENDER_TLS bool					plane_shade;
+RENDER_TLS fixed_t					pviewx, pviewy;
 
 void R_DrawTiltedPlane_ASM (int y, int x1);
 }
 
 fixed_t 				yslope[MAXHEIGHT];
-static fixed_t			xscale, yscale;
-static DWORD			xstepscale, ystepscale;
-static DWORD			basexfrac, baseyfrac;
+static RENDER_TLS fixed_t			xscale, yscale;
+static RENDER_TLS DWORD			xstepscale, ystepscale;
+static RENDER_TLS DWORD			basexfrac, baseyfrac;
+
+// [Zandronum] The sky box currently being drawn. This used to be marked on
+// the actors, which several render slices can't share.
+static RENDER_TLS ASkyViewpoint	*CurrentSkyViewpoint, *CurrentSkyMate;
+
+static inline bool R_InSkybox (ASkyViewpoint *sky)
+{
+	return sky == CurrentSkyViewpoint || sky == CurrentSkyMate;
+}
 
 #ifdef X86_ASM
 extern "C" void R_SetSpanSource_ASM (const BYTE *flat);
@@ -223,10 +232,12 @@ void R_MapPlane (int y, int x1)
 
 	distance = FixedMul (planeheight, yslope[y]);
 
+	// The texture position is stepped from the center of the view, so a
+	// span gives the same pixels no matter which column it starts at.
 	ds_xstep = FixedMul (distance, xstepscale);
 	ds_ystep = FixedMul (distance, ystepscale);
-	ds_xfrac = FixedMul (distance, basexfrac) + pviewx;
-	ds_yfrac = FixedMul (distance, baseyfrac) + pviewy;
+	ds_xfrac = FixedMul (distance, basexfrac) + (DWORD)(x1 - halfviewwidth) * ds_xstep + pviewx;
+	ds_yfrac = FixedMul (distance, baseyfrac) + (DWORD)(x1 - halfviewwidth) * ds_ystep + pviewy;
 
 	if (plane_shade)
 	{
@@ -362,26 +373,18 @@ void STACK_ARGS R_CalcTiltedLighting (fixed_t lval, fixed_t lend, int width)
 void R_MapTiltedPlane (int y, int x1)
 {
 	int x2 = spanend[y];
-	int width = x2 - x1;
 	double iz, uz, vz;
 	BYTE *fb;
 	DWORD u, v;
-	int i;
-
-	iz = plane_sz[2] + plane_sz[1]*(centery-y) + plane_sz[0]*(x1-centerx);
-
-	// Lighting is simple. It's just linear interpolation from start to end
-	if (plane_shade)
-	{
-		uz = (iz + plane_sz[0]*width) * planelightfloat;
-		vz = iz * planelightfloat;
-		R_CalcTiltedLighting (xs_RoundToInt(vz), xs_RoundToInt(uz), width);
-	}
 
-	uz = plane_su[2] + plane_su[1]*(centery-y) + plane_su[0]*(x1-centerx);
-	vz = plane_sv[2] + plane_sv[1]*(centery-y) + plane_sv[0]*(x1-centerx);
+	// The plane equations at x = 0. Everything is computed from these for
+	// the absolute screen position, so that a span gives the same pixels no
+	// matter where it starts. [Zandronum] Render slices depend on that.
+	double iz0 = plane_sz[2] + plane_sz[1]*(centery-y) - plane_sz[0]*centerx;
+	double uz0 = plane_su[2] + plane_su[1]*(centery-y) - plane_su[0]*centerx;
+	double vz0 = plane_sv[2] + plane_sv[1]*(centery-y) - plane_sv[0]*centerx;
 
-	fb = ylookup[y] + x1 + dc_destorg;
+	fb = ylookup[y] + dc_destorg;
 
 	BYTE vshift = 32 - ds_ybits;
 	BYTE ushift = vshift - ds_xbits;
@@ -389,19 +392,24 @@ void R_MapTiltedPlane (int y, int x1)
 
 #if 0		// The "perfect" reference version of this routine. Pretty slow.
 			// Use it only to see how things are supposed to look.
-	i = 0;
-	do
+	if (plane_shade)
+	{
+		R_CalcTiltedLighting (xs_RoundToInt((iz0 + plane_sz[0]*x1) * planelightfloat),
+			xs_RoundToInt((iz0 + plane_sz[0]*x2) * planelightfloat), x2 - x1);
+	}
+	for (int x = x1; x <= x2; ++x)
 	{
+		iz = iz0 + plane_sz[0]*x;
+		uz = uz0 + plane_su[0]*x;
+		vz = vz0 + plane_sv[0]*x;
+
 		double z = 1.f/iz;
 
 		u = SQWORD(uz*z) + pviewx;
 		v = SQWORD(vz*z) + pviewy;
-		ds_colormap = tiltlighting[i];
-		fb[i++] = ds_colormap[ds_source[(v >> vshift) | ((u >> ushift) & umask)]];
-		iz += plane_sz[0];
-		uz += plane_su[0];
-		vz += plane_sv[0];
-	} while (--width >= 0);
+		ds_colormap = tiltlighting[x - x1];
+		fb[x] = ds_colormap[ds_source[(v >> vshift) | ((u >> ushift) & umask)]];
+	}
 #else
 //#define SPANSIZE 32
 //#define INVSPAN 0.03125f
@@ -410,75 +418,45 @@ void R_MapTiltedPlane (int y, int x1)
 #define SPANSIZE 16
 #define INVSPAN	0.0625f
 
-	double startz = 1.f/iz;
-	double startu = uz*startz;
-	double startv = vz*startz;
-	double izstep, uzstep, vzstep;
-
-	izstep = plane_sz[0] * SPANSIZE;
-	uzstep = plane_su[0] * SPANSIZE;
-	vzstep = plane_sv[0] * SPANSIZE;
-	x1 = 0;
-	width++;
-
-	while (width >= SPANSIZE)
+	// Texture coordinates are calculated exactly at the edges of each
+	// SPANSIZE aligned block and interpolated linearly in between.
+	int x = x1;
+	while (x <= x2)
 	{
-		iz += izstep;
-		uz += uzstep;
-		vz += vzstep;
+		int bs = x & ~(SPANSIZE-1);
+		int be = MIN (bs + SPANSIZE - 1, x2);
+
+		iz = iz0 + plane_sz[0]*bs;
+		uz = uz0 + plane_su[0]*bs;
+		vz = vz0 + plane_sv[0]*bs;
+		double startz = 1.f/iz;
+		double startu = uz*startz;
+		double startv = vz*startz;
+
+		// Lighting is simple. It's just linear interpolation across the block.
+		if (plane_shade)
+		{
+			R_CalcTiltedLighting (xs_RoundToInt(iz * planelightfloat),
+				xs_RoundToInt((iz + plane_sz[0]*SPANSIZE) * planelightfloat), SPANSIZE);
+		}
 
+		iz = iz0 + plane_sz[0]*(bs + SPANSIZE);
+		uz = uz0 + plane_su[0]*(bs + SPANSIZE);
+		vz = vz0 + plane_sv[0]*(bs + SPANSIZE);
 		double endz = 1.f/iz;
 		double endu = uz*endz;
 		double endv = vz*endz;
 		DWORD stepu = SQWORD((endu - startu) * INVSPAN);
 		DWORD stepv = SQWORD((endv - startv) * INVSPAN);
-		u = SQWORD(startu) + pviewx;
-		v = SQWORD(startv) + pviewy;
+		u = SQWORD(startu) + pviewx + (x - bs) * stepu;
+		v = SQWORD(startv) + pviewy + (x - bs) * stepv;
 
-		for (i = SPANSIZE-1; i >= 0; i--)
+		for (; x <= be; x++)
 		{
-			fb[x1] = *(tiltlighting[x1] + ds_source[(v >> vshift) | ((u >> ushift) & umask)]);
-			x1++;
+			fb[x] = *(tiltlighting[x - bs] + ds_source[(v >> vshift) | ((u >> ushift) & umask)]);
 			u += stepu;
 			v += stepv;
 		}
-		startu = endu;
-		startv = endv;
-		startz = endz;
-		width -= SPANSIZE;
-	}
-	if (width > 0)
-	{
-		if (width == 1)
-		{
-			u = SQWORD(startu);
-			v = SQWORD(startv);
-			fb[x1] = *(tiltlighting[x1] + ds_source[(v >> vshift) | ((u >> ushift) & umask)]);
-		}
-		else
-		{
-			double left = width;
-			iz += plane_sz[0] * left;
-			uz += plane_su[0] * left;
-			vz += plane_sv[0] * left;
-
-			double endz = 1.f/iz;
-			double endu = uz*endz;
-			double endv = vz*endz;
-			left = 1.f/left;
-			DWORD stepu = SQWORD((endu - startu) * left);
-			DWORD stepv = SQWORD((endv - startv) * left);
-			u = SQWORD(startu) + pviewx;
-			v = SQWORD(startv) + pviewy;
-
-			for (; width != 0; width--)
-			{
-				fb[x1] = *(tiltlighting[x1] + ds_source[(v >> vshift) | ((u >> ushift) & umask)]);
-				x1++;
-				u += stepu;
-				v += stepv;
-			}
-		}
 	}
 #endif
 }
@@ -613,9 +591,9 @@ visplane_t *R_FindPlane (const secplane_t &height, FTextureID picnum, int lightl
 		// same visplane, then only the floor sky will be drawn.
 		plane.c = height.c;
 		plane.ic = height.ic;
-		isskybox = skybox != NULL && !skybox->bInSkybox;
+		isskybox = skybox != NULL && !R_InSkybox (skybox);
 	}
-	else if (skybox != NULL && skybox->bAlways && !skybox->bInSkybox)
+	else if (skybox != NULL && skybox->bAlways && !R_InSkybox (skybox))
 	{
 		plane = height;
 		isskybox = true;
@@ -785,7 +763,7 @@ visplane_t *R_CheckPlane (visplane_t *pl, int start, int stop)
 		// make a new visplane
 		unsigned hash;
 
-		if (pl->skybox != NULL && !pl->skybox->bInSkybox && (pl->picnum == skyflatnum || pl->skybox->bAlways) && viewactive)
+		if (pl->skybox != NULL && !R_InSkybox (pl->skybox) && (pl->picnum == skyflatnum || pl->skybox->bAlways) && viewactive)
 		{
 			hash = MAXVISPLANES;
 		}
@@ -851,26 +829,27 @@ inline void R_MakeSpans (int x, int t1, int b1, int t2, int b2, void (*mapfunc)(
 //
 //==========================================================================
 
-static FTexture *frontskytex, *backskytex;
-static angle_t skyflip;
-static int frontpos, backpos;
-static fixed_t frontyScale;
-static fixed_t frontcyl, backcyl;
-static fixed_t skymid;
-static angle_t skyangle;
-int frontiScale;
+static RENDER_TLS FTexture *frontskytex, *backskytex;
+static RENDER_TLS angle_t skyflip;
+static RENDER_TLS int frontpos, backpos;
+static RENDER_TLS fixed_t frontyScale;
+static RENDER_TLS fixed_t frontcyl, backcyl;
+static RENDER_TLS fixed_t skymid;
+static RENDER_TLS angle_t skyangle;
+RENDER_TLS int frontiScale;
 
-extern fixed_t swall[MAXWIDTH];
-extern fixed_t lwall[MAXWIDTH];
-extern fixed_t rw_offset;
-extern FTexture *rw_pic;
+extern RENDER_TLS fixed_t swall[MAXWIDTH];
+extern RENDER_TLS fixed_t lwall[MAXWIDTH];
+extern RENDER_TLS fixed_t rw_offset;
+extern RENDER_TLS FTexture *rw_pic;
 
 // Allow for layer skies up to 512 pixels tall. This is overkill,
 // since the most anyone can ever see of the sky is 500 pixels.
 // We need 4 skybufs because wallscan can draw up to 4 columns at a time.
-static BYTE skybuf[4][512];
-static DWORD lastskycol[4];
-static int skycolplace;
+// Each column of a group of four gets its own buffer, so that building one
+// can never overwrite another that is still waiting to be drawn.
+static RENDER_TLS BYTE skybuf[4][512];
+static RENDER_TLS DWORD lastskycol[4];
 
 // Get a column of sky when there is only one sky texture.
 static const BYTE *R_GetOneSkyColumn (FTexture *fronttex, int x)
@@ -891,17 +870,13 @@ static const BYTE *R_GetTwoSkyColumns (FTexture *fronttex, int x)
 	DWORD skycol = (angle1 << 16) | angle2;
 	int i;
 
-	for (i = 0; i < 4; ++i)
+	if (lastskycol[x & 3] == skycol)
 	{
-		if (lastskycol[i] == skycol)
-		{
-			return skybuf[i];
-		}
+		return skybuf[x & 3];
 	}
 
-	lastskycol[skycolplace] = skycol;
-	BYTE *composite = skybuf[skycolplace];
-	skycolplace = (skycolplace + 1) & 3;
+	lastskycol[x & 3] = skycol;
+	BYTE *composite = skybuf[x & 3];
 
 	// The ordering of the following code has been tuned to allow VC++ to optimize
 	// it well. In particular, this arrangement lets it keep count in a register
@@ -934,6 +909,12 @@ static void R_DrawSky (visplane_t *pl)
 
 	dc_iscale = skyiscale;
 
+	R_PrepareTexture (frontskytex);
+	if (backskytex != NULL)
+	{
+		R_PrepareTexture (backskytex);
+	}
+
 	clearbuf (swall+pl->minx, pl->maxx-pl->minx+1, dc_iscale<<2);
 
 	if (MirrorFlags & RF_XFLIP)
@@ -1133,6 +1114,7 @@ void R_DrawSinglePlane (visplane_t *pl, fixed_t alpha, bool additive, bool maske
 		R_SetupSpanBits(tex);
 		pl->xscale = MulScale16 (pl->xscale, tex->xScale);
 		pl->yscale = MulScale16 (pl->yscale, tex->yScale);
+		R_PrepareTexture (tex);
 		ds_source = tex->GetPixels ();
 
 		basecolormap = pl->colormap;
@@ -1147,7 +1129,7 @@ void R_DrawSinglePlane (visplane_t *pl, fixed_t alpha, bool additive, bool maske
 			R_DrawTiltedPlane (pl, alpha, additive, masked);
 		}
 	}
-	NetUpdate ();
+	R_NetUpdate ();
 }
 
 //==========================================================================
@@ -1171,15 +1153,15 @@ void R_DrawSinglePlane (visplane_t *pl, fixed_t alpha, bool additive, bool maske
 //
 //==========================================================================
 CVAR (Bool, r_skyboxes, true, 0)
-static int numskyboxes;
+static RENDER_TLS int numskyboxes;
 
 void R_DrawSkyBoxes ()
 {
-	static TArray<size_t> interestingStack;
-	static TArray<ptrdiff_t> drawsegStack;
-	static TArray<ptrdiff_t> visspriteStack;
-	static TArray<fixed_t> viewxStack, viewyStack, viewzStack;
-	static TArray<visplane_t *> visplaneStack;
+	static RENDER_TLS TArray<size_t> interestingStack;
+	static RENDER_TLS TArray<ptrdiff_t> drawsegStack;
+	static RENDER_TLS TArray<ptrdiff_t> visspriteStack;
+	static RENDER_TLS TArray<fixed_t> viewxStack, viewyStack, viewzStack;
+	static RENDER_TLS TArray<visplane_t *> visplaneStack;
 
 	numskyboxes = 0;
 
@@ -1248,12 +1230,12 @@ void R_DrawSkyBoxes ()
 			viewangle = pl->viewangle;
 		}
 
-		sky->bInSkybox = true;
-		if (mate != NULL) mate->bInSkybox = true;
+		CurrentSkyViewpoint = sky;
+		CurrentSkyMate = mate;
 		camera = sky;
 		viewsector = sky->Sector;
 		R_SetViewAngle ();
-		validcount++;	// Make sure we see all sprites
+		R_NewSpriteValidCount ();	// Make sure we see all sprites
 
 		R_ClearPlanes (false);
 		R_ClearClipSegs (pl->minx, pl->maxx + 1);
@@ -1309,8 +1291,7 @@ void R_DrawSkyBoxes ()
 		R_3D_ResetClip(); // reset clips (floor/ceiling)
 		R_DrawPlanes ();
 
-		sky->bInSkybox = false;
-		if (mate != NULL) mate->bInSkybox = false;
+		CurrentSkyViewpoint = CurrentSkyMate = NULL;
 	}
 
 	// Draw all the masked textures in a second pass, in the reverse order they
@@ -1548,10 +1529,9 @@ void R_DrawNormalPlane (visplane_t *pl, fixed_t alpha, bool additive, bool maske
 		ystepscale = (DWORD)(-(SDWORD)ystepscale);
 	}
 
-	int x = pl->maxx - halfviewwidth;
 	planeang = (planeang + (ANG90 >> ANGLETOFINESHIFT)) & FINEMASK;
-	basexfrac = FixedMul (xscale, finecosine[planeang]) + x*xstepscale;
-	baseyfrac = FixedMul (yscale, -finesine[planeang]) + x*ystepscale;
+	basexfrac = FixedMul (xscale, finecosine[planeang]);
+	baseyfrac = FixedMul (yscale, -finesine[planeang]);
 
 	planeheight = abs (FixedMul (pl->height.d, -pl->height.ic) - viewz);
 
@@ -1748,7 +1728,13 @@ void R_DrawTiltedPlane (visplane_t *pl, fixed_t alpha, bool additive, bool maske
 
 void R_MapVisPlane (visplane_t *pl, void (*mapfunc)(int y, int x1))
 {
-	int x = pl->maxx;
+	// [Zandronum] Only map the columns of the current render slice.
+	int minx = MAX (pl->minx, SliceLeft);
+	int x = MIN (pl->maxx, SliceRight - 1);
+	if (x < minx)
+	{
+		return;
+	}
 	int t2 = pl->top[x];
 	int b2 = pl->bottom[x];
 
@@ -1757,7 +1743,7 @@ void R_MapVisPlane (visplane_t *pl, void (*mapfunc)(int y, int x1))
 		clearbufshort (spanend+t2, b2-t2, x);
 	}
 
-	for (--x; x >= pl->minx; --x)
+	for (--x; x >= minx; --x)
 	{
 		int t1 = pl->top[x];
 		int b1 = pl->bottom[x];
@@ -1790,13 +1776,11 @@ void R_MapVisPlane (visplane_t *pl, void (*mapfunc)(int y, int x1))
 
 		t2 = pl->top[x];
 		b2 = pl->bottom[x];
-		basexfrac -= xstepscale;
-		baseyfrac -= ystepscale;
 	}
 	// Draw any spans that are still open
 	while (t2 < b2)
 	{
-		mapfunc (--b2, pl->minx);
+		mapfunc (--b2, minx);
 	}
 }
 
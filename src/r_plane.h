@@ -70,7 +70,7 @@ typedef struct visplane_s visplane_t;
 
 
 // Visplane related.
-extern ptrdiff_t		lastopening;	// type short
+extern RENDER_TLS ptrdiff_t		lastopening;	// type short
 
 
 typedef void (*planefunction_t) (int top, int bottom);
@@ -78,8 +78,8 @@ typedef void (*planefunction_t) (int top, int bottom);
 extern planefunction_t	floorfunc;
 extern planefunction_t	ceilingfunc_t;
 
-extern short			floorclip[MAXWIDTH];
-extern short			ceilingclip[MAXWIDTH];
+extern RENDER_TLS short			floorclip[MAXWIDTH];
+extern RENDER_TLS short			ceilingclip[MAXWIDTH];
 
 extern fixed_t			yslope[MAXHEIGHT];
 
@@ -115,7 +115,7 @@ visplane_t *R_CheckPlane (visplane_t *pl, int start, int stop);
 bool R_PlaneInitData (void);
 
 
-extern visplane_t*		floorplane;
-extern visplane_t*		ceilingplane;
+extern RENDER_TLS visplane_t*		floorplane;
+extern RENDER_TLS visplane_t*		ceilingplane;
 
 #endif // __R_PLANE_H__
@@ -856,26 +856,26 @@ void Polymost_Responder (event_t *ev)
 
 
 
-extern fixed_t WallSZ1, WallSZ2, WallTX1, WallTX2, WallTY1, WallTY2, WallCX1, WallCX2, WallCY1, WallCY2;
-extern int WallSX1, WallSX2;
-extern float WallUoverZorg, WallUoverZstep, WallInvZorg, WallInvZstep, WallDepthScale, WallDepthOrg;
-extern fixed_t	rw_backcz1, rw_backcz2;
-extern fixed_t	rw_backfz1, rw_backfz2;
-extern fixed_t	rw_frontcz1, rw_frontcz2;
-extern fixed_t	rw_frontfz1, rw_frontfz2;
-extern fixed_t	rw_offset;
-extern bool rw_markmirror;
-extern bool			rw_havehigh;
-extern bool			rw_havelow;
-extern bool		markfloor;
-extern bool		markceiling;
-extern FTexture *toptexture;
-extern FTexture *bottomtexture;
-extern FTexture *midtexture;
-extern bool			rw_mustmarkfloor, rw_mustmarkceiling;
+extern RENDER_TLS fixed_t WallSZ1, WallSZ2, WallTX1, WallTX2, WallTY1, WallTY2, WallCX1, WallCX2, WallCY1, WallCY2;
+extern RENDER_TLS int WallSX1, WallSX2;
+extern RENDER_TLS float WallUoverZorg, WallUoverZstep, WallInvZorg, WallInvZstep, WallDepthScale, WallDepthOrg;
+extern RENDER_TLS fixed_t	rw_backcz1, rw_backcz2;
+extern RENDER_TLS fixed_t	rw_backfz1, rw_backfz2;
+extern RENDER_TLS fixed_t	rw_frontcz1, rw_frontcz2;
+extern RENDER_TLS fixed_t	rw_frontfz1, rw_frontfz2;
+extern RENDER_TLS fixed_t	rw_offset;
+extern RENDER_TLS bool rw_markmirror;
+extern RENDER_TLS bool			rw_havehigh;
+extern RENDER_TLS bool			rw_havelow;
+extern RENDER_TLS bool		markfloor;
+extern RENDER_TLS bool		markceiling;
+extern RENDER_TLS FTexture *toptexture;
+extern RENDER_TLS FTexture *bottomtexture;
+extern RENDER_TLS FTexture *midtexture;
+extern RENDER_TLS bool			rw_mustmarkfloor, rw_mustmarkceiling;
 extern void R_NewWall(bool);
 //extern void R_GetExtraLight (int *light, const secplane_t &plane, FExtraLight *el);
-extern int doorclosed;
+extern RENDER_TLS int doorclosed;
 extern int viewpitch;
 #include "p_lnspec.h"
 
@@ -76,73 +76,73 @@ extern fixed_t globaluclip, globaldclip;
 
 // killough 1/6/98: replaced globals with statics where appropriate
 
-static bool		segtextured;	// True if any of the segs textures might be visible.
-bool		markfloor;		// False if the back side is the same plane.
-bool		markceiling;
-FTexture *toptexture;
-FTexture *bottomtexture;
-FTexture *midtexture;
-fixed_t rw_offset_top;
-fixed_t rw_offset_mid;
-fixed_t rw_offset_bottom;
+static RENDER_TLS bool		segtextured;	// True if any of the segs textures might be visible.
+RENDER_TLS bool		markfloor;		// False if the back side is the same plane.
+RENDER_TLS bool		markceiling;
+RENDER_TLS FTexture *toptexture;
+RENDER_TLS FTexture *bottomtexture;
+RENDER_TLS FTexture *midtexture;
+RENDER_TLS fixed_t rw_offset_top;
+RENDER_TLS fixed_t rw_offset_mid;
+RENDER_TLS fixed_t rw_offset_bottom;
 
 int OWallMost (short *mostbuf, fixed_t z);
 int WallMost (short *mostbuf, const secplane_t &plane);
 void PrepWall (fixed_t *swall, fixed_t *lwall, fixed_t walxrepeat);
 void PrepLWall (fixed_t *lwall, fixed_t walxrepeat);
-extern fixed_t WallSZ1, WallSZ2, WallTX1, WallTX2, WallTY1, WallTY2, WallCX1, WallCX2, WallCY1, WallCY2;
-extern int WallSX1, WallSX2;
-extern float WallUoverZorg, WallUoverZstep, WallInvZorg, WallInvZstep, WallDepthScale, WallDepthOrg;
+extern RENDER_TLS fixed_t WallSZ1, WallSZ2, WallTX1, WallTX2, WallTY1, WallTY2, WallCX1, WallCX2, WallCY1, WallCY2;
+extern RENDER_TLS int WallSX1, WallSX2;
+extern RENDER_TLS float WallUoverZorg, WallUoverZstep, WallInvZorg, WallInvZstep, WallDepthScale, WallDepthOrg;
 
-int		wallshade;
+RENDER_TLS int		wallshade;
 
-short	walltop[MAXWIDTH];	// [RH] record max extents of wall
-short	wallbottom[MAXWIDTH];
-short	wallupper[MAXWIDTH];
-short	walllower[MAXWIDTH];
-fixed_t	swall[MAXWIDTH];
-fixed_t	lwall[MAXWIDTH];
-fixed_t	lwallscale;
+RENDER_TLS short	walltop[MAXWIDTH];	// [RH] record max extents of wall
+RENDER_TLS short	wallbottom[MAXWIDTH];
+RENDER_TLS short	wallupper[MAXWIDTH];
+RENDER_TLS short	walllower[MAXWIDTH];
+RENDER_TLS fixed_t	swall[MAXWIDTH];
+RENDER_TLS fixed_t	lwall[MAXWIDTH];
+RENDER_TLS fixed_t	lwallscale;
 
 //
 // regular wall
 //
-extern fixed_t	rw_backcz1, rw_backcz2;
-extern fixed_t	rw_backfz1, rw_backfz2;
-extern fixed_t	rw_frontcz1, rw_frontcz2;
-extern fixed_t	rw_frontfz1, rw_frontfz2;
-
-int				rw_ceilstat, rw_floorstat;
-bool			rw_mustmarkfloor, rw_mustmarkceiling;
-bool			rw_prepped;
-bool			rw_markmirror;
-bool			rw_havehigh;
-bool			rw_havelow;
-
-fixed_t			rw_light;		// [RH] Scale lights with viewsize adjustments
-fixed_t			rw_lightstep;
-fixed_t			rw_lightleft;
-
-static fixed_t	rw_frontlowertop;
-
-static int		rw_x;
-static int		rw_stopx;
-fixed_t			rw_offset;
-static fixed_t	rw_scalestep;
-static fixed_t	rw_midtexturemid;
-static fixed_t	rw_toptexturemid;
-static fixed_t	rw_bottomtexturemid;
-static fixed_t	rw_midtexturescalex;
-static fixed_t	rw_midtexturescaley;
-static fixed_t	rw_toptexturescalex;
-static fixed_t	rw_toptexturescaley;
-static fixed_t	rw_bottomtexturescalex;
-static fixed_t	rw_bottomtexturescaley;
-
-FTexture		*rw_pic;
-
-static fixed_t	*maskedtexturecol;
-static FTexture	*WallSpriteTile;
+extern RENDER_TLS fixed_t	rw_backcz1, rw_backcz2;
+extern RENDER_TLS fixed_t	rw_backfz1, rw_backfz2;
+extern RENDER_TLS fixed_t	rw_frontcz1, rw_frontcz2;
+extern RENDER_TLS fixed_t	rw_frontfz1, rw_frontfz2;
+
+RENDER_TLS int				rw_ceilstat, rw_floorstat;
+RENDER_TLS bool			rw_mustmarkfloor, rw_mustmarkceiling;
+RENDER_TLS bool			rw_prepped;
+RENDER_TLS bool			rw_markmirror;
+RENDER_TLS bool			rw_havehigh;
+RENDER_TLS bool			rw_havelow;
+
+RENDER_TLS fixed_t			rw_light;		// [RH] Scale lights with viewsize adjustments
+RENDER_TLS fixed_t			rw_lightstep;
+RENDER_TLS fixed_t			rw_lightleft;
+
+static RENDER_TLS fixed_t	rw_frontlowertop;
+
+static RENDER_TLS int		rw_x;
+static RENDER_TLS int		rw_stopx;
+RENDER_TLS fixed_t			rw_offset;
+static RENDER_TLS fixed_t	rw_scalestep;
+static RENDER_TLS fixed_t	rw_midtexturemid;
+static RENDER_TLS fixed_t	rw_toptexturemid;
+static RENDER_TLS fixed_t	rw_bottomtexturemid;
+static RENDER_TLS fixed_t	rw_midtexturescalex;
+static RENDER_TLS fixed_t	rw_midtexturescaley;
+static RENDER_TLS fixed_t	rw_toptexturescalex;
+static RENDER_TLS fixed_t	rw_toptexturescaley;
+static RENDER_TLS fixed_t	rw_bottomtexturescalex;
+static RENDER_TLS fixed_t	rw_bottomtexturescaley;
+
+RENDER_TLS FTexture		*rw_pic;
+
+static RENDER_TLS fixed_t	*maskedtexturecol;
+static RENDER_TLS FTexture	*WallSpriteTile;
 
 static void R_RenderDecal (side_t *wall, DBaseDecal *first, drawseg_t *clipper, int pass);
 static void WallSpriteColumn (void (*drawfunc)(const BYTE *column, const FTexture::Span *spans));
@@ -179,8 +179,8 @@ CVAR(Bool, r_drawmirrors, true, 0)
 //
 // R_RenderMaskedSegRange
 //
-fixed_t *MaskedSWall;
-fixed_t MaskedScaleY;
+RENDER_TLS fixed_t *MaskedSWall;
+RENDER_TLS fixed_t MaskedScaleY;
 
 static void BlastMaskedColumn (void (*blastfunc)(const BYTE *pixels, const FTexture::Span *spans), FTexture *tex)
 {
@@ -260,7 +260,7 @@ void R_RenderMaskedSegRange (drawseg_t *ds, int x1, int x2)
 		return;
 	}
 
-	NetUpdate ();
+	R_NetUpdate ();
 
 	frontsector = curline->frontsector;
 	backsector = curline->backsector;
@@ -436,10 +436,19 @@ void R_RenderMaskedSegRange (drawseg_t *ds, int x1, int x2)
 		mfloorclip = walllower;
 		mceilingclip = wallupper;
 
+		// [Zandronum] Only draw the columns of the current render slice.
+		int cx1 = MAX (x1, SliceLeft);
+		int cx2 = MIN (x2, SliceRight - 1);
+		if (cx1 > cx2)
+			goto clearfog;
+		rw_light += (cx1 - x1) * rw_lightstep;
+		spryscale += (cx1 - x1) * rw_scalestep;
+		R_PrepareTexture (tex);
+
 		// draw the columns one at a time
 		if (drawmode == DoDraw0)
 		{
-			for (dc_x = x1; dc_x <= x2; ++dc_x)
+			for (dc_x = cx1; dc_x <= cx2; ++dc_x)
 			{
 				BlastMaskedColumn (R_DrawMaskedColumn, tex);
 			}
@@ -447,12 +456,9 @@ void R_RenderMaskedSegRange (drawseg_t *ds, int x1, int x2)
 		else
 		{
 			// [RH] Draw up to four columns at once
-			int stop = (x2+1) & ~3;
+			int stop = (cx2+1) & ~3;
 
-			if (x1 > x2)
-				goto clearfog;
-
-			dc_x = x1;
+			dc_x = cx1;
 
 			while ((dc_x < stop) && (dc_x & 3))
 			{
@@ -471,7 +477,7 @@ void R_RenderMaskedSegRange (drawseg_t *ds, int x1, int x2)
 				dc_x++;
 			}
 
-			while (dc_x <= x2)
+			while (dc_x <= cx2)
 			{
 				BlastMaskedColumn (R_DrawMaskedColumn, tex);
 				dc_x++;
@@ -1040,6 +1046,29 @@ void R_RenderFakeWallRange (drawseg_t *ds, int x1, int x2)
 }
 
 // prevlineasm1 is like vlineasm1 but skips the loop if only drawing one pixel
+//=============================================================================
+//
+// WallscanSliceClip
+//
+// [Zandronum] Narrows [x1, x2] to the columns of the current render slice,
+// moving the wall light along with x1. Returns false if nothing is left.
+//
+//=============================================================================
+
+static inline bool WallscanSliceClip (int &x1, int &x2, fixed_t &light)
+{
+	if (x1 < SliceLeft)
+	{
+		light += (SliceLeft - x1) * rw_lightstep;
+		x1 = SliceLeft;
+	}
+	if (x2 >= SliceRight)
+	{
+		x2 = SliceRight - 1;
+	}
+	return x1 <= x2;
+}
+
 inline fixed_t prevline1 (fixed_t vince, BYTE *colormap, int count, fixed_t vplce, const BYTE *bufplce, BYTE *dest)
 {
 	dc_iscale = vince;
@@ -1066,10 +1095,11 @@ void wallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixed_t
 	//if ((uwal[x1] > viewheight) && (uwal[x2] > viewheight)) return;
 	//if ((dwal[x1] < 0) && (dwal[x2] < 0)) return;
 
-	if (rw_pic->UseType == FTexture::TEX_Null)
+	if (rw_pic->UseType == FTexture::TEX_Null || !WallscanSliceClip (x1, x2, light))
 	{
 		return;
 	}
+	R_PrepareTexture (rw_pic);
 
 //extern cycle_t WallScanCycles;
 //clock (WallScanCycles);
@@ -1212,7 +1242,7 @@ void wallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixed_t
 
 //unclock (WallScanCycles);
 
-	NetUpdate ();
+	R_NetUpdate ();
 }
 
 void wallscan_striped (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixed_t *lwal, fixed_t yrepeat)
@@ -1420,6 +1450,12 @@ void maskwallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixe
 //extern cycle_t WallScanCycles;
 //clock (WallScanCycles);
 
+	if (!WallscanSliceClip (x1, x2, light))
+	{
+		return;
+	}
+	R_PrepareTexture (rw_pic);
+
 	rw_pic->GetHeight();	// Make sure texture size is loaded
 	shiftval = rw_pic->HeightBits;
 	setupmvline (32-shiftval);
@@ -1552,7 +1588,7 @@ void maskwallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal, fixe
 
 //unclock(WallScanCycles);
 
-	NetUpdate ();
+	R_NetUpdate ();
 }
 
 inline void preptmvline1 (fixed_t vince, BYTE *colormap, int count, fixed_t vplce, const BYTE *bufplce, BYTE *dest)
@@ -1593,6 +1629,12 @@ void transmaskwallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal,
 //extern cycle_t WallScanCycles;
 //clock (WallScanCycles);
 
+	if (!WallscanSliceClip (x1, x2, light))
+	{
+		return;
+	}
+	R_PrepareTexture (rw_pic);
+
 	rw_pic->GetHeight();	// Make sure texture size is loaded
 	shiftval = rw_pic->HeightBits;
 	setuptmvline (32-shiftval);
@@ -1728,7 +1770,7 @@ void transmaskwallscan (int x1, int x2, short *uwal, short *dwal, fixed_t *swal,
 
 //unclock(WallScanCycles);
 
-	NetUpdate ();
+	R_NetUpdate ();
 }
 
 //
@@ -1748,6 +1790,7 @@ void R_RenderSegLoop ()
 	int x;
 	fixed_t xscale, yscale;
 	fixed_t xoffset = rw_offset;
+	ClipStack *fakeclip = (fakeFloor != NULL && (fake3D & 7)) ? R_3D_GetClip (fakeFloor) : NULL;
 
 	if (fixedlightlev >= 0)
 		dc_colormap = basecolormap->Maps + fixedlightlev;
@@ -1772,7 +1815,7 @@ void R_RenderSegLoop ()
 	{
 		for (x = x1; x < x2; ++x)
 		{
-			short top = (fakeFloor && fake3D & 2) ? fakeFloor->ceilingclip[x] : ceilingclip[x];
+			short top = (fakeclip && fake3D & 2) ? fakeclip->ceilingclip[x] : ceilingclip[x];
 			short bottom = MIN (walltop[x], floorclip[x]);
 			if (top < bottom)
 			{
@@ -1788,7 +1831,7 @@ void R_RenderSegLoop ()
 		for (x = x1; x < x2; ++x)
 		{
 			short top = MAX (wallbottom[x], ceilingclip[x]);
-			short bottom = (fakeFloor && fake3D & 1) ? fakeFloor->floorclip[x] : floorclip[x];
+			short bottom = (fakeclip && fake3D & 1) ? fakeclip->floorclip[x] : floorclip[x];
 			if (top < bottom)
 			{
 				assert (bottom <= viewheight);
@@ -1803,7 +1846,7 @@ void R_RenderSegLoop ()
 	{
 		if (fake3D & FAKE3D_CLIPBOTFRONT)
 		{
-			memcpy (fakeFloor->floorclip+x1, wallbottom+x1, (x2-x1)*sizeof(short));
+			memcpy (fakeclip->floorclip+x1, wallbottom+x1, (x2-x1)*sizeof(short));
 		}
 		else
 		{
@@ -1811,11 +1854,11 @@ void R_RenderSegLoop ()
 			{
 				walllower[x] = MIN (MAX (walllower[x], ceilingclip[x]), wallbottom[x]);
 			}
-			memcpy (fakeFloor->floorclip+x1, walllower+x1, (x2-x1)*sizeof(short));
+			memcpy (fakeclip->floorclip+x1, walllower+x1, (x2-x1)*sizeof(short));
 		}
 		if (fake3D & FAKE3D_CLIPTOPFRONT)
 		{
-			memcpy (fakeFloor->ceilingclip+x1, walltop+x1, (x2-x1)*sizeof(short));
+			memcpy (fakeclip->ceilingclip+x1, walltop+x1, (x2-x1)*sizeof(short));
 		}
 		else
 		{
@@ -1823,7 +1866,7 @@ void R_RenderSegLoop ()
 			{
 				wallupper[x] = MAX (MIN (wallupper[x], floorclip[x]), walltop[x]);
 			}
-			memcpy (fakeFloor->ceilingclip+x1, wallupper+x1, (x2-x1)*sizeof(short));
+			memcpy (fakeclip->ceilingclip+x1, wallupper+x1, (x2-x1)*sizeof(short));
 		}
 	}
 	if(fake3D & 7) return;
@@ -2306,7 +2349,10 @@ void R_CheckDrawSegs ()
 		firstdrawseg = drawsegs + firstofs;
 		ds_p = drawsegs + MaxDrawSegs;
 		MaxDrawSegs = newdrawsegs;
-		DPrintf ("MaxDrawSegs increased to %zu\n", MaxDrawSegs);
+		if (!RenderingSlices)
+		{
+			DPrintf ("MaxDrawSegs increased to %zu\n", MaxDrawSegs);
+		}
 	}
 }
 
@@ -2324,7 +2370,10 @@ ptrdiff_t R_NewOpening (ptrdiff_t len)
 			maxopenings = maxopenings ? maxopenings*2 : 16384;
 		while ((size_t)lastopening > maxopenings);
 		openings = (short *)M_Realloc (openings, maxopenings * sizeof(*openings));
-		DPrintf ("MaxOpenings increased to %zu\n", maxopenings);
+		if (!RenderingSlices)
+		{
+			DPrintf ("MaxOpenings increased to %zu\n", maxopenings);
+		}
 	}
 	return res;
 }
@@ -2426,7 +2475,7 @@ void R_StoreWallRange (int start, int stop)
 		// killough 4/7/98: make doorclosed external variable
 
 		{
-			extern int doorclosed;	// killough 1/17/98, 2/8/98, 4/7/98
+			extern RENDER_TLS int doorclosed;	// killough 1/17/98, 2/8/98, 4/7/98
 			if (doorclosed || (rw_backcz1 <= rw_frontfz1 && rw_backcz2 <= rw_frontfz2))
 			{
 				ds_p->sprbottomclip = R_NewOpening (stop - start);
@@ -3286,13 +3335,21 @@ static void R_RenderDecal (side_t *wall, DBaseDecal *decal, drawseg_t *clipper,
 		{
 			int stop4;
 
+			// [Zandronum] Only draw the columns of the current render slice,
+			// but step the light as if all of them were drawn.
+			int cx1 = MAX (x1, SliceLeft);
+			int cx2 = MAX (cx1, MIN (x2, SliceRight));
+			rw_light += (cx1 - x1) * rw_lightstep;
+			dc_x = cx1;
+			R_PrepareTexture (WallSpriteTile);
+
 			if (mode == DoDraw0)
 			{ // 1 column at a time
 				stop4 = dc_x;
 			}
 			else	 // DoDraw1
 			{ // up to 4 columns at a time
-				stop4 = x2 & ~3;
+				stop4 = cx2 & ~3;
 			}
 
 			while ((dc_x < stop4) && (dc_x & 3))
@@ -3321,7 +3378,7 @@ static void R_RenderDecal (side_t *wall, DBaseDecal *decal, drawseg_t *clipper,
 				rt_draw4cols (dc_x - 4);
 			}
 
-			while (dc_x < x2)
+			while (dc_x < cx2)
 			{
 				if (calclighting)
 				{ // calculate lighting
@@ -3331,6 +3388,7 @@ static void R_RenderDecal (side_t *wall, DBaseDecal *decal, drawseg_t *clipper,
 				WallSpriteColumn (R_DrawMaskedColumn);
 				dc_x++;
 			}
+			rw_light += (x2 - cx2) * rw_lightstep;
 		}
 
 		// If this sprite is RF_CLIPFULL on a two-sided line, needrepeat will
@@ -27,9 +27,9 @@ struct drawseg_t;
 
 void R_RenderMaskedSegRange (drawseg_t *ds, int x1, int x2);
 
-extern short *openings;
-extern ptrdiff_t lastopening;
-extern size_t maxopenings;
+extern RENDER_TLS short *openings;
+extern RENDER_TLS ptrdiff_t lastopening;
+extern RENDER_TLS size_t maxopenings;
 
 ptrdiff_t R_NewOpening (ptrdiff_t len);
 
@@ -78,11 +78,11 @@ extern int 				numgamesubsectors;
 //
 // POV data.
 //
-extern fixed_t			viewz;
-extern angle_t			viewangle;
+extern RENDER_TLS fixed_t			viewz;
+extern RENDER_TLS angle_t			viewangle;
 
-extern AActor*			camera;		// [RH] camera instead of viewplayer
-extern sector_t*		viewsector;	// [RH] keep track of sector viewing from
+extern RENDER_TLS AActor*			camera;		// [RH] camera instead of viewplayer
+extern RENDER_TLS sector_t*		viewsector;	// [RH] keep track of sector viewing from
 
 extern angle_t			xtoviewangle[MAXWIDTH+1];
 extern int				FieldOfView;
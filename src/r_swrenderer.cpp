@@ -43,6 +43,12 @@
 #include "r_polymost.h"
 #include "textures/textures.h"
 #include "r_data/voxels.h"
+#include "c_dispatch.h"
+#include "doomstat.h"
+#include "r_utility.h"
+#include "stats.h"
+#include "network.h"
+#include "v_text.h"
 
 
 // [BB] Use ZDoom's freelook limit for the sotfware renderer.
@@ -305,3 +311,134 @@ sector_t *FSoftwareRenderer::FakeFlat(sector_t *sec, sector_t *tempsec, int *flo
 	return R_FakeFlat(sec, tempsec, floorlightlevel, ceilinglightlevel, back);
 }
 
+
+//==========================================================================
+//
+// CCMD bench_swrender
+//
+// [Zandronum] Renders the view from every player start, looking in eight
+// directions, to an offscreen canvas, once in a single slice and once with
+// the given number of render slices. Reports the frame times of both and
+// checks that the sliced frames are identical to the single-slice ones.
+// The views only depend on the map, so runs on different machines can be
+// compared.
+//
+// Usage: bench_swrender [width] [height] [repeats] [slices]
+//
+//==========================================================================
+
+EXTERN_CVAR (Int, r_slices)
+
+struct FBenchFrameTimes
+{
+	double Total, Best, Worst;
+
+	FBenchFrameTimes () : Total (0), Best (HUGE_VAL), Worst (0) {}
+
+	void Render (AActor *viewpoint, DCanvas *canvas, int width, int height)
+	{
+		cycle_t frametime;
+
+		frametime.Reset ();
+		frametime.Clock ();
+		R_RenderViewToCanvas (viewpoint, canvas, 0, 0, width, height);
+		frametime.Unclock ();
+
+		const double ms = frametime.TimeMS ();
+		Total += ms;
+		Best = MIN (Best, ms);
+		Worst = MAX (Worst, ms);
+	}
+};
+
+CCMD (bench_swrender)
+{
+	if ( gamestate != GS_LEVEL || currentrenderer != 0 || NETWORK_GetState( ) == NETSTATE_SERVER )
+	{
+		Printf ("bench_swrender can only be used in a level with the software renderer.\n");
+		return;
+	}
+	if (AllPlayerStarts.Size() == 0)
+	{
+		Printf ("This map has no player starts.\n");
+		return;
+	}
+
+	const int width = clamp (argv.argc() > 1 ? atoi (argv[1]) : SCREENWIDTH, 16, MAXWIDTH);
+	const int height = clamp (argv.argc() > 2 ? atoi (argv[2]) : SCREENHEIGHT, 16, MAXHEIGHT);
+	const int repeats = MAX (argv.argc() > 3 ? atoi (argv[3]) : 4, 1);
+	const int savedslices = r_slices;
+	const int slices = argv.argc() > 4 ? clamp (atoi (argv[4]), 0, MAX_RENDER_SLICES) : savedslices;
+
+	DSimpleCanvas *canvas = new DSimpleCanvas (width, height);
+	canvas->ObjectFlags |= OF_Fixed;
+	canvas->Lock ();
+
+	AActor *viewpoint = Spawn ("MapSpot", 0, 0, 0, NO_REPLACE);
+	const bool savednointerpolate = r_NoInterpolate;
+	r_NoInterpolate = true;
+
+	FBenchFrameTimes single, sliced;
+	TArray<BYTE> reference;
+	reference.Resize (width * height);
+	int frames = 0, mismatches = 0;
+
+	for (unsigned int i = 0; i < AllPlayerStarts.Size(); ++i)
+	{
+		viewpoint->SetOrigin (AllPlayerStarts[i].x, AllPlayerStarts[i].y, 0);
+		viewpoint->z = viewpoint->floorz + 41*FRACUNIT;
+		viewpoint->pitch = 0;
+
+		for (int dir = 0; dir < 8; ++dir)
+		{
+			viewpoint->angle = dir * ANGLE_45;
+
+			r_slices = 1;
+			for (int j = 0; j < repeats; ++j)
+			{
+				single.Render (viewpoint, canvas, width, height);
+			}
+			for (int y = 0; y < height; ++y)
+			{
+				memcpy (&reference[y * width], canvas->GetBuffer() + y * canvas->GetPitch(), width);
+			}
+
+			r_slices = slices;
+			for (int j = 0; j < repeats; ++j)
+			{
+				sliced.Render (viewpoint, canvas, width, height);
+			}
+			for (int y = 0; y < height; ++y)
+			{
+				if (memcmp (&reference[y * width], canvas->GetBuffer() + y * canvas->GetPitch(), width) != 0)
+				{
+					mismatches++;
+					break;
+				}
+			}
+			frames += repeats;
+		}
+	}
+
+	r_slices = savedslices;
+	r_NoInterpolate = savednointerpolate;
+	viewpoint->Destroy ();
+	canvas->Unlock ();
+	canvas->Destroy ();
+	canvas->ObjectFlags |= OF_YesReallyDelete;
+	delete canvas;
+
+	Printf ("%d frames at %dx%d from %u starts\n", frames, width, height, AllPlayerStarts.Size());
+	Printf ("1 slice: %.3f ms average, %.3f ms best, %.3f ms worst\n",
+		single.Total / frames, single.Best, single.Worst);
+	Printf ("r_slices %d: %.3f ms average, %.3f ms best, %.3f ms worst\n",
+		slices, sliced.Total / frames, sliced.Best, sliced.Worst);
+	if (mismatches > 0)
+	{
+		Printf (TEXTCOLOR_RED "%d of %d views differ from the single-slice render.\n", mismatches, frames / repeats);
+	}
+	else
+	{
+		Printf ("All sliced views match the single-slice render.\n");
+	}
+}
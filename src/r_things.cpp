@@ -119,7 +119,7 @@ vissprite_t		*VisPSprites[NUMPSPRITES];
 int				VisPSpritesX1[NUMPSPRITES];
 FDynamicColormap *VisPSpritesBaseColormap[NUMPSPRITES];
 
-static int		spriteshade;
+static RENDER_TLS int		spriteshade;
 
 // constant arrays
 //	used for psprite clipping and initializing clipping
@@ -133,24 +133,32 @@ EXTERN_CVAR (Bool, r_drawvoxels)
 // INITIALIZATION FUNCTIONS
 //
 
-int OffscreenBufferWidth, OffscreenBufferHeight;
-BYTE *OffscreenColorBuffer;
-FCoverageBuffer *OffscreenCoverageBuffer;
+RENDER_TLS int OffscreenBufferWidth, OffscreenBufferHeight;
+RENDER_TLS BYTE *OffscreenColorBuffer;
+RENDER_TLS FCoverageBuffer *OffscreenCoverageBuffer;
 
 //
 // GAME FUNCTIONS
 //
-int				MaxVisSprites;
-vissprite_t 	**vissprites;
-vissprite_t		**firstvissprite;
-vissprite_t		**vissprite_p;
-vissprite_t		**lastvissprite;
-int 			newvissprite;
-bool			DrewAVoxel;
+RENDER_TLS int				MaxVisSprites;
+RENDER_TLS vissprite_t 	**vissprites;
+RENDER_TLS vissprite_t		**firstvissprite;
+RENDER_TLS vissprite_t		**vissprite_p;
+RENDER_TLS vissprite_t		**lastvissprite;
+RENDER_TLS int 			newvissprite;
+RENDER_TLS bool			DrewAVoxel;
 
-static vissprite_t **spritesorter;
-static int spritesortersize = 0;
-static int vsprcount;
+static RENDER_TLS vissprite_t **spritesorter;
+static RENDER_TLS int spritesortersize = 0;
+static RENDER_TLS int vsprcount;
+
+// [Zandronum] Sectors whose sprites were already added, kept per render
+// thread instead of in sector_t::validcount.
+static RENDER_TLS TArray<int> SectorSpriteCounts;
+static RENDER_TLS int SpriteValidCount;
+
+// The actor that must not be drawn in the current pass.
+RENDER_TLS AActor		*r_hiddenviewer;
 
 
 void R_DeinitSprites()
@@ -213,7 +221,10 @@ vissprite_t *R_NewVisSprite (void)
 		lastvissprite = &vissprites[MaxVisSprites];
 		firstvissprite = &vissprites[firstvisspritenum];
 		vissprite_p = &vissprites[prevvisspritenum];
-		DPrintf ("MaxVisSprites increased to %d\n", MaxVisSprites);
+		if (!RenderingSlices)
+		{
+			DPrintf ("MaxVisSprites increased to %d\n", MaxVisSprites);
+		}
 
 		// Allocate sprites from the new pile
 		for (vissprite_t **p = vissprite_p; p < lastvissprite; ++p)
@@ -232,13 +243,13 @@ vissprite_t *R_NewVisSprite (void)
 // Masked means: partly transparent, i.e. stored
 //	in posts/runs of opaque pixels.
 //
-short*			mfloorclip;
-short*			mceilingclip;
+RENDER_TLS short*			mfloorclip;
+RENDER_TLS short*			mceilingclip;
 
-fixed_t 		spryscale;
-fixed_t 		sprtopscreen;
+RENDER_TLS fixed_t 		spryscale;
+RENDER_TLS fixed_t 		sprtopscreen;
 
-bool			sprflipvert;
+RENDER_TLS bool			sprflipvert;
 
 void R_DrawMaskedColumn (const BYTE *column, const FTexture::Span *span)
 {
@@ -370,6 +381,16 @@ void R_DrawVisSprite (vissprite_t *vis)
 		dc_x = vis->x1;
 		x2 = vis->x2 + 1;
 
+		// [Zandronum] Only draw the columns of the current render slice.
+		if (dc_x < SliceLeft)
+		{
+			frac += xiscale * (SliceLeft - dc_x);
+			dc_x = SliceLeft;
+		}
+		x2 = MIN (x2, SliceRight);
+		stop4 = MIN (stop4, x2 & ~3);
+		R_PrepareTexture (tex);
+
 		if (dc_x < x2)
 		{
 			while ((dc_x < stop4) && (dc_x & 3))
@@ -405,7 +426,7 @@ void R_DrawVisSprite (vissprite_t *vis)
 
 	R_FinishSetPatchStyle ();
 
-	NetUpdate ();
+	R_NetUpdate ();
 }
 
 void R_DrawVisVoxel(vissprite_t *spr, int minslabz, int maxslabz, short *cliptop, short *clipbot)
@@ -479,7 +500,7 @@ void R_DrawVisVoxel(vissprite_t *spr, int minslabz, int maxslabz, short *cliptop
 	}
 
 	R_FinishSetPatchStyle();
-	NetUpdate();
+	R_NetUpdate();
 }
 
 //
@@ -518,7 +539,7 @@ void R_ProjectSprite (AActor *thing, int fakeside, F3DFloor *fakefloor, F3DFloor
 	SWORD				LeftOffset;
 
 	// Don't waste time projecting sprites that are definitely not visible.
-	if (thing == NULL ||
+	if (thing == NULL || thing == r_hiddenviewer ||
 		(thing->renderflags & RF_INVISIBLE) ||
 		!thing->RenderStyle.IsVisible(thing->alpha) ||
 		!thing->IsVisibleToPlayer())
@@ -584,7 +605,10 @@ void R_ProjectSprite (AActor *thing, int fakeside, F3DFloor *fakefloor, F3DFloor
 #ifdef RANGECHECK
 		if (spritenum >= (signed)sprites.Size () || spritenum < 0)
 		{
-			DPrintf ("R_ProjectSprite: invalid sprite number %u\n", spritenum);
+			if (!RenderingSlices)
+			{
+				DPrintf ("R_ProjectSprite: invalid sprite number %u\n", spritenum);
+			}
 			return;
 		}
 #endif
@@ -907,6 +931,25 @@ void R_ProjectSprite (AActor *thing, int fakeside, F3DFloor *fakefloor, F3DFloor
 }
 
 
+//==========================================================================
+//
+// R_NewSpriteValidCount
+//
+// Starts a new BSP walk for R_AddSprites.
+//
+//==========================================================================
+
+void R_NewSpriteValidCount ()
+{
+	if (SectorSpriteCounts.Size() != (unsigned)numsectors)
+	{
+		SectorSpriteCounts.Resize (numsectors);
+		memset (&SectorSpriteCounts[0], 0, numsectors * sizeof(int));
+		SpriteValidCount = 0;
+	}
+	SpriteValidCount++;
+}
+
 //
 // R_AddSprites
 // During BSP traversal, this adds sprites by sector.
@@ -924,11 +967,11 @@ void R_AddSprites (sector_t *sec, int lightlevel, int fakeside)
 	// A sector might have been split into several
 	//	subsectors during BSP building.
 	// Thus we check whether it was already added.
-	if (sec->thinglist == NULL || sec->validcount == validcount)
+	if (sec->thinglist == NULL || SectorSpriteCounts[int(sec - sectors)] == SpriteValidCount)
 		return;
 
 	// Well, now it will be done.
-	sec->validcount = validcount;
+	SectorSpriteCounts[int(sec - sectors)] = SpriteValidCount;
 
 	spriteshade = LIGHT2SHADE(lightlevel + r_actualextralight);
 
@@ -1389,8 +1432,8 @@ static bool sv_compare2d(vissprite_t *a, vissprite_t *b)
 }
 
 #if 0
-static drawseg_t **drawsegsorter;
-static int drawsegsortersize = 0;
+static RENDER_TLS drawseg_t **drawsegsorter;
+static RENDER_TLS int drawsegsortersize = 0;
 
 // Sort vissprites by leftmost column, left to right
 static int STACK_ARGS sv_comparex (const void *arg1, const void *arg2)
@@ -1574,8 +1617,8 @@ void R_SortVisSprites (bool (*compare)(vissprite_t *, vissprite_t *), size_t fir
 // [BB] Added dummy argument to stop the current wallhack.
 void R_DrawSprite (vissprite_t * /*dummyArg*/, vissprite_t *spr)
 {
-	static short clipbot[MAXWIDTH];
-	static short cliptop[MAXWIDTH];
+	static RENDER_TLS short clipbot[MAXWIDTH];
+	static RENDER_TLS short cliptop[MAXWIDTH];
 	drawseg_t *ds;
 	int i;
 	int x1, x2;
@@ -1603,6 +1646,11 @@ void R_DrawSprite (vissprite_t * /*dummyArg*/, vissprite_t *spr)
 	if (x1 > x2)
 		return;
 
+	// [Zandronum] Sprites outside of the current render slice are drawn
+	// by another slice.
+	if (x2 < SliceLeft || x1 >= SliceRight)
+		return;
+
 	// [RH] Sprites split behind a one-sided line can also be discarded.
 	if (spr->sector == NULL)
 		return;
@@ -1968,6 +2016,16 @@ void R_DrawSprite (vissprite_t * /*dummyArg*/, vissprite_t *spr)
 		{
 			clearbufshort(cliptop + x2 + 1, viewwidth - x2 - 1, viewheight);
 		}
+		// [Zandronum] The same goes for everything outside of the current
+		// render slice.
+		if (SliceLeft > x1)
+		{
+			clearbufshort(cliptop + x1, SliceLeft - x1, viewheight);
+		}
+		if (SliceRight <= x2)
+		{
+			clearbufshort(cliptop + SliceRight, x2 - SliceRight + 1, viewheight);
+		}
 		int minvoxely = spr->gzt <= hzt ? 0 : (spr->gzt - hzt) / spr->yscale;
 		int maxvoxely = spr->gzb > hzb ? INT_MAX : (spr->gzt - hzb) / spr->yscale;
 		R_DrawVisVoxel(spr, minvoxely, maxvoxely, cliptop, clipbot);
@@ -2080,7 +2138,11 @@ void R_DrawMasked (void)
 		R_3D_DeleteHeights();
 		fake3D = 0;
 	}
-	R_DrawPlayerSprites ();
+	// [Zandronum] Slices leave the weapon to R_RenderActorView.
+	if (!RenderingSlices)
+	{
+		R_DrawPlayerSprites ();
+	}
 }
 
 
@@ -2274,11 +2336,17 @@ void R_DrawParticle (vissprite_t *vis)
 	BYTE color = vis->Style.colormap[vis->startfrac];
 	int yl = vis->gzb;
 	int ycount = vis->gzt - yl + 1;
-	int x1 = vis->x1;
-	int countbase = vis->x2 - x1 + 1;
+	// [Zandronum] Only draw the columns of the current render slice.
+	int x1 = MAX<int> (vis->x1, SliceLeft);
+	int countbase = MIN<int> (vis->x2, SliceRight - 1) - x1 + 1;
 
 	R_DrawMaskedSegsBehindParticle (vis);
 
+	if (countbase <= 0)
+	{
+		return;
+	}
+
 	// vis->renderflags holds translucency level (0-255)
 	{
 		fixed_t fglevel, bglevel;
@@ -78,10 +78,10 @@ struct particle_t;
 void R_DrawParticle (vissprite_t *);
 void R_ProjectParticle (particle_t *, const sector_t *sector, int shade, int fakeside);
 
-extern int MaxVisSprites;
+extern RENDER_TLS int MaxVisSprites;
 
-extern vissprite_t		**vissprites, **firstvissprite;
-extern vissprite_t		**vissprite_p;
+extern RENDER_TLS vissprite_t		**vissprites, **firstvissprite;
+extern RENDER_TLS vissprite_t		**vissprite_p;
 
 // Constant arrays used for psprite clipping
 //	and initializing clipping.
@@ -89,11 +89,12 @@ extern short			zeroarray[MAXWIDTH];
 extern short			screenheightarray[MAXWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern short*			mfloorclip;
-extern short*			mceilingclip;
-extern fixed_t			spryscale;
-extern fixed_t			sprtopscreen;
-extern bool				sprflipvert;
+extern RENDER_TLS short*			mfloorclip;
+extern RENDER_TLS short*			mceilingclip;
+extern RENDER_TLS fixed_t			spryscale;
+extern RENDER_TLS fixed_t			sprtopscreen;
+extern RENDER_TLS bool				sprflipvert;
+extern RENDER_TLS AActor			*r_hiddenviewer;
 
 extern fixed_t			pspritexscale;
 extern fixed_t			pspriteyscale;
@@ -105,11 +106,13 @@ void R_DrawMaskedColumn (const BYTE *column, const FTexture::Span *spans);
 
 void R_CacheSprite (spritedef_t *sprite);
 void R_SortVisSprites (int (STACK_ARGS *compare)(const void *, const void *), size_t first);
+void R_NewSpriteValidCount ();
 void R_AddSprites (sector_t *sec, int lightlevel, int fakeside);
 void R_AddPSprites ();
 void R_DrawSprites ();
 void R_ClearSprites ();
 void R_DrawMasked ();
+void R_DrawPlayerSprites ();
 void R_DrawRemainingPlayerSprites ();
 
 void R_CheckOffscreenBuffer(int width, int height, bool spansonly);
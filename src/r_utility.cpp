@@ -67,7 +67,7 @@
 extern bool DrawFSHUD;		// [RH] Defined in d_main.cpp
 EXTERN_CVAR (Bool, cl_capfps)
 
-extern lighttable_t*	fixedcolormap;
+extern RENDER_TLS lighttable_t*	fixedcolormap;
 extern FSpecialColormap*realfixedcolormap;
 
 // TYPES -------------------------------------------------------------------
@@ -105,9 +105,9 @@ DCanvas			*RenderTarget;		// [RH] canvas to render to
 int 			viewwindowx;
 int 			viewwindowy;
 
-fixed_t 		viewx;
-fixed_t 		viewy;
-fixed_t 		viewz;
+RENDER_TLS fixed_t 		viewx;
+RENDER_TLS fixed_t 		viewy;
+RENDER_TLS fixed_t 		viewz;
 int				viewpitch;
 
 extern "C" 
@@ -121,13 +121,13 @@ extern "C"
 
 int				otic;
 
-angle_t 		viewangle;
-sector_t		*viewsector;
+RENDER_TLS angle_t 		viewangle;
+RENDER_TLS sector_t		*viewsector;
 
-fixed_t 		viewcos, viewtancos;
-fixed_t 		viewsin, viewtansin;
+RENDER_TLS fixed_t 		viewcos, viewtancos;
+RENDER_TLS fixed_t 		viewsin, viewtansin;
 
-AActor			*camera;	// [RH] camera to draw from. doesn't have to be a player
+RENDER_TLS AActor			*camera;	// [RH] camera to draw from. doesn't have to be a player
 
 fixed_t			r_TicFrac;			// [RH] Fractional tic to render
 DWORD			r_FrameTime;		// [RH] Time this frame started drawing (in ms)
@@ -141,7 +141,7 @@ bool			LocalKeyboardTurner;
 float			LastFOV;
 int				WidescreenRatio;
 int				setblocks;
-int				extralight;
+RENDER_TLS int				extralight;
 bool			setsizeneeded;
 fixed_t			FocalTangent;
 
@@ -11,9 +11,9 @@
 
 extern DCanvas			*RenderTarget;
 
-extern fixed_t			viewx;
-extern fixed_t			viewy;
-extern fixed_t			viewz;
+extern RENDER_TLS fixed_t			viewx;
+extern RENDER_TLS fixed_t			viewy;
+extern RENDER_TLS fixed_t			viewz;
 extern int				viewpitch;
 
 extern "C" int			centerx, centerxwide;
@@ -21,8 +21,8 @@ extern "C" int			centery;
 
 extern int				setblocks;
 
-extern fixed_t			viewtancos;
-extern fixed_t			viewtansin;
+extern RENDER_TLS fixed_t			viewtancos;
+extern RENDER_TLS fixed_t			viewtansin;
 extern fixed_t			FocalTangent;
 
 extern bool				r_NoInterpolate;
@@ -35,7 +35,7 @@ extern int				WidescreenRatio;
 
 extern fixed_t			r_TicFrac;
 extern DWORD			r_FrameTime;
-extern int				extralight;
+extern RENDER_TLS int				extralight;
 extern unsigned int		R_OldBlend;
 
 const int				r_Yaspect = 200;	// Why did I make this a variable? It's never set anywhere.
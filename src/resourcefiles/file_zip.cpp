@@ -117,9 +117,12 @@ struct FZipLump : public FResourceLump
 
 	virtual FileReader *GetReader();
 	virtual int FillCache();
+	virtual bool ReadCompressedData(TArray<BYTE> &data);
+	virtual bool Decompress(const TArray<BYTE> &data, char *buffer);
 
 private:
 	void SetLumpAddress();
+	bool Decode(FileReader *reader, char *buffer);
 	virtual int GetFileOffset() 
 	{ 
 		if (Method != METHOD_STORED) return -1;
@@ -411,7 +414,10 @@ int FZipLump::FillCache()
 	if (Flags & LUMPFZIP_NEEDFILESTART) SetLumpAddress();
 	const char *buffer;
 
-	if (Method == METHOD_STORED && (buffer = Owner->Reader->GetBuffer()) != NULL)
+	// [Zandronum] A lump that runs past the end of a truncated file
+	// can't point into the file's data and takes the copying path.
+	if (Method == METHOD_STORED && (buffer = Owner->Reader->GetBuffer()) != NULL &&
+		Position >= 0 && Position + (long)LumpSize <= Owner->Reader->GetLength())
 	{
 		// This is an in-memory file so the cache can point directly to the file's data.
 		Cache = const_cast<char*>(buffer) + Position;
@@ -421,54 +427,102 @@ int FZipLump::FillCache()
 
 	Owner->Reader->Seek(Position, SEEK_SET);
 	Cache = new char[LumpSize];
+	if (!Decode(Owner->Reader, Cache))
+	{
+		return 0;
+	}
+	RefCount = 1;
+	return 1;
+}
+
+//==========================================================================
+//
+// Decompresses the lump from the reader into the buffer
+//
+//==========================================================================
+
+bool FZipLump::Decode(FileReader *reader, char *buffer)
+{
 	switch (Method)
 	{
 		case METHOD_STORED:
 		{
-			Owner->Reader->Read(Cache, LumpSize);
+			reader->Read(buffer, LumpSize);
 			break;
 		}
 
 		case METHOD_DEFLATE:
 		{
-			FileReaderZ frz(*Owner->Reader, true);
-			frz.Read(Cache, LumpSize);
+			FileReaderZ frz(*reader, true);
+			frz.Read(buffer, LumpSize);
 			break;
 		}
 
 		case METHOD_BZIP2:
 		{
-			FileReaderBZ2 frz(*Owner->Reader);
-			frz.Read(Cache, LumpSize);
+			FileReaderBZ2 frz(*reader);
+			frz.Read(buffer, LumpSize);
 			break;
 		}
 
 		case METHOD_LZMA:
 		{
-			FileReaderLZMA frz(*Owner->Reader, LumpSize, true);
-			frz.Read(Cache, LumpSize);
+			FileReaderLZMA frz(*reader, LumpSize, true);
+			frz.Read(buffer, LumpSize);
 			break;
 		}
 
 		case METHOD_IMPLODE:
 		{
 			FZipExploder exploder;
-			exploder.Explode((unsigned char *)Cache, LumpSize, Owner->Reader, CompressedSize, GPFlags);
+			exploder.Explode((unsigned char *)buffer, LumpSize, reader, CompressedSize, GPFlags);
 			break;
 		}
 
 		case METHOD_SHRINK:
 		{
-			ShrinkLoop((unsigned char *)Cache, LumpSize, Owner->Reader, CompressedSize);
+			ShrinkLoop((unsigned char *)buffer, LumpSize, reader, CompressedSize);
 			break;
 		}
 
 		default:
 			assert(0);
-			return 0;
+			return false;
 	}
-	RefCount = 1;
-	return 1;
+	return true;
+}
+
+//==========================================================================
+//
+// [Zandronum] Reads the lump's compressed data, so that it can be
+// decompressed on another thread.
+//
+//==========================================================================
+
+bool FZipLump::ReadCompressedData(TArray<BYTE> &data)
+{
+	if (Method == METHOD_STORED || CompressedSize <= 0)
+	{
+		return false;
+	}
+	if (Flags & LUMPFZIP_NEEDFILESTART) SetLumpAddress();
+
+	data.Resize(CompressedSize);
+	Owner->Reader->Seek(Position, SEEK_SET);
+	return Owner->Reader->Read(&data[0], CompressedSize) == CompressedSize;
+}
+
+//==========================================================================
+//
+// [Zandronum] Decompresses data read by ReadCompressedData into the buffer.
+// This doesn't touch the file and can be called from any thread.
+//
+//==========================================================================
+
+bool FZipLump::Decompress(const TArray<BYTE> &data, char *buffer)
+{
+	MemoryReader reader((const char *)&data[0], data.Size());
+	return Decode(&reader, buffer);
 }
 
 
@@ -339,7 +339,9 @@ int FUncompressedLump::FillCache()
 {
 	const char * buffer = Owner->Reader->GetBuffer();
 
-	if (buffer != NULL)
+	// [Zandronum] A lump that runs past the end of a truncated file
+	// can't point into the file's data and takes the copying path.
+	if (buffer != NULL && Position >= 0 && Position + (long)LumpSize <= Owner->Reader->GetLength())
 	{
 		// This is an in-memory file so the cache can point directly to the file's data.
 		Cache = const_cast<char*>(buffer) + Position;
@@ -48,6 +48,12 @@ struct FResourceLump
 	void *CacheLump();
 	int ReleaseCache();
 
+	// [Zandronum] Allow FWadCollection::PrefetchLumps to decompress the lump on
+	// another thread: ReadCompressedData must be called on the main thread,
+	// Decompress can then be called on any thread.
+	virtual bool ReadCompressedData(TArray<BYTE> &data) { return false; }
+	virtual bool Decompress(const TArray<BYTE> &data, char *buffer) { return false; }
+
 protected:
 	virtual int FillCache() = 0;
 
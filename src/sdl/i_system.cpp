@@ -36,6 +36,7 @@
 #include <sys/types.h>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <signal.h>
 #ifndef NO_GTK
@@ -166,6 +167,48 @@ unsigned int I_FPSTime()
 	return SDL_GetTicks();
 }
 
+// [Zandronum] Returns the resident memory of the process in kilobytes.
+unsigned int I_GetResidentMemoryKB ()
+{
+#ifdef __linux__
+	FILE *statm = fopen ("/proc/self/statm", "r");
+	unsigned long size, resident = 0;
+
+	if (statm != NULL)
+	{
+		if (fscanf (statm, "%lu %lu", &size, &resident) != 2)
+		{
+			resident = 0;
+		}
+		fclose (statm);
+	}
+	return (unsigned int)(resident * (sysconf (_SC_PAGESIZE) / 1024));
+#else
+	return 0;
+#endif
+}
+
+// [Zandronum] Maps the whole file into memory. Pages that are never written
+// to are shared with every other process that maps the same file.
+void *I_MapFile (FILE *file, long length)
+{
+	if (length <= 0)
+	{
+		return NULL;
+	}
+
+	void *data = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno (file), 0);
+	return (data != MAP_FAILED) ? data : NULL;
+}
+
+void I_UnmapFile (void *data, long length)
+{
+	if (data != NULL)
+	{
+		munmap (data, length);
+	}
+}
+
 //
 // I_GetTime
 // returns time in 1/35th second tics
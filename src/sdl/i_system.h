@@ -127,6 +127,14 @@ bool I_WriteIniFailed ();
 unsigned int I_MSTime (void);
 unsigned int I_FPSTime();
 
+// [Zandronum] Returns the resident memory of the process in kilobytes, 0 if unknown.
+unsigned int I_GetResidentMemoryKB ();
+
+// [Zandronum] Maps the whole file into memory as a private copy-on-write view,
+// returns NULL if that isn't possible.
+void *I_MapFile (FILE *file, long length);
+void I_UnmapFile (void *data, long length);
+
 class FTexture;
 bool I_SetCursor(FTexture *);
 
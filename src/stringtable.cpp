@@ -44,6 +44,28 @@
 #include "c_dispatch.h"
 #include "v_text.h"
 #include "gi.h"
+#include "md5.h"
+#include "m_misc.h"
+#include "c_cvars.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// [Zandronum] The strings loaded from the LANGUAGE lumps are cached in a file,
+// so that they don't have to be parsed again the next time the same lumps
+// are loaded. Increase the version whenever the file format or the way the
+// lumps are parsed changes.
+//
+// Only LANGUAGE is cached. MAPINFO, SNDINFO, TEAMINFO and DECORATE build
+// structures that point into other tables (actors, sounds, textures), so
+// they are still parsed at every startup.
+#define STRING_CACHE_VERSION	1
+
+CVAR (Bool, language_cache, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 
 // PassNum identifies which language pass this string is from.
 // PassNum 0 is for DeHacked.
@@ -117,6 +139,29 @@ void FStringTable::LoadStrings (bool enuOnly)
 
 	FreeNonDehackedStrings ();
 
+	// [Zandronum] Use the cached strings if nothing changed since they were written.
+	BYTE key[16];
+	cycle_t keytime, loadtime;
+	keytime.Reset ();
+	loadtime.Reset ();
+	if (language_cache)
+	{
+		keytime.Clock ();
+		MakeCacheKey (key, enuOnly);
+		keytime.Unclock ();
+		loadtime.Clock ();
+		bool cached = ReadCache (key, enuOnly);
+		loadtime.Unclock ();
+		if (cached)
+		{
+			DPrintf ("LANGUAGE strings read from the cache in %.2f ms (%.2f ms to hash the lumps)\n",
+				keytime.TimeMS() + loadtime.TimeMS(), keytime.TimeMS());
+			return;
+		}
+	}
+
+	loadtime.Clock ();
+
 	lastlump = 0;
 
 	while ((lump = Wads.FindLump ("LANGUAGE", &lastlump)) != -1)
@@ -136,6 +181,259 @@ void FStringTable::LoadStrings (bool enuOnly)
 		// Fill in any missing strings with the default language
 		LoadLanguage (lump, MAKE_ID('*','*',0,0), true, ++j);
 	}
+	loadtime.Unclock ();
+	DPrintf ("LANGUAGE lumps parsed in %.2f ms\n", keytime.TimeMS() + loadtime.TimeMS());
+
+	if (language_cache)
+	{
+		WriteCache (key, enuOnly);
+	}
+}
+
+//==========================================================================
+//
+// FStringTable :: MakeCacheKey
+//
+// [Zandronum] The cached strings are only valid for the same LANGUAGE
+// lumps, the same language settings and game, and the same DeHackEd
+// strings, since those hide the strings from the lumps.
+//
+//==========================================================================
+
+void FStringTable::MakeCacheKey (BYTE key[16], bool enuOnly) const
+{
+	MD5Context md5;
+	DWORD header[6] = { STRING_CACHE_VERSION, enuOnly, LanguageIDs[0], LanguageIDs[1], LanguageIDs[2], LanguageIDs[3] };
+	int lastlump = 0, lump;
+
+	md5.Update ((const BYTE *)header, sizeof(header));
+	md5.Update ((const BYTE *)GameTypeName(), (unsigned)strlen (GameTypeName()) + 1);
+
+	while ((lump = Wads.FindLump ("LANGUAGE", &lastlump)) != -1)
+	{
+		FMemLump data = Wads.ReadLump (lump);
+		DWORD size = Wads.LumpLength (lump);
+
+		md5.Update ((const BYTE *)&size, sizeof(size));
+		md5.Update ((const BYTE *)data.GetMem(), size);
+	}
+
+	for (int i = 0; i < HASH_SIZE; ++i)
+	{
+		for (StringEntry *entry = Buckets[i]; entry != NULL; entry = entry->Next)
+		{
+			if (entry->PassNum == 0)
+			{
+				md5.Update ((const BYTE *)entry->Name, (unsigned)strlen (entry->Name) + 1);
+			}
+		}
+	}
+	md5.Final (key);
+}
+
+//==========================================================================
+//
+// [Zandronum] String cache file helpers
+//
+//==========================================================================
+
+static DWORD ReadCacheLong (const BYTE *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+static void WriteCacheLong (BYTE *p, DWORD v)
+{
+	p[0] = (BYTE)v;
+	p[1] = (BYTE)(v >> 8);
+	p[2] = (BYTE)(v >> 16);
+	p[3] = (BYTE)(v >> 24);
+}
+
+// The key is part of the name, so that programs that load different files
+// don't keep replacing each other's cache.
+static FString GetStringCacheName (const BYTE key[16], bool enuOnly, bool create)
+{
+	FString path = M_GetCachePath (create);
+	path << "/strings";
+	if (create) CreatePath (path);
+	path << '/' << (enuOnly ? "enu-" : "");
+	for (int i = 0; i < 16; ++i)
+	{
+		path.AppendFormat ("%02x", key[i]);
+	}
+	path << ".cache";
+	return path;
+}
+
+//==========================================================================
+//
+// FStringTable :: ReadCache
+//
+// [Zandronum] Loads the strings from the cache file if its key matches.
+// The file is a "LNGC" header, the key, the number of strings and then
+// the pass number, name and text of each string.
+//
+//==========================================================================
+
+bool FStringTable::ReadCache (const BYTE key[16], bool enuOnly)
+{
+	FILE *f = fopen (GetStringCacheName (key, enuOnly, false), "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+
+	TArray<BYTE> data;
+	fseek (f, 0, SEEK_END);
+	long size = ftell (f);
+	fseek (f, 0, SEEK_SET);
+	if (size > 24)
+	{
+		data.Resize (size);
+		if (fread (&data[0], 1, size, f) != (size_t)size)
+		{
+			data.Clear ();
+		}
+	}
+	fclose (f);
+
+	if (data.Size() <= 24 || memcmp (&data[0], "LNGC", 4) != 0 || memcmp (&data[4], key, 16) != 0)
+	{
+		return false;
+	}
+
+	const BYTE *p = &data[24], *end = &data[0] + data.Size();
+	DWORD count = ReadCacheLong (&data[20]);
+
+	for (DWORD i = 0; i < count; ++i)
+	{
+		if (end - p < 9)
+		{
+			break;
+		}
+		BYTE passnum = p[0];
+		DWORD namelen = ReadCacheLong (p + 1);
+		DWORD stringlen = ReadCacheLong (p + 5);
+		p += 9;
+		if ((DWORD)(end - p) < namelen + stringlen + 2)
+		{
+			break;
+		}
+		InsertString ((const char *)p, (const char *)p + namelen + 1, stringlen, passnum);
+		p += namelen + stringlen + 2;
+	}
+
+	if (p != end)
+	{
+		// The file is damaged. Parse the lumps after all.
+		FreeNonDehackedStrings ();
+		return false;
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// FStringTable :: WriteCache
+//
+//==========================================================================
+
+void FStringTable::WriteCache (const BYTE key[16], bool enuOnly) const
+{
+	TArray<BYTE> data;
+	DWORD count = 0;
+
+	data.Resize (24);
+	memcpy (&data[0], "LNGC", 4);
+	memcpy (&data[4], key, 16);
+
+	for (int i = 0; i < HASH_SIZE; ++i)
+	{
+		for (StringEntry *entry = Buckets[i]; entry != NULL; entry = entry->Next)
+		{
+			if (entry->PassNum == 0)
+			{
+				continue;
+			}
+			DWORD namelen = (DWORD)strlen (entry->Name);
+			DWORD stringlen = (DWORD)strlen (entry->String);
+			unsigned int pos = data.Reserve (9 + namelen + stringlen + 2);
+
+			data[pos] = entry->PassNum;
+			WriteCacheLong (&data[pos + 1], namelen);
+			WriteCacheLong (&data[pos + 5], stringlen);
+			memcpy (&data[pos + 9], entry->Name, namelen + 1);
+			memcpy (&data[pos + 10 + namelen], entry->String, stringlen + 1);
+			count++;
+		}
+	}
+	WriteCacheLong (&data[20], count);
+
+	// Write to a temporary file first, so that no other program reading the
+	// cache at the same time sees a partially written file.
+	FString name = GetStringCacheName (key, enuOnly, true);
+	FString tempname;
+#ifdef _WIN32
+	tempname.Format ("%s.%d.tmp", name.GetChars(), _getpid());
+#else
+	tempname.Format ("%s.%d.tmp", name.GetChars(), (int)getpid());
+#endif
+
+	FILE *f = fopen (tempname, "wb");
+	if (f != NULL)
+	{
+		bool written = fwrite (&data[0], 1, data.Size(), f) == data.Size();
+		written &= fclose (f) == 0;
+
+		// On Windows, rename fails if the target exists.
+		if (written && rename (tempname, name) != 0)
+		{
+			remove (name);
+			written = rename (tempname, name) == 0;
+		}
+		if (!written)
+		{
+			remove (tempname);
+		}
+	}
+}
+
+//==========================================================================
+//
+// FStringTable :: InsertString
+//
+// [Zandronum] Adds a cached string unless there already is one with the
+// same name, i.e. one from DeHackEd.
+//
+//==========================================================================
+
+void FStringTable::InsertString (const char *name, const char *string, size_t stringlen, BYTE passnum)
+{
+	DWORD bucket = MakeKey (name) & (HASH_SIZE-1);
+	StringEntry **pentry = &Buckets[bucket], *entry = *pentry;
+	int cmpval = 1;
+
+	while (entry != NULL)
+	{
+		cmpval = stricmp (entry->Name, name);
+		if (cmpval >= 0)
+			break;
+		pentry = &entry->Next;
+		entry = *pentry;
+	}
+	if (entry != NULL && cmpval == 0)
+	{
+		return;
+	}
+
+	size_t namelen = strlen (name);
+	entry = (StringEntry *)M_Malloc (sizeof(*entry) + stringlen + namelen + 2);
+	entry->Next = *pentry;
+	*pentry = entry;
+	memcpy (entry->String, string, stringlen + 1);
+	strcpy (entry->Name = entry->String + stringlen + 1, name);
+	entry->PassNum = passnum;
 }
 
 void FStringTable::LoadLanguage (int lumpnum, DWORD code, bool exactMatch, int passnum)
@@ -70,6 +70,10 @@ private:
 	void FreeData ();
 	void FreeNonDehackedStrings ();
 	void LoadLanguage (int lumpnum, DWORD code, bool exactMatch, int passnum);
+	void MakeCacheKey (BYTE key[16], bool enuOnly) const;
+	bool ReadCache (const BYTE key[16], bool enuOnly);
+	void WriteCache (const BYTE key[16], bool enuOnly) const;
+	void InsertString (const char *name, const char *string, size_t stringlen, BYTE passnum);
 	static size_t ProcessEscapes (char *str);
 	void FindString (const char *stringName, StringEntry **&pentry, StringEntry *&entry);
 };
@@ -0,0 +1,586 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: sv_actorsnapshot.cpp
+//
+// Description: Replicates the movement of monsters through per-client delta
+// snapshots instead of individual MoveThing commands.
+//
+// For every client and every replicated actor, the server remembers the state
+// the client acknowledged last. Each time the client gets its player updates,
+// it is also sent an unreliable snapshot. This snapshot contains a delta for
+// each actor whose position, velocity, angle or movedir differs from the
+// acknowledged state, or that has fields which were sent but not acknowledged
+// yet. Lost snapshots are therefore repaired by the next one, and actors that
+// don't move cost nothing.
+//
+// The acknowledgements arrive a round trip after the snapshots, by which time
+// an actor that keeps moving has been sent again. So the server keeps the
+// last few states it sent of every actor, and an acknowledgement of any of
+// them becomes the new baseline. Only the fields sent after that one stay
+// pending.
+//
+// Snapshots that don't fit into one packet are split into pieces, each of which
+// starts with its own header. The client acknowledges the latest snapshot
+// together with the pieces of it that it received completely.
+//
+// States and flags are still sent as events, the clients run the action
+// functions of the states themselves. MoveThingExact is still sent as well,
+// snapshots only have the precision of MoveThing.
+//
+//-----------------------------------------------------------------------------
+
+#include "sv_actorsnapshot.h"
+#include "actor.h"
+#include "c_cvars.h"
+#include "doomstat.h"
+#include "network/netcommand.h"
+#include "network/servercommands.h"
+#include "stats.h"
+#include "sv_main.h"
+#include "sv_packetscheduler.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// Every actor is sent completely at least this often, so that clients can't
+// drift away from the server unnoticed, e.g. through their own physics. This
+// has to be odd, so that it works with every cl_ticsperupdate.
+#define	ACTORSNAPSHOT_REFRESH_TICS	( 5 * TICRATE )
+
+// How many of the states sent of an actor are remembered per client, waiting
+// to be acknowledged. This has to cover the round trip time in snapshots.
+#define	ACTORSNAPSHOT_HISTORY		8
+
+//*****************************************************************************
+//	STRUCTURES
+
+// The replicated part of an actor, as the client sees it after the
+// quantization of the network commands.
+struct ACTORSNAPSHOTSTATE_s
+{
+	fixed_t		x;
+	fixed_t		y;
+	fixed_t		z;
+	angle_t		angle;
+	fixed_t		velx;
+	fixed_t		vely;
+	fixed_t		velz;
+	int			movedir;
+};
+
+//*****************************************************************************
+// One delta of an actor sent to a client.
+struct ACTORSNAPSHOTSENT_s
+{
+	// The state the client has after applying this delta.
+	ACTORSNAPSHOTSTATE_s	State;
+
+	// The snapshot and piece the delta was sent in, lTic is -1 if the entry is
+	// unused or was acknowledged.
+	LONG					lTic;
+	ULONG					ulPiece;
+
+	// The fields the delta contained.
+	ULONG					ulBits;
+};
+
+//*****************************************************************************
+// What one client knows about one actor.
+struct ACTORSNAPSHOTBASELINE_s
+{
+	// The state the client acknowledged. Only meaningful if bAcknowledged is true.
+	ACTORSNAPSHOTSTATE_s	Acknowledged;
+	LONG					lAcknowledgedTic;
+	bool					bAcknowledged;
+
+	// The deltas sent since the acknowledged one (ring buffer).
+	ACTORSNAPSHOTSENT_s		aSent[ACTORSNAPSHOT_HISTORY];
+	ULONG					ulNextSent;
+
+	// The fields of the deltas that dropped out of aSent before they were
+	// acknowledged, and the snapshot of the latest of them. These stay pending
+	// until a later snapshot is acknowledged.
+	ULONG					ulEvictedBits;
+	LONG					lEvictedTic;
+};
+
+//*****************************************************************************
+struct ACTORSNAPSHOTRECORD_s
+{
+	AActor					*pActor;
+
+	// Was the actor still around during the last SERVER_ACTORSNAPSHOT_Tick?
+	bool					bSeen;
+
+	ACTORSNAPSHOTBASELINE_s	aBaselines[MAXPLAYERS];
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+// The records of the replicated actors, indexed by their network ID.
+static	ACTORSNAPSHOTRECORD_s	*g_apRecords[IDList<AActor>::MAX_NETID];
+
+// The network IDs that have a record.
+static	TArray<WORD>			g_TrackedNetIDs;
+
+// The latest snapshot each client acknowledged.
+static	LONG					g_alAcknowledgedTic[MAXPLAYERS];
+
+// Statistics for "stat actorsnapshots".
+static	ULONG					g_ulDeltasThisTic;
+static	ULONG					g_ulBytesThisTic;
+static	ULONG					g_ulPiecesThisTic;
+static	ULONG					g_ulLastDeltas;
+static	ULONG					g_ulLastBytes;
+static	ULONG					g_ulLastPieces;
+static	ULONG					g_ulAcknowledgedThisTic;
+static	ULONG					g_ulEvictedThisTic;
+static	ULONG					g_ulLastAcknowledged;
+static	ULONG					g_ulLastEvicted;
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	void			server_actorsnapshot_ResetBaseline( ACTORSNAPSHOTBASELINE_s &Baseline );
+static	ULONG			server_actorsnapshot_GetPendingBits( const ACTORSNAPSHOTBASELINE_s &Baseline );
+static	void			server_actorsnapshot_RecordSent( ACTORSNAPSHOTBASELINE_s &Baseline, const ACTORSNAPSHOTSTATE_s &State, ULONG ulPiece, ULONG ulBits );
+static	void			server_actorsnapshot_GetState( AActor *pActor, ACTORSNAPSHOTSTATE_s &State );
+static	ULONG			server_actorsnapshot_CompareStates( const ACTORSNAPSHOTSTATE_s &State1, const ACTORSNAPSHOTSTATE_s &State2 );
+static	void			server_actorsnapshot_FreeRecord( WORD wNetID );
+
+//*****************************************************************************
+//	CONSOLE VARIABLES
+
+CUSTOM_CVAR( Bool, sv_actorsnapshots, false, CVAR_ARCHIVE|CVAR_NOSETBYACS )
+{
+	// Start from scratch, the clients got MoveThing commands in the meantime.
+	SERVER_ACTORSNAPSHOT_Clear( );
+}
+
+//*****************************************************************************
+//	FUNCTIONS
+
+bool SERVER_ACTORSNAPSHOT_IsEnabled( void )
+{
+	return (( NETWORK_GetState( ) == NETSTATE_SERVER ) && sv_actorsnapshots );
+}
+
+//*****************************************************************************
+//
+// Returns whether the movement of this actor is sent through snapshots. If it
+// is, MoveThing commands to all clients leave out the snapshot fields.
+//
+bool SERVER_ACTORSNAPSHOT_IsReplicated( AActor *pActor )
+{
+	if (( pActor == NULL ) || ( SERVER_ACTORSNAPSHOT_IsEnabled( ) == false ))
+		return ( false );
+
+	// Players are moved by MovePlayer.
+	if (( pActor->lNetID <= 0 ) || ( pActor->lNetID >= IDList<AActor>::MAX_NETID ) || ( pActor->player != NULL ))
+		return ( false );
+
+	if ( pActor->ulNetworkFlags & NETFL_SERVERSIDEONLY )
+		return ( false );
+
+	return (( pActor->flags3 & MF3_ISMONSTER ) != 0 );
+}
+
+//*****************************************************************************
+//
+// Updates the records to the actors of this tic. Has to be called once per
+// tic before the snapshots are written.
+//
+void SERVER_ACTORSNAPSHOT_Tick( void )
+{
+	g_ulLastDeltas = g_ulDeltasThisTic;
+	g_ulLastBytes = g_ulBytesThisTic;
+	g_ulLastPieces = g_ulPiecesThisTic;
+	g_ulLastAcknowledged = g_ulAcknowledgedThisTic;
+	g_ulLastEvicted = g_ulEvictedThisTic;
+	g_ulDeltasThisTic = g_ulBytesThisTic = g_ulPiecesThisTic = 0;
+	g_ulAcknowledgedThisTic = g_ulEvictedThisTic = 0;
+
+	if (( SERVER_ACTORSNAPSHOT_IsEnabled( ) == false ) || ( gamestate != GS_LEVEL ))
+		return;
+
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); i++ )
+		g_apRecords[g_TrackedNetIDs[i]]->bSeen = false;
+
+	TThinkerIterator<AActor>	iterator;
+	AActor						*pActor;
+
+	while (( pActor = iterator.Next( )) != NULL )
+	{
+		if ( SERVER_ACTORSNAPSHOT_IsReplicated( pActor ) == false )
+			continue;
+
+		const WORD wNetID = static_cast<WORD>( pActor->lNetID );
+		ACTORSNAPSHOTRECORD_s *pRecord = g_apRecords[wNetID];
+
+		// A different actor got this ID, the clients know nothing about it yet.
+		if (( pRecord != NULL ) && ( pRecord->pActor != pActor ))
+		{
+			for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+				server_actorsnapshot_ResetBaseline( pRecord->aBaselines[ulIdx] );
+			pRecord->pActor = pActor;
+		}
+		else if ( pRecord == NULL )
+		{
+			pRecord = new ACTORSNAPSHOTRECORD_s;
+			pRecord->pActor = pActor;
+			for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+				server_actorsnapshot_ResetBaseline( pRecord->aBaselines[ulIdx] );
+
+			g_apRecords[wNetID] = pRecord;
+			g_TrackedNetIDs.Push( wNetID );
+		}
+
+		pRecord->bSeen = true;
+	}
+
+	// Forget the actors that are gone.
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); )
+	{
+		if ( g_apRecords[g_TrackedNetIDs[i]]->bSeen )
+		{
+			i++;
+			continue;
+		}
+
+		server_actorsnapshot_FreeRecord( g_TrackedNetIDs[i] );
+		g_TrackedNetIDs[i] = g_TrackedNetIDs[g_TrackedNetIDs.Size( ) - 1];
+		g_TrackedNetIDs.Pop( );
+	}
+}
+
+//*****************************************************************************
+//
+void SERVER_ACTORSNAPSHOT_WriteClientSnapshot( ULONG ulClient )
+{
+	if (( SERVER_ACTORSNAPSHOT_IsEnabled( ) == false ) || ( gamestate != GS_LEVEL ) || ( ulClient >= MAXPLAYERS ))
+		return;
+
+	CLIENT_s *pClient = SERVER_GetClient( ulClient );
+
+	// The client is still spawning the actors of the full update.
+	if ( pClient->bFullUpdateIncomplete )
+		return;
+
+	ServerCommands::ActorSnapshot	header;
+	ULONG							ulPiece = 0;
+	ULONG							ulPieceSize = 0;
+	bool							bHeaderWritten = false;
+
+	header.SetSnapshotTic( gametic );
+
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); i++ )
+	{
+		ACTORSNAPSHOTRECORD_s	*pRecord = g_apRecords[g_TrackedNetIDs[i]];
+		ACTORSNAPSHOTBASELINE_s	&baseline = pRecord->aBaselines[ulClient];
+		ACTORSNAPSHOTSTATE_s	state;
+
+		server_actorsnapshot_GetState( pRecord->pActor, state );
+
+		ULONG ulBits = server_actorsnapshot_GetPendingBits( baseline );
+		if (( baseline.bAcknowledged == false ) || ((( g_TrackedNetIDs[i] + gametic ) % ACTORSNAPSHOT_REFRESH_TICS ) == 0 ))
+			ulBits |= ACTORSNAPSHOT_FIELDS;
+		else
+			ulBits |= server_actorsnapshot_CompareStates( state, baseline.Acknowledged );
+
+		if ( ulBits == 0 )
+			continue;
+
+		ServerCommands::ActorDelta delta;
+		delta.SetActor( pRecord->pActor );
+		delta.SetBits( ulBits );
+		delta.SetX( state.x );
+		delta.SetY( state.y );
+		delta.SetZ( state.z );
+		delta.SetAngle( state.angle );
+		delta.SetVelX( state.velx );
+		delta.SetVelY( state.vely );
+		delta.SetVelZ( state.velz );
+		delta.SetMovedir( state.movedir );
+
+		NetCommand command = delta.BuildNetCommand( );
+		const ULONG ulSize = command.calcSize( );
+
+		// Start a new piece if this delta would not fit into the current packet.
+		// Every piece needs its own header, the packets may get lost or arrive
+		// in any order. The packet scheduler sends each piece as a whole, so it
+		// only has to fit into a packet of its own.
+		if ( bHeaderWritten )
+		{
+			const bool bScheduled = SERVER_PACKETSCHEDULER_IsEnabled( );
+			const ULONG ulPacketSize = bScheduled ? ulPieceSize : pClient->UnreliablePacketBuffer.CalcSize( );
+
+			if (( ulPacketSize + ulSize + 5 ) >= SERVER_GetMaxPacketSize( ))
+			{
+				if ( bScheduled == false )
+					SERVER_SendClientPacket( ulClient, false );
+				ulPiece++;
+				bHeaderWritten = false;
+			}
+		}
+
+		if ( bHeaderWritten == false )
+		{
+			header.SetPiece( MIN<ULONG>( ulPiece, 255 ));
+			NetCommand headerCommand = header.BuildNetCommand( );
+			g_ulBytesThisTic += headerCommand.calcSize( );
+			g_ulPiecesThisTic++;
+			headerCommand.sendCommandToOneClient( ulClient );
+			ulPieceSize = headerCommand.calcSize( );
+			bHeaderWritten = true;
+		}
+
+		command.sendCommandToOneClient( ulClient );
+		ulPieceSize += ulSize;
+		g_ulBytesThisTic += ulSize;
+		g_ulDeltasThisTic++;
+
+		server_actorsnapshot_RecordSent( baseline, state, ulPiece, ulBits );
+	}
+}
+
+//*****************************************************************************
+//
+// The client received the given pieces of the snapshot sent at lSnapshotTic.
+// Every actor that was sent in one of these pieces is now known to have had
+// the state that was sent, which becomes its new baseline. Only the fields
+// of the deltas sent after that stay pending.
+//
+void SERVER_ACTORSNAPSHOT_Acknowledge( ULONG ulClient, LONG lSnapshotTic, ULONG ulPieceMask )
+{
+	if (( ulClient >= MAXPLAYERS ) || ( lSnapshotTic > gametic ))
+		return;
+
+	// Acknowledgements may arrive out of order. An older one can still
+	// confirm the actors that weren't in the newer snapshot.
+	g_alAcknowledgedTic[ulClient] = MAX( g_alAcknowledgedTic[ulClient], lSnapshotTic );
+
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); i++ )
+	{
+		ACTORSNAPSHOTBASELINE_s &baseline = g_apRecords[g_TrackedNetIDs[i]]->aBaselines[ulClient];
+
+		if ( baseline.bAcknowledged && ( lSnapshotTic <= baseline.lAcknowledgedTic ))
+			continue;
+
+		for ( ULONG ulIdx = 0; ulIdx < ACTORSNAPSHOT_HISTORY; ulIdx++ )
+		{
+			const ACTORSNAPSHOTSENT_s &sent = baseline.aSent[ulIdx];
+
+			if (( sent.lTic != lSnapshotTic ) ||
+				( sent.ulPiece >= MAX_ACKNOWLEDGED_PIECES ) ||
+				(( ulPieceMask & ( 1 << sent.ulPiece )) == 0 ))
+			{
+				continue;
+			}
+
+			baseline.Acknowledged = sent.State;
+			baseline.lAcknowledgedTic = lSnapshotTic;
+			baseline.bAcknowledged = true;
+			g_ulAcknowledgedThisTic++;
+
+			// Whatever was sent up to this snapshot is covered by it now.
+			for ( ULONG ulOther = 0; ulOther < ACTORSNAPSHOT_HISTORY; ulOther++ )
+			{
+				if ( baseline.aSent[ulOther].lTic <= lSnapshotTic )
+					baseline.aSent[ulOther].lTic = -1;
+			}
+			if ( baseline.lEvictedTic <= lSnapshotTic )
+			{
+				baseline.ulEvictedBits = 0;
+				baseline.lEvictedTic = -1;
+			}
+			break;
+		}
+	}
+}
+
+//*****************************************************************************
+//
+// The client (re)spawned all actors, e.g. through a full update, so nothing
+// it acknowledged before is valid anymore.
+//
+void SERVER_ACTORSNAPSHOT_ResetClient( ULONG ulClient )
+{
+	if ( ulClient >= MAXPLAYERS )
+		return;
+
+	g_alAcknowledgedTic[ulClient] = 0;
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); i++ )
+		server_actorsnapshot_ResetBaseline( g_apRecords[g_TrackedNetIDs[i]]->aBaselines[ulClient] );
+}
+
+//*****************************************************************************
+//
+void SERVER_ACTORSNAPSHOT_Clear( void )
+{
+	for ( unsigned int i = 0; i < g_TrackedNetIDs.Size( ); i++ )
+		server_actorsnapshot_FreeRecord( g_TrackedNetIDs[i] );
+
+	g_TrackedNetIDs.Clear( );
+	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+		g_alAcknowledgedTic[ulIdx] = 0;
+}
+
+//*****************************************************************************
+//
+static void server_actorsnapshot_ResetBaseline( ACTORSNAPSHOTBASELINE_s &Baseline )
+{
+	Baseline.bAcknowledged = false;
+	Baseline.lAcknowledgedTic = -1;
+	for ( ULONG ulIdx = 0; ulIdx < ACTORSNAPSHOT_HISTORY; ulIdx++ )
+		Baseline.aSent[ulIdx].lTic = -1;
+	Baseline.ulNextSent = 0;
+	Baseline.ulEvictedBits = 0;
+	Baseline.lEvictedTic = -1;
+}
+
+//*****************************************************************************
+//
+// Returns the fields that were sent since the acknowledged state. If any of
+// those deltas arrived, the client may have values that differ from both the
+// acknowledged and the current state, so these have to be sent again.
+//
+static ULONG server_actorsnapshot_GetPendingBits( const ACTORSNAPSHOTBASELINE_s &Baseline )
+{
+	ULONG ulBits = Baseline.ulEvictedBits;
+
+	for ( ULONG ulIdx = 0; ulIdx < ACTORSNAPSHOT_HISTORY; ulIdx++ )
+	{
+		if ( Baseline.aSent[ulIdx].lTic != -1 )
+			ulBits |= Baseline.aSent[ulIdx].ulBits;
+	}
+
+	return ( ulBits );
+}
+
+//*****************************************************************************
+//
+static void server_actorsnapshot_RecordSent( ACTORSNAPSHOTBASELINE_s &Baseline, const ACTORSNAPSHOTSTATE_s &State, ULONG ulPiece, ULONG ulBits )
+{
+	ACTORSNAPSHOTSENT_s &sent = Baseline.aSent[Baseline.ulNextSent];
+
+	// The oldest delta wasn't acknowledged in time, its fields stay pending.
+	if ( sent.lTic != -1 )
+	{
+		Baseline.ulEvictedBits |= sent.ulBits;
+		Baseline.lEvictedTic = MAX( Baseline.lEvictedTic, sent.lTic );
+		g_ulEvictedThisTic++;
+	}
+
+	sent.State = State;
+	sent.lTic = gametic;
+	sent.ulPiece = ulPiece;
+	sent.ulBits = ulBits;
+	Baseline.ulNextSent = ( Baseline.ulNextSent + 1 ) % ACTORSNAPSHOT_HISTORY;
+}
+
+//*****************************************************************************
+//
+// Gets the state of the actor with the precision it has on the clients.
+//
+static void server_actorsnapshot_GetState( AActor *pActor, ACTORSNAPSHOTSTATE_s &State )
+{
+	const fixed_t	fracMask = ~( FRACUNIT - 1 );
+
+	State.x = pActor->x & fracMask;
+	State.y = pActor->y & fracMask;
+	State.z = pActor->z & fracMask;
+	State.angle = pActor->angle & 0xFFFF0000;
+	State.velx = pActor->velx & fracMask;
+	State.vely = pActor->vely & fracMask;
+	State.velz = pActor->velz & fracMask;
+	State.movedir = pActor->movedir & 0xFF;
+}
+
+//*****************************************************************************
+//
+static ULONG server_actorsnapshot_CompareStates( const ACTORSNAPSHOTSTATE_s &State1, const ACTORSNAPSHOTSTATE_s &State2 )
+{
+	ULONG	ulBits = 0;
+
+	if ( State1.x != State2.x )
+		ulBits |= CM_X;
+	if ( State1.y != State2.y )
+		ulBits |= CM_Y;
+	if ( State1.z != State2.z )
+		ulBits |= CM_Z;
+	if ( State1.angle != State2.angle )
+		ulBits |= CM_ANGLE;
+	if ( State1.velx != State2.velx )
+		ulBits |= CM_VELX;
+	if ( State1.vely != State2.vely )
+		ulBits |= CM_VELY;
+	if ( State1.velz != State2.velz )
+		ulBits |= CM_VELZ;
+	if ( State1.movedir != State2.movedir )
+		ulBits |= CM_MOVEDIR;
+
+	return ( ulBits );
+}
+
+//*****************************************************************************
+//
+static void server_actorsnapshot_FreeRecord( WORD wNetID )
+{
+	delete ( g_apRecords[wNetID] );
+	g_apRecords[wNetID] = NULL;
+}
+
+//*****************************************************************************
+//	STATISTICS
+
+ADD_STAT( actorsnapshots )
+{
+	FString	out;
+
+	out.Format( "%u actors tracked, last tic: %lu deltas in %lu pieces, %lu bytes (%.1f per delta), %lu acknowledged, %lu unacknowledged dropped from the history",
+		g_TrackedNetIDs.Size( ), g_ulLastDeltas, g_ulLastPieces, g_ulLastBytes,
+		g_ulLastDeltas ? static_cast<double>( g_ulLastBytes ) / g_ulLastDeltas : 0.0,
+		g_ulLastAcknowledged, g_ulLastEvicted );
+	return ( out );
+}
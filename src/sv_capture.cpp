@@ -0,0 +1,612 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: sv_capture.cpp
+//
+// Description: Records everything a server receives, so that a session can be
+// replayed offline, as fast as possible and without any sockets.
+//
+// A capture always starts with a fresh map, so that the level and the random
+// number generators start from a known state. After the header that describes
+// this state, the file contains the decoded packets and console commands in
+// the order the server processed them, split into tics by CE_TIC entries.
+// Replaying feeds these back through NETWORK_GetPackets, one tic per
+// SERVER_Tick call and without waiting for the clock. Everything the server
+// sends is dropped.
+//
+//-----------------------------------------------------------------------------
+
+#include "sv_capture.h"
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "cmdlib.h"
+#include "d_net.h"
+#include "doomstat.h"
+#include "g_level.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_random.h"
+#include "network.h"
+#include "stats.h"
+#include "sv_main.h"
+#include "version.h"
+
+//*****************************************************************************
+//	DEFINES
+
+enum CAPTURESTATE_e
+{
+	CAPTURESTATE_NONE,
+
+	// sv_capture was used, the capture begins with the next map.
+	CAPTURESTATE_ARMED,
+	CAPTURESTATE_CAPTURING,
+
+	// -replaycapture was given, the replay begins with the first tic.
+	CAPTURESTATE_REPLAYPENDING,
+	CAPTURESTATE_REPLAYING,
+
+	// The whole capture was replayed, D_DoomLoop quits after this tic.
+	CAPTURESTATE_REPLAYFINISHED,
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+static	const char		g_CaptureMagic[4] = { 'Z', 'S', 'C', 'P' };
+
+static	CAPTURESTATE_e	g_CaptureState = CAPTURESTATE_NONE;
+static	FILE			*g_pCaptureFile = NULL;
+static	FString			g_CaptureFileName;
+
+// Value of I_MSTime( ) when the capture started.
+static	unsigned int	g_uiCaptureStartTime;
+
+static	ULONG			g_ulNumCapturedTics;
+static	ULONG			g_ulNumCapturedPackets;
+static	ULONG			g_ulNumCapturedBytes;
+
+// The state the replay needs to start from, read from the header.
+static	FString			g_ReplayMapName;
+static	int				g_iReplayGametic;
+static	DWORD			g_ReplayRNGSeed;
+static	bool			g_bReplayUseStaticRNG;
+static	DWORD			g_ReplayStaticRNGSeed;
+static	bool			g_bReplayGameStarted;
+
+static	ULONG			g_ulNumReplayedTics;
+static	ULONG			g_ulNumReplayedPackets;
+static	ULONG			g_ulNumDivergedTics;
+static	cycle_t			g_ReplayTime;
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	void			server_capture_Stop( void );
+static	void			server_capture_WriteLong( DWORD dwValue );
+static	void			server_capture_WriteString( const char *pszString );
+static	bool			server_capture_ReadLong( DWORD &dwValue );
+static	bool			server_capture_ReadString( FString &String );
+static	bool			server_capture_ReadHeader( void );
+static	void			server_capture_FinishReplay( void );
+
+//*****************************************************************************
+//	FUNCTIONS
+
+void SERVER_CAPTURE_Construct( void )
+{
+	// Call SERVER_CAPTURE_Destruct() when Zandronum closes.
+	atterm( SERVER_CAPTURE_Destruct );
+
+	const char *pszReplayFile = Args->CheckValue( "-replaycapture" );
+	if ( pszReplayFile == NULL )
+		return;
+
+	g_pCaptureFile = fopen( pszReplayFile, "rb" );
+	if ( g_pCaptureFile == NULL )
+		I_FatalError( "Couldn't open capture %s: %s", pszReplayFile, strerror( errno ));
+
+	g_CaptureFileName = pszReplayFile;
+	if ( server_capture_ReadHeader( ) == false )
+		I_FatalError( "%s is not a valid server capture", pszReplayFile );
+
+	g_CaptureState = CAPTURESTATE_REPLAYPENDING;
+}
+
+//*****************************************************************************
+//
+void SERVER_CAPTURE_Destruct( void )
+{
+	if ( g_CaptureState == CAPTURESTATE_CAPTURING )
+		server_capture_Stop( );
+
+	if ( g_pCaptureFile )
+	{
+		fclose( g_pCaptureFile );
+		g_pCaptureFile = NULL;
+	}
+
+	g_CaptureState = CAPTURESTATE_NONE;
+}
+
+//*****************************************************************************
+//
+bool SERVER_CAPTURE_IsCapturing( void )
+{
+	return ( g_CaptureState == CAPTURESTATE_CAPTURING );
+}
+
+//*****************************************************************************
+//
+bool SERVER_CAPTURE_IsReplaying( void )
+{
+	return (( g_CaptureState == CAPTURESTATE_REPLAYPENDING ) || ( g_CaptureState == CAPTURESTATE_REPLAYING ) || ( g_CaptureState == CAPTURESTATE_REPLAYFINISHED ));
+}
+
+//*****************************************************************************
+//
+bool SERVER_CAPTURE_IsReplayFinished( void )
+{
+	return ( g_CaptureState == CAPTURESTATE_REPLAYFINISHED );
+}
+
+//*****************************************************************************
+//
+// Called by G_InitNew right after the random number generators were seeded.
+//
+void SERVER_CAPTURE_NewGame( void )
+{
+	if ( g_CaptureState == CAPTURESTATE_REPLAYING )
+	{
+		if ( g_bReplayGameStarted )
+			return;
+
+		// Continue from the gametic the capture started at, the clients' move
+		// commands refer to it. From now on the seeds are handled like they were
+		// on the recording server.
+		gametic = maketic = g_iReplayGametic;
+		use_staticrng = g_bReplayUseStaticRNG;
+		staticrngseed = g_ReplayStaticRNGSeed;
+		g_bReplayGameStarted = true;
+		return;
+	}
+
+	if ( g_CaptureState != CAPTURESTATE_ARMED )
+		return;
+
+	fwrite( g_CaptureMagic, 1, sizeof( g_CaptureMagic ), g_pCaptureFile );
+	server_capture_WriteLong( CAPTURE_VERSION );
+	server_capture_WriteString( DOTVERSIONSTR );
+
+	// The replaying server needs the same data.
+	const TArray<NetworkPWAD> &PWADs = NETWORK_GetPWADList( );
+	server_capture_WriteString( NETWORK_GetIWAD( ));
+	server_capture_WriteLong( PWADs.Size( ));
+	for ( unsigned int i = 0; i < PWADs.Size( ); ++i )
+	{
+		server_capture_WriteString( PWADs[i].name );
+		server_capture_WriteString( PWADs[i].checksum );
+	}
+
+	server_capture_WriteString( level.mapname );
+	server_capture_WriteLong( gametic );
+	server_capture_WriteLong( rngseed );
+	server_capture_WriteLong( use_staticrng );
+	server_capture_WriteLong( staticrngseed );
+	server_capture_WriteString( C_GetMassCVarString( CVAR_SERVERINFO | CVAR_ARCHIVE ));
+
+	// G_InitNew is called from G_Ticker, so the input of this tic was already processed.
+	fputc( CE_TIC, g_pCaptureFile );
+	server_capture_WriteLong( gametic );
+
+	g_uiCaptureStartTime = I_MSTime( );
+	g_ulNumCapturedTics = 0;
+	g_ulNumCapturedPackets = 0;
+	g_ulNumCapturedBytes = 0;
+	g_CaptureState = CAPTURESTATE_CAPTURING;
+
+	Printf( "Capturing the server session on %s to %s.\n", level.mapname, g_CaptureFileName.GetChars( ));
+}
+
+//*****************************************************************************
+//
+void SERVER_CAPTURE_RecordPacket( const NETADDRESS_s &Address, const BYTE *pbData, ULONG ulSize )
+{
+	if ( g_CaptureState != CAPTURESTATE_CAPTURING )
+		return;
+
+	fputc( CE_PACKET, g_pCaptureFile );
+	server_capture_WriteLong( I_MSTime( ) - g_uiCaptureStartTime );
+	fwrite( Address.abIP, 1, sizeof( Address.abIP ), g_pCaptureFile );
+	fwrite( &Address.usPort, 1, sizeof( Address.usPort ), g_pCaptureFile );
+	server_capture_WriteLong( ulSize );
+	fwrite( pbData, 1, ulSize, g_pCaptureFile );
+
+	g_ulNumCapturedPackets++;
+	g_ulNumCapturedBytes += ulSize;
+}
+
+//*****************************************************************************
+//
+void SERVER_CAPTURE_RecordCommand( const char *pszCommand )
+{
+	if ( g_CaptureState != CAPTURESTATE_CAPTURING )
+		return;
+
+	fputc( CE_COMMAND, g_pCaptureFile );
+	server_capture_WriteString( pszCommand );
+}
+
+//*****************************************************************************
+//
+// Called by SERVER_Tick once the input of the current tic was processed.
+//
+void SERVER_CAPTURE_EndTicInput( void )
+{
+	if ( g_CaptureState != CAPTURESTATE_CAPTURING )
+		return;
+
+	fputc( CE_TIC, g_pCaptureFile );
+	server_capture_WriteLong( gametic );
+	g_ulNumCapturedTics++;
+}
+
+//*****************************************************************************
+//
+// Returns the next packet of the current tic. Console commands on the way are
+// executed right away, just like they were on the recording server.
+//
+bool SERVER_CAPTURE_ReadPacket( NETADDRESS_s &Address, BYTE *pbData, ULONG ulMaxSize, ULONG &ulSize )
+{
+	if ( g_CaptureState != CAPTURESTATE_REPLAYING )
+		return ( false );
+
+	while ( true )
+	{
+		const int entry = fgetc( g_pCaptureFile );
+		DWORD dwValue;
+		FString command;
+
+		switch ( entry )
+		{
+		case CE_TIC:
+
+			if ( server_capture_ReadLong( dwValue ) == false )
+				break;
+
+			// The replay doesn't run the same tics as the recording server did.
+			if ( g_bReplayGameStarted && ( static_cast<int>( dwValue ) != gametic ))
+				g_ulNumDivergedTics++;
+			return ( false );
+		case CE_PACKET:
+
+			if (( server_capture_ReadLong( dwValue ) == false )
+				|| ( fread( Address.abIP, 1, sizeof( Address.abIP ), g_pCaptureFile ) != sizeof( Address.abIP ))
+				|| ( fread( &Address.usPort, 1, sizeof( Address.usPort ), g_pCaptureFile ) != sizeof( Address.usPort ))
+				|| ( server_capture_ReadLong( dwValue ) == false )
+				|| ( dwValue > ulMaxSize )
+				|| ( fread( pbData, 1, dwValue, g_pCaptureFile ) != dwValue ))
+			{
+				break;
+			}
+
+			ulSize = dwValue;
+			g_ulNumReplayedPackets++;
+			return ( true );
+		case CE_COMMAND:
+
+			if ( server_capture_ReadString( command ) == false )
+				break;
+
+			AddCommandString( command.LockBuffer( ));
+			command.UnlockBuffer( );
+			continue;
+		default:
+
+			break;
+		}
+
+		// End of the capture (or garbage).
+		server_capture_FinishReplay( );
+		return ( false );
+	}
+}
+
+//*****************************************************************************
+//
+// Called by SERVER_Tick in replay mode. Returns false if there is no tic to run.
+//
+bool SERVER_CAPTURE_BeginReplayTic( void )
+{
+	if ( g_CaptureState == CAPTURESTATE_REPLAYPENDING )
+	{
+		Printf( "Replaying %s from %s...\n", g_CaptureFileName.GetChars( ), g_ReplayMapName.GetChars( ));
+
+		// Start the map of the capture with the captured seed.
+		use_staticrng = true;
+		staticrngseed = g_ReplayRNGSeed;
+		g_bReplayGameStarted = false;
+		g_ulNumReplayedTics = 0;
+		g_ulNumReplayedPackets = 0;
+		g_ulNumDivergedTics = 0;
+		g_ReplayTime.Reset( );
+
+		FString command;
+		command.Format( "map %s", g_ReplayMapName.GetChars( ));
+		AddCommandString( command.LockBuffer( ));
+		command.UnlockBuffer( );
+
+		g_CaptureState = CAPTURESTATE_REPLAYING;
+	}
+
+	if ( g_CaptureState != CAPTURESTATE_REPLAYING )
+		return ( false );
+
+	g_ulNumReplayedTics++;
+	return ( true );
+}
+
+//*****************************************************************************
+//
+// Brackets the time SERVER_Tick spends on a replayed tic.
+//
+void SERVER_CAPTURE_ClockReplay( bool bStart )
+{
+	if ( bStart )
+		g_ReplayTime.Clock( );
+	else
+		g_ReplayTime.Unclock( );
+}
+
+//*****************************************************************************
+//
+static void server_capture_FinishReplay( void )
+{
+	const double totalMS = g_ReplayTime.TimeMS( );
+
+	Printf( "Replayed %lu tics (%lu packets) in %.3f s: %.3f ms per tic, %.0f tics per second.\n",
+		g_ulNumReplayedTics, g_ulNumReplayedPackets, totalMS / 1000,
+		g_ulNumReplayedTics ? totalMS / g_ulNumReplayedTics : 0.0,
+		totalMS > 0 ? g_ulNumReplayedTics * 1000 / totalMS : 0.0 );
+
+	if ( g_ulNumDivergedTics )
+		Printf( "Warning: %lu tics didn't line up with the capture, the replay isn't exact.\n", g_ulNumDivergedTics );
+
+	fclose( g_pCaptureFile );
+	g_pCaptureFile = NULL;
+
+	// We're in the middle of parsing packets here, so don't quit right away.
+	g_CaptureState = CAPTURESTATE_REPLAYFINISHED;
+}
+
+//*****************************************************************************
+//
+static void server_capture_Stop( void )
+{
+	Printf( "Captured %lu tics and %lu packets (%lu bytes) to %s.\n", g_ulNumCapturedTics, g_ulNumCapturedPackets, g_ulNumCapturedBytes, g_CaptureFileName.GetChars( ));
+
+	fclose( g_pCaptureFile );
+	g_pCaptureFile = NULL;
+	g_CaptureState = CAPTURESTATE_NONE;
+}
+
+//*****************************************************************************
+//
+static bool server_capture_ReadHeader( void )
+{
+	char magic[4];
+	DWORD dwVersion, dwNumPWADs, dwValue;
+	FString string, checksum;
+
+	if (( fread( magic, 1, sizeof( magic ), g_pCaptureFile ) != sizeof( magic ))
+		|| ( memcmp( magic, g_CaptureMagic, sizeof( magic )) != 0 )
+		|| ( server_capture_ReadLong( dwVersion ) == false ))
+	{
+		return ( false );
+	}
+
+	if ( dwVersion != CAPTURE_VERSION )
+	{
+		Printf( "The capture has version %u, but only version %d is supported.\n", static_cast<unsigned int>( dwVersion ), CAPTURE_VERSION );
+		return ( false );
+	}
+
+	if ( server_capture_ReadString( string ) == false )
+		return ( false );
+	if ( string.Compare( DOTVERSIONSTR ) != 0 )
+		Printf( "Warning: The capture was made with version %s.\n", string.GetChars( ));
+
+	// The replay can only be exact with the same data.
+	if ( server_capture_ReadString( string ) == false )
+		return ( false );
+	if ( string.CompareNoCase( NETWORK_GetIWAD( )) != 0 )
+		Printf( "Warning: The capture was made with IWAD %s.\n", string.GetChars( ));
+
+	const TArray<NetworkPWAD> &PWADs = NETWORK_GetPWADList( );
+	if ( server_capture_ReadLong( dwNumPWADs ) == false )
+		return ( false );
+	if ( dwNumPWADs != PWADs.Size( ))
+		Printf( "Warning: The capture was made with %u PWADs, %u are loaded.\n", static_cast<unsigned int>( dwNumPWADs ), PWADs.Size( ));
+
+	for ( unsigned int i = 0; i < dwNumPWADs; ++i )
+	{
+		if (( server_capture_ReadString( string ) == false ) || ( server_capture_ReadString( checksum ) == false ))
+			return ( false );
+
+		if (( i >= PWADs.Size( )) || ( PWADs[i].checksum.Compare( checksum ) != 0 ))
+			Printf( "Warning: The capture was made with %s (%s), which isn't loaded.\n", string.GetChars( ), checksum.GetChars( ));
+	}
+
+	if (( server_capture_ReadString( g_ReplayMapName ) == false )
+		|| ( server_capture_ReadLong( dwValue ) == false ))
+	{
+		return ( false );
+	}
+	g_iReplayGametic = static_cast<int>( dwValue );
+
+	if (( server_capture_ReadLong( g_ReplayRNGSeed ) == false )
+		|| ( server_capture_ReadLong( dwValue ) == false )
+		|| ( server_capture_ReadLong( g_ReplayStaticRNGSeed ) == false )
+		|| ( server_capture_ReadString( string ) == false ))
+	{
+		return ( false );
+	}
+	g_bReplayUseStaticRNG = !!dwValue;
+
+	// Restore the settings of the recording server.
+	BYTE *pbCVars = reinterpret_cast<BYTE *>( string.LockBuffer( ));
+	C_ReadCVars( &pbCVars );
+	string.UnlockBuffer( );
+
+	return ( true );
+}
+
+//*****************************************************************************
+//
+static void server_capture_WriteLong( DWORD dwValue )
+{
+	const DWORD dwLittle = LittleLong( dwValue );
+	fwrite( &dwLittle, 1, sizeof( dwLittle ), g_pCaptureFile );
+}
+
+//*****************************************************************************
+//
+static void server_capture_WriteString( const char *pszString )
+{
+	fwrite( pszString, 1, strlen( pszString ) + 1, g_pCaptureFile );
+}
+
+//*****************************************************************************
+//
+static bool server_capture_ReadLong( DWORD &dwValue )
+{
+	if ( fread( &dwValue, 1, sizeof( dwValue ), g_pCaptureFile ) != sizeof( dwValue ))
+		return ( false );
+
+	dwValue = LittleLong( dwValue );
+	return ( true );
+}
+
+//*****************************************************************************
+//
+static bool server_capture_ReadString( FString &String )
+{
+	String = "";
+
+	int c;
+	while (( c = fgetc( g_pCaptureFile )) > 0 )
+		String += static_cast<char>( c );
+
+	return ( c == 0 );
+}
+
+//*****************************************************************************
+//
+CCMD( sv_capture )
+{
+	if ( NETWORK_GetState( ) != NETSTATE_SERVER )
+	{
+		Printf( "Only servers can capture their sessions.\n" );
+		return;
+	}
+
+	if ( argv.argc( ) < 2 )
+	{
+		Printf( "Usage: sv_capture <file>\n"
+			"Restarts the map and records the session into <file>, until sv_stopcapture is used.\n"
+			"Replay it with the -replaycapture <file> command line parameter.\n"
+			"Only works while no clients are connected, clients have to join after the capture started.\n" );
+		return;
+	}
+
+	// The capture only contains the packets sent after the map restart. The
+	// connection handshake of clients that are already in the game isn't part
+	// of it, so the replay would drop all their packets.
+	if ( SERVER_CalcNumConnectedClients( ) > 0 )
+	{
+		Printf( "Can't capture while clients are connected, they would be missing from the replay.\n" );
+		return;
+	}
+
+	if ( g_CaptureState != CAPTURESTATE_NONE )
+	{
+		Printf( "The server is already capturing or replaying.\n" );
+		return;
+	}
+
+	g_CaptureFileName = argv[1];
+	DefaultExtension( g_CaptureFileName, ".zcap" );
+
+	g_pCaptureFile = fopen( g_CaptureFileName, "wb" );
+	if ( g_pCaptureFile == NULL )
+	{
+		Printf( "Couldn't open %s for writing: %s\n", g_CaptureFileName.GetChars( ), strerror( errno ));
+		return;
+	}
+
+	// Packets arrive in small bits, so use a big buffer.
+	setvbuf( g_pCaptureFile, NULL, _IOFBF, 1 << 20 );
+	g_CaptureState = CAPTURESTATE_ARMED;
+
+	// The capture needs a well defined starting point.
+	FString command;
+	command.Format( "map %s", level.mapname );
+	AddCommandString( command.LockBuffer( ));
+	command.UnlockBuffer( );
+}
+
+//*****************************************************************************
+//
+CCMD( sv_stopcapture )
+{
+	if ( g_CaptureState == CAPTURESTATE_ARMED )
+	{
+		fclose( g_pCaptureFile );
+		g_pCaptureFile = NULL;
+		g_CaptureState = CAPTURESTATE_NONE;
+		Printf( "Capture aborted.\n" );
+	}
+	else if ( g_CaptureState == CAPTURESTATE_CAPTURING )
+		server_capture_Stop( );
+	else
+		Printf( "The server isn't capturing.\n" );
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: sv_capture.h
+//
+// Description: Records everything a server receives, so that a session can be
+// replayed offline, as fast as possible and without any sockets.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef __SV_CAPTURE_H__
+#define __SV_CAPTURE_H__
+
+#include "network.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// Bump this whenever the layout of capture files changes.
+#define	CAPTURE_VERSION				1
+
+//*****************************************************************************
+// The entries of a capture file, following the header.
+enum CAPTUREENTRY_e
+{
+	// End of the input of a tic, followed by the gametic.
+	CE_TIC,
+
+	// A decoded packet: Arrival time in ms since the capture started, address and data.
+	CE_PACKET,
+
+	// A command from the server console.
+	CE_COMMAND,
+
+	NUM_CAPTUREENTRIES
+};
+
+//*****************************************************************************
+//	PROTOTYPES
+
+void		SERVER_CAPTURE_Construct( void );
+void		SERVER_CAPTURE_Destruct( void );
+bool		SERVER_CAPTURE_IsCapturing( void );
+bool		SERVER_CAPTURE_IsReplaying( void );
+bool		SERVER_CAPTURE_IsReplayFinished( void );
+void		SERVER_CAPTURE_NewGame( void );
+void		SERVER_CAPTURE_RecordPacket( const NETADDRESS_s &Address, const BYTE *pbData, ULONG ulSize );
+void		SERVER_CAPTURE_RecordCommand( const char *pszCommand );
+void		SERVER_CAPTURE_EndTicInput( void );
+bool		SERVER_CAPTURE_ReadPacket( NETADDRESS_s &Address, BYTE *pbData, ULONG ulMaxSize, ULONG &ulSize );
+bool		SERVER_CAPTURE_BeginReplayTic( void );
+void		SERVER_CAPTURE_ClockReplay( bool bStart );
+
+#endif	// __SV_CAPTURE_H__
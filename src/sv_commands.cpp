@@ -66,6 +66,9 @@
 #include "sbar.h"
 #include "sv_commands.h"
 #include "sv_main.h"
+#include "sv_actorsnapshot.h"
+#include "sv_packetscheduler.h"
+#include "s_sound.h"
 #include "team.h"
 #include "survival.h"
 #include "vectors.h"
@@ -82,6 +85,8 @@
 #include "decallib.h"
 #include "network/netcommand.h"
 #include "network/servercommands.h"
+#include "stats.h"
+#include "c_dispatch.h"
 
 CVAR (Bool, sv_showwarnings, false, CVAR_GLOBALCONFIG|CVAR_ARCHIVE)
 
@@ -138,6 +143,16 @@ void RemoveUnnecessaryPositionUpdateFlags( AActor *pActor, ULONG &ulBits )
 		ulBits  &= ~CM_MOVEDIR;
 }
 
+//*****************************************************************************
+//
+// Actors that are replicated through snapshots get their movement from there,
+// so broadcasts only need to contain what the snapshots don't cover.
+void RemoveActorSnapshotFlags( AActor *pActor, ULONG &ulBits )
+{
+	if ( SERVER_ACTORSNAPSHOT_IsReplicated( pActor ))
+		ulBits &= ~( ACTORSNAPSHOT_FIELDS|CM_LAST_X|CM_LAST_Y|CM_LAST_Z );
+}
+
 //*****************************************************************************
 //
 // [BB] Mark the actor as updated according to ulBits.
@@ -1371,7 +1386,10 @@ void SERVERCOMMANDS_MoveThing( AActor *actor, ULONG bits, ULONG ulPlayerExtra, S
 
 	// [BB] Only skip updates, if sent to all players.
 	if ( flags == 0 )
+	{
+		RemoveActorSnapshotFlags ( actor, bits );
 		RemoveUnnecessaryPositionUpdateFlags ( actor, bits );
+	}
 	else // [WS] This will inform clients not to set their lastX/Y/Z with the new position.
 		bits |= CM_NOLAST;
 
@@ -2020,6 +2038,18 @@ void SERVERCOMMANDS_SpawnBloodSplatter( fixed_t x, fixed_t y, fixed_t z, AActor
 	}
 }
 
+//*****************************************************************************
+// [Zandronum] Puffs and sounds only matter at the moment they happen. With the
+// packet scheduler enabled they are sent unreliably, so that they are
+// scheduled as cosmetic commands and are the first to go when the client's
+// budget is short, instead of using it up through the reliable stream.
+//
+static void servercommands_SendCosmeticCommand( NetCommand &command, ULONG ulPlayerExtra, ServerCommandFlags flags )
+{
+	command.setUnreliable( SERVER_PACKETSCHEDULER_IsEnabled( ));
+	command.sendCommandToClients( ulPlayerExtra, flags );
+}
+
 //*****************************************************************************
 // SpawnPuff is essentially SpawnThing that is treated a bit differently
 // by the client. It differs a lot from SpawnPuffNoNetID.
@@ -2069,7 +2099,9 @@ void SERVERCOMMANDS_SpawnPuffNoNetID( AActor *pActor, ULONG ulState, bool bSendT
 	command.SetStateid( ulState );
 	command.SetReceiveTranslation( !!bSendTranslation );
 	command.SetTranslation( pActor->Translation );
-	command.sendCommandToClients( ulPlayerExtra, flags );
+
+	NetCommand netCommand = command.BuildNetCommand( );
+	servercommands_SendCosmeticCommand( netCommand, ulPlayerExtra, flags );
 }
 
 //*****************************************************************************
@@ -3339,7 +3371,16 @@ void SERVERCOMMANDS_SoundActor( AActor *pActor, LONG lChannel, const char *pszSo
 	command.SetSound( pszSound );
 	command.SetVolume( LONG ( clamp( fVolume, 0.0f, 2.0f ) * 127 ) );
 	command.SetAttenuation( NETWORK_AttenuationFloatToInt ( fAttenuation ));
-	command.sendCommandToClients( ulPlayerExtra, flags );
+
+	// [Zandronum] A looping sound plays until it's stopped, so it must arrive.
+	if ( lChannel & CHAN_LOOP )
+	{
+		command.sendCommandToClients( ulPlayerExtra, flags );
+		return;
+	}
+
+	NetCommand netCommand = command.BuildNetCommand( );
+	servercommands_SendCosmeticCommand( netCommand, ulPlayerExtra, flags );
 }
 
 //*****************************************************************************
@@ -3370,7 +3411,9 @@ void SERVERCOMMANDS_SoundPoint( LONG lX, LONG lY, LONG lZ, LONG lChannel, const
 	command.SetSound( pszSound );
 	command.SetVolume( LONG ( clamp( fVolume, 0.0f, 2.0f ) * 127 ) );
 	command.SetAttenuation( NETWORK_AttenuationFloatToInt ( fAttenuation ) );
-	command.sendCommandToClients ( ulPlayerExtra, flags );
+
+	NetCommand netCommand = command.BuildNetCommand( );
+	servercommands_SendCosmeticCommand( netCommand, ulPlayerExtra, flags );
 }
 
 //*****************************************************************************
@@ -4945,3 +4988,65 @@ void APathFollower::SyncWithClient ( const ULONG ulClient )
 	command.addFloat( this->Time );
 	command.sendCommandToOneClient( ulClient );
 }
+
+//*****************************************************************************
+//
+// Measures how long it takes to build server commands, with and without the
+// pooled packet buffers. The commands are addressed to no client, so nothing
+// is actually sent. Only commands that don't depend on the players or teams in
+// the game are used, so that every iteration really builds one.
+//
+CCMD( bench_servercommands )
+{
+	const ULONG	ulNumTics = ( argv.argc( ) > 1 ) ? MAX( atoi( argv[1] ), 1 ) : TICRATE;
+	const ULONG	ulCommandsPerTic = ( argv.argc( ) > 2 ) ? MAX( atoi( argv[2] ), 1 ) : 10000;
+
+	if ( NETWORK_GetState( ) != NETSTATE_SERVER )
+	{
+		Printf( "bench_servercommands can only be used by the server.\n" );
+		return;
+	}
+
+	for ( int pass = 0; pass < 2; pass++ )
+	{
+		const bool	bPooled = ( pass == 1 );
+		cycle_t		time;
+		ULONG		ulReused;
+		ULONG		ulAllocated;
+		ULONG		ulOldReused;
+		ULONG		ulOldAllocated;
+
+		NETWORK_SetPacketBufferPooling( bPooled );
+		NETWORK_GetPacketBufferPoolStats( ulOldReused, ulOldAllocated );
+		time.Reset( );
+
+		for ( ULONG ulTic = 0; ulTic < ulNumTics; ulTic++ )
+		{
+			time.Clock( );
+			for ( ULONG ulIdx = 0; ulIdx < ulCommandsPerTic; ulIdx++ )
+			{
+				switch ( ulIdx % 3 )
+				{
+				case 0:
+
+					SERVERCOMMANDS_SetMapTime( MAXPLAYERS, SVCF_ONLYTHISCLIENT );
+					break;
+				case 1:
+
+					SERVERCOMMANDS_SetGameModeLimits( MAXPLAYERS, SVCF_ONLYTHISCLIENT );
+					break;
+				default:
+
+					SERVERCOMMANDS_Print( "bench_servercommands\n", PRINT_HIGH, MAXPLAYERS, SVCF_ONLYTHISCLIENT );
+					break;
+				}
+			}
+			time.Unclock( );
+		}
+
+		NETWORK_GetPacketBufferPoolStats( ulReused, ulAllocated );
+		Printf( "%s: %.3f ms per tic for %lu commands (%lu buffers reused, %lu allocated)\n",
+			bPooled ? "Pooled buffers" : "Allocated buffers", time.TimeMS( ) / ulNumTics, ulCommandsPerTic,
+			ulReused - ulOldReused, ulAllocated - ulOldAllocated );
+	}
+}
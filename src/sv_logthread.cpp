@@ -0,0 +1,409 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Description: Writes the logfile and the console output of the server on a
+// thread of its own.
+//
+// Without the log thread, every Printf on the server writes the line to the
+// logfile and flushes it right away, and the console output is flushed every
+// tic, so a mod that prints a lot costs the game thread the time these writes
+// take. With -logthread, the game thread only copies the text into a ring
+// buffer and the log thread writes it out. The log thread wakes up every
+// LOGTHREAD_FLUSH_MS or as soon as LOGTHREAD_FLUSH_SIZE bytes are waiting,
+// collects everything that was queued for the same file and writes each file
+// with a single fwrite and fflush.
+//
+// The ring has exactly one producer (the game thread) and one consumer (the
+// log thread), so it gets along without locks. The text is put together,
+// including the timestamps, on the game thread, the log thread only writes
+// it. Text printed by any other thread is written directly, since it can't
+// use the ring. If the ring is full, the game thread waits for the log thread
+// to make room, so nothing is lost. SERVER_LOGTHREAD_Flush waits until
+// everything queued so far is written, e.g. before the logfile is closed.
+//
+//-----------------------------------------------------------------------------
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <string.h>
+#include "sv_logthread.h"
+#include "c_dispatch.h"
+#include "i_system.h"
+#include "stats.h"
+#include "templates.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// The size of the ring buffer in bytes. Must be a power of two.
+#define	LOGTHREAD_RING_SIZE			( 1 << 20 )
+
+// The log thread writes out what is queued at least this often...
+#define	LOGTHREAD_FLUSH_MS			100
+
+// ...or as soon as this many bytes are waiting.
+#define	LOGTHREAD_FLUSH_SIZE		( 16 << 10 )
+
+// The files the log thread writes to in a single batch.
+#define	LOGTHREAD_MAX_FILES			4
+
+//*****************************************************************************
+//	STRUCTURES
+
+// Each piece of text in the ring is preceded by this header.
+struct LOGTHREADRECORD_s
+{
+	FILE			*pFile;
+	unsigned int	ulLength;
+};
+
+struct LOGTHREADBATCH_s
+{
+	FILE			*pFile;
+	std::string		Text;
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+static	std::thread						g_Thread;
+static	std::atomic<bool>				g_bRunning( false );
+static	std::thread::id					g_GameThreadID;
+
+static	char							*g_pcRing = NULL;
+
+// Both only ever increase, the position in the ring is the value modulo
+// LOGTHREAD_RING_SIZE. The game thread moves the tail, the log thread the head
+// once the text has been written and flushed.
+static	std::atomic<unsigned int>		g_ulHead( 0 );
+static	std::atomic<unsigned int>		g_ulTail( 0 );
+
+// Wakes up the log thread early, see SERVER_LOGTHREAD_Write and
+// SERVER_LOGTHREAD_Flush.
+static	std::mutex						g_WakeMutex;
+static	std::condition_variable			g_WakeCondition;
+static	bool							g_bWakeRequested = false;
+
+// Signaled by the log thread after each batch.
+static	std::condition_variable			g_WrittenCondition;
+
+// Only used by the game thread.
+static	unsigned int					g_ulLastWakeTail = 0;
+
+// Only used by the log thread.
+static	LOGTHREADBATCH_s				g_Batches[LOGTHREAD_MAX_FILES];
+
+// Statistics for "stat logthread".
+static	std::atomic<ULONG>				g_ulBytesWritten( 0 );
+static	std::atomic<ULONG>				g_ulBatchesWritten( 0 );
+static	std::atomic<ULONG>				g_ulRingFullWaits( 0 );
+static	std::atomic<ULONG>				g_ulDirectWrites( 0 );
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	void		server_logthread_Run( void );
+static	void		server_logthread_WakeUp( void );
+static	void		server_logthread_CopyToRing( unsigned int ulPosition, const void *pData, unsigned int ulSize );
+static	void		server_logthread_CopyFromRing( unsigned int ulPosition, void *pData, unsigned int ulSize );
+
+//*****************************************************************************
+//	FUNCTIONS
+
+void SERVER_LOGTHREAD_Start( void )
+{
+	if ( g_bRunning )
+		return;
+
+	g_pcRing = new char[LOGTHREAD_RING_SIZE];
+	g_ulHead = g_ulTail = g_ulLastWakeTail = 0;
+	g_GameThreadID = std::this_thread::get_id( );
+
+	g_bRunning = true;
+	g_Thread = std::thread( server_logthread_Run );
+	atterm( SERVER_LOGTHREAD_Stop );
+
+	Printf( "Writing the log on a separate thread.\n" );
+}
+
+//*****************************************************************************
+//
+void SERVER_LOGTHREAD_Stop( void )
+{
+	if ( g_bRunning == false )
+		return;
+
+	// The log thread writes out whatever is left before it returns.
+	{
+		std::lock_guard<std::mutex> lock( g_WakeMutex );
+		g_bRunning = false;
+	}
+	g_WakeCondition.notify_one( );
+	g_Thread.join( );
+
+	delete[] g_pcRing;
+	g_pcRing = NULL;
+}
+
+//*****************************************************************************
+//
+bool SERVER_LOGTHREAD_IsRunning( void )
+{
+	return ( g_bRunning );
+}
+
+//*****************************************************************************
+//
+// Queues the text to be written to the file. Returns false if the log thread
+// isn't running, in which case the caller has to write the text itself. Text
+// from threads other than the game thread is written and flushed right away.
+//
+bool SERVER_LOGTHREAD_Write( FILE *pFile, const char *pszText )
+{
+	if (( g_bRunning == false ) || ( pFile == NULL ))
+		return ( false );
+
+	if ( std::this_thread::get_id( ) != g_GameThreadID )
+	{
+		g_ulDirectWrites++;
+		fputs( pszText, pFile );
+		fflush( pFile );
+		return ( true );
+	}
+
+	LOGTHREADRECORD_s	Record;
+	Record.pFile = pFile;
+	Record.ulLength = static_cast<unsigned int>( strlen( pszText ));
+
+	if ( Record.ulLength == 0 )
+		return ( true );
+
+	const unsigned int	ulRecordSize = sizeof( Record ) + Record.ulLength;
+
+	// Text that doesn't comfortably fit into the ring is written directly once
+	// everything before it has been written.
+	if ( ulRecordSize > LOGTHREAD_RING_SIZE / 4 )
+	{
+		SERVER_LOGTHREAD_Flush( );
+		g_ulDirectWrites++;
+		fputs( pszText, pFile );
+		fflush( pFile );
+		return ( true );
+	}
+
+	const unsigned int	ulTail = g_ulTail.load( std::memory_order_relaxed );
+
+	if ( ulTail + ulRecordSize - g_ulHead.load( std::memory_order_acquire ) > LOGTHREAD_RING_SIZE )
+	{
+		g_ulRingFullWaits++;
+		do
+		{
+			server_logthread_WakeUp( );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ));
+		} while ( ulTail + ulRecordSize - g_ulHead.load( std::memory_order_acquire ) > LOGTHREAD_RING_SIZE );
+	}
+
+	server_logthread_CopyToRing( ulTail, &Record, sizeof( Record ));
+	server_logthread_CopyToRing( ulTail + sizeof( Record ), pszText, Record.ulLength );
+	g_ulTail.store( ulTail + ulRecordSize, std::memory_order_release );
+
+	if ( ulTail + ulRecordSize - g_ulLastWakeTail >= LOGTHREAD_FLUSH_SIZE )
+		server_logthread_WakeUp( );
+
+	return ( true );
+}
+
+//*****************************************************************************
+//
+// Waits until everything that was queued so far is written and flushed.
+//
+void SERVER_LOGTHREAD_Flush( void )
+{
+	if (( g_bRunning == false ) || ( std::this_thread::get_id( ) != g_GameThreadID ))
+		return;
+
+	const unsigned int	ulTail = g_ulTail.load( std::memory_order_relaxed );
+
+	if ( g_ulHead.load( std::memory_order_acquire ) == ulTail )
+		return;
+
+	server_logthread_WakeUp( );
+
+	std::unique_lock<std::mutex> lock( g_WakeMutex );
+	g_WrittenCondition.wait( lock, [ulTail] { return ( static_cast<int>( g_ulHead.load( std::memory_order_acquire ) - ulTail ) >= 0 ); } );
+}
+
+//*****************************************************************************
+//
+static void server_logthread_WakeUp( void )
+{
+	g_ulLastWakeTail = g_ulTail.load( std::memory_order_relaxed );
+
+	{
+		std::lock_guard<std::mutex> lock( g_WakeMutex );
+		g_bWakeRequested = true;
+	}
+	g_WakeCondition.notify_one( );
+}
+
+//*****************************************************************************
+//
+static void server_logthread_CopyToRing( unsigned int ulPosition, const void *pData, unsigned int ulSize )
+{
+	const unsigned int	ulOffset = ulPosition & ( LOGTHREAD_RING_SIZE - 1 );
+	const unsigned int	ulFirst = MIN<unsigned int>( ulSize, LOGTHREAD_RING_SIZE - ulOffset );
+
+	memcpy( g_pcRing + ulOffset, pData, ulFirst );
+	memcpy( g_pcRing, static_cast<const char *>( pData ) + ulFirst, ulSize - ulFirst );
+}
+
+//*****************************************************************************
+//
+static void server_logthread_CopyFromRing( unsigned int ulPosition, void *pData, unsigned int ulSize )
+{
+	const unsigned int	ulOffset = ulPosition & ( LOGTHREAD_RING_SIZE - 1 );
+	const unsigned int	ulFirst = MIN<unsigned int>( ulSize, LOGTHREAD_RING_SIZE - ulOffset );
+
+	memcpy( pData, g_pcRing + ulOffset, ulFirst );
+	memcpy( static_cast<char *>( pData ) + ulFirst, g_pcRing, ulSize - ulFirst );
+}
+
+//*****************************************************************************
+//
+static void server_logthread_Run( void )
+{
+	bool bStop = false;
+
+	while ( bStop == false )
+	{
+		{
+			std::unique_lock<std::mutex> lock( g_WakeMutex );
+			g_WakeCondition.wait_for( lock, std::chrono::milliseconds( LOGTHREAD_FLUSH_MS ), [] { return ( g_bWakeRequested || ( g_bRunning == false )); } );
+			g_bWakeRequested = false;
+			bStop = ( g_bRunning == false );
+		}
+
+		const unsigned int	ulHead = g_ulHead.load( std::memory_order_relaxed );
+		const unsigned int	ulTail = g_ulTail.load( std::memory_order_acquire );
+
+		if ( ulHead == ulTail )
+			continue;
+
+		// Sort the queued text by file, keeping the order within each file.
+		ULONG ulNumBatches = 0;
+
+		for ( unsigned int ulPosition = ulHead; ulPosition != ulTail; )
+		{
+			LOGTHREADRECORD_s	Record;
+			ULONG				ulBatch;
+
+			server_logthread_CopyFromRing( ulPosition, &Record, sizeof( Record ));
+			ulPosition += sizeof( Record );
+
+			for ( ulBatch = 0; ulBatch < ulNumBatches; ulBatch++ )
+			{
+				if ( g_Batches[ulBatch].pFile == Record.pFile )
+					break;
+			}
+
+			// Too many different files, write the oldest batch to make room.
+			if ( ulBatch == LOGTHREAD_MAX_FILES )
+			{
+				fwrite( g_Batches[0].Text.data( ), 1, g_Batches[0].Text.size( ), g_Batches[0].pFile );
+				fflush( g_Batches[0].pFile );
+				g_Batches[0].Text.clear( );
+				g_Batches[0].pFile = Record.pFile;
+				ulBatch = 0;
+			}
+			else if ( ulBatch == ulNumBatches )
+			{
+				g_Batches[ulBatch].pFile = Record.pFile;
+				ulNumBatches++;
+			}
+
+			std::string			&Text = g_Batches[ulBatch].Text;
+			const size_t		Length = Text.size( );
+
+			Text.resize( Length + Record.ulLength );
+			server_logthread_CopyFromRing( ulPosition, &Text[Length], Record.ulLength );
+			ulPosition += Record.ulLength;
+		}
+
+		for ( ULONG ulBatch = 0; ulBatch < ulNumBatches; ulBatch++ )
+		{
+			std::string &Text = g_Batches[ulBatch].Text;
+
+			fwrite( Text.data( ), 1, Text.size( ), g_Batches[ulBatch].pFile );
+			fflush( g_Batches[ulBatch].pFile );
+			g_ulBytesWritten += static_cast<ULONG>( Text.size( ));
+			Text.clear( );
+		}
+
+		g_ulBatchesWritten++;
+
+		// The game thread may only reuse the space and close the files once
+		// the text is written.
+		{
+			std::lock_guard<std::mutex> lock( g_WakeMutex );
+			g_ulHead.store( ulTail, std::memory_order_release );
+		}
+		g_WrittenCondition.notify_all( );
+	}
+}
+
+//*****************************************************************************
+//	STATISTICS
+
+ADD_STAT( logthread )
+{
+	FString	out;
+
+	if ( g_bRunning == false )
+		return ( "The log thread is not running." );
+
+	out.Format( "%u bytes queued, %lu bytes written in %lu batches, %lu waits for a full ring, %lu direct writes",
+		g_ulTail.load( ) - g_ulHead.load( ), g_ulBytesWritten.load( ), g_ulBatchesWritten.load( ), g_ulRingFullWaits.load( ), g_ulDirectWrites.load( ));
+	return ( out );
+}
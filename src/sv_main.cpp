@@ -110,6 +110,11 @@
 #include "sv_commands.h"
 #include "sv_save.h"
 #include "sv_rcon.h"
+#include "sv_capture.h"
+#include "sv_actorsnapshot.h"
+#include "sv_packetscheduler.h"
+#include "sv_logthread.h"
+#include "sv_netthread.h"
 #include "gamemode.h"
 #include "domination.h"
 #include "a_movingcamera.h"
@@ -118,6 +123,8 @@
 #include "po_man.h"
 #include "network/cl_auth.h"
 #include "network/sv_auth.h"
+#include "network/netcompression.h"
+#include "network/servercommands.h"
 #include "r_data/colormaps.h"
 #include "network_enums.h"
 #include "d_protocol.h"
@@ -138,11 +145,17 @@ void SERVERCONSOLE_ReListPlayers( void );
 
 EXTERN_CVAR( Bool, sv_cheats );
 EXTERN_CVAR( Bool, sv_showwarnings );
+EXTERN_CVAR( Bool, sv_netcompression );
 EXTERN_CVAR( Bool, sv_unlagged_debugactors )
 
 //*****************************************************************************
 //	PROTOTYPES
 
+static	void	server_RunTic( int &iOldTime );
+static	void	server_KickOverMovingClients( void );
+#ifdef _DEBUG
+static	void	server_CheckPlayerLists( void );
+#endif
 static	bool	server_StartChat( BYTESTREAM_s *pByteStream );
 static	bool	server_EndChat( BYTESTREAM_s *pByteStream );
 static	bool	server_Ignore( BYTESTREAM_s *pByteStream );
@@ -151,6 +164,9 @@ static	bool	server_ClientMove( BYTESTREAM_s *pByteStream );
 static	bool	server_MissingPacket( BYTESTREAM_s *pByteStream );
 static	bool	server_UpdateClientPing( BYTESTREAM_s *pByteStream );
 static	bool	server_WeaponSelect( BYTESTREAM_s *pByteStream );
+static	void	server_ReadClientMove( BYTESTREAM_s *pByteStream, CLIENT_MOVE_COMMAND_s &moveCmd );
+static	bool	server_ProcessClientMove( const ULONG ulClient, const CLIENT_MOVE_COMMAND_s &moveCmd );
+static	bool	server_ProcessWeaponSelect( const ULONG ulClient, const USHORT usActorNetworkIndex );
 static	bool	server_Taunt( BYTESTREAM_s *pByteStream );
 static	bool	server_Spectate( BYTESTREAM_s *pByteStream );
 static	bool	server_RequestJoin( BYTESTREAM_s *pByteStream );
@@ -190,6 +206,12 @@ static  void	server_LogPacket( BYTESTREAM_s *pByteStream, NETADDRESS_s Address,
 // Global array of clients.
 static	CLIENT_s		g_aClients[MAXPLAYERS];
 
+// Dense lists of the valid clients, the players in the game (bots included) and
+// the spectators. These are rebuilt by SERVER_UpdatePlayerLists.
+static	PLAYERLIST_s	g_ClientList;
+static	PLAYERLIST_s	g_InGamePlayerList;
+static	PLAYERLIST_s	g_SpectatorList;
+
 // The last client we received a packet from.
 static	LONG			g_lCurrentClient;
 
@@ -433,6 +455,7 @@ void SERVER_Construct( void )
 	// Initizlize the playeringame array (is this necessary?).
 	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ++ulIdx )
 		playeringame[ulIdx] = false;
+	SERVER_UpdatePlayerLists( );
 
 	// Initialize clients.
 	g_ulMaxPacketSize = sv_maxpacketsize;
@@ -510,6 +533,16 @@ void SERVER_Construct( void )
 	SERVER_MASTER_Construct( );
 	SERVER_SAVE_Construct( );
 	SERVER_RCON_Construct( );
+	SERVER_CAPTURE_Construct( );
+
+	// Receive the packets on a separate thread. A replayed capture provides
+	// the packets itself.
+	if ( Args->CheckParm( "-netthread" ) && ( SERVER_CAPTURE_IsReplaying( ) == false ))
+		SERVER_NETTHREAD_Start( );
+
+	// Write the logfile and the console output on a separate thread.
+	if ( Args->CheckParm( "-logthread" ))
+		SERVER_LOGTHREAD_Start( );
 
 	for (int i = 0; i < MAXPLAYERS; i++)
 	{
@@ -549,189 +582,221 @@ void SERVER_Destruct( void )
 //DWORD	g_LastMS, g_LastSec, g_FrameCount, g_LastCount, g_LastTic;
 
 void			SERVERCONSOLE_UpdateStatistics( void );
+void			SERVERCONSOLE_UpdateScoreboard( void );
 
 //*****************************************************************************
 //
-void SERVERCONSOLE_UpdateScoreboard( void );
-void SERVER_Tick( void )
+// Runs a single server tic.
+//
+static void server_RunTic( int &iOldTime )
 {
-	LONG			lNowTime;
-	LONG			lNewTics;
-	LONG			lPreviousTics;
-	LONG			lCurTics;
-	ULONG			ulIdx;
-
-	I_DoSelect();
-	lPreviousTics = static_cast<LONG> ( g_lGameTime / (( 1.0 / TICRATE ) * 1000.0 ) );
-
-	lNowTime = I_MSTime( );
-	lNewTics = static_cast<LONG> ( lNowTime / (( 1.0 / TICRATE ) * 1000.0 ) );
+	ULONG	ulIdx;
 
-	lCurTics = lNewTics - lPreviousTics;
-	while ( lCurTics <= 0 )
-	{
-		// [BB] Recieve packets whenever possible (not only once each tic) to allow
-		// for an accurate ping measurement.
-		SERVER_GetPackets( );
+	//DObject::BeginFrame ();
 
-		I_Sleep( 1 );
-		lNowTime = I_MSTime( );
-		lNewTics = static_cast<LONG> ( lNowTime / (( 1.0 / TICRATE ) * 1000.0 ) );
-		lCurTics = lNewTics - lPreviousTics;
-	}
+	// Recieve packets.
+	SERVER_GetPackets( );
+	SERVER_CAPTURE_EndTicInput( );
 
-#ifdef NO_SERVER_GUI
-	// console input
-	char *cmd = I_ConsoleInput();
-	if (cmd)
-		AddCommandString (cmd);
-	fflush(stdout);
-#else
-	// Execute any commands that have been issued through server menus.
-	while ( g_ServerCommandQueue.Size( ))
-		SERVER_DeleteCommand( );
+#ifdef _DEBUG
+	server_CheckPlayerLists( );
 #endif
-	
-	int iOldTime = level.time;
-	while ( lCurTics-- )
-	{
-		//DObject::BeginFrame ();
 
-		// Recieve packets.
-		SERVER_GetPackets( );
+	// We have to record player positions before their mobj moves.
+	// [BB] Tick the unlagged module.
+	UNLAGGED_Tick( );
 
-		// We have to record player positions before their mobj moves.
-		// [BB] Tick the unlagged module.
-		UNLAGGED_Tick( );
+	G_Ticker ();
 
-		G_Ticker ();
+	// However we need to spawn the unlagged debug actors here i.e. after having processed their
+	// movement commands which updated their last server gametic.
+	// [BB] Spawn debug actors if the server runner wants them.
+	if ( sv_unlagged_debugactors )
+		UNLAGGED_SpawnDebugActors( );
 
-		// However we need to spawn the unlagged debug actors here i.e. after having processed their
-		// movement commands which updated their last server gametic.
-		// [BB] Spawn debug actors if the server runner wants them.
-		if ( sv_unlagged_debugactors )
-			UNLAGGED_SpawnDebugActors( );
+	gametic++;
+	maketic++;
 
-		gametic++;
-		maketic++;
+	// Update the scoreboard if we have a new second to display.
+	if ( timelimit && (( level.time % TICRATE ) == 0 ) && ( level.time != iOldTime ))
+	{
+		SERVERCONSOLE_UpdateScoreboard( );
+		iOldTime = level.time;
+	}
 
-		// Update the scoreboard if we have a new second to display.
-		if ( timelimit && (( level.time % TICRATE ) == 0 ) && ( level.time != iOldTime ))
+	if ( g_lMapRestartTimer > 0 )
+	{
+		if ( --g_lMapRestartTimer == 0 )
 		{
-			SERVERCONSOLE_UpdateScoreboard( );
-			iOldTime = level.time;
-		}
+			FString string;
 
-		if ( g_lMapRestartTimer > 0 )
-		{
-			if ( --g_lMapRestartTimer == 0 )
+			if ( GAMEMODE_IsNextMapCvarLobby( ) )
 			{
-				FString string;
-
-				if ( GAMEMODE_IsNextMapCvarLobby( ) )
-				{
-					// [AM] If we're using a lobby map, reset to the lobby.
-					//      In theory, there can be many MAPINFO-lobbies, but there is only
-					//      one lobby cvar setting, so we only need to bother with the cvar.
-					string.Format( "map %s", *lobby );
-				}
-				else
-				{
-					string.Format( "map %s", level.mapname );
-				}
-
-				AddCommandString( string.LockBuffer() );
-				string.UnlockBuffer();
+				// [AM] If we're using a lobby map, reset to the lobby.
+				//      In theory, there can be many MAPINFO-lobbies, but there is only
+				//      one lobby cvar setting, so we only need to bother with the cvar.
+				string.Format( "map %s", *lobby );
 			}
+			else
+			{
+				string.Format( "map %s", level.mapname );
+			}
+
+			AddCommandString( string.LockBuffer() );
+			string.UnlockBuffer();
 		}
+	}
 
-		// Drop anyone who's been disconnected.
-		SERVER_CheckTimeouts( );
+	// Drop anyone who's been disconnected.
+	SERVER_CheckTimeouts( );
 
-		// Send out player's true position, etc.
-		SERVER_WriteCommands( );
+	// Send out player's true position, etc.
+	SERVER_WriteCommands( );
 
-		// Check everyone's PacketBuffer for anything that needs to be sent.
-		SERVER_SendOutPackets( );
+	// Check everyone's PacketBuffer for anything that needs to be sent.
+	SERVER_SendOutPackets( );
 
-		// [BB] Send out sheduled packets, respecting sv_maxpacketspertick.
-		for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
-		{
-			if ( g_aClients[ulIdx].State == CLS_FREE )
-				continue;
+	// [BB] Send out sheduled packets, respecting sv_maxpacketspertick.
+	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	{
+		if ( g_aClients[ulIdx].State == CLS_FREE )
+			continue;
 
-			SERVER_GetClient ( ulIdx )->SavedPackets.Tick ( );
-		}
+		SERVER_GetClient ( ulIdx )->SavedPackets.Tick ( );
+	}
 
-		// Potentially send an update to the master server.
-		SERVER_MASTER_Tick( );
+	// Potentially send an update to the master server.
+	SERVER_MASTER_Tick( );
 
-		// Time out any old RCON sessions.
-		SERVER_RCON_Tick( );
+	// Time out any old RCON sessions.
+	SERVER_RCON_Tick( );
 
-		// Broadcast the server signal so it can be detected on a LAN.
-		SERVER_MASTER_Broadcast( );
+	// Broadcast the server signal so it can be detected on a LAN.
+	SERVER_MASTER_Broadcast( );
 
-		// Potentially re-parse the banfile.
-		SERVERBAN_Tick( );
+	// Potentially re-parse the banfile.
+	SERVERBAN_Tick( );
 
-		// Print stats and get out.
-		FStat::PrintStat( );
+	// Print stats and get out.
+	FStat::PrintStat( );
 
+	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	{
+		if (( SERVER_IsValidClient( ulIdx ) == false ) || ( players[ulIdx].bSpectating ))
+			continue;
+
+		if ( g_aClients[ulIdx].lLastMoveTick != gametic && g_aClients[ulIdx].lOverMovementLevel > -MAX_OVERMOVEMENT_LEVEL )
+		{
+			g_aClients[ulIdx].lOverMovementLevel--;
+//					Printf( "%s: -- (%d)\n", players[ulIdx].userinfo.GetName(), g_aClients[ulIdx].lOverMovementLevel );
+		}
+
+		// [BB] If the client didn't authenticate the new map by now, likely his authentication packet was lost.
+		// Ask him to authenticate again.
+		if ( ( SERVER_GetClient( ulIdx )->State == CLS_SPAWNED_BUT_NEEDS_AUTHENTICATION ) && ( ( level.maptime % ( 2 * TICRATE ) ) == 0 ) )
+			SERVERCOMMANDS_MapAuthenticate ( level.mapname, ulIdx, SVCF_ONLYTHISCLIENT );
+	}
+
+	// Do some statistic stuff every second.
+	if (( gametic % TICRATE ) == 0 )
+	{
+		// Increase the number of seconds the server has been active.
+		g_lTotalServerSeconds++;
+
+		// Count the number of active players.
+		LONG lCurrentNumPlayers = 0;
 		for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
 		{
-			if (( SERVER_IsValidClient( ulIdx ) == false ) || ( players[ulIdx].bSpectating ))
+			if ( SERVER_IsValidClient( ulIdx ) == false )
 				continue;
 
-			if ( g_aClients[ulIdx].lLastMoveTick != gametic && g_aClients[ulIdx].lOverMovementLevel > -MAX_OVERMOVEMENT_LEVEL )
-			{
-				g_aClients[ulIdx].lOverMovementLevel--;
-//					Printf( "%s: -- (%d)\n", players[ulIdx].userinfo.GetName(), g_aClients[ulIdx].lOverMovementLevel );
-			}
-
-			// [BB] If the client didn't authenticate the new map by now, likely his authentication packet was lost.
-			// Ask him to authenticate again.
-			if ( ( SERVER_GetClient( ulIdx )->State == CLS_SPAWNED_BUT_NEEDS_AUTHENTICATION ) && ( ( level.maptime % ( 2 * TICRATE ) ) == 0 ) )
-				SERVERCOMMANDS_MapAuthenticate ( level.mapname, ulIdx, SVCF_ONLYTHISCLIENT );
+			g_lTotalNumPlayers++; // Divided by g_lTotalServerSeconds to form an average.
+			lCurrentNumPlayers++;
 		}
 
-		// Do some statistic stuff every second.
-		if (( gametic % TICRATE ) == 0 )
-		{
-			// Increase the number of seconds the server has been active.
-			g_lTotalServerSeconds++;
+		// Check for new peak records!
+		if ( lCurrentNumPlayers > g_lMaxNumPlayers )
+			g_lMaxNumPlayers = lCurrentNumPlayers;
+		if ( g_lCurrentOutboundDataTransfer > g_lMaxOutboundDataTransfer )
+			g_lMaxOutboundDataTransfer = g_lCurrentOutboundDataTransfer;
+		if ( g_lCurrentInboundDataTransfer > g_lMaxInboundDataTransfer )
+			g_lMaxInboundDataTransfer = g_lCurrentInboundDataTransfer;
 
-			// Count the number of active players.
-			LONG lCurrentNumPlayers = 0;
-			for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
-			{
-				if ( SERVER_IsValidClient( ulIdx ) == false )
-					continue;
+		// Update "current" outbound data.
+		g_lOutboundDataTransferLastSecond = g_lCurrentOutboundDataTransfer;
+		g_lCurrentOutboundDataTransfer = 0;
+		g_lInboundDataTransferLastSecond = g_lCurrentInboundDataTransfer;
+		g_lCurrentInboundDataTransfer = 0;
 
-				g_lTotalNumPlayers++; // Divided by g_lTotalServerSeconds to form an average.
-				lCurrentNumPlayers++;
-			}
+		// Update the form.
+		SERVERCONSOLE_UpdateStatistics( );
+	}
 
-			// Check for new peak records!
-			if ( lCurrentNumPlayers > g_lMaxNumPlayers )
-				g_lMaxNumPlayers = lCurrentNumPlayers;
-			if ( g_lCurrentOutboundDataTransfer > g_lMaxOutboundDataTransfer )
-				g_lMaxOutboundDataTransfer = g_lCurrentOutboundDataTransfer;
-			if ( g_lCurrentInboundDataTransfer > g_lMaxInboundDataTransfer )
-				g_lMaxInboundDataTransfer = g_lCurrentInboundDataTransfer;
+	//DObject::EndFrame ();
+}
 
-			// Update "current" outbound data.
-			g_lOutboundDataTransferLastSecond = g_lCurrentOutboundDataTransfer;
-			g_lCurrentOutboundDataTransfer = 0;
-			g_lInboundDataTransferLastSecond = g_lCurrentInboundDataTransfer;
-			g_lCurrentInboundDataTransfer = 0;
+//*****************************************************************************
+//
+void SERVER_Tick( void )
+{
+	LONG			lNowTime;
+	LONG			lNewTics;
+	LONG			lPreviousTics;
+	LONG			lCurTics;
 
-			// Update the form.
-			SERVERCONSOLE_UpdateStatistics( );
+	// When replaying a capture, run one tic after another without waiting.
+	if ( SERVER_CAPTURE_IsReplaying( ))
+	{
+		int iOldTime = level.time;
+		if ( SERVER_CAPTURE_BeginReplayTic( ))
+		{
+			SERVER_CAPTURE_ClockReplay( true );
+			server_RunTic( iOldTime );
+			server_KickOverMovingClients( );
+			SERVER_CAPTURE_ClockReplay( false );
 		}
+		return;
+	}
+
+	I_DoSelect();
+	lPreviousTics = static_cast<LONG> ( g_lGameTime / (( 1.0 / TICRATE ) * 1000.0 ) );
+
+	lNowTime = I_MSTime( );
+	lNewTics = static_cast<LONG> ( lNowTime / (( 1.0 / TICRATE ) * 1000.0 ) );
+
+	lCurTics = lNewTics - lPreviousTics;
+	while ( lCurTics <= 0 )
+	{
+		// [BB] Recieve packets whenever possible (not only once each tic) to allow
+		// for an accurate ping measurement.
+		SERVER_GetPackets( );
+
+		I_Sleep( 1 );
+		lNowTime = I_MSTime( );
+		lNewTics = static_cast<LONG> ( lNowTime / (( 1.0 / TICRATE ) * 1000.0 ) );
+		lCurTics = lNewTics - lPreviousTics;
+	}
 
-		//DObject::EndFrame ();
+#ifdef NO_SERVER_GUI
+	// console input
+	char *cmd = I_ConsoleInput();
+	if (cmd)
+	{
+		SERVER_CAPTURE_RecordCommand( cmd );
+		AddCommandString (cmd);
 	}
+	// [Zandronum] The log thread flushes the output itself.
+	if ( SERVER_LOGTHREAD_IsRunning( ) == false )
+		fflush(stdout);
+#else
+	// Execute any commands that have been issued through server menus.
+	while ( g_ServerCommandQueue.Size( ))
+		SERVER_DeleteCommand( );
+#endif
+	
+	int iOldTime = level.time;
+	while ( lCurTics-- )
+		server_RunTic( iOldTime );
 /*
 	if ( 1 )
 	{
@@ -759,8 +824,20 @@ void SERVER_Tick( void )
 	// [BB] Remove IP adresses from g_floodProtectionIPQueue that have been in there long enough.
 	g_floodProtectionIPQueue.adjustHead ( g_lGameTime / 1000 );
 
-	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	server_KickOverMovingClients( );
+}
+
+//*****************************************************************************
+//
+static void server_KickOverMovingClients( void )
+{
+	// Work on a copy, kicking a client changes the list.
+	const PLAYERLIST_s clients = SERVER_GetClientList( );
+
+	for ( ULONG ulListIdx = 0; ulListIdx < clients.ulNumPlayers; ulListIdx++ )
 	{
+		const ULONG ulIdx = clients.aulPlayers[ulListIdx];
+
 		if (( SERVER_IsValidClient( ulIdx ) == false ) || ( players[ulIdx].bSpectating ))
 			continue;
 
@@ -774,16 +851,18 @@ void SERVER_Tick( void )
 //
 void SERVER_SendOutPackets( void )
 {
-	ULONG	ulIdx;
+	const PLAYERLIST_s &clients = SERVER_GetClientList( );
 
-	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	for ( ULONG ulListIdx = 0; ulListIdx < clients.ulNumPlayers; ulListIdx++ )
 	{
-		if ( SERVER_IsValidClient( ulIdx ) == false )
-			continue;
+		const ULONG ulIdx = clients.aulPlayers[ulListIdx];
 
 		if ( g_aClients[ulIdx].PacketBuffer.CalcSize() > 0 )
 			SERVER_SendClientPacket( ulIdx, true );
 
+		// The scheduler needs to know what the reliable packets cost first.
+		SERVER_PACKETSCHEDULER_Flush( ulIdx );
+
 		if ( g_aClients[ulIdx].UnreliablePacketBuffer.CalcSize() > 0 )
 			SERVER_SendClientPacket( ulIdx, false );
 	}
@@ -803,6 +882,7 @@ void SERVER_SendClientPacket( ULONG ulClient, bool bReliable )
 
 	if ( bReliable )
 	{
+		SERVER_PACKETSCHEDULER_CountReliableBytes( ulClient, pClient->PacketBuffer.CalcSize() );
 		pClient->SavedPackets.ScheduleUnsentPacket( pClient->PacketBuffer );
 		pClient->PacketBuffer.Clear();
 		return;
@@ -1034,6 +1114,10 @@ void SERVER_GetPackets( void )
 {
 	BYTESTREAM_s	*pByteStream;
 
+	// The network thread can't look up the auth server address itself.
+	if ( SERVER_NETTHREAD_IsRunning( ))
+		SERVER_NETTHREAD_SetAuthServerAddress( NETWORK_AUTH_GetCachedServerAddress( ));
+
 	while ( NETWORK_GetPackets( ) > 0 )
 	{
 		// Set up our byte stream.
@@ -1185,6 +1269,17 @@ void SERVER_RequestClientToAuthenticate( ULONG ulClient )
 	// the client from relying on a gametic of 0 or some unset number.
 	g_aClients[ulClient].PacketBuffer.ByteStream.WriteLong( gametic );
 
+	// Tell the client that we accept its packet compression. The client can
+	// already decode this packet even if it's compressed. The client isn't in
+	// the game yet, so the command has to be written directly.
+	if ( g_aClients[ulClient].bNetCompression )
+	{
+		ServerCommands::SetNetCompression command;
+		command.SetDictionaryID( NETWORK_COMPRESSION_GetDictionaryID( ));
+		command.BuildNetCommand( ).sendCommandToOneClient( ulClient );
+		NETWORK_COMPRESSION_EnableForAddress( g_aClients[ulClient].Address, true );
+	}
+
 	// Send the packet off.
 	SERVER_SendClientPacket( ulClient, true );
 }
@@ -1295,6 +1390,7 @@ void SERVER_ConnectNewPlayer( BYTESTREAM_s *pByteStream )
 		players[g_lCurrentClient].bSpectating = true;
 		players[g_lCurrentClient].bSpectating = (( PLAYER_ShouldSpawnAsSpectator( &players[g_lCurrentClient] )) || ( g_aClients[g_lCurrentClient].bWantStartAsSpectator ));
 	}
+	SERVER_UpdatePlayerLists( );
 
 	// Don't restart the map! There's people here!
 	g_lMapRestartTimer = 0;
@@ -1803,9 +1899,16 @@ void SERVER_SetupNewConnection( BYTESTREAM_s *pByteStream, bool bNewPlayer )
 	// Read in the client's network game version.
 	clientNetworkGameVersion = pByteStream->ReadByte();
 
+	// Read in the dictionary the client wants to compress the packets with.
+	const ULONG ulNetCompressionDictionaryID = ( connectFlags & CCF_NETCOMPRESSION ) ? pByteStream->ReadLong() : 0;
+	g_aClients[lClient].bNetCompression = ( connectFlags & CCF_NETCOMPRESSION ) && sv_netcompression
+		&& ( ulNetCompressionDictionaryID == NETWORK_COMPRESSION_GetDictionaryID( ));
+	NETWORK_COMPRESSION_EnableForAddress( AddressFrom, false );
+
 	g_aClients[lClient].SavedPackets.Clear();
 	g_aClients[lClient].PacketBuffer.Clear();
 	g_aClients[lClient].UnreliablePacketBuffer.Clear();
+	SERVER_PACKETSCHEDULER_ResetClient( lClient );
 
 	// Who is connecting?
 	Printf( "Connect (v%s): %s\n", clientVersion.GetChars(), NETWORK_GetFromAddress().ToString() );
@@ -1888,6 +1991,7 @@ void SERVER_SetupNewConnection( BYTESTREAM_s *pByteStream, bool bNewPlayer )
 	players[lClient].bSpectating = false;
 	players[lClient].bDeadSpectator = false;
 	players[lClient].ulTeam = teams.Size( );
+	SERVER_UpdatePlayerLists( );
 	players[lClient].bOnTeam = false;
 
 	g_aClients[lClient].bRCONAccess = false;
@@ -1907,6 +2011,7 @@ void SERVER_SetupNewConnection( BYTESTREAM_s *pByteStream, bool bNewPlayer )
 	g_aClients[lClient].lLastMoveTick = 0;
 	g_aClients[lClient].lLastMoveTickProcess = 0;
 	g_aClients[lClient].lOverMovementLevel = 0;
+	g_aClients[lClient].MoveCMDs.Clear();
 	g_aClients[lClient].bRunEnterScripts = false;
 	g_aClients[lClient].bSuspicious = false;
 	g_aClients[lClient].ulNumConsistencyWarnings = 0;
@@ -2293,6 +2398,9 @@ void SERVER_SendFullUpdate( ULONG ulClient )
 	AInventory					*pInventory;
 	TThinkerIterator<AActor>	Iterator;
 
+	// The client spawns all actors anew, so its actor snapshots start over.
+	SERVER_ACTORSNAPSHOT_ResetClient( ulClient );
+
 	// Send active players to the client.
 	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
 	{
@@ -2717,11 +2825,15 @@ void SERVER_WriteCommands( void )
 	// Ping clients and stuff.
 	SERVER_SendHeartBeat( );
 
-	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ++ulIdx )
+	SERVER_ACTORSNAPSHOT_Tick( );
+
+	const PLAYERLIST_s &clients = SERVER_GetClientList( );
+	const PLAYERLIST_s &inGamePlayers = SERVER_GetInGamePlayerList( );
+
+	// [BB] Only clients need to be informed about player movement.
+	for ( ULONG ulListIdx = 0; ulListIdx < clients.ulNumPlayers; ++ulListIdx )
 	{
-		// [BB] Only clients need to be informed about player movement.
-		if ( SERVER_IsValidClient( ulIdx ) == false )
-			continue;
+		const ULONG ulIdx = clients.aulPlayers[ulListIdx];
 
 		// [BB] If we requested the client to change his weapon, keep bugging him till the change is confirmed.
 		// This is necessary because the client doesn't notice when the last packet is missing. He only
@@ -2752,10 +2864,9 @@ void SERVER_WriteCommands( void )
 		// [BB] Only necessary if we are in a level.
 		if ( gamestate == GS_LEVEL )
 		{
-			for ( ULONG ulPlayer = 0; ulPlayer < MAXPLAYERS; ulPlayer++ )
+			for ( ULONG ulPlayerListIdx = 0; ulPlayerListIdx < inGamePlayers.ulNumPlayers; ulPlayerListIdx++ )
 			{
-				if ( ( playeringame[ulPlayer] == false ) || players[ulPlayer].bSpectating )
-					continue;
+				const ULONG ulPlayer = inGamePlayers.aulPlayers[ulPlayerListIdx];
 
 				// [BB] The consoleplayer on a client has to be moved differently.
 				if ( ulPlayer == ulIdx )
@@ -2763,6 +2874,8 @@ void SERVER_WriteCommands( void )
 
 				SERVERCOMMANDS_MovePlayer( ulPlayer, ulIdx, SVCF_ONLYTHISCLIENT );
 			}
+
+			SERVER_ACTORSNAPSHOT_WriteClientSnapshot( ulIdx );
 		}
 
 		// Spectators can move around freely, without us telling it what to do (lag-less).
@@ -2791,10 +2904,9 @@ void SERVER_WriteCommands( void )
 	// Once every four seconds, update each player's ping.
 	if (( gametic % ( 4 * TICRATE )) == 0 )
 	{
-		for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+		for ( ULONG ulListIdx = 0; ulListIdx < clients.ulNumPlayers; ulListIdx++ )
 		{
-			if ( SERVER_IsValidClient( ulIdx ) == false )
-				continue;
+			const ULONG ulIdx = clients.aulPlayers[ulListIdx];
 
 			// Tell everyone this player's ping.
 			SERVERCOMMANDS_UpdatePlayerPing( ulIdx );
@@ -2806,8 +2918,13 @@ void SERVER_WriteCommands( void )
 		// [K6] Also check for afk players
 		if ( sv_afk2spec )
 		{
-			for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ++ulIdx )
+			// Work on a copy, forcing a client to spectate changes the lists.
+			const PLAYERLIST_s afkCandidates = clients;
+
+			for ( ULONG ulListIdx = 0; ulListIdx < afkCandidates.ulNumPlayers; ++ulListIdx )
 			{
+				const ULONG ulIdx = afkCandidates.aulPlayers[ulListIdx];
+
 				// [BB] Don't kick dead spectators for inactivity.
 				if ( ( SERVER_IsValidClient( ulIdx ) == false ) || ( players[ulIdx].bSpectating ) )
 					continue;
@@ -2846,6 +2963,81 @@ bool SERVER_IsValidClient( ULONG ulClient )
 	return ( true );
 }
 
+//*****************************************************************************
+//
+// Rebuilds the dense player lists. This has to be called whenever a player
+// enters or leaves the game, or starts or stops spectating.
+//
+void SERVER_UpdatePlayerLists( void )
+{
+	g_ClientList.ulNumPlayers = 0;
+	g_InGamePlayerList.ulNumPlayers = 0;
+	g_SpectatorList.ulNumPlayers = 0;
+
+	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	{
+		if ( playeringame[ulIdx] == false )
+			continue;
+
+		if ( players[ulIdx].pSkullBot == NULL )
+			g_ClientList.aulPlayers[g_ClientList.ulNumPlayers++] = ulIdx;
+
+		if ( players[ulIdx].bSpectating )
+			g_SpectatorList.aulPlayers[g_SpectatorList.ulNumPlayers++] = ulIdx;
+		else
+			g_InGamePlayerList.aulPlayers[g_InGamePlayerList.ulNumPlayers++] = ulIdx;
+	}
+
+	// Launchers need to see the new player list.
+	SERVER_MASTER_InvalidateServerInfo( );
+}
+
+//*****************************************************************************
+//
+const PLAYERLIST_s &SERVER_GetClientList( void )
+{
+	return ( g_ClientList );
+}
+
+//*****************************************************************************
+//
+const PLAYERLIST_s &SERVER_GetInGamePlayerList( void )
+{
+	return ( g_InGamePlayerList );
+}
+
+//*****************************************************************************
+//
+const PLAYERLIST_s &SERVER_GetSpectatorList( void )
+{
+	return ( g_SpectatorList );
+}
+
+#ifdef _DEBUG
+//*****************************************************************************
+//
+// Makes sure nobody changed playeringame or bSpectating without updating the
+// player lists.
+//
+static void server_CheckPlayerLists( void )
+{
+	const PLAYERLIST_s	clients = g_ClientList;
+	const PLAYERLIST_s	inGame = g_InGamePlayerList;
+	const PLAYERLIST_s	spectators = g_SpectatorList;
+
+	SERVER_UpdatePlayerLists( );
+	if (( clients.ulNumPlayers != g_ClientList.ulNumPlayers ) ||
+		( inGame.ulNumPlayers != g_InGamePlayerList.ulNumPlayers ) ||
+		( spectators.ulNumPlayers != g_SpectatorList.ulNumPlayers ) ||
+		( memcmp( clients.aulPlayers, g_ClientList.aulPlayers, clients.ulNumPlayers * sizeof( ULONG )) != 0 ) ||
+		( memcmp( inGame.aulPlayers, g_InGamePlayerList.aulPlayers, inGame.ulNumPlayers * sizeof( ULONG )) != 0 ) ||
+		( memcmp( spectators.aulPlayers, g_SpectatorList.aulPlayers, spectators.ulNumPlayers * sizeof( ULONG )) != 0 ))
+	{
+		Printf( "server_CheckPlayerLists: The player lists were out of date!\n" );
+	}
+}
+#endif
+
 //*****************************************************************************
 //
 void SERVER_AdjustPlayersReactiontime( const ULONG ulPlayer )
@@ -2947,10 +3139,13 @@ void SERVER_DisconnectClient( ULONG ulClient, bool bBroadcast, bool bSaveInfo )
 	// [BB] Clear any cheats the player had. Note: This may not be done before the player dropped the important items!
 	players[ulClient].cheats = players[ulClient].cheats2 = 0;
 
+	NETWORK_COMPRESSION_EnableForAddress( g_aClients[ulClient].Address, false );
 	memset( &g_aClients[ulClient].Address, 0, sizeof( g_aClients[ulClient].Address ));
 	g_aClients[ulClient].State = CLS_FREE;
 	g_aClients[ulClient].ulLastGameTic = 0;
 	playeringame[ulClient] = false;
+	SERVER_UpdatePlayerLists( );
+	SERVER_ACTORSNAPSHOT_ResetClient( ulClient );
 
 	// Run the disconnect scripts now that the player is leaving.
 	if (( players[ulClient].bSpectating == false ) ||
@@ -2969,6 +3164,7 @@ void SERVER_DisconnectClient( ULONG ulClient, bool bBroadcast, bool bSaveInfo )
 	g_aClients[ulClient].PacketBuffer.Clear();
 	g_aClients[ulClient].UnreliablePacketBuffer.Clear();
 	g_aClients[ulClient].SavedPackets.Clear();
+	SERVER_PACKETSCHEDULER_ResetClient( ulClient );
 
 	// Tell the join queue module that a player has left the game.
 	JOINQUEUE_PlayerLeftGame( ulClient, true );
@@ -3484,6 +3680,8 @@ void SERVER_LoadNewLevel( const char *pszMapName )
 {
 	ULONG		ulIdx;
 
+	SERVER_MASTER_InvalidateServerInfo( );
+
 	for ( ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
 	{
 		if ( SERVER_IsValidClient( ulIdx ) == false )
@@ -3620,6 +3818,7 @@ void SERVER_AddCommand( const char *pszCommand )
 void SERVER_DeleteCommand( void )
 {
 #ifndef NO_SERVER_GUI
+	SERVER_CAPTURE_RecordCommand( g_ServerCommandQueue[0].GetChars( ));
 	AddCommandString( (char *)g_ServerCommandQueue[0].GetChars( ));
 	g_ServerCommandQueue.Delete( 0 );
 #endif
@@ -4893,6 +5092,15 @@ bool SERVER_ProcessCommand( LONG lCommand, BYTESTREAM_s *pByteStream )
 		}
 		return false;
 
+	case CLC_ACKACTORSNAPSHOT:
+		{
+			// The client tells us which actor snapshot it received.
+			const LONG lSnapshotTic = pByteStream->ReadLong();
+			const ULONG ulPieceMask = pByteStream->ReadByte();
+			SERVER_ACTORSNAPSHOT_Acknowledge( g_lCurrentClient, lSnapshotTic, ulPieceMask );
+		}
+		return ( false );
+
 	// [TP] Client sets a CVar over RCON.
 	case CLC_RCONSETCVAR:
 		{
@@ -5060,20 +5268,95 @@ void SERVER_UpdateThingVelocity( AActor *pActor, bool updateZ, bool updateXY )
 
 //*****************************************************************************
 //
-template <typename CommandType>
-static bool server_ParseBufferedCommand ( BYTESTREAM_s *pByteStream )
+// Statistics about the buffered client commands.
+static	ULONG	g_ulNumDroppedClientCommands = 0;
+static	ULONG	g_ulNumMergedClientCommands = 0;
+static	ULONG	g_ulPeakClientCommandDepth = 0;
+
+// Returns the record the next buffered command of the current client is read
+// into. Without the tic buffer, that's the local record of the caller.
+// If the client's buffer is full, its oldest command is dropped to make room,
+// unless it's a weapon selection, which is executed right away to keep the
+// weapons in sync. Returns NULL if the client was kicked doing so.
+static CLIENT_BUFFERED_COMMAND_s *server_GetBufferedCommandSlot ( CLIENT_BUFFERED_COMMAND_s &LocalCmd )
 {
-	CommandType *cmd = new CommandType ( pByteStream );
+	if ( sv_useticbuffer == false )
+		return &LocalCmd;
 
-	if ( sv_useticbuffer )
+	ClientCommandBuffer &buffer = g_aClients[g_lCurrentClient].MoveCMDs;
+	if ( buffer.IsFull( ) )
 	{
-		g_aClients[g_lCurrentClient].MoveCMDs.Push ( cmd );
-		return false;
+		const CLIENT_BUFFERED_COMMAND_s oldest = buffer.Front( );
+		buffer.PopFront( );
+
+		if ( oldest.Type == CCT_MOVE )
+			g_ulNumDroppedClientCommands++;
+		else if ( SERVER_ProcessBufferedCommand( g_lCurrentClient, oldest ))
+			return NULL;
+	}
+
+	return &buffer.Back( );
+}
+
+// Adds the command read into the slot returned by server_GetBufferedCommandSlot
+// to the current client's buffer, or executes it if the tic buffer is off.
+// A movement command for a client gametic that's already buffered (i.e. a
+// duplicate) replaces the buffered one instead of being added again.
+static bool server_BufferCommand ( CLIENT_BUFFERED_COMMAND_s &Cmd )
+{
+	if ( sv_useticbuffer == false )
+		return SERVER_ProcessBufferedCommand( g_lCurrentClient, Cmd );
+
+	ClientCommandBuffer &buffer = g_aClients[g_lCurrentClient].MoveCMDs;
+	CLIENT_BUFFERED_COMMAND_s *pDuplicate = ( Cmd.Type == CCT_MOVE ) ? buffer.FindMoveCommand( Cmd.MoveCmd.ulGametic ) : NULL;
+
+	if ( pDuplicate != NULL )
+	{
+		pDuplicate->MoveCmd = Cmd.MoveCmd;
+		g_ulNumMergedClientCommands++;
+	}
+	else
+	{
+		buffer.PushBack( );
+		g_ulPeakClientCommandDepth = MAX<ULONG>( g_ulPeakClientCommandDepth, buffer.Size( ));
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+bool SERVER_ProcessBufferedCommand( ULONG ulClient, const CLIENT_BUFFERED_COMMAND_s &Cmd )
+{
+	switch ( Cmd.Type )
+	{
+	case CCT_MOVE:
+		return server_ProcessClientMove( ulClient, Cmd.MoveCmd );
+	case CCT_WEAPONSELECT:
+		return server_ProcessWeaponSelect( ulClient, Cmd.usActorNetworkIndex );
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+ADD_STAT( clientcommands )
+{
+	FString	out;
+	ULONG	ulTotal = 0;
+	ULONG	ulDeepest = 0;
+
+	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ulIdx++ )
+	{
+		if ( SERVER_IsValidClient( ulIdx ) == false )
+			continue;
+
+		ulTotal += g_aClients[ulIdx].MoveCMDs.Size( );
+		ulDeepest = MAX<ULONG>( ulDeepest, g_aClients[ulIdx].MoveCMDs.Size( ));
 	}
 
-	const bool retValue = cmd->process ( g_lCurrentClient );
-	delete cmd;
-	return retValue;
+	out.Format( "Buffered client commands: %lu (deepest queue %lu, peak %lu of %d), dropped %lu, merged %lu",
+		ulTotal, ulDeepest, g_ulPeakClientCommandDepth, ClientCommandBuffer::CAPACITY, g_ulNumDroppedClientCommands, g_ulNumMergedClientCommands );
+	return out;
 }
 
 //*****************************************************************************
@@ -5300,21 +5583,6 @@ static bool server_Say( BYTESTREAM_s *pByteStream )
 	}
 }
 
-//*****************************************************************************
-class ClientMoveCommand : public ClientCommand
-{
-	CLIENT_MOVE_COMMAND_s moveCmd;
-public:
-	ClientMoveCommand ( BYTESTREAM_s *pByteStream );
-
-	bool process ( const ULONG ulClient ) const;
-
-	virtual bool isMoveCmd ( ) const
-	{
-		return true;
-	}
-};
-
 //*****************************************************************************
 //
 static bool server_ClientMove( BYTESTREAM_s *pByteStream )
@@ -5326,10 +5594,19 @@ static bool server_ClientMove( BYTESTREAM_s *pByteStream )
 	// in a buffer. This way we can limit the amount of movement commands
 	// we process for a player in a given tic to prevent the player from
 	// seemingly teleporting in case too many movement commands arrive at once.
-	return server_ParseBufferedCommand<ClientMoveCommand> ( pByteStream );
+	CLIENT_BUFFERED_COMMAND_s	localCmd;
+	CLIENT_BUFFERED_COMMAND_s	*pCmd = server_GetBufferedCommandSlot( localCmd );
+	if ( pCmd == NULL )
+		return ( true );
+
+	pCmd->Type = CCT_MOVE;
+	server_ReadClientMove( pByteStream, pCmd->MoveCmd );
+	return server_BufferCommand( *pCmd );
 }
 
-ClientMoveCommand::ClientMoveCommand ( BYTESTREAM_s *pByteStream )
+//*****************************************************************************
+//
+static void server_ReadClientMove( BYTESTREAM_s *pByteStream, CLIENT_MOVE_COMMAND_s &moveCmd )
 {
 	ticcmd_t *pCmd = &moveCmd.cmd;
 
@@ -5397,7 +5674,9 @@ ClientMoveCommand::ClientMoveCommand ( BYTESTREAM_s *pByteStream )
 		moveCmd.usWeaponNetworkIndex = 0;
 }
 
-bool ClientMoveCommand::process( const ULONG ulClient ) const
+//*****************************************************************************
+//
+static bool server_ProcessClientMove( const ULONG ulClient, const CLIENT_MOVE_COMMAND_s &moveCmd )
 {
 	player_t *pPlayer = &players[ulClient];
 	ticcmd_t *pCmd = &pPlayer->cmd;
@@ -5643,16 +5922,6 @@ static bool server_UpdateClientPing( BYTESTREAM_s *pByteStream )
 	return ( false );
 }
 
-//*****************************************************************************
-class ClientWeaponSelectCommand : public ClientCommand
-{
-	const USHORT usActorNetworkIndex;
-public:
-	ClientWeaponSelectCommand ( BYTESTREAM_s *pByteStream );
-
-	bool process ( const ULONG ulClient ) const;
-};
-
 //*****************************************************************************
 //
 static bool server_WeaponSelect( BYTESTREAM_s *pByteStream )
@@ -5660,14 +5929,20 @@ static bool server_WeaponSelect( BYTESTREAM_s *pByteStream )
 	// [BB] To keep weapon sync when buffering movement commands, the weapon 
 	// select commands also need to be stored in the same buffer the keep
 	// the proper order of the commands.
-	return server_ParseBufferedCommand<ClientWeaponSelectCommand> ( pByteStream );
-}
+	CLIENT_BUFFERED_COMMAND_s	localCmd;
+	CLIENT_BUFFERED_COMMAND_s	*pCmd = server_GetBufferedCommandSlot( localCmd );
+	if ( pCmd == NULL )
+		return ( true );
 
-ClientWeaponSelectCommand::ClientWeaponSelectCommand ( BYTESTREAM_s *pByteStream )
+	pCmd->Type = CCT_WEAPONSELECT;
 	// Read in the identification of the weapon the player is selecting.
-	: usActorNetworkIndex ( pByteStream->ReadShort() ) { }
+	pCmd->usActorNetworkIndex = pByteStream->ReadShort();
+	return server_BufferCommand( *pCmd );
+}
 
-bool ClientWeaponSelectCommand::process( const ULONG ulClient ) const
+//*****************************************************************************
+//
+static bool server_ProcessWeaponSelect( const ULONG ulClient, const USHORT usActorNetworkIndex )
 {
 	const PClass	*pType;
 	AInventory		*pInventory;
@@ -6084,6 +6359,7 @@ static bool server_ChangeTeam( BYTESTREAM_s *pByteStream )
 	// Also, take away spectator status.
 	players[g_lCurrentClient].bSpectating = false;
 	players[g_lCurrentClient].bDeadSpectator = false;
+	SERVER_UpdatePlayerLists( );
 
 	if ( GAMEMODE_GetCurrentFlags() & GMF_TEAMGAME )
 		G_TeamgameSpawnPlayer( g_lCurrentClient, players[g_lCurrentClient].ulTeam, true );
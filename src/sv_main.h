@@ -201,19 +201,64 @@ struct CLIENT_MOVE_COMMAND_s
 };
 
 //*****************************************************************************
-class ClientCommand
+enum CLIENTCOMMANDTYPE_e
+{
+	CCT_MOVE,
+	CCT_WEAPONSELECT,
+};
+
+//*****************************************************************************
+// A client command that is buffered until the next tic, stored by value.
+struct CLIENT_BUFFERED_COMMAND_s
+{
+	CLIENTCOMMANDTYPE_e		Type;
+
+	// The movement command (CCT_MOVE).
+	CLIENT_MOVE_COMMAND_s	MoveCmd;
+
+	// The weapon the client is selecting (CCT_WEAPONSELECT).
+	USHORT					usActorNetworkIndex;
+};
+
+//*****************************************************************************
+// Fixed size ring of the commands received from a client that haven't been
+// executed yet. Commands are read straight into their slot, so buffering a
+// command never allocates.
+class ClientCommandBuffer
 {
 public:
-	ClientCommand () {};
+	enum { CAPACITY = 64 };	// Must be a power of two.
+
+	ClientCommandBuffer ( ) : _first ( 0 ), _count ( 0 ) { }
+
+	unsigned int Size ( ) const { return _count; }
+	bool IsFull ( ) const { return _count == CAPACITY; }
+	void Clear ( ) { _first = _count = 0; }
 
-	virtual ~ClientCommand () {};
+	// The oldest buffered command.
+	const CLIENT_BUFFERED_COMMAND_s &Front ( ) const { return _commands[_first]; }
+	void PopFront ( ) { _first = ( _first + 1 ) & ( CAPACITY - 1 ); _count--; }
 
-	virtual bool process ( const ULONG ulClient ) const = 0;
+	// The free slot behind the newest command. PushBack adds it to the buffer.
+	CLIENT_BUFFERED_COMMAND_s &Back ( ) { return _commands[( _first + _count ) & ( CAPACITY - 1 )]; }
+	void PushBack ( ) { _count++; }
 
-	virtual bool isMoveCmd ( ) const
+	// Returns the buffered movement command for the given client gametic, if any.
+	CLIENT_BUFFERED_COMMAND_s *FindMoveCommand ( ULONG ulGametic )
 	{
-		return false;
+		for ( unsigned int i = 0; i < _count; i++ )
+		{
+			CLIENT_BUFFERED_COMMAND_s &cmd = _commands[( _first + i ) & ( CAPACITY - 1 )];
+			if (( cmd.Type == CCT_MOVE ) && ( cmd.MoveCmd.ulGametic == ulGametic ))
+				return &cmd;
+		}
+		return NULL;
 	}
+
+private:
+	CLIENT_BUFFERED_COMMAND_s	_commands[CAPACITY];
+	unsigned int				_first;
+	unsigned int				_count;
 };
 
 //*****************************************************************************
@@ -263,6 +308,9 @@ struct CLIENT_s
 	// [TP] Client doesn't want his account to be revealed to the other players.
 	bool			WantHideAccount;
 
+	// Did the client offer packet compression that we accepted?
+	bool			bNetCompression;
+
 	// [BB] Did the client not yet acknowledge receiving the last full update?
 	bool			bFullUpdateIncomplete;
 
@@ -328,7 +376,7 @@ struct CLIENT_s
 	LONG			lLastActionTic;
 
 	// [BB] Buffer storing all movement commands received from the client we haven't executed yet.
-	TArray<ClientCommand*>	MoveCMDs;
+	ClientCommandBuffer	MoveCMDs;
 
 	// [BB] Variables for the account system
 	FString username;
@@ -398,6 +446,15 @@ struct SECTORLINK_s
 
 };
 
+//*****************************************************************************
+// A dense list of player indices in ascending order. Loops that only care
+// about the active players walk these instead of all MAXPLAYERS slots.
+struct PLAYERLIST_s
+{
+	ULONG			aulPlayers[MAXPLAYERS];
+	ULONG			ulNumPlayers;
+};
+
 //*****************************************************************************
 //	PROTOTYPES
 
@@ -430,6 +487,11 @@ void		SERVER_ClientError( ULONG ulClient, ULONG ulErrorCode );
 void		SERVER_SendFullUpdate( ULONG ulClient );
 void		SERVER_WriteCommands( void );
 bool		SERVER_IsValidClient( ULONG ulClient );
+void		SERVER_UpdatePlayerLists( void );
+const PLAYERLIST_s	&SERVER_GetClientList( void );
+const PLAYERLIST_s	&SERVER_GetInGamePlayerList( void );
+const PLAYERLIST_s	&SERVER_GetSpectatorList( void );
+bool		SERVER_ProcessBufferedCommand( ULONG ulClient, const CLIENT_BUFFERED_COMMAND_s &Cmd );
 void		SERVER_AdjustPlayersReactiontime( const ULONG ulPlayer );
 void		SERVER_DisconnectClient( ULONG ulClient, bool bBroadcast, bool bSaveInfo );
 void		SERVER_SendHeartBeat( void );
@@ -498,6 +560,7 @@ void		SERVER_MASTER_Destruct( void );
 void		SERVER_MASTER_Tick( void );
 void		SERVER_MASTER_Broadcast( void );
 void		SERVER_MASTER_SendServerInfo( NETADDRESS_s Address, ULONG ulFlags, ULONG ulTime, ULONG ulFlags2, bool bBroadcasting );
+void		SERVER_MASTER_InvalidateServerInfo( void );
 const char	*SERVER_MASTER_GetGameName( void );
 NETADDRESS_s SERVER_MASTER_GetMasterAddress( void );
 void		SERVER_MASTER_HandleVerificationRequest( BYTESTREAM_s *pByteStream );
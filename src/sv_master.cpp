@@ -70,6 +70,38 @@
 #include "sv_ban.h"
 #include "version.h"
 #include "d_dehacked.h"
+#include "stats.h"
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+//-- DEFINES ---------------------------------------------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+
+// How many flag combinations are cached at most.
+#define	MAX_CACHED_SERVERINFO			16
+
+// A cached response is rebuilt after this many tics even if nothing
+// invalidated it, since pings, times and cvars don't.
+#define	SERVERINFO_CACHE_TICS			TICRATE
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+//-- STRUCTURES ------------------------------------------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+
+//*****************************************************************************
+//
+// A launcher response without the header and the launcher's time, which are
+// the only parts that differ between launchers asking for the same flags.
+//
+struct CACHEDSERVERINFO_s
+{
+	ULONG			ulFlags;
+	ULONG			ulFlags2;
+
+	// The gametic the response was built.
+	LONG			lBuiltGametic;
+
+	TArray<BYTE>	Data;
+};
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- VARIABLES -------------------------------------------------------------------------------------------------------------------------------------
@@ -84,17 +116,32 @@ static	NETBUFFER_s			g_MasterServerBuffer;
 // Port the master server is located on.
 static	USHORT				g_usMasterPort;
 
-// List of IP address that this server has been queried by recently.
-static	STORED_QUERY_IP_s	g_StoredQueryIPs[MAX_STORED_QUERY_IPS];
+// IP addresses that this server has been queried by recently, mapped to the
+// gametic when they may query again.
+static	TMap<DWORD, LONG>	g_StoredQueryIPs;
 
-static	LONG				g_lStoredQueryIPHead;
-static	LONG				g_lStoredQueryIPTail;
 static	TArray<int>			g_OptionalWadIndices;
 
+// Launcher responses for the flag combinations that were queried recently.
+static	TArray<CACHEDSERVERINFO_s>	g_CachedServerInfo;
+
+// Statistics for "stat launcherqueries".
+static	ULONG				g_ulServerInfoCacheHits = 0;
+static	ULONG				g_ulServerInfoCacheMisses = 0;
+
 extern	NETADDRESS_s		g_LocalAddress;
 
 FString g_VersionWithOS;
 
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+//-- PROTOTYPES ------------------------------------------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+
+static	DWORD				server_master_GetIPKey( const NETADDRESS_s &Address );
+static	void				server_master_NormalizeFlags( ULONG &ulFlags, ULONG &ulFlags2 );
+static	CACHEDSERVERINFO_s	*server_master_FindCachedServerInfo( ULONG ulFlags, ULONG ulFlags2 );
+static	void				server_master_CacheServerInfo( ULONG ulFlags, ULONG ulFlags2, const BYTE *pbData, LONG lSize );
+
 //*****************************************************************************
 //	CONSOLE VARIABLES
 
@@ -122,8 +169,7 @@ void SERVER_MASTER_Construct( void )
 	else 
 	   g_usMasterPort = DEFAULT_MASTER_PORT;
 
-	g_lStoredQueryIPHead = 0;
-	g_lStoredQueryIPTail = 0;
+	g_StoredQueryIPs.Clear( );
 
 #ifndef _WIN32
 	struct utsname u_name;
@@ -156,10 +202,22 @@ void SERVER_MASTER_Destruct( void )
 //
 void SERVER_MASTER_Tick( void )
 {
-	while (( g_lStoredQueryIPHead != g_lStoredQueryIPTail ) && ( gametic >= g_StoredQueryIPs[g_lStoredQueryIPHead].lNextAllowedGametic ))
+	// Forget the addresses that may query again once per second. Expired
+	// entries are ignored anyway, this only keeps the table small.
+	if (( gametic % TICRATE ) == 0 )
 	{
-		g_lStoredQueryIPHead++;
-		g_lStoredQueryIPHead = g_lStoredQueryIPHead % MAX_STORED_QUERY_IPS;
+		TMapIterator<DWORD, LONG>		it( g_StoredQueryIPs );
+		TMap<DWORD, LONG>::Pair			*pair;
+		TArray<DWORD>					expired;
+
+		while ( it.NextPair( pair ))
+		{
+			if ( gametic >= pair->Value )
+				expired.Push( pair->Key );
+		}
+
+		for ( unsigned int i = 0; i < expired.Size( ); i++ )
+			g_StoredQueryIPs.Remove( expired[i] );
 	}
 
 	// Send an update to the master server every 30 seconds.
@@ -270,36 +328,27 @@ void SERVER_MASTER_SendServerInfo( NETADDRESS_s Address, ULONG ulFlags, ULONG ul
 
 	if ( bBroadcasting == false )
 	{
-		// First, check to see if we've been queried by this address recently.
-		if ( g_lStoredQueryIPHead != g_lStoredQueryIPTail )
-		{
-			ulIdx = g_lStoredQueryIPHead;
-			while ( ulIdx != (ULONG)g_lStoredQueryIPTail )
-			{
-				// Check to see if this IP exists in our stored query IP list. If it does, then
-				// ignore it, since it queried us less than 10 seconds ago.
-				if ( Address.CompareNoPort( g_StoredQueryIPs[ulIdx].Address ))
-				{
-					// Write our header.
-					g_MasterServerBuffer.ByteStream.WriteLong( SERVER_LAUNCHER_IGNORING );
+		// First, check to see if we've been queried by this address recently. If
+		// so, ignore it, since it queried us less than sv_queryignoretime seconds ago.
+		const DWORD	ulIPKey = server_master_GetIPKey( Address );
+		const LONG	*plNextAllowedGametic = g_StoredQueryIPs.CheckKey( ulIPKey );
 
-					// Send the time the launcher sent to us.
-					g_MasterServerBuffer.ByteStream.WriteLong( ulTime );
+		if (( plNextAllowedGametic != NULL ) && ( gametic < *plNextAllowedGametic ))
+		{
+			// Write our header.
+			g_MasterServerBuffer.ByteStream.WriteLong( SERVER_LAUNCHER_IGNORING );
 
-					// Send the packet.
-	//				NETWORK_LaunchPacket( &g_MasterServerBuffer, Address, true );
-					NETWORK_LaunchPacket( &g_MasterServerBuffer, Address );
+			// Send the time the launcher sent to us.
+			g_MasterServerBuffer.ByteStream.WriteLong( ulTime );
 
-					if ( sv_showlauncherqueries )
-						Printf( "Ignored IP launcher challenge.\n" );
+			// Send the packet.
+			NETWORK_LaunchPacket( &g_MasterServerBuffer, Address );
 
-					// Nothing more to do here.
-					return;
-				}
+			if ( sv_showlauncherqueries )
+				Printf( "Ignored IP launcher challenge.\n" );
 
-				ulIdx++;
-				ulIdx = ulIdx % MAX_STORED_QUERY_IPS;
-			}
+			// Nothing more to do here.
+			return;
 		}
 	
 		// Now, check to see if this IP has been banend from this server.
@@ -323,14 +372,11 @@ void SERVER_MASTER_SendServerInfo( NETADDRESS_s Address, ULONG ulFlags, ULONG ul
 		}
 
 		// This IP didn't exist in the list. and it wasn't banned. 
-		// So, add it, and keep it there for 10 seconds.
-		g_StoredQueryIPs[g_lStoredQueryIPTail].Address = Address;
-		g_StoredQueryIPs[g_lStoredQueryIPTail].lNextAllowedGametic = gametic + ( TICRATE * ( sv_queryignoretime ));
-
-		g_lStoredQueryIPTail++;
-		g_lStoredQueryIPTail = g_lStoredQueryIPTail % MAX_STORED_QUERY_IPS;
-		if ( g_lStoredQueryIPTail == g_lStoredQueryIPHead )
-			Printf( "SERVER_MASTER_SendServerInfo: WARNING! g_lStoredQueryIPTail == g_lStoredQueryIPHead\n" );
+		// So, add it, and keep it there for sv_queryignoretime seconds.
+		if (( plNextAllowedGametic != NULL ) || ( g_StoredQueryIPs.CountUsed( ) < MAX_STORED_QUERY_IPS ))
+			g_StoredQueryIPs[ulIPKey] = gametic + ( TICRATE * ( sv_queryignoretime ));
+		else
+			Printf( "SERVER_MASTER_SendServerInfo: WARNING! Too many stored query IPs.\n" );
 	}
 
 	// Write our header.
@@ -339,6 +385,21 @@ void SERVER_MASTER_SendServerInfo( NETADDRESS_s Address, ULONG ulFlags, ULONG ul
 	// Send the time the launcher sent to us.
 	g_MasterServerBuffer.ByteStream.WriteLong( ulTime );
 
+	// The rest of the response only depends on the flags, so answer with the
+	// cached one if we built it recently.
+	CACHEDSERVERINFO_s	*pCached = server_master_FindCachedServerInfo( ulFlags, ulFlags2 );
+
+	if ( pCached != NULL )
+	{
+		g_ulServerInfoCacheHits++;
+		g_MasterServerBuffer.ByteStream.WriteBuffer( &pCached->Data[0], pCached->Data.Size( ));
+		NETWORK_LaunchPacket( &g_MasterServerBuffer, Address );
+		return;
+	}
+
+	g_ulServerInfoCacheMisses++;
+	const LONG lCachedDataStart = g_MasterServerBuffer.CalcSize( );
+
 	// Send our version. [K6] ...with OS
 	g_MasterServerBuffer.ByteStream.WriteString( g_VersionWithOS.GetChars() );
 
@@ -622,10 +683,23 @@ void SERVER_MASTER_SendServerInfo( NETADDRESS_s Address, ULONG ulFlags, ULONG ul
 		}
 	}
 
+	server_master_CacheServerInfo( ulFlags, ulFlags2, g_MasterServerBuffer.pbData + lCachedDataStart, g_MasterServerBuffer.CalcSize( ) - lCachedDataStart );
+
 //	NETWORK_LaunchPacket( &g_MasterServerBuffer, Address, true );
 	NETWORK_LaunchPacket( &g_MasterServerBuffer, Address );
 }
 
+//*****************************************************************************
+//
+// Throws away the cached launcher responses. This has to be called whenever
+// something changes that launchers are told about right away, like players
+// joining or leaving, the scores or the map.
+//
+void SERVER_MASTER_InvalidateServerInfo( void )
+{
+	g_CachedServerInfo.Clear( );
+}
+
 //*****************************************************************************
 //
 const char *SERVER_MASTER_GetGameName( void )
@@ -688,6 +762,87 @@ void SERVER_MASTER_SendBanlistReceipt ( void )
 	NETWORK_LaunchPacket( &g_MasterServerBuffer, SERVER_MASTER_GetMasterAddress () );
 }
 
+//*****************************************************************************
+//
+// Returns the key of an address in g_StoredQueryIPs. Like before, the port
+// is ignored.
+//
+static DWORD server_master_GetIPKey( const NETADDRESS_s &Address )
+{
+	return (( Address.abIP[0] << 24 ) | ( Address.abIP[1] << 16 ) | ( Address.abIP[2] << 8 ) | Address.abIP[3] );
+}
+
+//*****************************************************************************
+//
+// Only the flags that change the response are compared, so that launchers
+// asking for unknown flags share the same entry.
+//
+static void server_master_NormalizeFlags( ULONG &ulFlags, ULONG &ulFlags2 )
+{
+	ulFlags &= SQF_ALL;
+
+	// No extended flags means no extended info at all, but asking for none of
+	// the known extended flags still sends an empty extended block.
+	if ( ulFlags2 != 0 )
+		ulFlags2 = ( ulFlags2 & SQF2_ALL ) | SQF_EXTENDED_INFO;
+}
+
+//*****************************************************************************
+//
+static CACHEDSERVERINFO_s *server_master_FindCachedServerInfo( ULONG ulFlags, ULONG ulFlags2 )
+{
+	server_master_NormalizeFlags( ulFlags, ulFlags2 );
+
+	for ( unsigned int i = 0; i < g_CachedServerInfo.Size( ); i++ )
+	{
+		if (( g_CachedServerInfo[i].ulFlags != ulFlags ) || ( g_CachedServerInfo[i].ulFlags2 != ulFlags2 ))
+			continue;
+
+		if ( gametic - g_CachedServerInfo[i].lBuiltGametic >= SERVERINFO_CACHE_TICS )
+			return ( NULL );
+
+		return ( &g_CachedServerInfo[i] );
+	}
+
+	return ( NULL );
+}
+
+//*****************************************************************************
+//
+static void server_master_CacheServerInfo( ULONG ulFlags, ULONG ulFlags2, const BYTE *pbData, LONG lSize )
+{
+	CACHEDSERVERINFO_s	*pEntry = NULL;
+
+	server_master_NormalizeFlags( ulFlags, ulFlags2 );
+
+	// Replace the outdated entry of the same flags or, if there is none and
+	// the cache is full, the oldest entry.
+	for ( unsigned int i = 0; i < g_CachedServerInfo.Size( ); i++ )
+	{
+		if (( g_CachedServerInfo[i].ulFlags == ulFlags ) && ( g_CachedServerInfo[i].ulFlags2 == ulFlags2 ))
+		{
+			pEntry = &g_CachedServerInfo[i];
+			break;
+		}
+
+		if (( g_CachedServerInfo.Size( ) >= MAX_CACHED_SERVERINFO ) &&
+			(( pEntry == NULL ) || ( g_CachedServerInfo[i].lBuiltGametic < pEntry->lBuiltGametic )))
+		{
+			pEntry = &g_CachedServerInfo[i];
+		}
+	}
+
+	if ( pEntry == NULL )
+		pEntry = &g_CachedServerInfo[g_CachedServerInfo.Reserve( 1 )];
+
+	pEntry->ulFlags = ulFlags;
+	pEntry->ulFlags2 = ulFlags2;
+	pEntry->lBuiltGametic = gametic;
+	pEntry->Data.Resize( lSize );
+	if ( lSize > 0 )
+		memcpy( &pEntry->Data[0], pbData, lSize );
+}
+
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- CONSOLE ---------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -736,3 +891,16 @@ CCMD( wads )
 			( Wads.IsWadOptional( pwad.wadnum ) ? " (optional)" : "" ));
 	}
 }
+
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+//-- STATISTICS ------------------------------------------------------------------------------------------------------------------------------------
+//--------------------------------------------------------------------------------------------------------------------------------------------------
+
+ADD_STAT( launcherqueries )
+{
+	FString	out;
+
+	out.Format( "%lu responses from cache, %lu built, %u cached, %u stored query IPs",
+		g_ulServerInfoCacheHits, g_ulServerInfoCacheMisses, g_CachedServerInfo.Size( ), static_cast<unsigned int>( g_StoredQueryIPs.CountUsed( )));
+	return ( out );
+}
@@ -0,0 +1,388 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: sv_netthread.cpp
+//
+// Description: Receives and decodes the packets to the server on a thread of
+// its own and throttles launcher queries before they reach the game thread.
+//
+// Without the network thread, the game thread receives and decodes every
+// packet itself between the tics, so a flood of launcher queries directly
+// costs simulation time. With -netthread, a separate thread waits on the
+// socket, decodes the packets and sorts them into two queues: one for the
+// game packets and a small one for launcher queries. Launcher queries from an
+// address that queried within the last second are dropped right away. The
+// game thread takes all game packets, but only a few launcher queries per tic,
+// the rest of a flood is dropped once the queue is full.
+//
+// Each queue has exactly one producer (the network thread) and one consumer
+// (the game thread), so they get along without locks. Everything else, i.e.
+// parsing the packets, ban checks and answering the launchers, still happens
+// on the game thread, since it needs the game state. Packets are still sent
+// by the game thread.
+//
+//-----------------------------------------------------------------------------
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "sv_netthread.h"
+#include "c_dispatch.h"
+#include "doomstat.h"
+#include "i_system.h"
+#include "network.h"
+#include "network/netcompression.h"
+#include "network/sv_auth.h"
+#include "stats.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// The number of packets each queue can hold.
+#define	GAME_PACKET_QUEUE_SIZE			256
+#define	LAUNCHER_PACKET_QUEUE_SIZE		16
+
+// The game thread handles at most this many launcher queries per tic.
+#define	MAX_LAUNCHER_QUERIES_PER_TIC	4
+
+// How long the network thread waits for a packet before it checks whether it
+// should stop.
+#define	NETTHREAD_WAIT_MS				100
+
+//*****************************************************************************
+//	STRUCTURES
+
+struct NETTHREADPACKET_s
+{
+	NETADDRESS_s	Address;
+
+	// The size of the decoded packet and of the packet as it was received.
+	ULONG			ulSize;
+	ULONG			ulRawSize;
+
+	BYTE			abData[MAX_UDP_PACKET];
+};
+
+//*****************************************************************************
+//
+// A queue of packets with one thread writing and another thread reading.
+// The writer fills the slot returned by getFreeSlot and then calls push, the
+// reader uses the slot returned by front and then calls pop.
+//
+template <unsigned int Capacity>
+class NetThreadPacketQueue
+{
+	NETTHREADPACKET_s			_slots[Capacity];
+
+	// Both only ever increase, the slot is the index modulo Capacity.
+	std::atomic<unsigned int>	_head;
+	std::atomic<unsigned int>	_tail;
+
+public:
+	NetThreadPacketQueue( ) : _head( 0 ), _tail( 0 ) { }
+
+	NETTHREADPACKET_s *getFreeSlot( )
+	{
+		const unsigned int tail = _tail.load( std::memory_order_relaxed );
+
+		if ( tail - _head.load( std::memory_order_acquire ) >= Capacity )
+			return ( NULL );
+
+		return ( &_slots[tail % Capacity] );
+	}
+
+	void push( )
+	{
+		_tail.store( _tail.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	}
+
+	NETTHREADPACKET_s *front( )
+	{
+		const unsigned int head = _head.load( std::memory_order_relaxed );
+
+		if ( head == _tail.load( std::memory_order_acquire ))
+			return ( NULL );
+
+		return ( &_slots[head % Capacity] );
+	}
+
+	void pop( )
+	{
+		_head.store( _head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	}
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+static	std::thread											g_Thread;
+static	std::atomic<bool>									g_bRunning( false );
+
+static	NetThreadPacketQueue<GAME_PACKET_QUEUE_SIZE>		*g_pGamePackets = NULL;
+static	NetThreadPacketQueue<LAUNCHER_PACKET_QUEUE_SIZE>	*g_pLauncherPackets = NULL;
+
+// The auth server doesn't Huffman encode its packets. The game thread looks
+// the address up, the network thread only gets a copy.
+static	std::mutex											g_AuthServerAddressMutex;
+static	NETADDRESS_s										g_AuthServerAddress;
+
+// Only used by the network thread.
+static	QueryIPQueue										g_LauncherFloodQueue( 1 );
+static	BYTE												g_abRawPacket[MAX_UDP_PACKET * 2];
+static	BYTE												g_abDecodedPacket[MAX_UDP_PACKET];
+
+// Only used by the game thread.
+static	LONG												g_lLauncherQueryTic = -1;
+static	ULONG												g_ulLauncherQueriesThisTic = 0;
+
+// Statistics for "stat netthread".
+static	std::atomic<ULONG>									g_ulPacketsReceived( 0 );
+static	std::atomic<ULONG>									g_ulGamePacketsDropped( 0 );
+static	std::atomic<ULONG>									g_ulLauncherQueriesThrottled( 0 );
+static	std::atomic<ULONG>									g_ulLauncherQueriesDropped( 0 );
+static	std::atomic<ULONG>									g_ulOversizedPacketsDropped( 0 );
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	void		server_netthread_Run( void );
+
+//*****************************************************************************
+//	FUNCTIONS
+
+void SERVER_NETTHREAD_Start( void )
+{
+	if ( g_bRunning )
+		return;
+
+	// The dictionary and the zlib streams must be set up before two threads
+	// can use them.
+	NETWORK_COMPRESSION_Construct( );
+	SERVER_NETTHREAD_SetAuthServerAddress( NETWORK_AUTH_GetCachedServerAddress( ));
+
+	g_pGamePackets = new NetThreadPacketQueue<GAME_PACKET_QUEUE_SIZE>;
+	g_pLauncherPackets = new NetThreadPacketQueue<LAUNCHER_PACKET_QUEUE_SIZE>;
+
+	g_bRunning = true;
+	g_Thread = std::thread( server_netthread_Run );
+	atterm( SERVER_NETTHREAD_Stop );
+
+	Printf( "Receiving packets on a separate thread.\n" );
+}
+
+//*****************************************************************************
+//
+void SERVER_NETTHREAD_Stop( void )
+{
+	if ( g_bRunning == false )
+		return;
+
+	g_bRunning = false;
+	g_Thread.join( );
+
+	delete g_pGamePackets;
+	delete g_pLauncherPackets;
+	g_pGamePackets = NULL;
+	g_pLauncherPackets = NULL;
+}
+
+//*****************************************************************************
+//
+bool SERVER_NETTHREAD_IsRunning( void )
+{
+	return ( g_bRunning );
+}
+
+//*****************************************************************************
+//
+// Takes the next packet the network thread received. Game packets come first,
+// launcher queries are only handed out up to MAX_LAUNCHER_QUERIES_PER_TIC
+// per tic.
+//
+bool SERVER_NETTHREAD_PopPacket( NETADDRESS_s &Address, BYTE *pbData, ULONG ulMaxSize, ULONG &ulSize, ULONG &ulRawSize )
+{
+	if ( g_bRunning == false )
+		return ( false );
+
+	if ( g_lLauncherQueryTic != gametic )
+	{
+		g_lLauncherQueryTic = gametic;
+		g_ulLauncherQueriesThisTic = 0;
+	}
+
+	while ( true )
+	{
+		NETTHREADPACKET_s	*pPacket = g_pGamePackets->front( );
+		bool				bLauncherQuery = false;
+
+		if (( pPacket == NULL ) && ( g_ulLauncherQueriesThisTic < MAX_LAUNCHER_QUERIES_PER_TIC ))
+		{
+			pPacket = g_pLauncherPackets->front( );
+			bLauncherQuery = true;
+		}
+
+		if ( pPacket == NULL )
+			return ( false );
+
+		// Just like NETWORK_GetPackets, ignore packets that exceed the buffer size.
+		const bool bOversized = (( pPacket->ulRawSize >= ulMaxSize ) || ( pPacket->ulSize > ulMaxSize ));
+
+		if ( bOversized == false )
+		{
+			Address = pPacket->Address;
+			ulSize = pPacket->ulSize;
+			ulRawSize = pPacket->ulRawSize;
+			memcpy( pbData, pPacket->abData, ulSize );
+		}
+
+		if ( bLauncherQuery )
+		{
+			g_pLauncherPackets->pop( );
+			g_ulLauncherQueriesThisTic++;
+		}
+		else
+			g_pGamePackets->pop( );
+
+		if ( bOversized )
+		{
+			g_ulOversizedPacketsDropped++;
+			continue;
+		}
+
+		return ( true );
+	}
+}
+
+//*****************************************************************************
+//
+void SERVER_NETTHREAD_SetAuthServerAddress( const NETADDRESS_s &Address )
+{
+	std::lock_guard<std::mutex> lock( g_AuthServerAddressMutex );
+	g_AuthServerAddress = Address;
+}
+
+//*****************************************************************************
+//
+static void server_netthread_Run( void )
+{
+	while ( g_bRunning )
+	{
+		NETADDRESS_s	Address;
+		NETADDRESS_s	AuthServerAddress;
+		const LONG		lRawSize = NETWORK_ReceiveRawPacket( g_abRawPacket, sizeof( g_abRawPacket ), Address, NETTHREAD_WAIT_MS );
+		int				iSize = sizeof( g_abDecodedPacket );
+
+		if ( lRawSize <= 0 )
+			continue;
+
+		g_ulPacketsReceived++;
+
+		{
+			std::lock_guard<std::mutex> lock( g_AuthServerAddressMutex );
+			AuthServerAddress = g_AuthServerAddress;
+		}
+
+		if ( Address.Compare( AuthServerAddress ))
+		{
+			iSize = MIN<int>( lRawSize, sizeof( g_abDecodedPacket ));
+			memcpy( g_abDecodedPacket, g_abRawPacket, iSize );
+		}
+		else
+			NETWORK_COMPRESSION_Decode( g_abRawPacket, g_abDecodedPacket, lRawSize, &iSize );
+
+		if ( iSize <= 0 )
+			continue;
+
+		NETTHREADPACKET_s *pPacket;
+
+		if ( g_abDecodedPacket[0] == LAUNCHER_SERVER_CHALLENGE )
+		{
+			const LONG lTime = I_MSTime( ) / 1000;
+
+			g_LauncherFloodQueue.adjustHead( lTime );
+			if ( g_LauncherFloodQueue.isFull( ) || g_LauncherFloodQueue.addressInQueue( Address ))
+			{
+				g_ulLauncherQueriesThrottled++;
+				continue;
+			}
+
+			g_LauncherFloodQueue.addAddress( Address, lTime );
+
+			if (( pPacket = g_pLauncherPackets->getFreeSlot( )) == NULL )
+			{
+				g_ulLauncherQueriesDropped++;
+				continue;
+			}
+		}
+		else if (( pPacket = g_pGamePackets->getFreeSlot( )) == NULL )
+		{
+			// The reliable packets will be resent like any other lost packet.
+			g_ulGamePacketsDropped++;
+			continue;
+		}
+
+		pPacket->Address = Address;
+		pPacket->ulSize = iSize;
+		pPacket->ulRawSize = lRawSize;
+		memcpy( pPacket->abData, g_abDecodedPacket, iSize );
+
+		if ( g_abDecodedPacket[0] == LAUNCHER_SERVER_CHALLENGE )
+			g_pLauncherPackets->push( );
+		else
+			g_pGamePackets->push( );
+	}
+}
+
+//*****************************************************************************
+//	STATISTICS
+
+ADD_STAT( netthread )
+{
+	FString	out;
+
+	if ( g_bRunning == false )
+		return ( "The network thread is not running." );
+
+	out.Format( "%lu packets received, %lu game packets dropped, %lu launcher queries throttled, %lu dropped, %lu oversized packets dropped",
+		g_ulPacketsReceived.load( ), g_ulGamePacketsDropped.load( ), g_ulLauncherQueriesThrottled.load( ), g_ulLauncherQueriesDropped.load( ), g_ulOversizedPacketsDropped.load( ));
+	return ( out );
+}
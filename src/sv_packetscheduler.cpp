@@ -0,0 +1,472 @@
+//-----------------------------------------------------------------------------
+//
+// Zandronum Source
+// Copyright (C) 2026 Zandronum Development Team
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 3. Neither the name of the Zandronum Development Team nor the names of its
+//    contributors may be used to endorse or promote products derived from this
+//    software without specific prior written permission.
+// 4. Redistributions in any form must be accompanied by information on how to
+//    obtain complete source code for the software and any accompanying
+//    software that uses the software. The source code must either be included
+//    in the distribution or be available for no more than the cost of
+//    distribution plus a nominal fee, and must be freely redistributable
+//    under reasonable conditions. For an executable file, complete source
+//    code means the source code for all modules it contains. It does not
+//    include source code for modules or files that typically accompany the
+//    major components of the operating system on which the executable file
+//    runs.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//
+// Filename: sv_packetscheduler.cpp
+//
+// Description: Schedules the unreliable commands to the clients by priority
+// within a per-client byte budget.
+//
+// Without a budget, unreliable commands are written into the client's
+// unreliable packet in the order the game generates them, so a tic with many
+// moving players or a large actor snapshot can flood a slow client. With
+// sv_maxclientrate set, the unreliable commands are queued instead. Once per
+// tic, the queue is written out in the order of the command priorities, until
+// the client's budget is used up. The budget is refilled every tic with
+// sv_maxclientrate / TICRATE bytes, everything sent through the reliable
+// stream is deducted from it first. A burst of reliable commands, e.g. a full
+// update, may put the budget into debt, but the movement of the players still
+// gets a share of every tic's refill, so it isn't frozen while the debt is
+// paid off. Puffs and sounds are sent unreliably while the scheduler is
+// enabled, so they don't use up the budget through the reliable stream.
+//
+// Whatever didn't fit is dropped, unless the command carries a value that is
+// replaced by a newer one anyway, like a ping. Such commands stay queued and a
+// newer command of the same kind for the same player replaces the queued one.
+// Dropping is safe, unreliable commands may get lost on the way anyway: the
+// next MovePlayer repairs the position of a player, the actor snapshots keep
+// sending everything the client didn't acknowledge.
+//
+// The reliable commands are not scheduled. The client relies on getting them
+// in the order they were sent, and lost reliable packets are resent by their
+// sequence number.
+//
+//-----------------------------------------------------------------------------
+
+#include "sv_packetscheduler.h"
+#include "c_cvars.h"
+#include "doomdef.h"
+#include "doomstat.h"
+#include "d_player.h"
+#include "network_enums.h"
+#include "stats.h"
+#include "sv_main.h"
+#include "templates.h"
+
+//*****************************************************************************
+//	DEFINES
+
+// The highest rate used for clients with cl_connectiontype 0 (56k / ISDN), in
+// bytes per second.
+#define	SLOW_CONNECTION_RATE		8000
+
+// How many tics of unused budget a client may save up for a larger tic.
+#define	MAX_SAVED_BUDGET_TICS		4
+
+// The share of a tic's budget that the movement commands may always use, even
+// if the reliable stream put the budget into debt (1/n).
+#define	MOVEMENT_RESERVE_SHARE		2
+
+// The priorities of the unreliable commands, the lower, the more important.
+enum PACKETPRIORITY_e
+{
+	// The client's own position and the pings the server measures.
+	PACKETPRIORITY_LOCALPLAYER,
+
+	// The movement of the other players.
+	PACKETPRIORITY_MOVEMENT,
+
+	// The actor snapshots.
+	PACKETPRIORITY_ACTORS,
+
+	// Pings and times shown on the scoreboard.
+	PACKETPRIORITY_STATUS,
+
+	// Everything else, e.g. weapon bobbing, puffs and sounds.
+	PACKETPRIORITY_COSMETIC,
+
+	NUM_PACKETPRIORITIES
+};
+
+//*****************************************************************************
+//	STRUCTURES
+
+struct SCHEDULEDCOMMAND_s
+{
+	// Commands with the same key replace each other, 0 if the command can't be
+	// replaced.
+	ULONG			ulKey;
+
+	// Where the command is stored in the client's queue.
+	ULONG			ulOffset;
+	ULONG			ulSize;
+
+	PACKETPRIORITY_e	Priority;
+
+	// Keep the command for the next tic if it didn't fit into this one?
+	bool			bCarryOver;
+
+	// Has this command been replaced by a newer one?
+	bool			bReplaced;
+};
+
+//*****************************************************************************
+struct CLIENTSCHEDULE_s
+{
+	TArray<BYTE>				Data;
+	TArray<SCHEDULEDCOMMAND_s>	Commands;
+
+	// The bytes this client may still be sent, may be negative if the reliable
+	// stream used more than the budget.
+	LONG						lBudget;
+
+	// The tic the budget was refilled last.
+	LONG						lRefillTic;
+
+	// Is the latest command an actor snapshot header that the following
+	// deltas belong to?
+	bool						bSnapshotPieceOpen;
+};
+
+//*****************************************************************************
+//	VARIABLES
+
+static	CLIENTSCHEDULE_s	g_aSchedules[MAXPLAYERS];
+
+// Statistics for "stat packetscheduler".
+static	ULONG				g_ulCommandsQueued;
+static	ULONG				g_ulCommandsReplaced;
+static	ULONG				g_ulCommandsDropped;
+static	ULONG				g_ulCommandsCarriedOver;
+static	ULONG				g_ulMovementSent;
+static	ULONG				g_ulMovementSentInDebt;
+static	ULONG				g_ulMovementDropped;
+
+//*****************************************************************************
+//	PROTOTYPES
+
+static	LONG			server_packetscheduler_GetClientRate( ULONG ulClient );
+static	void			server_packetscheduler_Refill( ULONG ulClient );
+static	void			server_packetscheduler_Classify( const NETBUFFER_s &Command, SCHEDULEDCOMMAND_s &Scheduled );
+
+//*****************************************************************************
+//	CONSOLE VARIABLES
+
+// The bytes per second each client may be sent, 0 disables the scheduler.
+CUSTOM_CVAR( Int, sv_maxclientrate, 0, CVAR_ARCHIVE|CVAR_NOSETBYACS )
+{
+	if ( self < 0 )
+		self = 0;
+}
+
+//*****************************************************************************
+//	FUNCTIONS
+
+bool SERVER_PACKETSCHEDULER_IsEnabled( void )
+{
+	return (( NETWORK_GetState( ) == NETSTATE_SERVER ) && ( sv_maxclientrate > 0 ));
+}
+
+//*****************************************************************************
+//
+// Queues an unreliable command to a client. Returns false if the command
+// wasn't queued and has to be written into the client's packet right away.
+//
+bool SERVER_PACKETSCHEDULER_QueueCommand( ULONG ulClient, const NETBUFFER_s &Command )
+{
+	if (( SERVER_PACKETSCHEDULER_IsEnabled( ) == false ) || ( ulClient >= MAXPLAYERS ))
+		return ( false );
+
+	CLIENTSCHEDULE_s	&schedule = g_aSchedules[ulClient];
+	const ULONG			ulSize = Command.CalcSize( );
+	SCHEDULEDCOMMAND_s	scheduled;
+
+	if ( ulSize == 0 )
+		return ( true );
+
+	server_packetscheduler_Classify( Command, scheduled );
+
+	// Write the command through a byte stream, so that it's included in the
+	// traffic measurements.
+	const ULONG ulOffset = schedule.Data.Size( );
+	BYTESTREAM_s stream;
+	schedule.Data.Resize( ulOffset + ulSize );
+	stream.pbStream = &schedule.Data[ulOffset];
+	stream.pbStreamEnd = stream.pbStream + ulSize;
+	Command.WriteTo( stream );
+
+	// The deltas of an actor snapshot are only of use together with their
+	// header, so they are sent or dropped together.
+	const bool bDelta = (( Command.pbData[0] == SVC_EXTENDEDCOMMAND ) && ( Command.pbData[1] == SVC2_ACTORDELTA ));
+	if ( bDelta && schedule.bSnapshotPieceOpen )
+	{
+		schedule.Commands[schedule.Commands.Size( ) - 1].ulSize += ulSize;
+		return ( true );
+	}
+
+	schedule.bSnapshotPieceOpen = (( Command.pbData[0] == SVC_EXTENDEDCOMMAND ) && ( Command.pbData[1] == SVC2_ACTORSNAPSHOT ));
+
+	// A newer command replaces an older one of the same kind.
+	if ( scheduled.ulKey != 0 )
+	{
+		for ( unsigned int i = 0; i < schedule.Commands.Size( ); i++ )
+		{
+			if (( schedule.Commands[i].ulKey == scheduled.ulKey ) && ( schedule.Commands[i].bReplaced == false ))
+			{
+				schedule.Commands[i].bReplaced = true;
+				g_ulCommandsReplaced++;
+			}
+		}
+	}
+
+	scheduled.ulOffset = ulOffset;
+	scheduled.ulSize = ulSize;
+	scheduled.bReplaced = false;
+	schedule.Commands.Push( scheduled );
+	g_ulCommandsQueued++;
+	return ( true );
+}
+
+//*****************************************************************************
+//
+// Deducts the bytes sent to the client through the reliable stream from the
+// budget of the unreliable commands.
+//
+void SERVER_PACKETSCHEDULER_CountReliableBytes( ULONG ulClient, ULONG ulBytes )
+{
+	if (( SERVER_PACKETSCHEDULER_IsEnabled( ) == false ) || ( ulClient >= MAXPLAYERS ))
+		return;
+
+	server_packetscheduler_Refill( ulClient );
+
+	// Don't let a full update block the unreliable commands for more than a
+	// second.
+	const LONG lRate = server_packetscheduler_GetClientRate( ulClient );
+	g_aSchedules[ulClient].lBudget = MAX<LONG>( g_aSchedules[ulClient].lBudget - static_cast<LONG>( ulBytes ), -lRate );
+}
+
+//*****************************************************************************
+//
+// Writes the queued commands of this tic into the client's unreliable packet,
+// most important first. Has to be called after the reliable packet of the tic
+// was sent.
+//
+void SERVER_PACKETSCHEDULER_Flush( ULONG ulClient )
+{
+	if ( ulClient >= MAXPLAYERS )
+		return;
+
+	CLIENTSCHEDULE_s	&schedule = g_aSchedules[ulClient];
+	CLIENT_s			*pClient = SERVER_GetClient( ulClient );
+	const bool			bLimited = SERVER_PACKETSCHEDULER_IsEnabled( );
+	bool				bBudgetUsedUp = false;
+
+	schedule.bSnapshotPieceOpen = false;
+	if ( schedule.Commands.Size( ) == 0 )
+		return;
+
+	server_packetscheduler_Refill( ulClient );
+
+	// The movement commands may use this much of the tic's refill regardless
+	// of the debt.
+	const LONG	lRate = server_packetscheduler_GetClientRate( ulClient );
+	LONG		lReserve = lRate / TICRATE / MOVEMENT_RESERVE_SHARE;
+
+	TArray<SCHEDULEDCOMMAND_s>	unsent;
+
+	for ( int priority = 0; priority < NUM_PACKETPRIORITIES; priority++ )
+	{
+		for ( unsigned int i = 0; i < schedule.Commands.Size( ); i++ )
+		{
+			const SCHEDULEDCOMMAND_s &scheduled = schedule.Commands[i];
+
+			if (( scheduled.Priority != priority ) || scheduled.bReplaced )
+				continue;
+
+			const bool	bMovement = ( scheduled.Priority <= PACKETPRIORITY_MOVEMENT );
+			const LONG	lAvailable = bMovement ? MAX( schedule.lBudget, lReserve ) : schedule.lBudget;
+
+			// Once a command didn't fit, nothing less important is sent either,
+			// otherwise small cosmetic commands could starve large important ones.
+			if ( bLimited && ( bBudgetUsedUp || ( static_cast<LONG>( scheduled.ulSize ) > lAvailable )))
+			{
+				bBudgetUsedUp = true;
+				unsent.Push( scheduled );
+				if ( bMovement )
+					g_ulMovementDropped++;
+				continue;
+			}
+
+			SERVER_CheckClientBuffer( ulClient, scheduled.ulSize, false );
+			pClient->UnreliablePacketBuffer.ByteStream.WriteBuffer( &schedule.Data[scheduled.ulOffset], scheduled.ulSize );
+
+			if ( bMovement )
+			{
+				g_ulMovementSent++;
+				if ( static_cast<LONG>( scheduled.ulSize ) > schedule.lBudget )
+					g_ulMovementSentInDebt++;
+				lReserve -= scheduled.ulSize;
+			}
+			schedule.lBudget = MAX<LONG>( schedule.lBudget - static_cast<LONG>( scheduled.ulSize ), -lRate );
+		}
+	}
+
+	// Keep what may be sent later, the commands of a tic are only replaced by
+	// newer ones, so their order doesn't matter.
+	TArray<BYTE>	data;
+
+	schedule.Commands.Clear( );
+	for ( unsigned int i = 0; i < unsent.Size( ); i++ )
+	{
+		if ( unsent[i].bCarryOver == false )
+		{
+			g_ulCommandsDropped++;
+			continue;
+		}
+
+		SCHEDULEDCOMMAND_s scheduled = unsent[i];
+		scheduled.ulOffset = data.Size( );
+		data.Resize( scheduled.ulOffset + scheduled.ulSize );
+		memcpy( &data[scheduled.ulOffset], &schedule.Data[unsent[i].ulOffset], scheduled.ulSize );
+		schedule.Commands.Push( scheduled );
+		g_ulCommandsCarriedOver++;
+	}
+
+	schedule.Data = data;
+}
+
+//*****************************************************************************
+//
+void SERVER_PACKETSCHEDULER_ResetClient( ULONG ulClient )
+{
+	if ( ulClient >= MAXPLAYERS )
+		return;
+
+	g_aSchedules[ulClient].Data.Clear( );
+	g_aSchedules[ulClient].Commands.Clear( );
+	g_aSchedules[ulClient].lBudget = 0;
+	g_aSchedules[ulClient].lRefillTic = gametic;
+	g_aSchedules[ulClient].bSnapshotPieceOpen = false;
+}
+
+//*****************************************************************************
+//
+static LONG server_packetscheduler_GetClientRate( ULONG ulClient )
+{
+	LONG lRate = sv_maxclientrate;
+
+	if ( players[ulClient].userinfo.GetConnectionType( ) == 0 )
+		lRate = MIN<LONG>( lRate, SLOW_CONNECTION_RATE );
+
+	return ( lRate );
+}
+
+//*****************************************************************************
+//
+static void server_packetscheduler_Refill( ULONG ulClient )
+{
+	CLIENTSCHEDULE_s	&schedule = g_aSchedules[ulClient];
+	const LONG			lRate = server_packetscheduler_GetClientRate( ulClient );
+	const LONG			lTics = MIN<LONG>( gametic - schedule.lRefillTic, MAX_SAVED_BUDGET_TICS );
+
+	// The tic counter was reset, e.g. by a map change.
+	if ( lTics < 0 )
+	{
+		schedule.lRefillTic = gametic;
+		return;
+	}
+
+	schedule.lRefillTic = gametic;
+	schedule.lBudget = MIN<LONG>( schedule.lBudget + ( lRate * lTics ) / TICRATE, ( lRate * MAX_SAVED_BUDGET_TICS ) / TICRATE );
+}
+
+//*****************************************************************************
+//
+static void server_packetscheduler_Classify( const NETBUFFER_s &Command, SCHEDULEDCOMMAND_s &Scheduled )
+{
+	const ULONG	ulSize = Command.CalcSize( );
+	int			header = Command.pbData[0];
+
+	if (( header == SVC_EXTENDEDCOMMAND ) && ( ulSize > 1 ))
+		header = NUM_SERVER_COMMANDS + Command.pbData[1];
+
+	// The player the command is about is the first parameter of the player
+	// commands.
+	const ULONG ulPlayer = ( ulSize > 1 ) ? Command.pbData[1] : 0;
+
+	Scheduled.ulKey = 0;
+	Scheduled.Priority = PACKETPRIORITY_COSMETIC;
+	Scheduled.bCarryOver = false;
+
+	switch ( header )
+	{
+	case SVC_MOVELOCALPLAYER:
+	case NUM_SERVER_COMMANDS + SVC2_SETLOCALPLAYERJUMPTICS:
+	case SVC_PING:
+
+		Scheduled.Priority = PACKETPRIORITY_LOCALPLAYER;
+		Scheduled.ulKey = ( header + 1 ) << 8;
+		Scheduled.bCarryOver = true;
+		break;
+	case SVC_MOVEPLAYER:
+	case SVC_UPDATEPLAYEREXTRADATA:
+
+		Scheduled.Priority = PACKETPRIORITY_MOVEMENT;
+		Scheduled.ulKey = (( header + 1 ) << 8 ) | ulPlayer;
+		break;
+	case NUM_SERVER_COMMANDS + SVC2_ACTORSNAPSHOT:
+	case NUM_SERVER_COMMANDS + SVC2_ACTORDELTA:
+
+		Scheduled.Priority = PACKETPRIORITY_ACTORS;
+		break;
+	case SVC_UPDATEPLAYERPING:
+	case SVC_UPDATEPLAYERTIME:
+
+		Scheduled.Priority = PACKETPRIORITY_STATUS;
+		Scheduled.ulKey = (( header + 1 ) << 8 ) | ulPlayer;
+		Scheduled.bCarryOver = true;
+		break;
+	}
+}
+
+//*****************************************************************************
+//	STATISTICS
+
+ADD_STAT( packetscheduler )
+{
+	FString	out;
+
+	out.Format( "%lu commands queued, %lu replaced, %lu dropped, %lu carried over\n"
+		"Movement: %lu sent (%lu of them while the budget was in debt), %lu not sent",
+		g_ulCommandsQueued, g_ulCommandsReplaced, g_ulCommandsDropped, g_ulCommandsCarriedOver,
+		g_ulMovementSent, g_ulMovementSentInDebt, g_ulMovementDropped );
+	return ( out );
+}
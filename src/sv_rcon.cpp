@@ -61,6 +61,7 @@
 #include "m_random.h"
 #include "version.h"
 #include "v_text.h"
+#include "sv_logthread.h"
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- VARIABLES -------------------------------------------------------------------------------------------------------------------------------------
@@ -81,6 +82,9 @@ static	std::list<FString>				g_RecentConsoleLines;
 // IPs that we're ignoring (bad passwords, old protocol versions) to prevent flooding.
 static	QueryIPQueue					g_BadRequestFloodQueue( BAD_QUERY_IGNORE_TIME );
 
+// [Zandronum] With -logthread, the messages printed during a tic are collected here and sent together by SERVER_RCON_Tick.
+static	FString							g_PendingMessages;
+
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- PROTOTYPES ------------------------------------------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------------------------------------------------------
@@ -91,6 +95,8 @@ static	void							server_rcon_HandleLogin( int iCandidateIndex, const char *pszH
 static	void							server_rcon_CreateSalt( char *pszBuffer );
 static	LONG							server_rcon_FindClient( NETADDRESS_s Address );
 static	LONG							server_rcon_FindCandidate( NETADDRESS_s Address );
+static	void							server_rcon_SendMessage( const char *pszString );
+static	void							server_rcon_SendPendingMessages( );
 
 //--------------------------------------------------------------------------------------------------------------------------------------------------
 //-- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------
@@ -142,6 +148,8 @@ void SERVER_RCON_Tick( )
 	}
 
 	g_BadRequestFloodQueue.adjustHead( gametic / 1000 );
+
+	server_rcon_SendPendingMessages( );
 }
 
 //==========================================================================
@@ -237,13 +245,14 @@ void SERVER_RCON_ParseMessage( NETADDRESS_s Address, LONG lMessage, BYTESTREAM_s
 
 void SERVER_RCON_Print( const char *pszString )
 {
-	for ( unsigned int i = 0; i < g_AuthedClients.Size( ); i++ )
+	// [Zandronum] Collect the messages of this tic if we're writing the log on a separate thread.
+	if ( SERVER_LOGTHREAD_IsRunning( ))
 	{
-		g_MessageBuffer.Clear();
-		g_MessageBuffer.ByteStream.WriteByte( SVRC_MESSAGE );
-		g_MessageBuffer.ByteStream.WriteString( pszString );
-		NETWORK_LaunchPacket( &g_MessageBuffer, g_AuthedClients[i].Address );
+		if ( g_AuthedClients.Size( ) > 0 )
+			g_PendingMessages += pszString;
 	}
+	else
+		server_rcon_SendMessage( pszString );
 
 	//==========================================
 	// Add this to the cache of recent messages.
@@ -264,6 +273,57 @@ void SERVER_RCON_Print( const char *pszString )
 	g_RecentConsoleLines.push_back( fsLogged );
 }
 
+//==========================================================================
+//
+// server_rcon_SendMessage
+//
+// Sends one SVRC_MESSAGE to all connected administrators.
+//
+//==========================================================================
+
+static void server_rcon_SendMessage( const char *pszString )
+{
+	for ( unsigned int i = 0; i < g_AuthedClients.Size( ); i++ )
+	{
+		g_MessageBuffer.Clear();
+		g_MessageBuffer.ByteStream.WriteByte( SVRC_MESSAGE );
+		g_MessageBuffer.ByteStream.WriteString( pszString );
+		NETWORK_LaunchPacket( &g_MessageBuffer, g_AuthedClients[i].Address );
+	}
+}
+
+//==========================================================================
+//
+// server_rcon_SendPendingMessages
+//
+// [Zandronum] Sends the messages collected during this tic in as few packets as possible.
+// The text is split after a newline if it doesn't fit into one packet.
+//
+//==========================================================================
+
+static void server_rcon_SendPendingMessages( )
+{
+	const int	iMaxLength = MAX_UDP_PACKET / 2;
+	int			iStart = 0;
+
+	while ( iStart < static_cast<int>( g_PendingMessages.Len( )))
+	{
+		int iLength = static_cast<int>( g_PendingMessages.Len( )) - iStart;
+
+		if ( iLength > iMaxLength )
+		{
+			const int iNewline = g_PendingMessages.LastIndexOf( '\n', iStart + iMaxLength );
+
+			iLength = ( iNewline >= iStart ) ? ( iNewline + 1 - iStart ) : iMaxLength;
+		}
+
+		server_rcon_SendMessage( FString( g_PendingMessages.GetChars( ) + iStart, iLength ));
+		iStart += iLength;
+	}
+
+	g_PendingMessages = "";
+}
+
 //==========================================================================
 //
 // SERVER_RCON_UpdateInfo
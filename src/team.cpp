@@ -1050,6 +1050,7 @@ void TEAM_SetScore( ULONG ulTeamIdx, LONG lScore, bool bAnnouncer )
 
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 
 	// Implement the pointlimit.
@@ -1307,6 +1308,7 @@ void TEAM_SetFragCount( ULONG ulTeamIdx, LONG lFragCount, bool bAnnounce )
 
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 }
 
@@ -1373,6 +1375,7 @@ void TEAM_SetWinCount( ULONG ulTeamIdx, LONG lWinCount, bool bAnnounce )
 
 		// Also, update the scoreboard.
 		SERVERCONSOLE_UpdateScoreboard( );
+		SERVER_MASTER_InvalidateServerInfo( );
 	}
 }
 
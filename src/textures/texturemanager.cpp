@@ -557,7 +557,9 @@ void FTextureManager::AddHiresTextures (int wadnum)
 						AddTexture(newtex);
 					}
 				}
-				else
+				// [Zandronum] Replacements keep the size of the original texture and only
+				// change how it looks, so lean servers don't need to load them.
+				else if (!leanstartup)
 				{
 					for(unsigned int i = 0; i < tlist.Size(); i++)
 					{
@@ -638,7 +640,8 @@ void FTextureManager::LoadTextureDefs(int wadnum, const char *lumpname)
 						Printf("Attempting to remap texture %s to non-existent lump %s\n",
 							texname.GetChars(), sc.String);
 					}
-					else
+					// [Zandronum] Lean servers don't need replacements, see AddHiresTextures.
+					else if (!leanstartup)
 					{
 						for(unsigned int i = 0; i < tlist.Size(); i++)
 						{
@@ -1018,7 +1021,9 @@ void FTextureManager::Init()
 	InitAnimDefs();
 	FixAnimations();
 	InitSwitchList();
-	InitPalettedVersions();
+	// [Zandronum] The paletted versions are only used by the renderer.
+	if (!leanstartup)
+		InitPalettedVersions();
 }
 
 //==========================================================================
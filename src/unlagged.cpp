@@ -61,16 +61,35 @@
 #include "sv_commands.h"
 #include "templates.h"
 #include "d_netinf.h"
+#include "c_dispatch.h"
+#include "stats.h"
 
 CVAR(Flag, sv_nounlagged, zadmflags, ZADF_NOUNLAGGED);
 CVAR( Bool, sv_unlagged_debugactors, false, 0 )
 
+// Only change the positions of reconciled players, without relinking them
+// into the blockmap and sectors. Traces then find them through the list of
+// hitboxes instead. Other blockmap searches during a reconciled shot, e.g. of
+// a splash damage, still see the players where they were linked.
+CVAR( Bool, sv_unlagged_hitboxes, false, CVAR_ARCHIVE )
+
 bool reconciledGame = false;
 int reconciliationBlockers = 0;
 
+// The tic index the game is reconciled to and whether the players were
+// relinked.
+static int reconciledIndex = 0;
+static bool reconciledWithHitboxes = false;
+
+// The players moved back without being relinked.
+static AActor *hitboxActors[MAXPLAYERS];
+static ULONG numHitboxActors = 0;
+
 // To keep track of the shooter's height adjustement.
 fixed_t reconcilledZ;
 
+static void unlagged_ReconcileTo( AActor *actor, int unlaggedGametic, bool bHitboxes );
+
 void UNLAGGED_Tick( void )
 {
 	// [BB] Only the server has to do anything here.
@@ -154,10 +173,20 @@ void UNLAGGED_Reconcile( AActor *actor )
 	if (unlaggedGametic == gametic)
 		return;
 
+	unlagged_ReconcileTo( actor, unlaggedGametic, sv_unlagged_hitboxes );
+}
+
+// Does the actual work of UNLAGGED_Reconcile, once it's clear that the game
+// should be reconciled to unlaggedGametic.
+static void unlagged_ReconcileTo( AActor *actor, int unlaggedGametic, bool bHitboxes )
+{
 	reconciledGame = true;
+	reconciledWithHitboxes = bHitboxes;
+	numHitboxActors = 0;
 
 	//find the index
 	const int unlaggedIndex = unlaggedGametic % UNLAGGEDTICS;
+	reconciledIndex = unlaggedIndex;
 
 	//reconcile the sectors
 	for (int i = 0; i < numsectors; ++i)
@@ -186,7 +215,15 @@ void UNLAGGED_Reconcile( AActor *actor )
 
 			//Also, don't reconcile the shooter because the client is supposed
 			//to predict him
-			if (players+i != actor->player)
+			if ((players+i != actor->player) && bHitboxes)
+			{
+				players[i].mo->x = players[i].unlaggedX[unlaggedIndex];
+				players[i].mo->y = players[i].unlaggedY[unlaggedIndex];
+				players[i].mo->z = players[i].unlaggedZ[unlaggedIndex];
+				players[i].bUnlaggedHitbox = true;
+				hitboxActors[numHitboxActors++] = players[i].mo;
+			}
+			else if (players+i != actor->player)
 			{
 				players[i].mo->SetOrigin(
 					players[i].unlaggedX[unlaggedIndex],
@@ -267,13 +304,15 @@ void UNLAGGED_Restore( AActor *actor )
 		sectors[i].ceilingplane.d = sectors[i].ceilingplane.restoreD;
 	}
 
-	const int unlaggedIndex = UNLAGGED_Gametic( actor->player ) % UNLAGGEDTICS;
+	const int unlaggedIndex = reconciledIndex;
 
 	//restore the players
 	for (int i = 0; i < MAXPLAYERS; ++i)
 	{
 		if (playeringame[i] && players[i].mo && !players[i].bSpectating)
 		{
+			players[i].bUnlaggedHitbox = false;
+
 			// Do not restore this player's position if the shot resulted in his direct teleportation.
 			if ( players + i != actor->player )
 			{
@@ -291,15 +330,36 @@ void UNLAGGED_Restore( AActor *actor )
 				continue;
 			}
 
-			players[i].mo->SetOrigin( players[i].restoreX, players[i].restoreY, players[i].restoreZ );
+			// Without relinking, the player is still linked at the restored position.
+			if ( reconciledWithHitboxes )
+			{
+				players[i].mo->x = players[i].restoreX;
+				players[i].mo->y = players[i].restoreY;
+				players[i].mo->z = players[i].restoreZ;
+			}
+			else
+				players[i].mo->SetOrigin( players[i].restoreX, players[i].restoreY, players[i].restoreZ );
 			players[i].mo->floorz = players[i].restoreFloorZ;
 			players[i].mo->ceilingz = players[i].restoreCeilingZ;
 		}
 	}
 
+	numHitboxActors = 0;
 	reconciledGame = false;
 }
 
+// The players a trace has to check in addition to the things it finds in the
+// blockmap, see sv_unlagged_hitboxes.
+ULONG UNLAGGED_GetNumHitboxActors ( )
+{
+	return numHitboxActors;
+}
+
+AActor *UNLAGGED_GetHitboxActor ( ULONG ulIdx )
+{
+	return ( ulIdx < numHitboxActors ) ? hitboxActors[ulIdx] : NULL;
+}
+
 
 // Record the positions of just one player
 // in order to be able to reconcile them later
@@ -464,3 +524,67 @@ void UNLAGGED_SpawnDebugActors ( )
 		pActor->Destroy();
 	}
 }
+
+// Measures how many reconciled hitscan shots per second the server can do
+// with the players in the game, once relinking the players and once with
+// sv_unlagged_hitboxes. Add bots to test with 32 or 64 players.
+CCMD( bench_unlagged )
+{
+	const ULONG ulShots = ( argv.argc( ) > 1 ) ? MAX( atoi( argv[1] ), 1 ) : 10000;
+	AActor *shooter = NULL;
+	ULONG ulNumPlayers = 0;
+
+	if ( NETWORK_GetState( ) != NETSTATE_SERVER )
+	{
+		Printf( "bench_unlagged can only be used by the server.\n" );
+		return;
+	}
+
+	if ( reconciledGame || ( reconciliationBlockers > 0 ) || ( gametic < 1 ))
+		return;
+
+	for ( ULONG ulIdx = 0; ulIdx < MAXPLAYERS; ++ulIdx )
+	{
+		if ( playeringame[ulIdx] && players[ulIdx].mo && !players[ulIdx].bSpectating )
+		{
+			if ( shooter == NULL )
+				shooter = players[ulIdx].mo;
+			ulNumPlayers++;
+		}
+	}
+
+	if ( shooter == NULL )
+	{
+		Printf( "bench_unlagged needs at least one player in the game.\n" );
+		return;
+	}
+
+	for ( int pass = 0; pass < 2; ++pass )
+	{
+		const bool bHitboxes = ( pass == 1 );
+		ULONG ulHits = 0;
+		cycle_t time;
+
+		time.Reset( );
+		time.Clock( );
+		for ( ULONG ulShot = 0; ulShot < ulShots; ++ulShot )
+		{
+			// Spread the shots around the shooter so that they hit something now and then.
+			const angle_t angle = shooter->angle + ( ulShot * ( ANGLE_MAX / 64 ));
+			FTraceResults trace;
+
+			unlagged_ReconcileTo( shooter, gametic - 1, bHitboxes );
+			Trace( shooter->x, shooter->y, shooter->z + shooter->height / 2, shooter->Sector,
+				finecosine[angle >> ANGLETOFINESHIFT], finesine[angle >> ANGLETOFINESHIFT], 0, 8192 * FRACUNIT,
+				MF_SHOOTABLE, ML_BLOCKEVERYTHING, shooter, trace );
+			UNLAGGED_Restore( shooter );
+
+			if ( trace.HitType == TRACE_HitActor )
+				ulHits++;
+		}
+		time.Unclock( );
+
+		Printf( "%s: %.0f shots per second with %lu players (%lu hit a thing)\n",
+			bHitboxes ? "Hitboxes" : "Relinking", ulShots * 1000.0 / MAX( time.TimeMS( ), 0.001 ), ulNumPlayers, ulHits );
+	}
+}
@@ -69,5 +69,7 @@ bool	UNLAGGED_IsReconciled ( );
 void	UNLAGGED_AddReconciliationBlocker ( );
 void	UNLAGGED_RemoveReconciliationBlocker ( );
 void	UNLAGGED_SpawnDebugActors ( );
+ULONG	UNLAGGED_GetNumHitboxActors ( );
+AActor	*UNLAGGED_GetHitboxActor ( ULONG ulIdx );
 
 #endif // __UNLAGGED_H__
@@ -38,6 +38,9 @@
 
 #include <stdlib.h>
 #include <ctype.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <string.h>
@@ -155,6 +158,7 @@ void FWadCollection::DeleteAll ()
 
 	LumpInfo.Clear();
 	NumLumps = 0;
+	PrefetchedLumps.Clear();
 
 	// we must count backward to enssure that embedded WADs are deleted before
 	// the ones that contain their data.
@@ -289,9 +293,27 @@ void FWadCollection::AddFile (const char *filename, FileReader *wadinfo, bool bL
 
 		if (!isdir)
 		{
+			// [Zandronum] With -mmapwads, the file is mapped into memory so that
+			// the uncompressed lumps can be used from the page cache directly.
+			if (Args->CheckParm("-mmapwads"))
+			{
+				MappedFileReader *mapped = new MappedFileReader(filename);
+				if (mapped->IsMapped())
+				{
+					wadinfo = mapped;
+				}
+				else
+				{
+					delete mapped;
+				}
+			}
+
 			try
 			{
-				wadinfo = new FileReader(filename);
+				if (wadinfo == NULL)
+				{
+					wadinfo = new FileReader(filename);
+				}
 			}
 			catch (CRecoverableError &err)
 			{ // Didn't find file
@@ -1195,6 +1217,269 @@ FWadLump *FWadCollection::ReopenLumpNum (int lump)
 	return new FWadLump(LumpInfo[lump].lump, true);
 }
 
+//==========================================================================
+//
+// PrefetchLumps
+//
+// [Zandronum] Fills the caches of the given compressed lumps on worker
+// threads, so that they aren't decompressed one at a time on the main
+// thread when they are first used. The caches are held until
+// ReleasePrefetchedLumps is called.
+//
+// A file can only be read by one thread at a time, so the compressed data
+// of zip lumps is read here and the workers only decompress it. The other
+// compressed lumps, e.g. those in a solid 7z archive, are cached one after
+// another by a single worker per underlying file. An embedded file may be
+// read through its parent's FILE, so files are grouped by what they are
+// really read from rather than by wadnum.
+//
+//==========================================================================
+
+struct FPrefetchTask
+{
+	int wadnum;
+	const void *source;
+	int lump;				// decompress this lump from data...
+	TArray<BYTE> data;
+	char *buffer;
+	TArray<int> lumps;		// ...or cache these lumps of the file one by one
+	double ms;
+};
+
+static const void *GetPrefetchSource (FResourceFile *file)
+{
+	FileReader *reader = file->GetReader();
+
+	if (reader == NULL)
+	{
+		// e.g. a directory, which opens a new file for every lump
+		return file;
+	}
+	if (reader->GetBuffer() != NULL || reader->GetFile() == NULL)
+	{
+		// Memory readers only share their read position.
+		return reader;
+	}
+	return reader->GetFile();
+}
+
+void FWadCollection::PrefetchLumps (const TArray<int> &lumps)
+{
+	TArray<FPrefetchTask> tasks;
+	TMap<int, bool> seen;
+	TArray<BYTE> data;
+	unsigned int i, j;
+
+	for (i = 0; i < lumps.Size(); ++i)
+	{
+		if ((unsigned)lumps[i] >= NumLumps || seen.CheckKey(lumps[i]) != NULL)
+		{
+			continue;
+		}
+		seen[lumps[i]] = true;
+
+		FResourceLump *lump = LumpInfo[lumps[i]].lump;
+		const int wadnum = LumpInfo[lumps[i]].wadnum;
+		const void *source;
+
+		// Skip lumps that are already cached or can be read from the file directly.
+		if (lump->Cache != NULL || lump->LumpSize <= 0 || lump->GetReader() != NULL)
+		{
+			continue;
+		}
+
+		if (lump->ReadCompressedData(data))
+		{
+			FPrefetchTask &task = tasks[tasks.Reserve(1)];
+			task.wadnum = wadnum;
+			task.source = NULL;
+			task.lump = lumps[i];
+			task.data = data;
+			task.buffer = NULL;
+			task.ms = 0;
+			continue;
+		}
+
+		source = GetPrefetchSource(Files[wadnum]);
+		for (j = 0; j < tasks.Size(); ++j)
+		{
+			if (tasks[j].lump < 0 && tasks[j].source == source)
+			{
+				break;
+			}
+		}
+		if (j == tasks.Size())
+		{
+			FPrefetchTask &task = tasks[tasks.Reserve(1)];
+			task.wadnum = wadnum;
+			task.source = source;
+			task.lump = -1;
+			task.buffer = NULL;
+			task.ms = 0;
+		}
+		tasks[j].lumps.Push(lumps[i]);
+	}
+
+	if (tasks.Size() == 0)
+	{
+		return;
+	}
+
+	const unsigned int starttime = I_MSTime();
+	std::atomic<unsigned int> nexttask(0);
+
+	auto work = [&]()
+	{
+		unsigned int t;
+
+		while ((t = nexttask++) < tasks.Size())
+		{
+			FPrefetchTask &task = tasks[t];
+			const auto start = std::chrono::steady_clock::now();
+			FResourceLump *current = NULL;
+
+			// Errors are reported when the lump is used on the main thread.
+			try
+			{
+				if (task.lump >= 0)
+				{
+					current = LumpInfo[task.lump].lump;
+					task.buffer = new char[current->LumpSize];
+					if (!current->Decompress(task.data, task.buffer))
+					{
+						delete[] task.buffer;
+						task.buffer = NULL;
+					}
+				}
+				else
+				{
+					for (unsigned int l = 0; l < task.lumps.Size(); ++l)
+					{
+						current = LumpInfo[task.lumps[l]].lump;
+						current->CacheLump();
+					}
+				}
+			}
+			catch (...)
+			{
+				if (task.lump >= 0)
+				{
+					delete[] task.buffer;
+					task.buffer = NULL;
+				}
+				else if (current != NULL && current->RefCount == 0)
+				{
+					delete[] current->Cache;
+					current->Cache = NULL;
+				}
+			}
+			task.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	};
+
+	unsigned int numthreads = MIN<unsigned int>(MAX<unsigned int>(std::thread::hardware_concurrency(), 1), 8);
+	numthreads = MIN(numthreads, tasks.Size());
+
+	if (numthreads <= 1)
+	{
+		work();
+	}
+	else
+	{
+		TArray<std::thread *> threads;
+		for (i = 0; i < numthreads; ++i)
+		{
+			threads.Push(new std::thread(work));
+		}
+		for (i = 0; i < numthreads; ++i)
+		{
+			threads[i]->join();
+			delete threads[i];
+		}
+	}
+
+	// Hand the results over to the lumps and report the time spent per file.
+	for (unsigned int wadnum = 0; wadnum < Files.Size(); ++wadnum)
+	{
+		int count = 0;
+		int size = 0;
+		double ms = 0;
+
+		for (i = 0; i < tasks.Size(); ++i)
+		{
+			FPrefetchTask &task = tasks[i];
+
+			// The lumps of a task can come from several files that share a
+			// reader. Its time is reported for the file it was created for.
+			if (task.wadnum == (int)wadnum)
+			{
+				ms += task.ms;
+			}
+
+			if (task.lump >= 0)
+			{
+				if (task.wadnum != (int)wadnum)
+				{
+					continue;
+				}
+				if (task.buffer != NULL)
+				{
+					FResourceLump *lump = LumpInfo[task.lump].lump;
+					lump->Cache = task.buffer;
+					lump->RefCount = 1;
+					PrefetchedLumps.Push(task.lump);
+					count++;
+					size += lump->LumpSize;
+				}
+			}
+			else
+			{
+				for (j = 0; j < task.lumps.Size(); ++j)
+				{
+					FResourceLump *lump = LumpInfo[task.lumps[j]].lump;
+					if (LumpInfo[task.lumps[j]].wadnum != (int)wadnum)
+					{
+						continue;
+					}
+					if (lump->Cache != NULL)
+					{
+						PrefetchedLumps.Push(task.lumps[j]);
+						count++;
+						size += lump->LumpSize;
+					}
+				}
+			}
+		}
+
+		if (count > 0)
+		{
+			DPrintf ("Prefetched %d lumps (%d KB) from %s in %.1f ms\n", count, size >> 10, Files[wadnum]->Filename, ms);
+		}
+	}
+	DPrintf ("Prefetching %u tasks on %u threads took %u ms\n", tasks.Size(), numthreads, I_MSTime() - starttime);
+}
+
+//==========================================================================
+//
+// ReleasePrefetchedLumps
+//
+// [Zandronum] Releases the references PrefetchLumps holds. Lumps that
+// nothing else uses are freed.
+//
+//==========================================================================
+
+void FWadCollection::ReleasePrefetchedLumps ()
+{
+	for (unsigned int i = 0; i < PrefetchedLumps.Size(); ++i)
+	{
+		if ((unsigned)PrefetchedLumps[i] < NumLumps)
+		{
+			LumpInfo[PrefetchedLumps[i]].lump->ReleaseCache();
+		}
+	}
+	PrefetchedLumps.Clear();
+}
+
 //==========================================================================
 //
 // GetFileReader
@@ -1508,7 +1793,8 @@ FWadLump::FWadLump(FResourceLump *lump, bool alwayscache)
 {
 	FileReader *f = lump->GetReader();
 
-	if (f != NULL && f->GetFile() != NULL && !alwayscache)
+	// [Zandronum] Lumps in mapped files are always read from the memory.
+	if (f != NULL && f->GetFile() != NULL && f->GetBuffer() == NULL && !alwayscache)
 	{
 		// Uncompressed lump in a file
 		File = f->GetFile();
@@ -183,6 +183,9 @@ public:
 	
 	FileReader * GetFileReader(int wadnum);	// Gets a FileReader object to the entire WAD
 
+	void PrefetchLumps (const TArray<int> &lumps);	// [Zandronum] Decompresses the lumps on worker threads
+	void ReleasePrefetchedLumps ();					// [Zandronum] Lets go of the lumps cached by PrefetchLumps
+
 	int FindLump (const char *name, int *lastlump, bool anyns=false);		// [RH] Find lumps with duplication
 	int FindLumpMulti (const char **names, int *lastlump, bool anyns = false, int *nameindex = NULL); // same with multiple possible names
 	bool CheckLumpName (int lump, const char *name);	// [RH] True if lump's name == name
@@ -238,6 +241,8 @@ protected:
 	DWORD NumLumps;					// Not necessarily the same as LumpInfo.Size()
 	DWORD NumWads;
 
+	TArray<int> PrefetchedLumps;	// [Zandronum] Lumps whose caches PrefetchLumps holds
+
 	void SkinHack (int baselump);
 	void InitHashChains ();								// [RH] Set up the lumpinfo hashing
 
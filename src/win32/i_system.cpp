@@ -51,6 +51,7 @@
 #include <mmsystem.h>
 #include <richedit.h>
 #include <wincrypt.h>
+#include <psapi.h>
 // [BB] New #includes.
 #include <shellapi.h>
 #include <shlobj.h>
@@ -333,6 +334,74 @@ unsigned int I_FPSTime()
 	return timeGetTime();
 }
 
+//==========================================================================
+//
+// I_GetResidentMemoryKB
+//
+// [Zandronum] Returns the working set of the process in kilobytes.
+//
+//==========================================================================
+
+unsigned int I_GetResidentMemoryKB()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return (unsigned int)(counters.WorkingSetSize / 1024);
+	}
+	return 0;
+}
+
+//==========================================================================
+//
+// I_MapFile
+//
+// [Zandronum] Maps the whole file into memory as a copy-on-write view.
+// Pages that are never written to are shared with every other process
+// that maps the same file.
+//
+//==========================================================================
+
+void *I_MapFile(FILE *file, long length)
+{
+	if (length <= 0)
+	{
+		return NULL;
+	}
+
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMapping(handle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+
+	// The view keeps the mapping alive.
+	void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, length);
+	CloseHandle(mapping);
+	return data;
+}
+
+//==========================================================================
+//
+// I_UnmapFile
+//
+//==========================================================================
+
+void I_UnmapFile(void *data, long length)
+{
+	if (data != NULL)
+	{
+		UnmapViewOfFile(data);
+	}
+}
+
 //==========================================================================
 //
 // I_GetTimePolled